@@ -6,28 +6,265 @@
 #include "FlattenRenderGraph.h"
 #include "Schemas/Types.h"
 #include <vector>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <numeric>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 #include "GigiCompilerLib/Backends/Shared.h"
 
+// A compact, index based view of which resources each node accesses, and how.
+// Resource nodes are renumbered densely into resource slots, in node order, so that per resource state is small.
+// The accesses of all nodes are stored in one flat array. The accesses of node N are in [nodeAccessBegin[N], nodeAccessBegin[N+1]).
+// If several pins of a node reference the same resource, the last pin wins.
+// Barrier nodes have no accesses, since they are removed after flattening.
+struct ResourceAccess
+{
+    int resourceSlot;
+    ShaderResourceAccessType access;
+};
+
+struct ResourceAccessTable
+{
+    std::vector<int> resourceNodeIndices;   // resource slot -> node index
+    std::vector<int> resourceSlots;         // node index -> resource slot, -1 if not a resource node
+    std::vector<bool> resourceImported;     // resource slot -> imported
+    std::vector<int> nodeAccessBegin;       // node index -> first access
+    std::vector<ResourceAccess> accesses;   // sorted by resource slot within each node
+
+    int ResourceCount() const
+    {
+        return (int)resourceNodeIndices.size();
+    }
+
+    const ResourceAccess* AccessesBegin(int nodeIndex) const
+    {
+        return accesses.data() + nodeAccessBegin[nodeIndex];
+    }
+
+    const ResourceAccess* AccessesEnd(int nodeIndex) const
+    {
+        return accesses.data() + nodeAccessBegin[nodeIndex + 1];
+    }
+};
+
+static ResourceAccessTable BuildResourceAccessTable(const RenderGraph& renderGraph)
+{
+    ResourceAccessTable ret;
+    ret.resourceSlots.resize(renderGraph.nodes.size(), -1);
+    for (int nodeIndex = 0; nodeIndex < (int)renderGraph.nodes.size(); ++nodeIndex)
+    {
+        const RenderGraphNode& node = renderGraph.nodes[nodeIndex];
+        if (!GetNodeIsResourceNode(node))
+            continue;
+
+        ret.resourceSlots[nodeIndex] = ret.ResourceCount();
+        ret.resourceNodeIndices.push_back(nodeIndex);
+        ret.resourceImported.push_back(GetNodeResourceVisibility(node) == ResourceVisibility::Imported);
+    }
+
+    ret.nodeAccessBegin.resize(renderGraph.nodes.size() + 1, 0);
+    for (int nodeIndex = 0; nodeIndex < (int)renderGraph.nodes.size(); ++nodeIndex)
+    {
+        const RenderGraphNode& node = renderGraph.nodes[nodeIndex];
+        int accessBegin = (int)ret.accesses.size();
+        ret.nodeAccessBegin[nodeIndex] = accessBegin;
+
+        if (GetNodeIsResourceNode(node) || node._index == RenderGraphNode::c_index_actionBarrier)
+            continue;
+
+        int pinCount = GetNodePinCount(node);
+        for (int pinIndex = 0; pinIndex < pinCount; ++pinIndex)
+        {
+            int resourceNodeIndex = GetResourceNodeForPin(renderGraph, node, pinIndex);
+            if (resourceNodeIndex == -1)
+                continue;
+
+            int resourceSlot = ret.resourceSlots[resourceNodeIndex];
+            ShaderResourceAccessType access = GetNodePinInputNodeInfo(node, pinIndex).access;
+
+            auto it = std::find_if(ret.accesses.begin() + accessBegin, ret.accesses.end(), [resourceSlot](const ResourceAccess& access) { return access.resourceSlot == resourceSlot; });
+            if (it != ret.accesses.end())
+                it->access = access;
+            else
+                ret.accesses.push_back({ resourceSlot, access });
+        }
+
+        std::sort(ret.accesses.begin() + accessBegin, ret.accesses.end(),
+            [](const ResourceAccess& A, const ResourceAccess& B)
+            {
+                return A.resourceSlot < B.resourceSlot;
+            }
+        );
+    }
+    ret.nodeAccessBegin[renderGraph.nodes.size()] = (int)ret.accesses.size();
+
+    return ret;
+}
+
+static bool StateChangeNeedsTransition(ShaderResourceAccessType lastState, ShaderResourceAccessType nextState)
+{
+    // if the state changed, or it goes from uavrw to uavrw, we need to emit a transition
+    return (lastState != nextState) || lastState == ShaderResourceAccessType::UAV;
+}
+
+// Scores an ordering of nodes by the number of resource transitions it needs, as nodes are appended to it.
+// Score() is a lower bound for the number of transitions of any ordering that starts with the nodes appended so far.
+// FinalScore() is the exact number of transitions CalculateResourceTransitions would make, once every node has been appended.
+// Append() costs a few integer ops per resource the node accesses, and can be undone in reverse order with Undo().
+class TransitionScorer
+{
+public:
+    TransitionScorer(const ResourceAccessTable& table)
+        : m_table(&table)
+    {
+        m_resourceStates.resize(table.ResourceCount());
+    }
+
+    int Score() const
+    {
+        return m_score;
+    }
+
+    // How much Score() would go up if this node were appended
+    int AppendCost(int nodeIndex) const
+    {
+        int ret = 0;
+        for (const ResourceAccess* access = m_table->AccessesBegin(nodeIndex); access != m_table->AccessesEnd(nodeIndex); ++access)
+        {
+            const ResourceState& state = m_resourceStates[access->resourceSlot];
+            if (state.firstState != ShaderResourceAccessType::Count && StateChangeNeedsTransition(state.lastState, access->access))
+                ret += TransitionScore(access->resourceSlot, state.transitionCount + 1) - TransitionScore(access->resourceSlot, state.transitionCount);
+        }
+        return ret;
+    }
+
+    void Append(int nodeIndex)
+    {
+        m_undoBegin.push_back((int)m_undo.size());
+        for (const ResourceAccess* access = m_table->AccessesBegin(nodeIndex); access != m_table->AccessesEnd(nodeIndex); ++access)
+        {
+            ResourceState& state = m_resourceStates[access->resourceSlot];
+            m_undo.push_back({ access->resourceSlot, state, m_score });
+
+            if (state.firstState == ShaderResourceAccessType::Count)
+            {
+                state.firstState = access->access;
+            }
+            else if (StateChangeNeedsTransition(state.lastState, access->access))
+            {
+                m_score += TransitionScore(access->resourceSlot, state.transitionCount + 1) - TransitionScore(access->resourceSlot, state.transitionCount);
+                state.transitionCount++;
+            }
+            state.lastState = access->access;
+        }
+    }
+
+    void Undo()
+    {
+        int undoBegin = m_undoBegin.back();
+        m_undoBegin.pop_back();
+        while ((int)m_undo.size() > undoBegin)
+        {
+            const UndoRecord& record = m_undo.back();
+            m_resourceStates[record.resourceSlot] = record.state;
+            m_score = record.score;
+            m_undo.pop_back();
+        }
+    }
+
+    // Forgets the undo history. Useful when the scorer is copied rather than undone.
+    void ClearUndo()
+    {
+        m_undo.clear();
+        m_undoBegin.clear();
+    }
+
+    // Resources start the frame in the state they ended the last frame in,
+    // so this adds the transition from each resource's last state back to its first state.
+    int FinalScore() const
+    {
+        int ret = 0;
+        for (int resourceSlot = 0; resourceSlot < (int)m_resourceStates.size(); ++resourceSlot)
+        {
+            const ResourceState& state = m_resourceStates[resourceSlot];
+            if (state.firstState == ShaderResourceAccessType::Count)
+                continue;
+
+            int transitionCount = state.transitionCount;
+            if (StateChangeNeedsTransition(state.lastState, state.firstState))
+                transitionCount++;
+
+            ret += TransitionScore(resourceSlot, transitionCount);
+        }
+        return ret;
+    }
+
+    // Appends the first and last state of each resource to key. Orderings of the same set of nodes
+    // with the same key will score the same from here on out.
+    // Whether an imported resource has used its free first transition doesn't need to be in the key. It has used it unless every
+    // access so far was in the same non-UAV state, and the set of nodes, which is in the key, decides that.
+    void AppendStateKey(std::string& key) const
+    {
+        for (const ResourceState& state : m_resourceStates)
+        {
+            key.push_back((char)state.firstState);
+            key.push_back((char)state.lastState);
+        }
+    }
+
+private:
+    struct ResourceState
+    {
+        ShaderResourceAccessType firstState = ShaderResourceAccessType::Count;
+        ShaderResourceAccessType lastState = ShaderResourceAccessType::Count;
+        int transitionCount = 0;
+    };
+
+    struct UndoRecord
+    {
+        int resourceSlot;
+        ResourceState state;
+        int score;
+    };
+
+    int TransitionScore(int resourceSlot, int transitionCount) const
+    {
+        // imported resources skip their first transition, because they are explicitly put into the right state after importing
+        if (m_table->resourceImported[resourceSlot])
+            return std::max(transitionCount - 1, 0);
+        return transitionCount;
+    }
+
+    const ResourceAccessTable* m_table = nullptr;
+    std::vector<ResourceState> m_resourceStates;
+    std::vector<UndoRecord> m_undo;
+    std::vector<int> m_undoBegin;
+    int m_score = 0;
+};
+
 static float CalculateRenderGraphScore(const RenderGraph& renderGraph)
 {
+    // The begin half of a split barrier is not counted, so that a split barrier counts as one transition
     size_t ret = 0;
     for (const auto& it : renderGraph.transitions)
-        ret += it.transitions.size();
+    {
+        for (const ResourceTransition& transition : it.transitions)
+        {
+            if (transition.split != ResourceTransitionSplit::Begin)
+                ret++;
+        }
+    }
     return (float)ret;
 }
 
-static void CalculateResourceTransitions(RenderGraph& renderGraph)
+static void CalculateResourceTransitions(RenderGraph& renderGraph, const ResourceAccessTable& table)
 {
-    // Initialize the states of every node (we only care about resource nodes but this is easier to program)
-    // Leave an extra slot at the beginning for starting states.
-    std::vector<std::vector<ShaderResourceAccessType>> resourceStatesAtEachStep(renderGraph.nodes.size());
-    for (auto& states : resourceStatesAtEachStep)
-        states.resize(renderGraph.nodes.size(), ShaderResourceAccessType::Count);
-
-    // Set the state of each resource at each step of the render graph
+    // Record which resources each step depends on
     for (int stepIndex = 0; stepIndex < renderGraph.flattenedNodeList.size(); ++stepIndex)
     {
-        auto& states = resourceStatesAtEachStep[stepIndex];
         int nodeIndex = renderGraph.flattenedNodeList[stepIndex];
         RenderGraphNode& node = renderGraph.nodes[nodeIndex];
         int pinCount = GetNodePinCount(node);
@@ -50,93 +287,773 @@ static void CalculateResourceTransitions(RenderGraph& renderGraph)
                     }
                 }
 
-                states[resourceNodeIndex] = pinInfo.access;
                 AddResourceNodeAccessedAs(renderGraph.nodes[resourceNodeIndex], pinInfo.access);
                 AddResourceDependency(node, pinIndex, resourceNodeIndex, resourceType, pinInfo.access);
             }
         }
     }
 
+    // Find the first and last state of each resource
+    std::vector<ShaderResourceAccessType> firstStates(table.ResourceCount(), ShaderResourceAccessType::Count);
+    std::vector<ShaderResourceAccessType> lastStates(table.ResourceCount(), ShaderResourceAccessType::Count);
+    for (int nodeIndex : renderGraph.flattenedNodeList)
+    {
+        for (const ResourceAccess* access = table.AccessesBegin(nodeIndex); access != table.AccessesEnd(nodeIndex); ++access)
+        {
+            if (firstStates[access->resourceSlot] == ShaderResourceAccessType::Count)
+                firstStates[access->resourceSlot] = access->access;
+            lastStates[access->resourceSlot] = access->access;
+        }
+    }
+
     // set the final states on the resource nodes. Useful for creating textures in these states.
     // also set the starting states on the resource nodes. Useful for transitioning imported textures to this state before first use
-    for (size_t nodeIndex = 0; nodeIndex < renderGraph.nodes.size(); ++nodeIndex)
+    for (int resourceSlot = 0; resourceSlot < table.ResourceCount(); ++resourceSlot)
     {
-        if (!GetNodeIsResourceNode(renderGraph.nodes[nodeIndex]))
+        if (firstStates[resourceSlot] == ShaderResourceAccessType::Count)
             continue;
 
-        for (const auto& states : resourceStatesAtEachStep)
+        RenderGraphNode& resourceNode = renderGraph.nodes[table.resourceNodeIndices[resourceSlot]];
+        SetResourceNodeStartingState(resourceNode, firstStates[resourceSlot]);
+        SetResourceNodeFinalState(resourceNode, lastStates[resourceSlot]);
+    }
+
+    // make the transitions, with the states starting at whatever their ending state is (aka previous frame ending state)
+    std::vector<ShaderResourceAccessType> lastSetStates = lastStates;
+    std::vector<bool> firstTransition(table.ResourceCount(), true);
+    renderGraph.transitions.resize(renderGraph.nodes.size());
+    for (int stepIndex = 0; stepIndex < renderGraph.flattenedNodeList.size(); ++stepIndex)
+    {
+        int nodeIndex = renderGraph.flattenedNodeList[stepIndex];
+
+        // make transitions for any resources that want them. Resources that this step doesn't reference are not in the table.
+        for (const ResourceAccess* access = table.AccessesBegin(nodeIndex); access != table.AccessesEnd(nodeIndex); ++access)
         {
-            if (states[nodeIndex] != ShaderResourceAccessType::Count)
+            int resourceSlot = access->resourceSlot;
+            ShaderResourceAccessType lastState = lastSetStates[resourceSlot];
+            ShaderResourceAccessType nextState = access->access;
+
+            if (StateChangeNeedsTransition(lastState, nextState))
             {
-                SetResourceNodeStartingState(renderGraph.nodes[nodeIndex], states[nodeIndex]);
-                break;
+                // imported resources should skip their first transition, because we explicitly set them to the right state after importing
+                if (!table.resourceImported[resourceSlot] || !firstTransition[resourceSlot])
+                {
+                    ResourceTransition newTransition;
+                    newTransition.nodeIndex = table.resourceNodeIndices[resourceSlot];
+                    newTransition.oldState = lastState;
+                    newTransition.newState = nextState;
+                    renderGraph.transitions[stepIndex].transitions.push_back(newTransition);
+                }
+                else
+                {
+                    firstTransition[resourceSlot] = false;
+                }
+
+                lastSetStates[resourceSlot] = nextState;
             }
         }
+    }
+}
 
-        for (const auto& states : resourceStatesAtEachStep)
+// Turns transitions into split barriers where there is room to. A transition made before step S begins right after P,
+// the previous step in the frame that used the resource, and ends before S, so the GPU can do the work in between.
+// UAV barriers can't be split, and neither can transitions from the previous frame's state.
+// Each step's transitions are then sorted by resource node index, so that each batch is deterministic.
+static void CalculateSplitBarriers(RenderGraph& renderGraph, const ResourceAccessTable& table)
+{
+    std::vector<int> lastAccessSteps(table.ResourceCount(), -1);
+    std::vector<std::vector<ResourceTransition>> beginTransitions(renderGraph.transitions.size());
+    for (int stepIndex = 0; stepIndex < (int)renderGraph.flattenedNodeList.size(); ++stepIndex)
+    {
+        for (ResourceTransition& transition : renderGraph.transitions[stepIndex].transitions)
         {
-            if (states[nodeIndex] != ShaderResourceAccessType::Count)
-                SetResourceNodeFinalState(renderGraph.nodes[nodeIndex], states[nodeIndex]);
+            if (transition.oldState == transition.newState)
+                continue;
+
+            int previousStepIndex = lastAccessSteps[table.resourceSlots[transition.nodeIndex]];
+            if (previousStepIndex == -1 || previousStepIndex + 1 >= stepIndex)
+                continue;
+
+            transition.split = ResourceTransitionSplit::End;
+
+            ResourceTransition beginTransition = transition;
+            beginTransition.split = ResourceTransitionSplit::Begin;
+            beginTransitions[previousStepIndex + 1].push_back(beginTransition);
         }
+
+        int nodeIndex = renderGraph.flattenedNodeList[stepIndex];
+        for (const ResourceAccess* access = table.AccessesBegin(nodeIndex); access != table.AccessesEnd(nodeIndex); ++access)
+            lastAccessSteps[access->resourceSlot] = stepIndex;
     }
 
-    // make the transitions, with the states starting at whatever their ending state is (aka previous frame ending state)
-    std::vector<ShaderResourceAccessType> lastSetStates(renderGraph.nodes.size());
-    for (int stepIndex = 0; stepIndex < renderGraph.flattenedNodeList.size(); ++stepIndex)
+    for (int stepIndex = 0; stepIndex < (int)renderGraph.transitions.size(); ++stepIndex)
     {
-        int nodeIndex = renderGraph.flattenedNodeList[stepIndex];
-        if (!GetNodeIsResourceNode(renderGraph.nodes[nodeIndex]))
+        std::vector<ResourceTransition>& transitions = renderGraph.transitions[stepIndex].transitions;
+        transitions.insert(transitions.end(), beginTransitions[stepIndex].begin(), beginTransitions[stepIndex].end());
+        std::stable_sort(transitions.begin(), transitions.end(),
+            [](const ResourceTransition& a, const ResourceTransition& b)
+            {
+                return a.nodeIndex < b.nodeIndex;
+            }
+        );
+    }
+}
+
+// D3D12 places resources on 64KB boundaries, unless they are multisampled, which Gigi resources never are.
+static const size_t c_heapPlacementAlignment = 65536;
+
+static size_t AlignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// The bytes in one block of the format, and the width and height of a block in pixels. Returns false if the format has no fixed size.
+static bool TextureFormatBlockInfo(TextureFormat format, size_t& blockBytes, size_t& blockDimension)
+{
+    blockDimension = 1;
+    switch (format)
+    {
+        case TextureFormat::R8_Unorm:
+        case TextureFormat::R8_Snorm:
+        case TextureFormat::R8_Uint:
+        case TextureFormat::R8_Sint: blockBytes = 1; return true;
+        case TextureFormat::RG8_Unorm:
+        case TextureFormat::RG8_Snorm:
+        case TextureFormat::RG8_Uint:
+        case TextureFormat::RG8_Sint:
+        case TextureFormat::R16_Float:
+        case TextureFormat::D16_Unorm: blockBytes = 2; return true;
+        case TextureFormat::RGBA8_Unorm:
+        case TextureFormat::RGBA8_Unorm_sRGB:
+        case TextureFormat::RGBA8_Snorm:
+        case TextureFormat::RGBA8_Uint:
+        case TextureFormat::RGBA8_Sint:
+        case TextureFormat::RG16_Float:
+        case TextureFormat::R32_Float:
+        case TextureFormat::R32_Uint:
+        case TextureFormat::R11G11B10_Float:
+        case TextureFormat::D32_Float:
+        case TextureFormat::D24_Unorm_S8: blockBytes = 4; return true;
+        case TextureFormat::RGBA16_Float:
+        case TextureFormat::RGBA16_Unorm:
+        case TextureFormat::RGBA16_Snorm:
+        case TextureFormat::RG32_Float:
+        case TextureFormat::D32_Float_S8: blockBytes = 8; return true;
+        case TextureFormat::RGBA32_Float:
+        case TextureFormat::RGBA32_Uint: blockBytes = 16; return true;
+        case TextureFormat::BC7_Unorm:
+        case TextureFormat::BC7_Unorm_sRGB: blockBytes = 16; blockDimension = 4; return true;
+        default: blockBytes = 0; return false;
+    }
+}
+
+// The size of a resource in a heap, rounded up to its alignment, or 0 if it depends on a variable or another resource and so isn't known at compile time.
+// Textures are sized as a linear layout, with rows padded to 256 bytes and subresources to 512 bytes like D3D12 copy footprints.
+// Drivers may tile textures into more memory than that, so back ends placing resources must still check this against what the API reports.
+static size_t ResourceHeapSize(const RenderGraph& renderGraph, const RenderGraphNode& node)
+{
+    switch (node._index)
+    {
+        case RenderGraphNode::c_index_resourceTexture:
+        {
+            const RenderGraphNode_Resource_Texture& texture = node.resourceTexture;
+            if (!texture.size.node.name.empty() || !texture.size.variable.name.empty())
+                return 0;
+            if (!texture.format.node.name.empty() || !texture.format.variable.name.empty())
+                return 0;
+
+            size_t blockBytes = 0;
+            size_t blockDimension = 1;
+            if (!TextureFormatBlockInfo(texture.format.format, blockBytes, blockDimension))
+                return 0;
+
+            int size[3];
+            for (int i = 0; i < 3; ++i)
+            {
+                size[i] = (1 + texture.size.preAdd[i]) * texture.size.multiply[i] / std::max(texture.size.divide[i], 1) + texture.size.postAdd[i];
+                if (size[i] < 1)
+                    return 0;
+            }
+
+            size_t depth = 1;
+            size_t arraySize = 1;
+            switch (texture.dimension)
+            {
+                case TextureDimensionType::Texture2DArray: arraySize = size[2]; break;
+                case TextureDimensionType::Texture3D: depth = size[2]; break;
+                case TextureDimensionType::TextureCube: arraySize = 6; break;
+            }
+
+            int largestDimension = std::max(std::max(size[0], size[1]), (int)depth);
+            int fullMipCount = 1;
+            while ((largestDimension >> fullMipCount) > 0)
+                fullMipCount++;
+            int mipCount = (texture.numMips == 0) ? fullMipCount : std::min((int)texture.numMips, fullMipCount);
+
+            size_t bytes = 0;
+            for (int mipIndex = 0; mipIndex < mipCount; ++mipIndex)
+            {
+                size_t mipWidth = std::max(size[0] >> mipIndex, 1);
+                size_t mipHeight = std::max(size[1] >> mipIndex, 1);
+                size_t mipDepth = std::max(depth >> mipIndex, (size_t)1);
+                size_t rowPitch = AlignUp((mipWidth + blockDimension - 1) / blockDimension * blockBytes, 256);
+                size_t rowCount = (mipHeight + blockDimension - 1) / blockDimension;
+                bytes += AlignUp(rowPitch * rowCount * mipDepth, 512) * arraySize;
+            }
+            return AlignUp(bytes, c_heapPlacementAlignment);
+        }
+        case RenderGraphNode::c_index_resourceBuffer:
+        {
+            const RenderGraphNode_Resource_Buffer& buffer = node.resourceBuffer;
+            if (!buffer.count.node.name.empty() || !buffer.count.variable.name.empty() || !buffer.format.node.name.empty())
+                return 0;
+
+            size_t stride = 0;
+            if (buffer.format.structureType.structIndex >= 0 && buffer.format.structureType.structIndex < (int)renderGraph.structs.size())
+                stride = renderGraph.structs[buffer.format.structureType.structIndex].sizeInBytes;
+            else if (buffer.format.type != DataFieldType::Count)
+                stride = DataFieldTypeInfo(buffer.format.type).typeBytes;
+
+            int count = (1 + buffer.count.preAdd) * buffer.count.multiply / std::max(buffer.count.divide, 1) + buffer.count.postAdd;
+            if (stride == 0 || count < 1)
+                return 0;
+
+            return AlignUp(stride * count, c_heapPlacementAlignment);
+        }
+    }
+    return 0;
+}
+
+// Gives each alias group the size of its largest resource, and an offset in the heap for its heap class.
+// Every group may be in use at once, so groups don't share memory with each other. Groups with any resource of unknown size aren't placed,
+// and are left for back ends to allocate once the sizes are known.
+static void LayOutAliasGroups(ResourceAliasingPlan& plan)
+{
+    for (ResourceAliasGroup& group : plan.groups)
+    {
+        group.sizeInBytes = 0;
+        group.alignment = 0;
+        group.placed = false;
+        group.heapOffset = 0;
+    }
+
+    std::vector<bool> groupSizeKnown(plan.groups.size(), true);
+    for (const ResourceLifetime& lifetime : plan.lifetimes)
+    {
+        ResourceAliasGroup& group = plan.groups[lifetime.aliasGroup];
+        if (lifetime.sizeInBytes == 0)
+            groupSizeKnown[lifetime.aliasGroup] = false;
+        group.sizeInBytes = std::max(group.sizeInBytes, lifetime.sizeInBytes);
+        group.alignment = std::max(group.alignment, lifetime.alignment);
+    }
+
+    for (int heapClass = 0; heapClass < (int)ResourceHeapClass::Count; ++heapClass)
+        plan.heapSizes[heapClass] = 0;
+
+    for (int groupIndex = 0; groupIndex < (int)plan.groups.size(); ++groupIndex)
+    {
+        ResourceAliasGroup& group = plan.groups[groupIndex];
+        if (!groupSizeKnown[groupIndex])
+        {
+            group.sizeInBytes = 0;
             continue;
-        lastSetStates[nodeIndex] = GetResourceNodeFinalState(renderGraph.nodes[nodeIndex]);
+        }
+
+        size_t& heapSize = plan.heapSizes[(int)group.heapClass];
+        group.placed = true;
+        group.heapOffset = AlignUp(heapSize, group.alignment);
+        heapSize = group.heapOffset + group.sizeInBytes;
     }
+}
 
-    std::vector<bool> firstTransition(renderGraph.nodes.size(), true);
-    renderGraph.transitions.resize(renderGraph.nodes.size());
-    for (int stepIndex = 0; stepIndex < renderGraph.flattenedNodeList.size(); ++stepIndex)
+// A key that is the same for resources which are always the same size, so that alias groups can prefer them and waste less memory.
+static std::string ResourceSizeKey(const RenderGraphNode& node)
+{
+    std::ostringstream ret;
+    switch (node._index)
+    {
+        case RenderGraphNode::c_index_resourceTexture:
+        {
+            const RenderGraphNode_Resource_Texture& texture = node.resourceTexture;
+            ret << "texture|" << texture.format.node.name << "|" << (int)texture.format.format << "|" << texture.format.variable.name;
+            ret << "|" << texture.size.node.name << "|" << texture.size.variable.name;
+            for (int i = 0; i < 3; ++i)
+                ret << "|" << texture.size.multiply[i] << "," << texture.size.divide[i] << "," << texture.size.preAdd[i] << "," << texture.size.postAdd[i];
+            ret << "|" << texture.numMips << "|" << (int)texture.dimension;
+            break;
+        }
+        case RenderGraphNode::c_index_resourceBuffer:
+        {
+            const RenderGraphNode_Resource_Buffer& buffer = node.resourceBuffer;
+            ret << "buffer|" << buffer.format.node.name << "|" << buffer.format.structureType.name << "|" << (int)buffer.format.type;
+            ret << "|" << buffer.count.node.name << "|" << buffer.count.variable.name;
+            ret << "|" << buffer.count.multiply << "," << buffer.count.divide << "," << buffer.count.preAdd << "," << buffer.count.postAdd;
+            break;
+        }
+    }
+    return ret.str();
+}
+
+// Finds which transient resources can share memory, because they are never in use at the same time.
+// Only internal, transient textures and buffers which are written before they are read each frame are considered.
+// This is interval graph coloring: visiting resources in order of first use, each one goes into an alias group
+// whose resources are all done being used. Taking any such group gives the fewest groups possible,
+// and groups holding resources of the same size are preferred so that less memory is wasted.
+static void CalculateResourceAliasing(RenderGraph& renderGraph, const ResourceAccessTable& table)
+{
+    ResourceAliasingPlan& plan = renderGraph.aliasingPlan;
+    plan = ResourceAliasingPlan();
+
+    // Find when each resource is first and last used
+    std::vector<int> firstSteps(table.ResourceCount(), -1);
+    std::vector<int> lastSteps(table.ResourceCount(), -1);
+    std::vector<ShaderResourceAccessType> firstStates(table.ResourceCount(), ShaderResourceAccessType::Count);
+    for (int stepIndex = 0; stepIndex < (int)renderGraph.flattenedNodeList.size(); ++stepIndex)
     {
         int nodeIndex = renderGraph.flattenedNodeList[stepIndex];
+        for (const ResourceAccess* access = table.AccessesBegin(nodeIndex); access != table.AccessesEnd(nodeIndex); ++access)
+        {
+            if (firstSteps[access->resourceSlot] == -1)
+            {
+                firstSteps[access->resourceSlot] = stepIndex;
+                firstStates[access->resourceSlot] = access->access;
+            }
+            lastSteps[access->resourceSlot] = stepIndex;
+        }
+    }
 
-        // skip nodes that are resources
-        if (GetNodeIsResourceNode(renderGraph.nodes[nodeIndex]))
+    // Gather the resources which may be aliased
+    std::vector<std::string> sizeKeys;
+    for (int resourceSlot = 0; resourceSlot < table.ResourceCount(); ++resourceSlot)
+    {
+        int nodeIndex = table.resourceNodeIndices[resourceSlot];
+        const RenderGraphNode& node = renderGraph.nodes[nodeIndex];
+
+        ResourceLifetime lifetime;
+        switch (node._index)
+        {
+            case RenderGraphNode::c_index_resourceBuffer:
+            {
+                const RenderGraphNode_Resource_Buffer& buffer = node.resourceBuffer;
+                if (!buffer.transient || buffer.visibility != ResourceVisibility::Internal)
+                    continue;
+                lifetime.heapClass = ResourceHeapClass::Buffer;
+                break;
+            }
+            case RenderGraphNode::c_index_resourceTexture:
+            {
+                const RenderGraphNode_Resource_Texture& texture = node.resourceTexture;
+                if (!texture.transient || texture.visibility != ResourceVisibility::Internal || !texture.loadFileName.empty())
+                    continue;
+
+                unsigned int renderTargetFlags = (1 << (unsigned int)ShaderResourceAccessType::RenderTarget) | (1 << (unsigned int)ShaderResourceAccessType::DepthTarget);
+                lifetime.heapClass = (texture.accessedAs & renderTargetFlags) ? ResourceHeapClass::RenderTarget : ResourceHeapClass::Texture;
+                break;
+            }
+            default: continue;
+        }
+
+        // Resources that aren't used, or that are read before being written, need their contents kept around
+        if (firstSteps[resourceSlot] == -1 || ShaderResourceTypeIsReadOnly(firstStates[resourceSlot]))
             continue;
 
-        // get our states required at this step
-        const auto& states = resourceStatesAtEachStep[stepIndex];
+        lifetime.nodeIndex = nodeIndex;
+        lifetime.firstStep = firstSteps[resourceSlot];
+        lifetime.lastStep = lastSteps[resourceSlot];
+        lifetime.sizeInBytes = ResourceHeapSize(renderGraph, node);
+        lifetime.alignment = c_heapPlacementAlignment;
+        plan.lifetimes.push_back(lifetime);
+        sizeKeys.push_back(ResourceSizeKey(node));
+    }
 
-        // make transitions for any resources that want them
-        for (size_t resourceIndex = 0; resourceIndex < renderGraph.nodes.size(); ++resourceIndex)
+    // Assign alias groups in order of first use
+    std::vector<int> lifetimeOrder(plan.lifetimes.size());
+    std::iota(lifetimeOrder.begin(), lifetimeOrder.end(), 0);
+    std::stable_sort(lifetimeOrder.begin(), lifetimeOrder.end(),
+        [&plan](int A, int B)
         {
-            // skip nodes that arent resources
-            if (!GetNodeIsResourceNode(renderGraph.nodes[resourceIndex]))
-                continue;
+            return plan.lifetimes[A].firstStep < plan.lifetimes[B].firstStep;
+        }
+    );
 
-            ShaderResourceAccessType lastState = lastSetStates[resourceIndex];
-            ShaderResourceAccessType nextState = states[resourceIndex];
+    std::vector<int> groupLastSteps;
+    std::vector<std::string> groupSizeKeys;
+    for (int lifetimeIndex : lifetimeOrder)
+    {
+        ResourceLifetime& lifetime = plan.lifetimes[lifetimeIndex];
 
-            // skip this resource node if it isn't referenced by this step
-            if (nextState == ShaderResourceAccessType::Count)
+        int groupIndex = -1;
+        for (int candidateIndex = 0; candidateIndex < (int)plan.groups.size(); ++candidateIndex)
+        {
+            if (plan.groups[candidateIndex].heapClass != lifetime.heapClass || groupLastSteps[candidateIndex] >= lifetime.firstStep)
                 continue;
 
-            // if the state changed, or it goes from uavrw to uavrw, we need to emit a transition
-            if ((lastState != nextState) || lastState == ShaderResourceAccessType::UAV)
+            if (groupIndex == -1)
+                groupIndex = candidateIndex;
+
+            if (groupSizeKeys[candidateIndex] == sizeKeys[lifetimeIndex])
             {
-                // imported resources should skip their first transition, because we explicitly set them to the right state after importing
-                if (GetNodeResourceVisibility(renderGraph.nodes[resourceIndex]) != ResourceVisibility::Imported || !firstTransition[resourceIndex])
-                {
-                    ResourceTransition newTransition;
-                    newTransition.nodeIndex = (int)resourceIndex;
-                    newTransition.oldState = lastState;
-                    newTransition.newState = nextState;
-                    renderGraph.transitions[stepIndex].transitions.push_back(newTransition);
-                }
-                else
-                {
-                    firstTransition[resourceIndex] = false;
-                }
+                groupIndex = candidateIndex;
+                break;
+            }
+        }
+
+        if (groupIndex == -1)
+        {
+            groupIndex = (int)plan.groups.size();
+            ResourceAliasGroup newGroup;
+            newGroup.heapClass = lifetime.heapClass;
+            plan.groups.push_back(newGroup);
+            groupLastSteps.push_back(-1);
+            groupSizeKeys.push_back("");
+        }
+
+        lifetime.aliasGroup = groupIndex;
+        plan.groups[groupIndex].nodeIndices.push_back(lifetime.nodeIndex);
+        groupLastSteps[groupIndex] = lifetime.lastStep;
+        groupSizeKeys[groupIndex] = sizeKeys[lifetimeIndex];
+    }
+
+    LayOutAliasGroups(plan);
+}
+
+// Everything the schedulers need to know about the DAG, gathered once up front.
+struct ScheduleContext
+{
+    const ResourceAccessTable* table = nullptr;
+    std::vector<std::vector<int>> dependents;
+    std::vector<int> dependencyCounts;
+
+    // Budget for Beam and Exhaustive
+    std::chrono::high_resolution_clock::time_point startTime;
+    int budgetMS = 0;
+    int budgetIterations = 0;
+    int iterations = 0;
+    bool budgetExhausted = false;
+
+    // Most partial orderings Exhaustive remembers the best score of. 0 means no limit.
+    int memoMaxEntries = 0;
+
+    bool OutOfBudget()
+    {
+        if (budgetExhausted)
+            return true;
+
+        iterations++;
+        if (budgetIterations > 0 && iterations > budgetIterations)
+            budgetExhausted = true;
+
+        // Checking the clock is not free, so only do it every so often
+        if (budgetMS > 0 && (iterations % 256) == 0)
+        {
+            float elapsedMS = (float)std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(std::chrono::high_resolution_clock::now() - startTime).count();
+            if (elapsedMS > (float)budgetMS)
+                budgetExhausted = true;
+        }
+
+        return budgetExhausted;
+    }
+};
+
+// A partial ordering of the nodes, and the scorer for it
+struct ScheduleState
+{
+    ScheduleState(const ScheduleContext& context)
+        : dependencyCounts(context.dependencyCounts)
+        , scorer(*context.table)
+    {
+        order.reserve(dependencyCounts.size());
+    }
+
+    std::vector<int> order;
+    std::vector<int> dependencyCounts; // -1 means already scheduled
+    TransitionScorer scorer;
+};
+
+static void ScheduleAppend(const ScheduleContext& context, ScheduleState& state, int nodeIndex)
+{
+    state.scorer.Append(nodeIndex);
+    state.order.push_back(nodeIndex);
+    state.dependencyCounts[nodeIndex] = -1;
+    for (int dependentIndex : context.dependents[nodeIndex])
+        state.dependencyCounts[dependentIndex]--;
+}
+
+static void ScheduleUndo(const ScheduleContext& context, ScheduleState& state)
+{
+    int nodeIndex = state.order.back();
+    state.scorer.Undo();
+    state.order.pop_back();
+    state.dependencyCounts[nodeIndex] = 0;
+    for (int dependentIndex : context.dependents[nodeIndex])
+        state.dependencyCounts[dependentIndex]++;
+}
+
+static void GetReadyNodes(const ScheduleState& state, std::vector<int>& readyNodes)
+{
+    readyNodes.clear();
+    for (int nodeIndex = 0; nodeIndex < (int)state.dependencyCounts.size(); ++nodeIndex)
+    {
+        if (state.dependencyCounts[nodeIndex] == 0)
+            readyNodes.push_back(nodeIndex);
+    }
+}
+
+// Two partial orderings with the same key have the same nodes left to schedule and the same resource states,
+// so they will score the same from here on out. Only the one with the lower score needs to be kept.
+static std::string ScheduleStateKey(const ScheduleState& state)
+{
+    std::string ret;
+    ret.reserve(state.dependencyCounts.size());
+    for (int dependencyCount : state.dependencyCounts)
+        ret.push_back(dependencyCount == -1 ? 1 : 0);
+    state.scorer.AppendStateKey(ret);
+    return ret;
+}
+
+// Takes the first ready node in node order. This is the ordering Gigi has always used.
+static bool ScheduleDefault(const ScheduleContext& context, ScheduleState& state)
+{
+    std::vector<int> readyNodes;
+    while (state.order.size() < state.dependencyCounts.size())
+    {
+        GetReadyNodes(state, readyNodes);
+        if (readyNodes.empty())
+            return false;
+        ScheduleAppend(context, state, readyNodes[0]);
+    }
+    return true;
+}
+
+// List scheduling: takes the ready node that adds the fewest transitions, breaking ties by node order.
+static bool ScheduleGreedy(const ScheduleContext& context, ScheduleState& state)
+{
+    std::vector<int> readyNodes;
+    while (state.order.size() < state.dependencyCounts.size())
+    {
+        GetReadyNodes(state, readyNodes);
+        if (readyNodes.empty())
+            return false;
+
+        int bestNodeIndex = readyNodes[0];
+        int bestCost = INT_MAX;
+        for (int nodeIndex : readyNodes)
+        {
+            int cost = state.scorer.AppendCost(nodeIndex);
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestNodeIndex = nodeIndex;
+            }
+        }
+        ScheduleAppend(context, state, bestNodeIndex);
+    }
+    return true;
+}
+
+static bool ScheduleBeam(ScheduleContext& context, ScheduleState& state, int beamWidth)
+{
+    struct Candidate
+    {
+        int parentIndex;
+        int nodeIndex;
+        int score;
+    };
+
+    beamWidth = std::max(beamWidth, 1);
 
-                lastSetStates[resourceIndex] = nextState;
+    std::vector<ScheduleState> beam;
+    beam.push_back(state);
+    beam[0].scorer.ClearUndo();
+
+    std::vector<int> readyNodes;
+    std::vector<Candidate> candidates;
+    std::unordered_set<std::string> seen;
+    size_t nodeCount = state.dependencyCounts.size();
+    for (size_t stepIndex = state.order.size(); stepIndex < nodeCount; ++stepIndex)
+    {
+        // When out of budget, finish the best partial ordering greedily
+        if (context.budgetExhausted)
+            break;
+
+        // Gather every way of extending every ordering in the beam
+        candidates.clear();
+        for (int parentIndex = 0; parentIndex < (int)beam.size(); ++parentIndex)
+        {
+            const ScheduleState& parent = beam[parentIndex];
+            GetReadyNodes(parent, readyNodes);
+            for (int nodeIndex : readyNodes)
+                candidates.push_back({ parentIndex, nodeIndex, parent.scorer.Score() + parent.scorer.AppendCost(nodeIndex) });
+        }
+
+        if (candidates.empty())
+            return false;
+
+        // Keep the best ones. stable_sort keeps this deterministic.
+        std::stable_sort(candidates.begin(), candidates.end(),
+            [](const Candidate& A, const Candidate& B)
+            {
+                return A.score < B.score;
             }
+        );
+
+        std::vector<ScheduleState> nextBeam;
+        seen.clear();
+        for (const Candidate& candidate : candidates)
+        {
+            if ((int)nextBeam.size() >= beamWidth || context.OutOfBudget())
+                break;
+
+            // Candidates are in score order, so the first one with a key is the best of those with it.
+            ScheduleState next = beam[candidate.parentIndex];
+            ScheduleAppend(context, next, candidate.nodeIndex);
+            next.scorer.ClearUndo();
+            if (!seen.insert(ScheduleStateKey(next)).second)
+                continue;
+            nextBeam.push_back(std::move(next));
+        }
+
+        // The budget may run out before anything makes it into the next beam
+        if (nextBeam.empty())
+            break;
+
+        beam = std::move(nextBeam);
+    }
+
+    // Choose the best ordering in the beam, finishing any partial ones greedily
+    int bestScore = INT_MAX;
+    for (ScheduleState& candidate : beam)
+    {
+        if (!ScheduleGreedy(context, candidate))
+            return false;
+
+        int score = candidate.scorer.FinalScore();
+        if (score < bestScore)
+        {
+            bestScore = score;
+            state = candidate;
+        }
+    }
+    return true;
+}
+
+// Branch and bound over every valid ordering.
+// Partial orderings are pruned when their lower bound can't beat the best complete ordering found so far,
+// or when an ordering of the same nodes with the same resource states has already been seen with a better score.
+// A single state is appended to and undone as the search goes, so nothing is copied per candidate.
+static void ScheduleExhaustiveRecursive(ScheduleContext& context, ScheduleState& state, std::vector<int>& bestOrder, int& bestScore, std::unordered_map<std::string, int>& memo)
+{
+    if (state.order.size() == state.dependencyCounts.size())
+    {
+        int score = state.scorer.FinalScore();
+        if (score < bestScore)
+        {
+            bestScore = score;
+            bestOrder = state.order;
+        }
+        return;
+    }
+
+    if (state.scorer.Score() >= bestScore || context.OutOfBudget())
+        return;
+
+    // Once the memo is full, states already in it are still updated, but new ones aren't added.
+    // That only costs pruning, so the best ordering is still found.
+    std::string key = ScheduleStateKey(state);
+    auto it = memo.find(key);
+    if (it != memo.end())
+    {
+        if (it->second <= state.scorer.Score())
+            return;
+        it->second = state.scorer.Score();
+    }
+    else if (context.memoMaxEntries <= 0 || (int)memo.size() < context.memoMaxEntries)
+    {
+        memo[key] = state.scorer.Score();
+    }
+
+    // Try the cheapest choices first, so that good complete orderings are found early and prune more
+    std::vector<int> readyNodes;
+    GetReadyNodes(state, readyNodes);
+    std::vector<std::pair<int, int>> choices;
+    for (int nodeIndex : readyNodes)
+        choices.push_back({ state.scorer.AppendCost(nodeIndex), nodeIndex });
+    std::stable_sort(choices.begin(), choices.end(),
+        [](const std::pair<int, int>& A, const std::pair<int, int>& B)
+        {
+            return A.first < B.first;
+        }
+    );
+
+    for (const std::pair<int, int>& choice : choices)
+    {
+        ScheduleAppend(context, state, choice.second);
+        ScheduleExhaustiveRecursive(context, state, bestOrder, bestScore, memo);
+        ScheduleUndo(context, state);
+    }
+}
+
+static bool ScheduleExhaustive(ScheduleContext& context, ScheduleState& state)
+{
+    // Start with the greedy ordering, so there is a good ordering to prune against, and to fall back to if the budget runs out
+    ScheduleState greedyState = state;
+    if (!ScheduleGreedy(context, greedyState))
+        return false;
+    std::vector<int> bestOrder = greedyState.order;
+    int bestScore = greedyState.scorer.FinalScore();
+
+    std::unordered_map<std::string, int> memo;
+    ScheduleExhaustiveRecursive(context, state, bestOrder, bestScore, memo);
+
+    // Replay the best ordering into the state
+    while (!state.order.empty())
+        ScheduleUndo(context, state);
+    for (int nodeIndex : bestOrder)
+        ScheduleAppend(context, state, nodeIndex);
+    return true;
+}
+
+// Pin wiring makes a chain of accesses back to each resource node. Wiring every access to the one before it
+// makes false ordering constraints between nodes that only read a resource, so this follows the chain back
+// and only keeps the edges that are real hazards:
+//   Read after write: a read depends on the nearest write before it (or the resource node if there is none).
+//   Write after read: a write depends on every read back to the nearest write before it.
+//   Write after write: a write depends on the nearest write before it.
+// Barrier pins count as writes, so nothing is reordered across a barrier.
+// This removes false ordering constraints in the DAG, allowing for more DAG parallelism
+// which means there are more possible ways to reorder the nodes, to find orderings that
+// score better in the optimization function and so are thus more optimized.
+static void AddHazardDependencies(const RenderGraph& renderGraph, int nodeIndex, int pinIndex, std::vector<int>& dependentOn)
+{
+    InputNodeInfo connectionInfo = GetNodePinInputNodeInfo(renderGraph.nodes[nodeIndex], pinIndex);
+    bool isWrite = !ShaderResourceTypeIsReadOnly(connectionInfo.access);
+
+    int parentNodeIndex = connectionInfo.nodeIndex;
+    int parentPinIndex = connectionInfo.pinIndex;
+    while (parentNodeIndex != -1)
+    {
+        // If we found a resource node, we are done.
+        if (GetNodeIsResourceNode(renderGraph.nodes[parentNodeIndex]))
+        {
+            dependentOn.push_back(parentNodeIndex);
+            return;
         }
+
+        Assert(parentPinIndex != -1, "Pin index missing on node %s", GetNodeName(renderGraph.nodes[parentNodeIndex]).c_str());
+        InputNodeInfo parentInfo = GetNodePinInputNodeInfo(renderGraph.nodes[parentNodeIndex], parentPinIndex);
+        bool parentIsWrite = !ShaderResourceTypeIsReadOnly(parentInfo.access);
+
+        // A node may access the same resource through more than one of its pins. It can't depend on itself.
+        if (parentNodeIndex != nodeIndex && (isWrite || parentIsWrite))
+            dependentOn.push_back(parentNodeIndex);
+
+        // Everything before the nearest write is ordered by that write
+        if (parentIsWrite)
+            return;
+
+        // iterate to next connection
+        parentNodeIndex = parentInfo.nodeIndex;
+        parentPinIndex = parentInfo.pinIndex;
     }
 }
 
@@ -150,7 +1067,6 @@ void OptimizeAndFlattenRenderGraph(RenderGraph& renderGraph)
 
     struct DAG
     {
-        std::vector<int> flattenedList;
         std::vector<DAGNode> dag;
     };
 
@@ -179,124 +1095,110 @@ void OptimizeAndFlattenRenderGraph(RenderGraph& renderGraph)
                 continue;
             }
 
-            rgdag.dag[index].dependentOn.push_back(connectionInfo.nodeIndex);
-
-            // TODO: need to sort out false dependency ordering problem from read only access
-            // TOOD: when fixed, make sure barrier nodes are honored
-#if 0
-
-            // if this is not a read only access type, take it as is to keep the ordering constraint
-            // TODO: need to think about this. I think that we SHOULD allow this, but if multiple things want read access to the same thing before a write, it needs to copy it and make a temporary resource.
-            // TODO: we may actually need to disable this optimization until it's reworked, i don't think this fix is enough
-            if (!ShaderResourceTypeIsReadOnly(connectionInfo.access))
+            // With pin wiring dependencies, a node depends on whatever is plugged into its pins
+            if (!renderGraph.buildSettings.hazardDependencies)
             {
                 rgdag.dag[index].dependentOn.push_back(connectionInfo.nodeIndex);
                 continue;
             }
 
-            // If what we are conncected to has read access to what is plugged into it, follow the path back
-            // to the source resource until you hit a write, or the resource node itself.
-            // This removes false ordering constraints in the DAG, allowing for more DAG parallelism
-            // which means there are more possible ways to reorder the nodes, to find orderings that
-            // score better in the optimization function and so are thus more optimized.
-            int parentNodeIndex = connectionInfo.nodeIndex;
-            int parentPinIndex = connectionInfo.pinIndex;
-            while (1)
-            {
-                // If we found a resource node, we are done.
-                if (GetNodeIsResourceNode(renderGraph.nodes[parentNodeIndex]))
-                {
-                    rgdag.dag[index].dependentOn.push_back(parentNodeIndex);
-                    break;
-                }
+            AddHazardDependencies(renderGraph, index, pinIndex, rgdag.dag[index].dependentOn);
+        }
+    }
 
-                // if we found a non read only connection, the parent of this connection is the one to be dependent on.
-                Assert(parentPinIndex != -1, "Error");
-                InputNodeInfo inputNodeInfo = GetNodePinInputNodeInfo(renderGraph.nodes[parentNodeIndex], parentPinIndex);
-                Assert(inputNodeInfo.nodeIndex != -1, "Error");
-                if (!ShaderResourceTypeIsReadOnly(inputNodeInfo.access))
-                {
-                    rgdag.dag[index].dependentOn.push_back(parentNodeIndex);
-                    break;
-                }
+    // Gather what the schedulers need
+    ResourceAccessTable table = BuildResourceAccessTable(renderGraph);
+    ScheduleContext context;
+    context.table = &table;
+    context.dependents.resize(renderGraph.nodes.size());
+    context.dependencyCounts.resize(renderGraph.nodes.size(), 0);
+    int actionNodeCount = 0;
+    for (int index = 0; index < (int)renderGraph.nodes.size(); ++index)
+    {
+        std::vector<int>& dependentOn = rgdag.dag[index].dependentOn;
+        std::sort(dependentOn.begin(), dependentOn.end());
+        dependentOn.erase(std::unique(dependentOn.begin(), dependentOn.end()), dependentOn.end());
+        context.dependencyCounts[index] = (int)dependentOn.size();
+        for (int dependentOnIndex : dependentOn)
+            context.dependents[dependentOnIndex].push_back(index);
 
-                // iterate to next connection
-                parentNodeIndex = inputNodeInfo.nodeIndex;
-                parentPinIndex = inputNodeInfo.pinIndex;
-            }
-#endif
-        }
+        if (!GetNodeIsResourceNode(renderGraph.nodes[index]))
+            actionNodeCount++;
     }
 
+    const BuildSettings& buildSettings = renderGraph.buildSettings;
+    context.budgetMS = buildSettings.schedulerBudgetMS;
+    context.budgetIterations = buildSettings.schedulerBudgetIterations;
+    context.memoMaxEntries = buildSettings.schedulerMemoMaxEntries;
+    context.startTime = std::chrono::high_resolution_clock::now();
+
+    FlattenScheduler scheduler = buildSettings.scheduler;
+    if (scheduler == FlattenScheduler::Auto)
+        scheduler = (actionNodeCount <= buildSettings.schedulerExhaustiveMaxNodes) ? FlattenScheduler::Exhaustive : FlattenScheduler::Beam;
+
     // Do topological sorting to flatten the DAG
-    // Process all possible orderings of the nodes in the DAG to find the best one
-    std::vector<DAG> processing;
-    processing.push_back(rgdag);
-    RenderGraph bestRenderGraph = renderGraph;
-    float bestRenderGraphScore = FLT_MAX;
-    while (!processing.empty())
+    ScheduleState schedule(context);
+    bool scheduled = false;
+    switch (scheduler)
     {
-        // get the next partially flattened DAG to process
-        DAG dag = processing.back();
-        processing.pop_back();
-
-        // make a dag on the processing stack, taking each choice we have for the next item in the flattened list
-        for (size_t index = 0; index < dag.dag.size(); ++index)
+        case FlattenScheduler::Default: scheduled = ScheduleDefault(context, schedule); break;
+        case FlattenScheduler::Greedy: scheduled = ScheduleGreedy(context, schedule); break;
+        case FlattenScheduler::Beam: scheduled = ScheduleBeam(context, schedule, buildSettings.schedulerBeamWidth); break;
+        case FlattenScheduler::Exhaustive: scheduled = ScheduleExhaustive(context, schedule); break;
+        default:
         {
-            if (!dag.dag[index].dependentOn.empty())
-                continue;
-            int chosenNodeIndex = dag.dag[index].nodeIndex;
-
-            // make the choice
-            // 1) Add it to the flattened list
-            // 2) Remove the node from the dag
-            // 3) Clear any dependencies on this node index
-            DAG newDag = dag;
-            newDag.flattenedList.push_back(chosenNodeIndex);
-            newDag.dag.erase(newDag.dag.begin() + index);
-            for (DAGNode& dagNode : newDag.dag)
-                dagNode.dependentOn.erase(std::remove(dagNode.dependentOn.begin(), dagNode.dependentOn.end(), chosenNodeIndex), dagNode.dependentOn.end());
-
-            // if there is more processing to do, add it to the queue
-            if (!newDag.dag.empty())
-            {
-                processing.push_back(newDag);
-            }
-            // else we are done so consider keeping it
-            else
-            {
-                // reverse the order of the flattened lists since we built it backwards
-                std::reverse(newDag.dag.begin(), newDag.dag.end());
-
-                // score this proposed flattened render graph
-                RenderGraph candidate = renderGraph;
-                candidate.flattenedNodeList = newDag.flattenedList;
-
-                // Remove all barrier nodes from the list now that the render graph is flattened.
-                // We don't want it adding extra resource transitions, and it is a no-op at runtime.
-                candidate.flattenedNodeList.erase(
-                    std::remove_if(candidate.flattenedNodeList.begin(), candidate.flattenedNodeList.end(),
-                        [&candidate] (int nodeIndex)
-                        {
-                            return candidate.nodes[nodeIndex]._index == RenderGraphNode::c_index_actionBarrier;
-                        }
-                    ),
-                    candidate.flattenedNodeList.end()
-                );
-
-                // calculate the render graph score and keep it if it's the best we've seen so far
-                CalculateResourceTransitions(candidate);
-                float candidateScore = CalculateRenderGraphScore(candidate);
-                if (candidateScore < bestRenderGraphScore)
-                {
-                    bestRenderGraphScore = candidateScore;
-                    bestRenderGraph = candidate;
-                }
-            }
+            Assert(false, "Unhandled FlattenScheduler: %s", EnumToString(scheduler));
             break;
         }
     }
 
-    // Keep the best render graph we found
-    renderGraph = bestRenderGraph;
+    if (!scheduled)
+    {
+        Assert(false, "Could not flatten the render graph. There is a cycle in the node dependencies.");
+        return;
+    }
+
+    renderGraph.flattenedNodeList = schedule.order;
+
+    // Calculate the parallelism level of each node: one more than the deepest action node it depends on.
+    // Nodes at the same level don't depend on each other, so backends can batch them.
+    std::vector<int> nodeLevels(renderGraph.nodes.size(), 0);
+    for (int nodeIndex : schedule.order)
+    {
+        for (int dependentOnIndex : rgdag.dag[nodeIndex].dependentOn)
+        {
+            if (!GetNodeIsResourceNode(renderGraph.nodes[dependentOnIndex]))
+                nodeLevels[nodeIndex] = std::max(nodeLevels[nodeIndex], nodeLevels[dependentOnIndex] + 1);
+        }
+    }
+
+    // Remove all barrier nodes from the list now that the render graph is flattened.
+    // We don't want it adding extra resource transitions, and it is a no-op at runtime.
+    renderGraph.flattenedNodeList.erase(
+        std::remove_if(renderGraph.flattenedNodeList.begin(), renderGraph.flattenedNodeList.end(),
+            [&renderGraph] (int nodeIndex)
+            {
+                return renderGraph.nodes[nodeIndex]._index == RenderGraphNode::c_index_actionBarrier;
+            }
+        ),
+        renderGraph.flattenedNodeList.end()
+    );
+
+    renderGraph.flattenedNodeLevels.clear();
+    for (int nodeIndex : renderGraph.flattenedNodeList)
+        renderGraph.flattenedNodeLevels.push_back(nodeLevels[nodeIndex]);
+
+    CalculateResourceTransitions(renderGraph, table);
+    if (buildSettings.splitBarriers)
+        CalculateSplitBarriers(renderGraph, table);
+    CalculateResourceAliasing(renderGraph, table);
+
+    // The scorer and CalculateResourceTransitions should always agree
+    Assert((int)CalculateRenderGraphScore(renderGraph) == schedule.scorer.FinalScore(), "Transition scorer disagrees with CalculateResourceTransitions: %i vs %i", (int)CalculateRenderGraphScore(renderGraph), schedule.scorer.FinalScore());
+
+    if (scheduler != FlattenScheduler::Default)
+    {
+        float elapsedMS = (float)std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(std::chrono::high_resolution_clock::now() - context.startTime).count();
+        ShowInfoMessage("Scheduler %s: %i transitions, %i iterations, %0.2f ms%s", EnumToString(scheduler), schedule.scorer.FinalScore(), context.iterations, elapsedMS, context.budgetExhausted ? " (budget exhausted, keeping best ordering found)" : "");
+    }
 }
@@ -8,6 +8,7 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string>
 
 #define _SILENCE_ALL_MS_EXT_DEPRECATION_WARNINGS
 #include "spdlog/spdlog.h"
@@ -27,6 +28,8 @@ GigiPrintMessageFn g_printMessageFn = [](MessageType messageType, const char* ms
 
 bool g_headlessMode = false;
 
+thread_local std::string g_threadMessagePrefix;
+
 void SetGigiPrintMessage(const GigiPrintMessageFn& printMessageFn)
 {
 	g_printMessageFn = printMessageFn;
@@ -37,6 +40,11 @@ void SetGigiHeadlessMode(bool headless)
 	g_headlessMode = headless;
 }
 
+void SetGigiThreadMessagePrefix(const char* prefix)
+{
+	g_threadMessagePrefix = prefix ? prefix : "";
+}
+
 bool AskForConfirmation(const char* msg, ...)
 {
 	if (g_headlessMode)
@@ -69,9 +77,10 @@ void ShowInfoMessage(const char* msg, ...)
 {
 	char buffer[4096];
 	{
+		int prefixLength = sprintf_s(buffer, "%s", g_threadMessagePrefix.c_str());
 		va_list args;
 		va_start(args, msg);
-		vsprintf_s(buffer, msg, args);
+		vsprintf_s(buffer + prefixLength, sizeof(buffer) - prefixLength, msg, args);
 		va_end(args);
 		g_printMessageFn(MessageType::Info, buffer);
 	}
@@ -81,9 +90,10 @@ void ShowWarningMessage(const char* msg, ...)
 {
 	char buffer[4096];
 	{
+		int prefixLength = sprintf_s(buffer, "%s", g_threadMessagePrefix.c_str());
 		va_list args;
 		va_start(args, msg);
-		vsprintf_s(buffer, msg, args);
+		vsprintf_s(buffer + prefixLength, sizeof(buffer) - prefixLength, msg, args);
 		va_end(args);
 		g_printMessageFn(MessageType::Warn, buffer);
 	}
@@ -93,9 +103,10 @@ bool ShowErrorMessage(const char* msg, ...)
 {
 	char buffer[4096];
 	{
+		int prefixLength = sprintf_s(buffer, "%s", g_threadMessagePrefix.c_str());
 		va_list args;
 		va_start(args, msg);
-		vsprintf_s(buffer, msg, args);
+		vsprintf_s(buffer + prefixLength, sizeof(buffer) - prefixLength, msg, args);
 		va_end(args);
 		g_printMessageFn(MessageType::Error, buffer);
 
@@ -33,6 +33,10 @@ using GigiPrintMessageFn = void (*)(MessageType messageType, const char* msg);
 void SetGigiPrintMessage(const GigiPrintMessageFn & printMessageFn);
 void SetGigiHeadlessMode(bool headless);
 
+// Info, warning and error messages shown from the calling thread start with this prefix, until it's set again.
+// Batch compiles use it so the messages of jobs running at the same time say which job they came from.
+void SetGigiThreadMessagePrefix(const char* prefix);
+
 void ShowInfoMessage(const char* msg, ...);
 bool ShowErrorMessage(const char* msg, ...);
 void ShowWarningMessage(const char* msg, ...);
@@ -499,10 +499,17 @@ struct BackendDX12 : public BackendBase
                     : resourcePrefix
                 ;
 
+                const char* flags = "D3D12_RESOURCE_BARRIER_FLAG_NONE";
+                switch (transition.split)
+                {
+                    case ResourceTransitionSplit::Begin: flags = "D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY"; break;
+                    case ResourceTransitionSplit::End: flags = "D3D12_RESOURCE_BARRIER_FLAG_END_ONLY"; break;
+                }
+
                 stringReplacementMap["/*$(Execute)*/"] <<
                     "\n"
                     "\n            barriers[" << transitionIndex << "].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;"
-                    "\n            barriers[" << transitionIndex << "].Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;"
+                    "\n            barriers[" << transitionIndex << "].Flags = " << flags << ";"
                     "\n            barriers[" << transitionIndex << "].Transition.pResource = context->" << GetResourceNodePathInContext(GetNodeResourceVisibility(renderGraph.nodes[transition.nodeIndex])) << namePrefix << GetNodeName(renderGraph.nodes[transition.nodeIndex]) << ";"
                     "\n            barriers[" << transitionIndex << "].Transition.StateBefore = " << ShaderResourceTypeToDX12ResourceState(transition.oldState) << ";"
                     "\n            barriers[" << transitionIndex << "].Transition.StateAfter = " << ShaderResourceTypeToDX12ResourceState(transition.newState) << ";"
@@ -0,0 +1,520 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "SRGB.h"
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define MIPGENERATOR_SSE2 1
+#endif
+
+namespace DX12Utils
+{
+    // Generates mip levels on the CPU.
+    // Rows are decoded to linear floats once, filtered separably with precomputed taps and encoded back.
+    // The destination is split into bands of rows, per array slice or depth slice, which are processed in parallel.
+    struct MipGenerator
+    {
+        enum class ChannelType
+        {
+            U8,
+            S8,
+            U16,
+            S16,
+            U32,
+            S32,
+            F16,
+            F32,
+        };
+
+        enum class Filter
+        {
+            Box,    // Area weighted average of the source texels covered by the destination texel
+            Kaiser, // Kaiser windowed sinc. Sharper than box, with slight ringing.
+        };
+
+        struct Format
+        {
+            ChannelType channelType = ChannelType::U8;
+            int channelCount = 4;
+            bool sRGB = false; // The color channels are converted to linear before filtering, and back after
+        };
+
+        static int ChannelTypeSize(ChannelType channelType)
+        {
+            switch (channelType)
+            {
+                case ChannelType::U8:
+                case ChannelType::S8: return 1;
+                case ChannelType::U16:
+                case ChannelType::S16:
+                case ChannelType::F16: return 2;
+                default: return 4;
+            }
+        }
+
+        // Makes the mip below src. srcDims are width, height, and then depth for 3D textures or array size otherwise.
+        // threadCount 0 means to use all hardware threads.
+        static void MakeMip(const std::vector<unsigned char>& src, std::vector<unsigned char>& dest, const Format& format, bool is3D, const int srcDims[3], Filter filter = Filter::Box, int threadCount = 0)
+        {
+            int destDims[3] = { std::max(srcDims[0] / 2, 1), std::max(srcDims[1] / 2, 1), is3D ? std::max(srcDims[2] / 2, 1) : srcDims[2] };
+            dest.resize(size_t(destDims[0]) * size_t(destDims[1]) * size_t(destDims[2]) * size_t(format.channelCount * ChannelTypeSize(format.channelType)), 0);
+            MakeMip(src.data(), srcDims, dest.data(), destDims, format, is3D, filter, threadCount);
+        }
+
+        static void MakeMip(const unsigned char* src, const int srcDims[3], unsigned char* dest, const int destDims[3], const Format& format, bool is3D, Filter filter = Filter::Box, int threadCount = 0)
+        {
+            Context context;
+            context.src = src;
+            context.dest = dest;
+            context.format = format;
+            context.is3D = is3D;
+            for (int i = 0; i < 3; ++i)
+            {
+                context.srcDims[i] = srcDims[i];
+                context.destDims[i] = destDims[i];
+            }
+            context.srcRowBytes = size_t(srcDims[0]) * format.channelCount * ChannelTypeSize(format.channelType);
+            context.destRowBytes = size_t(destDims[0]) * format.channelCount * ChannelTypeSize(format.channelType);
+            context.tapsX = MakeTaps(srcDims[0], destDims[0], filter);
+            context.tapsY = MakeTaps(srcDims[1], destDims[1], filter);
+            if (is3D)
+                context.tapsZ = MakeTaps(srcDims[2], destDims[2], filter);
+
+            if (format.sRGB && format.channelType == ChannelType::U8)
+            {
+                for (int i = 0; i < 256; ++i)
+                    context.sRGBToLinearU8[i] = SRGBToLinear(float(i) / 255.0f);
+            }
+
+            // Split the destination into bands of rows. Small mips aren't worth the cost of starting threads.
+            const int c_bandRows = 16;
+            const int bandsPerSlice = (destDims[1] + c_bandRows - 1) / c_bandRows;
+            for (int z = 0; z < destDims[2]; ++z)
+            {
+                for (int band = 0; band < bandsPerSlice; ++band)
+                    context.bands.push_back({ z, band * c_bandRows, std::min((band + 1) * c_bandRows, destDims[1]) });
+            }
+
+            if (threadCount <= 0)
+                threadCount = (int)std::thread::hardware_concurrency();
+            if (size_t(destDims[0]) * destDims[1] * destDims[2] < 64 * 64)
+                threadCount = 1;
+            threadCount = std::max(std::min(threadCount, (int)context.bands.size()), 1);
+
+            if (threadCount == 1)
+            {
+                Worker(context);
+                return;
+            }
+
+            std::vector<std::thread> threads;
+            threads.reserve(threadCount - 1);
+            for (int i = 0; i < threadCount - 1; ++i)
+                threads.emplace_back([&context]() { Worker(context); });
+            Worker(context);
+            for (std::thread& thread : threads)
+                thread.join();
+        }
+
+    private:
+        // For each destination texel on an axis, the source texels that contribute to it and their weights.
+        // Taps that fall off the edge are clamped to the edge texel.
+        struct Taps
+        {
+            std::vector<int> first;
+            std::vector<int> count;
+            std::vector<int> weightOffset;
+            std::vector<float> weights;
+        };
+
+        struct Band
+        {
+            int z;
+            int yBegin;
+            int yEnd;
+        };
+
+        struct Context
+        {
+            const unsigned char* src = nullptr;
+            unsigned char* dest = nullptr;
+            Format format;
+            bool is3D = false;
+            int srcDims[3] = {};
+            int destDims[3] = {};
+            size_t srcRowBytes = 0;
+            size_t destRowBytes = 0;
+            Taps tapsX, tapsY, tapsZ;
+            float sRGBToLinearU8[256] = {};
+            std::vector<Band> bands;
+            std::atomic<int> nextBand = 0;
+        };
+
+        static float BesselI0(float x)
+        {
+            float sum = 1.0f;
+            float term = 1.0f;
+            float halfX = x * 0.5f;
+            for (int k = 1; k < 32; ++k)
+            {
+                term *= (halfX / float(k)) * (halfX / float(k));
+                sum += term;
+                if (term < sum * 1e-8f)
+                    break;
+            }
+            return sum;
+        }
+
+        // x is in destination texels
+        static float KaiserWeight(float x)
+        {
+            static const float c_width = 3.0f;
+            static const float c_alpha = 4.0f;
+            static const float c_pi = 3.14159265358979f;
+
+            if (std::fabs(x) >= c_width)
+                return 0.0f;
+
+            float sinc = (x == 0.0f) ? 1.0f : std::sin(c_pi * x) / (c_pi * x);
+            float t = x / c_width;
+            return sinc * BesselI0(c_alpha * std::sqrt(1.0f - t * t)) / BesselI0(c_alpha);
+        }
+
+        static Taps MakeTaps(int srcSize, int destSize, Filter filter)
+        {
+            Taps taps;
+            taps.first.resize(destSize);
+            taps.count.resize(destSize);
+            taps.weightOffset.resize(destSize);
+
+            const float scale = float(srcSize) / float(destSize);
+            const bool kaiser = (filter == Filter::Kaiser) && srcSize != destSize;
+            const float support = kaiser ? 3.0f * scale : 0.5f * scale;
+
+            for (int d = 0; d < destSize; ++d)
+            {
+                float center = (float(d) + 0.5f) * scale;
+                int rawBegin = (int)std::floor(center - support);
+                int rawEnd = (int)std::ceil(center + support) - 1;
+                int first = std::clamp(rawBegin, 0, srcSize - 1);
+                int last = std::clamp(rawEnd, 0, srcSize - 1);
+
+                taps.first[d] = first;
+                taps.count[d] = last - first + 1;
+                taps.weightOffset[d] = (int)taps.weights.size();
+                taps.weights.resize(taps.weights.size() + taps.count[d], 0.0f);
+                float* weights = &taps.weights[taps.weightOffset[d]];
+
+                float total = 0.0f;
+                for (int s = rawBegin; s <= rawEnd; ++s)
+                {
+                    float weight = 0.0f;
+                    if (kaiser)
+                        weight = KaiserWeight((float(s) + 0.5f - center) / scale);
+                    else
+                        weight = std::max(std::min(float(s + 1), center + support) - std::max(float(s), center - support), 0.0f);
+
+                    weights[std::clamp(s, 0, srcSize - 1) - first] += weight;
+                    total += weight;
+                }
+
+                if (total != 0.0f)
+                {
+                    for (int i = 0; i < taps.count[d]; ++i)
+                        weights[i] /= total;
+                }
+            }
+
+            return taps;
+        }
+
+        static float HalfToFloat(uint16_t h)
+        {
+            uint32_t sign = uint32_t(h & 0x8000) << 16;
+            uint32_t exponent = (h >> 10) & 0x1F;
+            uint32_t mantissa = h & 0x3FF;
+            uint32_t bits = 0;
+            if (exponent == 0x1F)
+                bits = sign | 0x7F800000 | (mantissa << 13);
+            else if (exponent != 0)
+                bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+            else if (mantissa != 0)
+            {
+                // denormal
+                exponent = 113;
+                while ((mantissa & 0x400) == 0)
+                {
+                    mantissa <<= 1;
+                    exponent--;
+                }
+                bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+            }
+            else
+                bits = sign;
+
+            float ret;
+            memcpy(&ret, &bits, sizeof(ret));
+            return ret;
+        }
+
+        // Round to nearest even
+        static uint16_t FloatToHalf(float f)
+        {
+            uint32_t bits;
+            memcpy(&bits, &f, sizeof(bits));
+            uint16_t sign = uint16_t((bits >> 16) & 0x8000);
+            int32_t exponent = int32_t((bits >> 23) & 0xFF) - 127 + 15;
+            uint32_t mantissa = bits & 0x7FFFFF;
+
+            if (((bits >> 23) & 0xFF) == 0xFF)
+                return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+            if (exponent >= 0x1F)
+                return sign | 0x7C00;
+            if (exponent <= 0)
+            {
+                if (exponent < -10)
+                    return sign;
+                mantissa |= 0x800000;
+                uint32_t shift = uint32_t(14 - exponent);
+                uint32_t halfMantissa = mantissa >> shift;
+                uint32_t remainder = mantissa & ((1u << shift) - 1);
+                uint32_t halfway = 1u << (shift - 1);
+                if (remainder > halfway || (remainder == halfway && (halfMantissa & 1)))
+                    halfMantissa++;
+                return sign | uint16_t(halfMantissa);
+            }
+
+            uint16_t ret = sign | uint16_t(exponent << 10) | uint16_t(mantissa >> 13);
+            uint32_t remainder = mantissa & 0x1FFF;
+            if (remainder > 0x1000 || (remainder == 0x1000 && (ret & 1)))
+                ret++; // carries into the exponent correctly, including overflow to infinity
+            return ret;
+        }
+
+        template <typename T>
+        static void DecodeValues(const unsigned char* src, float* dest, size_t count, float multiplier, float theMin)
+        {
+            const T* values = (const T*)src;
+            for (size_t i = 0; i < count; ++i)
+                dest[i] = std::max(float(values[i]) * multiplier, theMin);
+        }
+
+        template <typename T>
+        static void EncodeValues(const float* src, unsigned char* dest, size_t count, float multiplier, float theMin, float theMax)
+        {
+            T* values = (T*)dest;
+            for (size_t i = 0; i < count; ++i)
+                values[i] = (T)std::lround(std::clamp(src[i], theMin, theMax) * multiplier);
+        }
+
+        static void DecodeRow(const Context& context, const unsigned char* src, float* dest)
+        {
+            const int channelCount = context.format.channelCount;
+            const size_t count = size_t(context.srcDims[0]) * channelCount;
+            switch (context.format.channelType)
+            {
+                case ChannelType::U8: DecodeValues<uint8_t>(src, dest, count, 1.0f / 255.0f, 0.0f); break;
+                case ChannelType::S8: DecodeValues<int8_t>(src, dest, count, 1.0f / 127.0f, -1.0f); break;
+                case ChannelType::U16: DecodeValues<uint16_t>(src, dest, count, 1.0f / 65535.0f, 0.0f); break;
+                case ChannelType::S16: DecodeValues<int16_t>(src, dest, count, 1.0f / 32767.0f, -1.0f); break;
+                case ChannelType::U32: DecodeValues<uint32_t>(src, dest, count, 1.0f, 0.0f); break;
+                case ChannelType::S32: DecodeValues<int32_t>(src, dest, count, 1.0f, -FLT_MAX); break;
+                case ChannelType::F16:
+                {
+                    const uint16_t* values = (const uint16_t*)src;
+                    for (size_t i = 0; i < count; ++i)
+                        dest[i] = HalfToFloat(values[i]);
+                    break;
+                }
+                case ChannelType::F32: memcpy(dest, src, count * sizeof(float)); break;
+            }
+
+            // Alpha is never sRGB encoded
+            if (context.format.sRGB)
+            {
+                const int colorChannels = std::min(channelCount, 3);
+                for (size_t i = 0; i < count; i += channelCount)
+                {
+                    for (int c = 0; c < colorChannels; ++c)
+                    {
+                        if (context.format.channelType == ChannelType::U8)
+                            dest[i + c] = context.sRGBToLinearU8[src[i + c]];
+                        else
+                            dest[i + c] = SRGBToLinear(dest[i + c]);
+                    }
+                }
+            }
+        }
+
+        static void EncodeRow(const Context& context, float* src, unsigned char* dest)
+        {
+            const int channelCount = context.format.channelCount;
+            const size_t count = size_t(context.destDims[0]) * channelCount;
+
+            if (context.format.sRGB)
+            {
+                const int colorChannels = std::min(channelCount, 3);
+                for (size_t i = 0; i < count; i += channelCount)
+                {
+                    for (int c = 0; c < colorChannels; ++c)
+                        src[i + c] = LinearTosRGB(std::max(src[i + c], 0.0f));
+                }
+            }
+
+            switch (context.format.channelType)
+            {
+                case ChannelType::U8: EncodeValues<uint8_t>(src, dest, count, 255.0f, 0.0f, 1.0f); break;
+                case ChannelType::S8: EncodeValues<int8_t>(src, dest, count, 127.0f, -1.0f, 1.0f); break;
+                case ChannelType::U16: EncodeValues<uint16_t>(src, dest, count, 65535.0f, 0.0f, 1.0f); break;
+                case ChannelType::S16: EncodeValues<int16_t>(src, dest, count, 32767.0f, -1.0f, 1.0f); break;
+                case ChannelType::U32:
+                {
+                    uint32_t* values = (uint32_t*)dest;
+                    for (size_t i = 0; i < count; ++i)
+                        values[i] = (uint32_t)std::clamp<double>(std::round(src[i]), 0.0, 4294967295.0);
+                    break;
+                }
+                case ChannelType::S32:
+                {
+                    int32_t* values = (int32_t*)dest;
+                    for (size_t i = 0; i < count; ++i)
+                        values[i] = (int32_t)std::clamp<double>(std::round(src[i]), -2147483648.0, 2147483647.0);
+                    break;
+                }
+                case ChannelType::F16:
+                {
+                    uint16_t* values = (uint16_t*)dest;
+                    for (size_t i = 0; i < count; ++i)
+                        values[i] = FloatToHalf(src[i]);
+                    break;
+                }
+                case ChannelType::F32: memcpy(dest, src, count * sizeof(float)); break;
+            }
+        }
+
+        // dest[i] += src[i] * weight
+        static void AccumulateRow(float* dest, const float* src, float weight, size_t count)
+        {
+            size_t i = 0;
+    #ifdef MIPGENERATOR_SSE2
+            __m128 weight4 = _mm_set1_ps(weight);
+            for (; i + 4 <= count; i += 4)
+                _mm_storeu_ps(&dest[i], _mm_add_ps(_mm_loadu_ps(&dest[i]), _mm_mul_ps(_mm_loadu_ps(&src[i]), weight4)));
+    #endif
+            for (; i < count; ++i)
+                dest[i] += src[i] * weight;
+        }
+
+        static void FilterRowHorizontal(const Context& context, const float* src, float* dest)
+        {
+            const int channelCount = context.format.channelCount;
+            const Taps& taps = context.tapsX;
+
+    #ifdef MIPGENERATOR_SSE2
+            if (channelCount == 4)
+            {
+                for (int x = 0; x < context.destDims[0]; ++x)
+                {
+                    const float* weights = &taps.weights[taps.weightOffset[x]];
+                    const float* srcPixel = &src[size_t(taps.first[x]) * 4];
+                    __m128 sum = _mm_setzero_ps();
+                    for (int t = 0; t < taps.count[x]; ++t)
+                        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(&srcPixel[t * 4]), _mm_set1_ps(weights[t])));
+                    _mm_storeu_ps(&dest[size_t(x) * 4], sum);
+                }
+                return;
+            }
+    #endif
+
+            for (int x = 0; x < context.destDims[0]; ++x)
+            {
+                const float* weights = &taps.weights[taps.weightOffset[x]];
+                const float* srcPixel = &src[size_t(taps.first[x]) * channelCount];
+                float* destPixel = &dest[size_t(x) * channelCount];
+                for (int c = 0; c < channelCount; ++c)
+                    destPixel[c] = 0.0f;
+                for (int t = 0; t < taps.count[x]; ++t)
+                {
+                    for (int c = 0; c < channelCount; ++c)
+                        destPixel[c] += srcPixel[t * channelCount + c] * weights[t];
+                }
+            }
+        }
+
+        static void Worker(Context& context)
+        {
+            const size_t srcRowFloats = size_t(context.srcDims[0]) * context.format.channelCount;
+            const size_t destRowFloats = size_t(context.destDims[0]) * context.format.channelCount;
+
+            std::vector<float> decoded(srcRowFloats);
+            std::vector<float> filtered;
+            std::vector<float> accumulated(destRowFloats);
+
+            while (true)
+            {
+                int bandIndex = context.nextBand.fetch_add(1);
+                if (bandIndex >= (int)context.bands.size())
+                    break;
+                const Band& band = context.bands[bandIndex];
+
+                // The source slices that contribute to this destination slice
+                int zFirst = band.z;
+                int zCount = 1;
+                const float* zWeights = nullptr;
+                static const float c_one = 1.0f;
+                if (context.is3D)
+                {
+                    zFirst = context.tapsZ.first[band.z];
+                    zCount = context.tapsZ.count[band.z];
+                    zWeights = &context.tapsZ.weights[context.tapsZ.weightOffset[band.z]];
+                }
+                else
+                    zWeights = &c_one;
+
+                // The source rows that contribute to this band
+                int yFirst = context.tapsY.first[band.yBegin];
+                int yLast = yFirst;
+                for (int y = band.yBegin; y < band.yEnd; ++y)
+                    yLast = std::max(yLast, context.tapsY.first[y] + context.tapsY.count[y] - 1);
+                const int yCount = yLast - yFirst + 1;
+
+                // Decode and horizontally filter each contributing source row once
+                filtered.resize(size_t(zCount) * yCount * destRowFloats);
+                for (int zi = 0; zi < zCount; ++zi)
+                {
+                    const unsigned char* srcSlice = context.src + size_t(zFirst + zi) * context.srcDims[1] * context.srcRowBytes;
+                    for (int yi = 0; yi < yCount; ++yi)
+                    {
+                        DecodeRow(context, srcSlice + size_t(yFirst + yi) * context.srcRowBytes, decoded.data());
+                        FilterRowHorizontal(context, decoded.data(), &filtered[(size_t(zi) * yCount + yi) * destRowFloats]);
+                    }
+                }
+
+                // Filter vertically (and in depth) into each destination row
+                unsigned char* destSlice = context.dest + size_t(band.z) * context.destDims[1] * context.destRowBytes;
+                for (int y = band.yBegin; y < band.yEnd; ++y)
+                {
+                    std::fill(accumulated.begin(), accumulated.end(), 0.0f);
+
+                    const float* yWeights = &context.tapsY.weights[context.tapsY.weightOffset[y]];
+                    const int yOffset = context.tapsY.first[y] - yFirst;
+                    for (int zi = 0; zi < zCount; ++zi)
+                    {
+                        for (int yi = 0; yi < context.tapsY.count[y]; ++yi)
+                            AccumulateRow(accumulated.data(), &filtered[(size_t(zi) * yCount + yOffset + yi) * destRowFloats], zWeights[zi] * yWeights[yi], destRowFloats);
+                    }
+
+                    EncodeRow(context, accumulated.data(), destSlice + size_t(y) * context.destRowBytes);
+                }
+            }
+        }
+    };
+} // namespace DX12Utils
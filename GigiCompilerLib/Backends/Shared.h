@@ -10,6 +10,10 @@
 #include <unordered_map>
 #include <sstream>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <algorithm>
 #include "Nodes/nodes.h"
 #include "GigiAssert.h"
 #include "external/timyxml2/tinyxml2.h"
@@ -201,28 +205,169 @@ inline bool GetTokenParameter(const char* string, const char* token, std::string
     return true;
 }
 
-template <typename LAMBDA>
-inline void ForEachToken(const std::string& fileContents, const LAMBDA& lambda)
+// A template split into literal text, /*$(tokens)*/, and the /*$(if:condition:value)*/ and /*$(Endif)*/ markers of conditional blocks.
+// Segments are offsets into the template text, which isn't stored here. Parsed templates are cached by GetParsedTemplate.
+struct ParsedTemplate
 {
-    size_t processed = 0;
+    enum class SegmentType
+    {
+        Literal,
+        Token,
+        If,
+        Endif
+    };
+
+    struct Segment
+    {
+        SegmentType type = SegmentType::Literal;
+        size_t begin = 0;
+        size_t end = 0;
+        int tokenIndex = -1; // index into tokens, for everything but literals
+        std::string condition; // If
+        std::string value; // If
+    };
+
+    std::vector<Segment> segments;
+    std::vector<std::string> tokens; // each unique token in the template, including conditional markers
+    bool tokensHaveCarriageReturns = false;
 
+    // false if the template has a token inside of a token, a malformed conditional, or conditionals without matching endifs.
+    // Those are expanded with the string search engine instead, so they come out the same as they always have.
+    bool valid = true;
+};
+
+inline bool IsTemplateToken(const std::string& key)
+{
+    return key.size() >= 7 && key.compare(0, 4, "/*$(") == 0 && key.find(")*/", 4) == key.size() - 3 && key.find("/*$(", 4) == std::string::npos;
+}
+
+inline void ParseTemplate(const std::string& text, ParsedTemplate& parsedTemplate)
+{
+    std::unordered_map<std::string, int> tokenIndices;
+    int conditionalDepth = 0;
+
+    auto AddSegment = [&](ParsedTemplate::SegmentType type, size_t begin, size_t end) -> ParsedTemplate::Segment&
+    {
+        parsedTemplate.segments.emplace_back();
+        ParsedTemplate::Segment& segment = parsedTemplate.segments.back();
+        segment.type = type;
+        segment.begin = begin;
+        segment.end = end;
+        return segment;
+    };
+
+    auto GetTokenIndex = [&](const std::string& token) -> int
+    {
+        auto it = tokenIndices.find(token);
+        if (it != tokenIndices.end())
+            return it->second;
+
+        int tokenIndex = (int)parsedTemplate.tokens.size();
+        tokenIndices[token] = tokenIndex;
+        parsedTemplate.tokens.push_back(token);
+        if (token.find('\r') != std::string::npos)
+            parsedTemplate.tokensHaveCarriageReturns = true;
+        return tokenIndex;
+    };
+
+    size_t processed = 0;
     while (1)
     {
-        // first look for a "/*$("
-        size_t start = fileContents.find("/*$(", processed);
+        size_t start = text.find("/*$(", processed);
         if (start == std::string::npos)
-            return;
+            break;
 
-        // then look for a ")*/" after it
-        size_t end = fileContents.find(")*/", start + 4);
+        size_t end = text.find(")*/", start + 4);
         if (end == std::string::npos)
-            return;
+            break;
+        end += 3;
+
+        if (start > processed)
+            AddSegment(ParsedTemplate::SegmentType::Literal, processed, start);
+        processed = end;
+
+        std::string token = text.substr(start, end - start);
+        if (token.find("/*$(", 4) != std::string::npos)
+            parsedTemplate.valid = false;
+
+        size_t colon = std::string::npos;
+        if (!_strnicmp(token.c_str(), "/*$(if:", 7))
+        {
+            colon = token.find(':', 7);
+            if (colon == std::string::npos)
+                parsedTemplate.valid = false;
+        }
+
+        if (colon != std::string::npos)
+        {
+            ParsedTemplate::Segment& segment = AddSegment(ParsedTemplate::SegmentType::If, start, end);
+            segment.tokenIndex = GetTokenIndex(token);
+            segment.condition = token.substr(7, colon - 7);
+            segment.value = token.substr(colon + 1, token.size() - 3 - (colon + 1));
+            conditionalDepth++;
+        }
+        else if (!_stricmp(token.c_str(), "/*$(Endif)*/"))
+        {
+            if (conditionalDepth == 0)
+                parsedTemplate.valid = false;
+            conditionalDepth--;
+            AddSegment(ParsedTemplate::SegmentType::Endif, start, end).tokenIndex = GetTokenIndex(token);
+        }
+        else
+        {
+            AddSegment(ParsedTemplate::SegmentType::Token, start, end).tokenIndex = GetTokenIndex(token);
+        }
+    }
+
+    if (processed < text.size())
+        AddSegment(ParsedTemplate::SegmentType::Literal, processed, text.size());
+
+    if (conditionalDepth != 0)
+        parsedTemplate.valid = false;
+}
+
+// Templates are parsed once and cached by their contents. The viewer compiles over and over, and
+// a shader edited between compiles has different contents, so it gets a new entry instead of a stale one.
+// The cache is shared by everything in the process, including the jobs of a batch compile, and is thread safe.
+inline std::shared_ptr<const ParsedTemplate> GetParsedTemplate(const std::string& text)
+{
+    static const size_t c_maxCacheBytes = 64 * 1024 * 1024;
+
+    static std::mutex s_mutex;
+    static std::unordered_map<std::string, std::shared_ptr<const ParsedTemplate>> s_cache;
+    static size_t s_cacheBytes = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        auto it = s_cache.find(text);
+        if (it != s_cache.end())
+            return it->second;
+    }
 
-        // call the lambda
-        lambda(fileContents.substr(start, end - start + 3), &fileContents[0], &fileContents[start]);
+    std::shared_ptr<ParsedTemplate> parsedTemplate = std::make_shared<ParsedTemplate>();
+    ParseTemplate(text, *parsedTemplate);
 
-        // move past this token
-        processed = end + 3;
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (s_cacheBytes + text.size() > c_maxCacheBytes)
+    {
+        s_cache.clear();
+        s_cacheBytes = 0;
+    }
+    if (s_cache.insert({ text, parsedTemplate }).second)
+        s_cacheBytes += text.size();
+    return parsedTemplate;
+}
+
+// Calls the lambda for each /*$(token)*/ in the file, in order. Uses the cached parse, so shader files scanned by several
+// visitors and then string replaced are only tokenized once.
+template <typename LAMBDA>
+inline void ForEachToken(const std::string& fileContents, const LAMBDA& lambda)
+{
+    std::shared_ptr<const ParsedTemplate> parsedTemplate = GetParsedTemplate(fileContents);
+    for (const ParsedTemplate::Segment& segment : parsedTemplate->segments)
+    {
+        if (segment.type != ParsedTemplate::SegmentType::Literal)
+            lambda(parsedTemplate->tokens[segment.tokenIndex], &fileContents[0], &fileContents[segment.begin]);
     }
 }
 
@@ -266,11 +411,22 @@ inline void EnsureAllTokensEaten(const std::string& fileContents, std::unordered
 inline void StringReplaceAll(std::string& str, const std::string& from, const std::string& to) {
     if (from.empty())
         return;
-    size_t start_pos = 0;
-    while ((start_pos = str.find(from, start_pos)) != std::string::npos) {
-        str.replace(start_pos, from.length(), to);
-        start_pos += to.length();
+    size_t start_pos = str.find(from);
+    if (start_pos == std::string::npos)
+        return;
+
+    // Build the result in a new string, so that each replacement doesn't shift the rest of the string
+    std::string result;
+    result.reserve(str.size());
+    size_t copied_pos = 0;
+    while (start_pos != std::string::npos) {
+        result.append(str, copied_pos, start_pos - copied_pos);
+        result.append(to);
+        copied_pos = start_pos + from.length();
+        start_pos = str.find(from, copied_pos);
     }
+    result.append(str, copied_pos, std::string::npos);
+    str = std::move(result);
 }
 
 inline void AddTemplateFile(std::unordered_map<std::string, std::string>& files, const char* folderName, const char* fileName, const char* templateText)
@@ -391,9 +547,35 @@ inline void WriteFileIfDifferent(const std::string& fileName, const std::vector<
     fclose(file);
 }
 
-inline void ProcessStringReplacement(std::string& str, std::unordered_map<std::string, std::ostringstream>& stringReplacementMap, const RenderGraph& renderGraph)
+inline bool EvaluateTemplateCondition(const std::string& condition, const std::string& value, const RenderGraph& renderGraph)
+{
+    bool conditionIsTrue = false;
+    if (!_stricmp(condition.c_str(), "Platform"))
+    {
+        Backend backend;
+        StringToEnum(value.c_str(), backend);
+        conditionIsTrue = (backend == renderGraph.backend);
+    }
+    else if (!_stricmp(condition.c_str(), "PlatformNot"))
+    {
+        Backend backend;
+        StringToEnum(value.c_str(), backend);
+        conditionIsTrue = (backend != renderGraph.backend);
+    }
+    else if (!_stricmp(condition.c_str(), "DX12.AgilitySDKRequired"))
+    {
+        bool compareValue = false;
+        if (!_stricmp(value.c_str(), "true"))
+            compareValue = true;
+        conditionIsTrue = (compareValue == renderGraph.settings.dx12.AgilitySDKRequired);
+    }
+    return conditionIsTrue;
+}
+
+// Resolves /*$(if:)*/ blocks by searching the string. Each conditional is paired with the first /*$(Endif)*/ after it.
+// Only used for templates that ParseTemplate can't handle, such as ones with an /*$(if:)*/ that has no /*$(Endif)*/.
+inline void ProcessTemplateConditionals(std::string& str, const RenderGraph& renderGraph)
 {
-    // Gigi preprocessor
     size_t offset = 0;
     while (1)
     {
@@ -436,30 +618,8 @@ inline void ProcessStringReplacement(std::string& str, std::unordered_map<std::s
             conditionEndEnd = offset;
         }
 
-        // Evaluate the condition
-        bool conditionIsTrue = false;
-        if (!_stricmp(condition.c_str(), "Platform"))
-        {
-            Backend backend;
-            StringToEnum(value.c_str(), backend);
-            conditionIsTrue = (backend == renderGraph.backend);
-        }
-        else if (!_stricmp(condition.c_str(), "PlatformNot"))
-        {
-            Backend backend;
-            StringToEnum(value.c_str(), backend);
-            conditionIsTrue = (backend != renderGraph.backend);
-        }
-        else if (!_stricmp(condition.c_str(), "DX12.AgilitySDKRequired"))
-        {
-            bool compareValue = false;
-            if (!_stricmp(value.c_str(), "true"))
-                compareValue = true;
-            conditionIsTrue = (compareValue == renderGraph.settings.dx12.AgilitySDKRequired);
-        }
-
         // if the condition is true, we want to remove the conditional statements
-        if (conditionIsTrue)
+        if (EvaluateTemplateCondition(condition, value, renderGraph))
         {
             str.erase(conditionEndStart, conditionEndEnd - conditionEndStart);
             str.erase(conditionBeginStart, conditionBeginEnd - conditionBeginStart);
@@ -473,15 +633,203 @@ inline void ProcessStringReplacement(std::string& str, std::unordered_map<std::s
         // continue searching the string where we removed stuff
         offset = conditionBeginStart;
     }
+}
+
+// Expands a parsed template in a single pass, evaluating conditionals and replacing tokens with their values from the map.
+// The string search engine replaces one key at a time over the whole string, so a value containing a token, or text that becomes a key
+// once things around it are replaced, would depend on the order of the map. Returns false in those cases, without touching the map, so
+// the caller can fall back to the string search engine. With replaceTokens false, only conditionals are expanded and this can't fail.
+inline bool ExpandTemplate(const std::string& text, const ParsedTemplate& parsedTemplate, std::unordered_map<std::string, std::ostringstream>& stringReplacementMap, const RenderGraph& renderGraph, bool replaceTokens, std::string& out)
+{
+    // "\r\n" is the only key that isn't a token that we know how to handle in a single pass
+    bool normalizeLineEndings = false;
+    if (replaceTokens)
+    {
+        for (const std::pair<const std::string, std::ostringstream>& replacement : stringReplacementMap)
+        {
+            if (replacement.first.empty() || IsTemplateToken(replacement.first))
+                continue;
+
+            if (replacement.first != "\r\n" || replacement.second.str() != "\n")
+                return false;
+            normalizeLineEndings = true;
+        }
+
+        if (normalizeLineEndings && parsedTemplate.tokensHaveCarriageReturns)
+            return false;
+    }
+
+    std::vector<std::string> tokenValues(parsedTemplate.tokens.size());
+    std::vector<char> tokenState(parsedTemplate.tokens.size(), 0); // 0 = not seen, 1 = in the map, 2 = needs adding to the map
+
+    out.clear();
+    out.reserve(text.size());
+
+    auto Append = [&](const char* piece, size_t pieceLength) -> bool
+    {
+        if (pieceLength == 0)
+            return true;
+
+        if (replaceTokens && !out.empty())
+        {
+            // A "\r\n" that spans the join
+            if (normalizeLineEndings && out.back() == '\r' && piece[0] == '\n')
+                return false;
+
+            // A "/*$(" that spans the join
+            std::string join = out.substr(out.size() - std::min<size_t>(out.size(), 3));
+            size_t tailLength = join.size();
+            join.append(piece, std::min<size_t>(pieceLength, 3));
+            size_t tokenStart = join.find("/*$(");
+            if (tokenStart != std::string::npos && tokenStart < tailLength && tokenStart + 4 > tailLength)
+                return false;
+        }
+
+        if (!normalizeLineEndings)
+        {
+            out.append(piece, pieceLength);
+            return true;
+        }
+
+        for (size_t index = 0; index < pieceLength; ++index)
+        {
+            if (piece[index] == '\r' && index + 1 < pieceLength && piece[index + 1] == '\n')
+                continue;
+            out.push_back(piece[index]);
+        }
+        return true;
+    };
+
+    // A stack of whether the enclosing blocks are being kept
+    std::vector<bool> keepingStack;
+    bool keeping = true;
+
+    for (const ParsedTemplate::Segment& segment : parsedTemplate.segments)
+    {
+        switch (segment.type)
+        {
+            case ParsedTemplate::SegmentType::If:
+            {
+                keepingStack.push_back(keeping);
+                keeping = keeping && EvaluateTemplateCondition(segment.condition, segment.value, renderGraph);
+                break;
+            }
+            case ParsedTemplate::SegmentType::Endif:
+            {
+                keeping = keepingStack.back();
+                keepingStack.pop_back();
+                break;
+            }
+            case ParsedTemplate::SegmentType::Literal:
+            {
+                if (keeping && !Append(&text[segment.begin], segment.end - segment.begin))
+                    return false;
+                break;
+            }
+            case ParsedTemplate::SegmentType::Token:
+            {
+                if (!keeping)
+                    break;
+
+                if (!replaceTokens)
+                {
+                    Append(&text[segment.begin], segment.end - segment.begin);
+                    break;
+                }
+
+                std::string& value = tokenValues[segment.tokenIndex];
+                char& state = tokenState[segment.tokenIndex];
+                if (state == 0)
+                {
+                    auto it = stringReplacementMap.find(parsedTemplate.tokens[segment.tokenIndex]);
+                    if (it != stringReplacementMap.end())
+                    {
+                        value = it->second.str();
+                        state = 1;
+                    }
+                    else
+                        state = 2;
+
+                    if (value.find('\r') != std::string::npos || value.find("/*$(") != std::string::npos)
+                        return false;
+                }
+
+                if (!Append(value.c_str(), value.size()))
+                    return false;
+                break;
+            }
+        }
+    }
+
+    // make sure all tokens appear in the map, like EnsureAllTokensEaten does
+    for (size_t tokenIndex = 0; tokenIndex < tokenState.size(); ++tokenIndex)
+    {
+        if (tokenState[tokenIndex] == 2)
+            stringReplacementMap[parsedTemplate.tokens[tokenIndex]] << "";
+    }
+
+    return true;
+}
+
+// Returns true if the string was expanded in a single pass, which means it has no tokens left in it.
+inline bool ProcessStringReplacementInternal(std::string& str, std::unordered_map<std::string, std::ostringstream>& stringReplacementMap, const RenderGraph& renderGraph)
+{
+    std::shared_ptr<const ParsedTemplate> parsedTemplate = GetParsedTemplate(str);
+
+    std::string expanded;
+    if (parsedTemplate->valid)
+    {
+        if (ExpandTemplate(str, *parsedTemplate, stringReplacementMap, renderGraph, true, expanded))
+        {
+            str = std::move(expanded);
+            return true;
+        }
+
+        ExpandTemplate(str, *parsedTemplate, stringReplacementMap, renderGraph, false, expanded);
+        str = std::move(expanded);
+    }
+    else
+    {
+        ProcessTemplateConditionals(str, renderGraph);
+    }
 
     EnsureAllTokensEaten(str, stringReplacementMap);
     for (std::pair<const std::string, std::ostringstream>& replacement : stringReplacementMap)
         StringReplaceAll(str, replacement.first, replacement.second.str());
+    return false;
+}
+
+inline void ProcessStringReplacement(std::string& str, std::unordered_map<std::string, std::ostringstream>& stringReplacementMap, const RenderGraph& renderGraph)
+{
+    ProcessStringReplacementInternal(str, stringReplacementMap, renderGraph);
 }
 
 inline void ProcessStringReplacement(std::string& str, std::unordered_map<std::string, std::ostringstream>& stringReplacementMap1, const std::unordered_map<std::string, std::ostringstream>& stringReplacementMap2, const RenderGraph& renderGraph)
 {
-    ProcessStringReplacement(str, stringReplacementMap1, renderGraph);
+    // After a single pass expansion, the only key from the second map that can match anything is "\r\n"
+    bool singlePass = ProcessStringReplacementInternal(str, stringReplacementMap1, renderGraph);
+    bool normalizeLineEndings = false;
+    for (const std::pair<const std::string, std::ostringstream>& replacement : stringReplacementMap2)
+    {
+        if (!singlePass)
+            break;
+
+        if (replacement.first.empty() || IsTemplateToken(replacement.first))
+            continue;
+
+        if (replacement.first == "\r\n" && replacement.second.str() == "\n")
+            normalizeLineEndings = true;
+        else
+            singlePass = false;
+    }
+
+    if (singlePass)
+    {
+        if (normalizeLineEndings)
+            StringReplaceAll(str, "\r\n", "\n");
+        return;
+    }
+
     for (const std::pair<const std::string, std::ostringstream>& replacement : stringReplacementMap2)
         StringReplaceAll(str, replacement.first, replacement.second.str());
 }
@@ -532,6 +880,7 @@ inline bool ShaderResourceTypeIsReadOnly(ShaderResourceAccessType access)
         case ShaderResourceAccessType::CBV: return true;
         case ShaderResourceAccessType::Indirect: return true;
         case ShaderResourceAccessType::VertexBuffer: return true;
+        case ShaderResourceAccessType::IndexBuffer: return true;
         case ShaderResourceAccessType::RenderTarget: return false;
         case ShaderResourceAccessType::DepthTarget: return false;
         case ShaderResourceAccessType::Barrier: return false;
@@ -704,14 +1053,7 @@ inline bool EnumToEnum(ENUM_A a, ENUM_B& b)
 
 inline int GetVariableIndex(const RenderGraph& renderGraph, const char* variableName)
 {
-    int index = -1;
-    for (const Variable& variable : renderGraph.variables)
-    {
-        index++;
-        if (!_stricmp(variable.name.c_str(), variableName))
-            return index;
-    }
-    return -1;
+    return SymbolTableFindVariable(renderGraph, variableName);
 }
 
 inline void GetScopeFromVariable(const char* variableName, std::string& scope, std::string& name)
@@ -747,41 +1089,22 @@ inline int GetScopedVariableIndex(const RenderGraph& renderGraph, const char* va
             Assert(loopCount < 1000, "Variable rename loop detected while loop for variable \"%s\"", variableName);
             didRename = false;
 
-            for (const VariableReplacement& replacement : renderGraph.variableReplacements)
+            int replacementIndex = SymbolTableFindVariableReplacement(renderGraph, searchScope, searchVariableName);
+            if (replacementIndex != -1)
             {
-                if (_stricmp(replacement.srcScope.c_str(), searchScope.c_str()))
-                    continue;
-
-                if (!_stricmp(replacement.srcName.c_str(), searchVariableName.c_str()))
-                {
-                    searchScope = "";
-                    searchVariableName = replacement.destName;
-                    didRename = true;
+                searchScope = "";
+                searchVariableName = renderGraph.variableReplacements[replacementIndex].destName;
+                didRename = true;
 
-                    // extract the variable scope and name
-                    GetScopeFromVariable(searchVariableName.c_str(), searchScope, searchVariableName);
-
-                    break;
-                }
+                // extract the variable scope and name
+                GetScopeFromVariable(searchVariableName.c_str(), searchScope, searchVariableName);
             }
             loopCount++;
         }
         while (didRename);
     }
 
-    // Look through the list
-    int index = -1;
-    for (const Variable& variable : renderGraph.variables)
-    {
-        index++;
-
-        if (_stricmp(variable.scope.c_str(), searchScope.c_str()))
-            continue;
-
-        if (!_stricmp(variable.originalName.c_str(), searchVariableName.c_str()))
-            return index;
-    }
-    return -1;
+    return SymbolTableFindScopedVariable(renderGraph, searchScope, searchVariableName);
 }
 
 enum class DataFieldComponentType
@@ -0,0 +1,1116 @@
+///////////////////////////////////////////////////////////////////////////////
+//         Gigi Rapid Graphics Prototyping and Code Generation Suite         //
+//        Copyright (c) 2024 Electronic Arts Inc. All rights reserved.       //
+///////////////////////////////////////////////////////////////////////////////
+
+#include "CompilerUnitTests.h"
+
+#include "Schemas/Types.h"
+#include "Schemas/Visitor.h"
+#include "Backends/Shared.h"
+#include "RenderGraph/Visitors.h"
+#include "RenderGraph/SymbolTable.h"
+#include "FlattenRenderGraph.h"
+#include "ParseCSV.h"
+#include "GigiViewerDX12/DX12Utils/ShaderCache.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <vector>
+
+#define UNITTEST_CHECK(X, MSG, ...) \
+    if ((X) == false) \
+    { \
+        ShowErrorMessage("%s failed: " MSG, __FUNCTION__, __VA_ARGS__); \
+        return false; \
+    }
+
+// The render graphs for these tests are made of textures and copy resource nodes, with every pin plugged straight into a texture.
+// Pins are resolved to node indices here, like ReferenceFixupVisitor does, so the graphs can go straight to OptimizeAndFlattenRenderGraph().
+struct TestTexture
+{
+    const char* name;
+    ResourceVisibility visibility;
+    TextureFormat format = TextureFormat::RGBA8_Unorm;
+    int size = 1;                       // width and height, unless sizeVariable is given
+    const char* sizeVariable = nullptr; // if given, the size isn't known at compile time
+};
+
+struct TestCopy
+{
+    int sourceTexture;
+    int destTexture;
+};
+
+// Textures come first, then the copies in copyOrder
+static RenderGraph MakeCopyGraph(const std::vector<TestTexture>& textures, const std::vector<TestCopy>& copies, const std::vector<int>& copyOrder)
+{
+    RenderGraph renderGraph;
+    for (const TestTexture& texture : textures)
+    {
+        RenderGraphNode node;
+        node._index = RenderGraphNode::c_index_resourceTexture;
+        node.resourceTexture.name = texture.name;
+        node.resourceTexture.visibility = texture.visibility;
+        node.resourceTexture.format.format = texture.format;
+        node.resourceTexture.size.multiply[0] = texture.size;
+        node.resourceTexture.size.multiply[1] = texture.size;
+        if (texture.sizeVariable)
+            node.resourceTexture.size.variable.name = texture.sizeVariable;
+        node.resourceTexture.nodeIndex = (int)renderGraph.nodes.size();
+        renderGraph.nodes.push_back(node);
+    }
+
+    for (int copyIndex : copyOrder)
+    {
+        const TestCopy& copy = copies[copyIndex];
+
+        RenderGraphNode node;
+        node._index = RenderGraphNode::c_index_actionCopyResource;
+        RenderGraphNode_Action_CopyResource& copyNode = node.actionCopyResource;
+        copyNode.name = "Copy" + std::to_string(copyIndex);
+        copyNode.nodeIndex = (int)renderGraph.nodes.size();
+        copyNode.source.node = textures[copy.sourceTexture].name;
+        copyNode.source.nodeIndex = copy.sourceTexture;
+        copyNode.source.nodePinIndex = 0;
+        copyNode.dest.node = textures[copy.destTexture].name;
+        copyNode.dest.nodeIndex = copy.destTexture;
+        copyNode.dest.nodePinIndex = 0;
+        renderGraph.nodes.push_back(node);
+    }
+
+    return renderGraph;
+}
+
+static std::vector<int> IdentityOrder(size_t count)
+{
+    std::vector<int> ret(count);
+    std::iota(ret.begin(), ret.end(), 0);
+    return ret;
+}
+
+// Flattens the render graph with the scheduler given, without a budget, and returns the number of transitions per frame.
+// A split barrier counts as one transition, like the scheduler's score.
+static int FlattenAndCountTransitions(RenderGraph& renderGraph, FlattenScheduler scheduler, int beamWidth = 16)
+{
+    renderGraph.buildSettings.scheduler = scheduler;
+    renderGraph.buildSettings.schedulerBeamWidth = beamWidth;
+    renderGraph.buildSettings.schedulerBudgetMS = 0;
+    renderGraph.buildSettings.schedulerBudgetIterations = 0;
+    OptimizeAndFlattenRenderGraph(renderGraph);
+
+    int ret = 0;
+    for (const ResourceTransitions& transitions : renderGraph.transitions)
+    {
+        for (const ResourceTransition& transition : transitions.transitions)
+        {
+            if (transition.split != ResourceTransitionSplit::Begin)
+                ret++;
+        }
+    }
+    return ret;
+}
+
+// The copies don't depend on each other, so every order of them is valid. The default scheduler runs them in node order,
+// so this tries every order by putting the copies in that order, and returns the fewest transitions of any of them.
+static int BruteForceFewestTransitions(const std::vector<TestTexture>& textures, const std::vector<TestCopy>& copies)
+{
+    int ret = INT_MAX;
+    std::vector<int> copyOrder = IdentityOrder(copies.size());
+    do
+    {
+        RenderGraph renderGraph = MakeCopyGraph(textures, copies, copyOrder);
+        ret = std::min(ret, FlattenAndCountTransitions(renderGraph, FlattenScheduler::Default));
+    }
+    while (std::next_permutation(copyOrder.begin(), copyOrder.end()));
+    return ret;
+}
+
+// Imported resources get their first transition for free, because they are put into the right state when imported.
+// The exhaustive scheduler's memo and beam search's duplicate removal must not merge partial orderings that differ in which
+// free transitions they have used. Exhaustive, and a beam wide enough to never drop a partial ordering, must both find the best ordering there is.
+static bool TestSchedulersWithImportedResources()
+{
+    std::vector<TestTexture> textures =
+    {
+        { "ImportedA", ResourceVisibility::Imported },
+        { "ImportedB", ResourceVisibility::Imported },
+        { "Scratch", ResourceVisibility::Internal },
+    };
+
+    std::vector<TestCopy> copies =
+    {
+        { 0, 2 },
+        { 2, 0 },
+        { 1, 2 },
+        { 2, 1 },
+        { 0, 1 },
+    };
+
+    int fewestTransitions = BruteForceFewestTransitions(textures, copies);
+
+    RenderGraph exhaustiveGraph = MakeCopyGraph(textures, copies, IdentityOrder(copies.size()));
+    int exhaustiveTransitions = FlattenAndCountTransitions(exhaustiveGraph, FlattenScheduler::Exhaustive);
+    UNITTEST_CHECK(exhaustiveTransitions == fewestTransitions, "Exhaustive scheduler made %i transitions, but the best ordering has %i", exhaustiveTransitions, fewestTransitions);
+
+    RenderGraph beamGraph = MakeCopyGraph(textures, copies, IdentityOrder(copies.size()));
+    int beamTransitions = FlattenAndCountTransitions(beamGraph, FlattenScheduler::Beam, 100000);
+    UNITTEST_CHECK(beamTransitions == fewestTransitions, "Beam scheduler made %i transitions, but the best ordering has %i", beamTransitions, fewestTransitions);
+
+    return true;
+}
+
+// The exhaustive scheduler's memo only prunes, so when it is full it must still find the best ordering, just more slowly.
+// A memo of one entry is full almost right away.
+static bool TestExhaustiveWithFullMemo()
+{
+    std::vector<TestTexture> textures =
+    {
+        { "ImportedA", ResourceVisibility::Imported },
+        { "ImportedB", ResourceVisibility::Imported },
+        { "Scratch", ResourceVisibility::Internal },
+    };
+
+    std::vector<TestCopy> copies =
+    {
+        { 0, 2 },
+        { 2, 0 },
+        { 1, 2 },
+        { 2, 1 },
+        { 0, 1 },
+    };
+
+    int fewestTransitions = BruteForceFewestTransitions(textures, copies);
+
+    RenderGraph renderGraph = MakeCopyGraph(textures, copies, IdentityOrder(copies.size()));
+    renderGraph.buildSettings.schedulerMemoMaxEntries = 1;
+    int exhaustiveTransitions = FlattenAndCountTransitions(renderGraph, FlattenScheduler::Exhaustive);
+    UNITTEST_CHECK(exhaustiveTransitions == fewestTransitions, "Exhaustive scheduler made %i transitions with a full memo, but the best ordering has %i", exhaustiveTransitions, fewestTransitions);
+
+    return true;
+}
+
+// Beam search merges partial orderings with the same key, keeping the best scoring one. With a beam wide enough to never drop
+// a partial ordering, that merging is all that stands between it and trying every ordering, so it must find the best one.
+// Every resource is imported, and some are only read, so that partial orderings differ in which free transitions they have used.
+static bool TestBeamMergesOnlyEquivalentOrderings()
+{
+    std::vector<TestTexture> textures =
+    {
+        { "ImportedA", ResourceVisibility::Imported },
+        { "ImportedB", ResourceVisibility::Imported },
+        { "ImportedC", ResourceVisibility::Imported },
+        { "ImportedD", ResourceVisibility::Imported },
+    };
+
+    std::vector<TestCopy> copies =
+    {
+        { 0, 1 },
+        { 1, 2 },
+        { 2, 0 },
+        { 3, 0 },
+        { 1, 0 },
+        { 3, 2 },
+        { 0, 2 },
+    };
+
+    int fewestTransitions = BruteForceFewestTransitions(textures, copies);
+
+    RenderGraph beamGraph = MakeCopyGraph(textures, copies, IdentityOrder(copies.size()));
+    int beamTransitions = FlattenAndCountTransitions(beamGraph, FlattenScheduler::Beam, 100000);
+    UNITTEST_CHECK(beamTransitions == fewestTransitions, "Beam scheduler made %i transitions, but the best ordering has %i", beamTransitions, fewestTransitions);
+
+    return true;
+}
+
+// Index buffers are only read, so with hazard dependencies, draw calls that share an index buffer don't depend on each other.
+// DrawB comes first in node order, but its index buffer pin is wired through DrawA's. The default scheduler runs ready nodes
+// in node order, so it only runs DrawB first if reading the index buffer isn't taken to be a write.
+static bool TestHazardDependenciesWithIndexBuffer()
+{
+    RenderGraph renderGraph;
+    renderGraph.buildSettings.hazardDependencies = true;
+    renderGraph.nodes.resize(3);
+
+    RenderGraphNode& indicesNode = renderGraph.nodes[0];
+    indicesNode._index = RenderGraphNode::c_index_resourceBuffer;
+    indicesNode.resourceBuffer.name = "Indices";
+    indicesNode.resourceBuffer.visibility = ResourceVisibility::Imported;
+    indicesNode.resourceBuffer.nodeIndex = 0;
+
+    // With no shaders, a draw call's pins are the shading rate image, then the vertex, index and instance buffers
+    const int c_indexBufferPin = 2;
+    const char* drawNames[] = { "DrawB", "DrawA" };
+    for (int drawIndex = 0; drawIndex < 2; ++drawIndex)
+    {
+        RenderGraphNode& node = renderGraph.nodes[drawIndex + 1];
+        node._index = RenderGraphNode::c_index_actionDrawCall;
+        node.actionDrawCall.name = drawNames[drawIndex];
+        node.actionDrawCall.nodeIndex = drawIndex + 1;
+    }
+    renderGraph.nodes[1].actionDrawCall.indexBuffer.node = "DrawA";
+    renderGraph.nodes[1].actionDrawCall.indexBuffer.nodeIndex = 2;
+    renderGraph.nodes[1].actionDrawCall.indexBuffer.nodePinIndex = c_indexBufferPin;
+    renderGraph.nodes[2].actionDrawCall.indexBuffer.node = "Indices";
+    renderGraph.nodes[2].actionDrawCall.indexBuffer.nodeIndex = 0;
+    renderGraph.nodes[2].actionDrawCall.indexBuffer.nodePinIndex = 0;
+
+    FlattenAndCountTransitions(renderGraph, FlattenScheduler::Default);
+
+    std::vector<int> expectedOrder = { 0, 1, 2 };
+    UNITTEST_CHECK(renderGraph.flattenedNodeList == expectedOrder, "DrawB should run before DrawA, but the flattened order is %i %i %i",
+        renderGraph.flattenedNodeList.size() > 0 ? renderGraph.flattenedNodeList[0] : -1,
+        renderGraph.flattenedNodeList.size() > 1 ? renderGraph.flattenedNodeList[1] : -1,
+        renderGraph.flattenedNodeList.size() > 2 ? renderGraph.flattenedNodeList[2] : -1);
+
+    return true;
+}
+
+// Resources in the same alias group share memory, so they must not be in use at the same time, and resources in use at the same time
+// must be in separate memory. T0 and T2 are used at different times, so they can share memory, but T1 is used alongside both of them.
+static bool TestAliasingPlanOffsets()
+{
+    for (bool t1SizeKnown : { true, false })
+    {
+        std::vector<TestTexture> textures =
+        {
+            { "Source", ResourceVisibility::Imported },
+            { "T0", ResourceVisibility::Internal, TextureFormat::RGBA8_Unorm, 256 },
+            { "T1", ResourceVisibility::Internal, TextureFormat::RGBA16_Float, 512, t1SizeKnown ? nullptr : "T1Size" },
+            { "T2", ResourceVisibility::Internal, TextureFormat::R8_Unorm, 128 },
+            { "Dest", ResourceVisibility::Imported },
+        };
+
+        std::vector<TestCopy> copies =
+        {
+            { 0, 1 },
+            { 1, 2 },
+            { 2, 3 },
+            { 3, 4 },
+        };
+
+        RenderGraph renderGraph = MakeCopyGraph(textures, copies, IdentityOrder(copies.size()));
+        FlattenAndCountTransitions(renderGraph, FlattenScheduler::Default);
+        const ResourceAliasingPlan& plan = renderGraph.aliasingPlan;
+
+        auto FindLifetime = [&plan](int nodeIndex) -> const ResourceLifetime*
+        {
+            for (const ResourceLifetime& lifetime : plan.lifetimes)
+            {
+                if (lifetime.nodeIndex == nodeIndex)
+                    return &lifetime;
+            }
+            return nullptr;
+        };
+
+        const ResourceLifetime* t0 = FindLifetime(1);
+        const ResourceLifetime* t1 = FindLifetime(2);
+        const ResourceLifetime* t2 = FindLifetime(3);
+        UNITTEST_CHECK(t0 && t1 && t2 && plan.lifetimes.size() == 3, "Expected T0, T1 and T2 to be aliasable, and nothing else (%i lifetimes)", (int)plan.lifetimes.size());
+
+        // 256 RGBA8 pixels a row is 1KB, 128 R8 pixels is padded to 256 bytes, and 512 RGBA16F pixels is 4KB.
+        UNITTEST_CHECK(t0->sizeInBytes == 256 * 1024 && t2->sizeInBytes == 64 * 1024, "Wrong sizes for T0 (%i) and T2 (%i)", (int)t0->sizeInBytes, (int)t2->sizeInBytes);
+        UNITTEST_CHECK(t1->sizeInBytes == (t1SizeKnown ? 2 * 1024 * 1024 : 0), "Wrong size for T1 (%i)", (int)t1->sizeInBytes);
+
+        UNITTEST_CHECK(t0->aliasGroup == t2->aliasGroup && t0->aliasGroup != t1->aliasGroup, "T0 and T2 should share an alias group that T1 isn't in (%i %i %i)", t0->aliasGroup, t1->aliasGroup, t2->aliasGroup);
+
+        // Every placed group is aligned, and inside the heap. Groups of resources in use at the same time don't overlap in memory.
+        for (const ResourceLifetime& a : plan.lifetimes)
+        {
+            const ResourceAliasGroup& groupA = plan.groups[a.aliasGroup];
+            UNITTEST_CHECK(a.sizeInBytes != 0 || !groupA.placed, "Group %i is placed, but node %i in it has an unknown size", a.aliasGroup, a.nodeIndex);
+            if (!groupA.placed)
+                continue;
+
+            UNITTEST_CHECK(a.sizeInBytes <= groupA.sizeInBytes, "Node %i is larger than its group", a.nodeIndex);
+            UNITTEST_CHECK(groupA.heapOffset % a.alignment == 0, "Group %i isn't aligned", a.aliasGroup);
+            UNITTEST_CHECK(groupA.heapOffset + groupA.sizeInBytes <= plan.heapSizes[(int)a.heapClass], "Group %i is past the end of its heap", a.aliasGroup);
+
+            for (const ResourceLifetime& b : plan.lifetimes)
+            {
+                const ResourceAliasGroup& groupB = plan.groups[b.aliasGroup];
+                if (&a == &b || !groupB.placed || a.heapClass != b.heapClass)
+                    continue;
+
+                bool lifetimesOverlap = a.firstStep <= b.lastStep && b.firstStep <= a.lastStep;
+                bool memoryOverlaps = groupA.heapOffset < groupB.heapOffset + groupB.sizeInBytes && groupB.heapOffset < groupA.heapOffset + groupA.sizeInBytes;
+                UNITTEST_CHECK(!lifetimesOverlap || !memoryOverlaps, "Nodes %i and %i are in use at the same time, in the same memory", a.nodeIndex, b.nodeIndex);
+            }
+        }
+
+        const ResourceAliasGroup& sharedGroup = plan.groups[t0->aliasGroup];
+        const ResourceAliasGroup& t1Group = plan.groups[t1->aliasGroup];
+        UNITTEST_CHECK(sharedGroup.placed && sharedGroup.sizeInBytes == t0->sizeInBytes, "The group of T0 and T2 should be placed, and as large as T0 (%i)", (int)sharedGroup.sizeInBytes);
+        UNITTEST_CHECK(t1Group.placed == t1SizeKnown, "The group of T1 has placed = %i, but T1's size is %s", (int)t1Group.placed, t1SizeKnown ? "known" : "unknown");
+
+        size_t expectedHeapSize = t1SizeKnown ? t0->sizeInBytes + t1->sizeInBytes : t0->sizeInBytes;
+        UNITTEST_CHECK(plan.heapSizes[(int)ResourceHeapClass::Texture] == expectedHeapSize, "Texture heap is %i bytes, expected %i", (int)plan.heapSizes[(int)ResourceHeapClass::Texture], (int)expectedHeapSize);
+    }
+
+    return true;
+}
+
+// Index buffers are read, not written, so a transient buffer whose first use is as an index buffer needs its contents kept around,
+// and can't be aliased. One that a copy writes before a draw call uses it as an index buffer can be.
+static bool TestAliasingWithIndexBuffers()
+{
+    const char* bufferNames[] = { "ImportedIndices", "CopiedIndices", "UninitializedIndices" };
+    RenderGraph renderGraph;
+    renderGraph.nodes.resize(6);
+    for (int bufferIndex = 0; bufferIndex < 3; ++bufferIndex)
+    {
+        RenderGraphNode& node = renderGraph.nodes[bufferIndex];
+        node._index = RenderGraphNode::c_index_resourceBuffer;
+        node.resourceBuffer.name = bufferNames[bufferIndex];
+        node.resourceBuffer.visibility = (bufferIndex == 0) ? ResourceVisibility::Imported : ResourceVisibility::Internal;
+        node.resourceBuffer.nodeIndex = bufferIndex;
+    }
+
+    RenderGraphNode_Action_CopyResource& copyNode = renderGraph.nodes[3].actionCopyResource;
+    renderGraph.nodes[3]._index = RenderGraphNode::c_index_actionCopyResource;
+    copyNode.name = "Copy";
+    copyNode.nodeIndex = 3;
+    copyNode.source.node = "ImportedIndices";
+    copyNode.source.nodeIndex = 0;
+    copyNode.source.nodePinIndex = 0;
+    copyNode.dest.node = "CopiedIndices";
+    copyNode.dest.nodeIndex = 1;
+    copyNode.dest.nodePinIndex = 0;
+
+    // DrawA reads UninitializedIndices, and DrawB reads CopiedIndices through the copy's dest pin
+    const char* drawNames[] = { "DrawA", "DrawB" };
+    const int indexBufferNodes[] = { 2, 3 };
+    const int indexBufferPins[] = { 0, 1 };
+    for (int drawIndex = 0; drawIndex < 2; ++drawIndex)
+    {
+        RenderGraphNode& node = renderGraph.nodes[drawIndex + 4];
+        node._index = RenderGraphNode::c_index_actionDrawCall;
+        node.actionDrawCall.name = drawNames[drawIndex];
+        node.actionDrawCall.nodeIndex = drawIndex + 4;
+        node.actionDrawCall.indexBuffer.node = GetNodeName(renderGraph.nodes[indexBufferNodes[drawIndex]]);
+        node.actionDrawCall.indexBuffer.nodeIndex = indexBufferNodes[drawIndex];
+        node.actionDrawCall.indexBuffer.nodePinIndex = indexBufferPins[drawIndex];
+    }
+
+    FlattenAndCountTransitions(renderGraph, FlattenScheduler::Default);
+    const ResourceAliasingPlan& plan = renderGraph.aliasingPlan;
+
+    UNITTEST_CHECK(plan.lifetimes.size() == 1 && plan.lifetimes[0].nodeIndex == 1, "Expected CopiedIndices to be aliasable, and nothing else (%i lifetimes)", (int)plan.lifetimes.size());
+    UNITTEST_CHECK(plan.lifetimes[0].lastStep > plan.lifetimes[0].firstStep, "CopiedIndices should be in use from the copy through DrawB, not for steps %i to %i", plan.lifetimes[0].firstStep, plan.lifetimes[0].lastStep);
+
+    return true;
+}
+
+// Fails on the variable with the name given, and counts the variables it visits
+struct FailOnVariableVisitor
+{
+    static constexpr VisitorAccess c_access = VisitorAccess().Reads(VisitorData_Names);
+
+    template <typename TDATA>
+    bool Visit(TDATA& data, const VisitPath& path)
+    {
+        return true;
+    }
+
+    bool Visit(Variable& variable, const VisitPath& path)
+    {
+        visitCount++;
+        return variable.name != failName;
+    }
+
+    const char* failName = "";
+    int visitCount = 0;
+};
+
+// If visitors sharing a traversal fail on different things, the one reported must be the one that would fail if they ran one after another.
+// Here the second visitor fails on the first variable, but the first visitor would have failed on the second variable before the second visitor ran.
+static bool TestFusedVisitorFailsLikeSequential()
+{
+    RenderGraph renderGraph;
+    renderGraph.variables.resize(2);
+    renderGraph.variables[0].name = "Early";
+    renderGraph.variables[1].name = "Late";
+
+    FailOnVariableVisitor failLate;
+    failLate.failName = "Late";
+    FailOnVariableVisitor failEarly;
+    failEarly.failName = "Early";
+
+    FusedVisitor<FailOnVariableVisitor, FailOnVariableVisitor> visitor(failLate, failEarly);
+    Visit(renderGraph, visitor, "renderGraph");
+
+    UNITTEST_CHECK(visitor.FailedIndex() == 0, "Visitor %i was reported as failing, but visitor 0 would fail first", visitor.FailedIndex());
+    UNITTEST_CHECK(failLate.visitCount == 2, "The first visitor visited %i variables, not both", failLate.visitCount);
+    UNITTEST_CHECK(failEarly.visitCount == 1, "The second visitor visited %i variables after failing on the first", failEarly.visitCount);
+
+    return true;
+}
+
+struct WritesNames { static constexpr VisitorAccess c_access = VisitorAccess().Writes(VisitorData_Names); };
+struct ReadsNames { static constexpr VisitorAccess c_access = VisitorAccess().Reads(VisitorData_Names); };
+struct ReadsNamesAnywhere { static constexpr VisitorAccess c_access = VisitorAccess().ReadsAnywhere(VisitorData_Names); };
+
+// Visitors which read anywhere what an earlier visitor writes need it to have finished first, so start a new traversal.
+// These are the visitors that GigiCompile() gives to one RunVisitorPasses() call. ShaderData adds nodes, Validation resolves enum references,
+// and ReferenceFixup reads and writes references on nodes other than the one it is visiting.
+static bool TestVisitorGroups()
+{
+    constexpr size_t namesGroupEnd0 = VisitorGroupEnd<WritesNames, ReadsNames, ReadsNamesAnywhere>(0);
+    constexpr size_t namesGroupEnd2 = VisitorGroupEnd<WritesNames, ReadsNames, ReadsNamesAnywhere>(2);
+    UNITTEST_CHECK(namesGroupEnd0 == 2 && namesGroupEnd2 == 3, "Expected groups [0,2) and [2,3), got [0,%i) and [2,%i)", (int)namesGroupEnd0, (int)namesGroupEnd2);
+
+    constexpr size_t groupEnd0 = VisitorGroupEnd<ShaderDataVisitor, ValidationVisitor, ReferenceFixupVisitor, DepluralizeFileCopiesVisitor, ErrorCheckVisitor, AddNodeInfoToShadersVisitor, DfltFixupVisitor, DataFixupVisitor>(0);
+    constexpr size_t groupEnd1 = VisitorGroupEnd<ShaderDataVisitor, ValidationVisitor, ReferenceFixupVisitor, DepluralizeFileCopiesVisitor, ErrorCheckVisitor, AddNodeInfoToShadersVisitor, DfltFixupVisitor, DataFixupVisitor>(1);
+    constexpr size_t groupEnd2 = VisitorGroupEnd<ShaderDataVisitor, ValidationVisitor, ReferenceFixupVisitor, DepluralizeFileCopiesVisitor, ErrorCheckVisitor, AddNodeInfoToShadersVisitor, DfltFixupVisitor, DataFixupVisitor>(2);
+    constexpr size_t groupEnd4 = VisitorGroupEnd<ShaderDataVisitor, ValidationVisitor, ReferenceFixupVisitor, DepluralizeFileCopiesVisitor, ErrorCheckVisitor, AddNodeInfoToShadersVisitor, DfltFixupVisitor, DataFixupVisitor>(4);
+    UNITTEST_CHECK(groupEnd0 == 1 && groupEnd1 == 2 && groupEnd2 == 4 && groupEnd4 == 8,
+        "Expected ShaderData, Validation, ReferenceFixup with DepluralizeFileCopies, then the last four together. Got [0,%i), [1,%i), [2,%i) and [4,%i)",
+        (int)groupEnd0, (int)groupEnd1, (int)groupEnd2, (int)groupEnd4);
+
+    constexpr size_t sanitizeGroupEnd = VisitorGroupEnd<SanitizeVisitor, ShaderFileDuplicationVisitor>(0);
+    UNITTEST_CHECK(sanitizeGroupEnd == 2, "Expected Sanitize and ShaderFileDuplication to share a traversal, got [0,%i)", (int)sanitizeGroupEnd);
+
+    return true;
+}
+
+// Runs the visitors like RunVisitorPasses() does, sharing traversals where VisitorGroupEnd() allows. Returns the index of the visitor that failed, or -1.
+template <size_t BEGIN, typename... TVISITORS>
+static int VisitFusedGroups(RenderGraph& renderGraph, std::tuple<TVISITORS&...>& visitors)
+{
+    if constexpr (BEGIN == sizeof...(TVISITORS))
+    {
+        return -1;
+    }
+    else
+    {
+        constexpr size_t END = VisitorGroupEnd<TVISITORS...>(BEGIN);
+        int failedIndex = VisitFusedGroup<BEGIN>(renderGraph, visitors, "renderGraph", std::make_index_sequence<END - BEGIN>());
+        return (failedIndex != -1) ? failedIndex : VisitFusedGroups<END>(renderGraph, visitors);
+    }
+}
+
+// Runs the visitors one after another, each with a traversal of its own. Returns the index of the visitor that failed, or -1.
+template <typename... TVISITORS>
+static int VisitSequentially(RenderGraph& renderGraph, TVISITORS&... visitors)
+{
+    int failedIndex = -1;
+    int index = 0;
+    ((failedIndex == -1 && !Visit(renderGraph, visitors, "renderGraph") ? failedIndex = index : 0, index++), ...);
+    return failedIndex;
+}
+
+template <typename... TVISITORS>
+static int RunVisitors(RenderGraph& renderGraph, bool fused, TVISITORS&... visitors)
+{
+    if (!fused)
+        return VisitSequentially(renderGraph, visitors...);
+
+    std::tuple<TVISITORS&...> visitorTuple(visitors...);
+    return VisitFusedGroups<0>(renderGraph, visitorTuple);
+}
+
+// The visitor passes of GigiCompile(), without the ones that need files on disk. Returns the name of the visitor that failed, or nullptr.
+static const char* RunCompileVisitors(RenderGraph& renderGraph, bool fused)
+{
+    {
+        SanitizeVisitor sanitizeVisitor(renderGraph);
+        ShaderFileDuplicationVisitor shaderFileDuplicationVisitor(renderGraph);
+        static const char* c_names[] = { "Sanitize", "ShaderFileDuplication" };
+        int failedIndex = RunVisitors(renderGraph, fused, sanitizeVisitor, shaderFileDuplicationVisitor);
+        if (failedIndex != -1)
+            return c_names[failedIndex];
+    }
+
+    InvalidateSymbolTable(renderGraph);
+
+    {
+        ShaderReferenceFixupVisitor visitor(renderGraph);
+        if (RunVisitors(renderGraph, fused, visitor) != -1)
+            return "ShaderReferenceFixup";
+    }
+
+    {
+        ShaderDataVisitor shaderDataVisitor(renderGraph);
+        ValidationVisitor validationVisitor(renderGraph);
+        ReferenceFixupVisitor referenceFixupVisitor(renderGraph);
+        DepluralizeFileCopiesVisitor depluralizeFileCopiesVisitor;
+        ErrorCheckVisitor errorCheckVisitor;
+        AddNodeInfoToShadersVisitor addNodeInfoToShadersVisitor;
+        DfltFixupVisitor dfltFixupVisitor;
+        DataFixupVisitor dataFixupVisitor;
+        static const char* c_names[] = { "ShaderData", "Validation", "ReferenceFixup", "DepluralizeFileCopies", "ErrorCheck", "AddNodeInfoToShaders", "DfltFixup", "DataFixup" };
+        int failedIndex = RunVisitors(renderGraph, fused,
+            shaderDataVisitor, validationVisitor, referenceFixupVisitor, depluralizeFileCopiesVisitor, errorCheckVisitor, addNodeInfoToShadersVisitor, dfltFixupVisitor, dataFixupVisitor);
+        if (failedIndex != -1)
+            return c_names[failedIndex];
+    }
+
+    return nullptr;
+}
+
+// operator== skips fields that aren't serialized, which is most of what ReferenceFixupVisitor calculates, so those are gathered up to compare separately.
+struct CollectCalculatedIndicesVisitor
+{
+    template <typename TDATA>
+    bool Visit(TDATA& data, const VisitPath& path)
+    {
+        return true;
+    }
+
+    bool Visit(TextureNodeReference& data, const VisitPath& path)
+    {
+        indices.insert(indices.end(), { data.nodeIndex, data.textureNode ? data.textureNode->nodeIndex : -1 });
+        return true;
+    }
+
+    bool Visit(BufferNodeReference& data, const VisitPath& path)
+    {
+        indices.insert(indices.end(), { data.nodeIndex, data.bufferNode ? data.bufferNode->nodeIndex : -1 });
+        return true;
+    }
+
+    bool Visit(TextureOrBufferNodeReference& data, const VisitPath& path)
+    {
+        indices.insert(indices.end(), { data.nodeIndex, data.textureNode ? data.textureNode->nodeIndex : -1, data.bufferNode ? data.bufferNode->nodeIndex : -1 });
+        return true;
+    }
+
+    bool Visit(NodePinReference& data, const VisitPath& path)
+    {
+        indices.insert(indices.end(), { data.nodeIndex, data.nodePinIndex, data.resourceNodeIndex });
+        return true;
+    }
+
+    bool Visit(NodePinReferenceOptional& data, const VisitPath& path)
+    {
+        indices.insert(indices.end(), { data.nodeIndex, data.nodePinIndex, data.resourceNodeIndex });
+        return true;
+    }
+
+    bool Visit(NodePinConnection& data, const VisitPath& path)
+    {
+        indices.insert(indices.end(), { data.srcNodePinIndex, data.dstNodeIndex, data.dstNodePinIndex });
+        return true;
+    }
+
+    bool Visit(Condition& data, const VisitPath& path)
+    {
+        indices.insert(indices.end(), { data.variable1Index, data.variable2Index });
+        return true;
+    }
+
+    bool Visit(VariableReference& data, const VisitPath& path)
+    {
+        indices.push_back(data.variableIndex);
+        return true;
+    }
+
+    bool Visit(VariableReferenceNoConst& data, const VisitPath& path)
+    {
+        indices.push_back(data.variableIndex);
+        return true;
+    }
+
+    bool Visit(StructReference& data, const VisitPath& path)
+    {
+        indices.push_back(data.structIndex);
+        return true;
+    }
+
+    bool Visit(ComputeShaderReference& data, const VisitPath& path)
+    {
+        indices.push_back(data.shaderIndex);
+        return true;
+    }
+
+    bool Visit(Shader& data, const VisitPath& path)
+    {
+        indices.push_back((int)data.tokenReplacements.size());
+        return true;
+    }
+
+    std::vector<int> indices;
+};
+
+// A compute shader writing to a texture and reading a structured buffer, with its output copied to another texture.
+// The names need sanitizing, and there are references to nodes, pins, variables, structs and shaders for the fixup visitors to resolve.
+static RenderGraph MakeVisitorTestGraph()
+{
+    RenderGraph renderGraph;
+    renderGraph.name = "VisitorTest";
+
+    renderGraph.variables.resize(2);
+    renderGraph.variables[0].name = "Scale";
+    renderGraph.variables[0].type = DataFieldType::Float;
+    renderGraph.variables[0].dflt = "2";
+    renderGraph.variables[1].name = "Frame Count";
+    renderGraph.variables[1].type = DataFieldType::Int;
+
+    renderGraph.structs.resize(1);
+    renderGraph.structs[0].name = "Params";
+    renderGraph.structs[0].fields.resize(2);
+    renderGraph.structs[0].fields[0].name = "Position";
+    renderGraph.structs[0].fields[0].type = DataFieldType::Float3;
+    renderGraph.structs[0].fields[1].name = "Weight";
+    renderGraph.structs[0].fields[1].type = DataFieldType::Float;
+
+    renderGraph.shaders.resize(1);
+    Shader& shader = renderGraph.shaders[0];
+    shader.name = "Fill CS";
+    shader.fileName = "Fill.hlsl";
+    shader.entryPoint = "main";
+    shader.copyFile = false;
+    shader.resources.resize(2);
+    shader.resources[0].name = "Output";
+    shader.resources[0].type = ShaderResourceType::Texture;
+    shader.resources[0].access = ShaderResourceAccessType::UAV;
+    shader.resources[1].name = "Input";
+    shader.resources[1].type = ShaderResourceType::Buffer;
+    shader.resources[1].access = ShaderResourceAccessType::SRV;
+    shader.resources[1].buffer.typeStruct.name = "Params";
+
+    renderGraph.nodes.resize(5);
+
+    renderGraph.nodes[0]._index = RenderGraphNode::c_index_resourceTexture;
+    renderGraph.nodes[0].resourceTexture.name = "Color Tex";
+    renderGraph.nodes[0].resourceTexture.format.format = TextureFormat::RGBA8_Unorm;
+    renderGraph.nodes[0].resourceTexture.size.multiply[0] = 64;
+    renderGraph.nodes[0].resourceTexture.size.multiply[1] = 64;
+
+    renderGraph.nodes[1]._index = RenderGraphNode::c_index_resourceBuffer;
+    renderGraph.nodes[1].resourceBuffer.name = "Buf";
+    renderGraph.nodes[1].resourceBuffer.visibility = ResourceVisibility::Imported;
+    renderGraph.nodes[1].resourceBuffer.format.structureType.name = "Params";
+
+    renderGraph.nodes[2]._index = RenderGraphNode::c_index_actionComputeShader;
+    RenderGraphNode_Action_ComputeShader& dispatch = renderGraph.nodes[2].actionComputeShader;
+    dispatch.name = "Dispatch";
+    dispatch.shader.name = "Fill CS";
+    dispatch.dispatchSize.node.name = "Color Tex";
+    dispatch.connections.resize(2);
+    dispatch.connections[0].srcPin = "Output";
+    dispatch.connections[0].dstNode = "Color Tex";
+    dispatch.connections[0].dstPin = "resource";
+    dispatch.connections[1].srcPin = "Input";
+    dispatch.connections[1].dstNode = "Buf";
+    dispatch.connections[1].dstPin = "resource";
+    dispatch.condition.variable1 = "Scale";
+    dispatch.condition.comparison = ConditionComparison::GT;
+    dispatch.condition.value2 = "0";
+
+    renderGraph.nodes[3]._index = RenderGraphNode::c_index_resourceTexture;
+    renderGraph.nodes[3].resourceTexture.name = "Copy Dest";
+    renderGraph.nodes[3].resourceTexture.format.node.name = "Color Tex";
+    renderGraph.nodes[3].resourceTexture.size.node.name = "Color Tex";
+
+    renderGraph.nodes[4]._index = RenderGraphNode::c_index_actionCopyResource;
+    renderGraph.nodes[4].actionCopyResource.name = "Copy";
+    renderGraph.nodes[4].actionCopyResource.source.node = "Dispatch";
+    renderGraph.nodes[4].actionCopyResource.source.pin = "Output";
+    renderGraph.nodes[4].actionCopyResource.dest.node = "Copy Dest";
+    renderGraph.nodes[4].actionCopyResource.dest.pin = "resource";
+
+    renderGraph.setVars.resize(1);
+    renderGraph.setVars[0].destination.name = "Frame Count";
+    renderGraph.setVars[0].AVar.name = "Frame Count";
+    renderGraph.setVars[0].op = SetVariableOperator::Add;
+    renderGraph.setVars[0].BLiteral = "1";
+
+    renderGraph.buildSettings.disableWarnings.push_back(GigiCompileWarning::ShaderUnusedResource);
+
+    return renderGraph;
+}
+
+// Visitors sharing a traversal must leave the render graph exactly as running them one after another does
+static bool TestFusedVisitorsMatchSequential()
+{
+    RenderGraph sequentialGraph = MakeVisitorTestGraph();
+    const char* sequentialFailed = RunCompileVisitors(sequentialGraph, false);
+    UNITTEST_CHECK(sequentialFailed == nullptr, "%s failed when running the visitors one after another", sequentialFailed);
+
+    RenderGraph fusedGraph = MakeVisitorTestGraph();
+    const char* fusedFailed = RunCompileVisitors(fusedGraph, true);
+    UNITTEST_CHECK(fusedFailed == nullptr, "%s failed when running the visitors in shared traversals", fusedFailed);
+
+    UNITTEST_CHECK(fusedGraph == sequentialGraph, "The render graphs differ, with %i nodes fused and %i nodes sequential", (int)fusedGraph.nodes.size(), (int)sequentialGraph.nodes.size());
+
+    CollectCalculatedIndicesVisitor sequentialIndices;
+    Visit(sequentialGraph, sequentialIndices, "renderGraph");
+    CollectCalculatedIndicesVisitor fusedIndices;
+    Visit(fusedGraph, fusedIndices, "renderGraph");
+    UNITTEST_CHECK(fusedIndices.indices == sequentialIndices.indices, "The calculated indices differ, %i fused and %i sequential", (int)fusedIndices.indices.size(), (int)sequentialIndices.indices.size());
+
+    // Make sure the fixups ran, so the comparison above is comparing something
+    const RenderGraphNode_Action_CopyResource& copy = fusedGraph.nodes[4].actionCopyResource;
+    UNITTEST_CHECK(copy.source.nodeIndex == 2 && copy.source.resourceNodeIndex == 0, "The copy source resolved to node %i and resource node %i", copy.source.nodeIndex, copy.source.resourceNodeIndex);
+    UNITTEST_CHECK(fusedGraph.nodes[2].actionComputeShader.condition.variable1Index == 0, "The condition variable resolved to %i", fusedGraph.nodes[2].actionComputeShader.condition.variable1Index);
+
+    return true;
+}
+
+// ParseNumber() is meant to accept what sscanf does, and to ignore anything after the number
+static bool TestParseNumber()
+{
+    struct FloatCase
+    {
+        const char* text;
+        bool parses;
+        double value;
+    };
+
+    static const FloatCase c_floatCases[] =
+    {
+        { "+1.5", true, 1.5 },
+        { " \t-2.25", true, -2.25 },
+        { "0x1p3", true, 8.0 },
+        { "-0x1.8p1", true, -3.0 },
+        { "inf", true, INFINITY },
+        { "-INF", true, -INFINITY },
+        { "+Infinity", true, INFINITY },
+        { "1e999", true, INFINITY },
+        { "1.5f", true, 1.5 },
+        { "3e2,4", true, 300.0 },
+        { "7.", true, 7.0 },
+        { "", false, 0.0 },
+        { "+", false, 0.0 },
+        { "-.", false, 0.0 },
+        { "abc", false, 0.0 },
+    };
+
+    for (const FloatCase& floatCase : c_floatCases)
+    {
+        float floatValue = 0.0f;
+        double doubleValue = 0.0;
+        bool floatParsed = ParseText::ParseNumber(floatCase.text, floatValue);
+        bool doubleParsed = ParseText::ParseNumber(floatCase.text, doubleValue);
+        UNITTEST_CHECK(floatParsed == floatCase.parses && doubleParsed == floatCase.parses, "\"%s\" should %s", floatCase.text, floatCase.parses ? "parse" : "not parse");
+        if (floatCase.parses)
+            UNITTEST_CHECK(floatValue == (float)floatCase.value && doubleValue == floatCase.value, "\"%s\" parsed as %f and %f, not %f", floatCase.text, floatValue, doubleValue, floatCase.value);
+    }
+
+    // NaN isn't equal to itself, so is checked on its own
+    for (const char* text : { "nan", "-NaN", "nan(123)" })
+    {
+        float value = 0.0f;
+        UNITTEST_CHECK(ParseText::ParseNumber(text, value) && std::isnan(value), "\"%s\" should parse as NaN, not %f", text, value);
+    }
+
+    // Like %i: 0x is hex and a leading 0 is octal
+    struct IntCase
+    {
+        const char* text;
+        bool parses;
+        int value;
+    };
+
+    static const IntCase c_intCases[] =
+    {
+        { "+7", true, 7 },
+        { " -42", true, -42 },
+        { "-0x1A", true, -26 },
+        { "010", true, 8 },
+        { "09", true, 0 },
+        { "12abc", true, 12 },
+        { "5.9", true, 5 },
+        { "", false, 0 },
+        { "-", false, 0 },
+        { "x1", false, 0 },
+    };
+
+    for (const IntCase& intCase : c_intCases)
+    {
+        int value = 0;
+        bool parsed = ParseText::ParseNumber(intCase.text, value);
+        UNITTEST_CHECK(parsed == intCase.parses, "\"%s\" should %s as an int", intCase.text, intCase.parses ? "parse" : "not parse");
+        if (intCase.parses)
+            UNITTEST_CHECK(value == intCase.value, "\"%s\" parsed as %i, not %i", intCase.text, value, intCase.value);
+    }
+
+    // Like %u: decimal only, and negative numbers wrap around
+    struct UintCase
+    {
+        const char* text;
+        bool parses;
+        unsigned int value;
+    };
+
+    static const UintCase c_uintCases[] =
+    {
+        { "+7", true, 7 },
+        { "-1", true, 0xFFFFFFFF },
+        { "0x10", true, 0 },
+        { "5 apples", true, 5 },
+        { "", false, 0 },
+        { "+-1", false, 0 },
+    };
+
+    for (const UintCase& uintCase : c_uintCases)
+    {
+        unsigned int value = 0;
+        bool parsed = ParseText::ParseNumber(uintCase.text, value);
+        UNITTEST_CHECK(parsed == uintCase.parses, "\"%s\" should %s as a uint", uintCase.text, uintCase.parses ? "parse" : "not parse");
+        if (uintCase.parses)
+            UNITTEST_CHECK(value == uintCase.value, "\"%s\" parsed as %u, not %u", uintCase.text, value, uintCase.value);
+    }
+
+    // The string view ends the number, even if the memory after it has more digits
+    {
+        const char* text = "1234";
+        int value = 0;
+        UNITTEST_CHECK(ParseText::ParseNumber(std::string_view(text, 2), value) && value == 12, "The first two characters of \"%s\" parsed as %i, not 12", text, value);
+    }
+
+    return true;
+}
+
+// ForEachValueParallel() splits big files into chunks of lines, so the tokens either side of each split must come out the same as
+// when reading the whole file. The lines are different lengths, with both kinds of line ending, so the splits land on different kinds of token.
+static bool TestParseCSVChunkBoundaries()
+{
+    std::string csv = "a,b,c,d\n";
+    std::vector<float> expected;
+    char line[128];
+    for (int lineIndex = 0; csv.size() < 3 * 1024 * 1024; ++lineIndex)
+    {
+        snprintf(line, sizeof(line), "%i, +%i.5,\"0x%xp-1\",-%ie1%s", lineIndex, lineIndex, lineIndex, lineIndex, (lineIndex % 3 == 0) ? "\r\n" : "\n");
+        csv += line;
+        expected.insert(expected.end(), { (float)lineIndex, (float)lineIndex + 0.5f, (float)lineIndex / 2.0f, (float)lineIndex * -10.0f });
+    }
+
+    struct ChunkOutput
+    {
+        std::vector<int> tokenIndices;
+        std::vector<float> values;
+    };
+
+    std::vector<ChunkOutput> chunkOutputs;
+    bool success = ParseCSV::ForEachValueParallel(csv.c_str(), true, chunkOutputs,
+        [](ChunkOutput& chunkOutput, int tokenIndex, std::string_view token)
+        {
+            float value = 0.0f;
+            if (!ParseText::ParseNumber(token, value))
+                return false;
+            chunkOutput.tokenIndices.push_back(tokenIndex);
+            chunkOutput.values.push_back(value);
+            return true;
+        }
+    );
+    UNITTEST_CHECK(success, "A token failed to parse, in %i chunks", (int)chunkOutputs.size());
+    UNITTEST_CHECK(std::thread::hardware_concurrency() == 0 || chunkOutputs.size() > 1, "The %i bytes of csv weren't split into chunks", (int)csv.size());
+
+    size_t valueIndex = 0;
+    for (const ChunkOutput& chunkOutput : chunkOutputs)
+    {
+        for (size_t index = 0; index < chunkOutput.values.size(); ++index, ++valueIndex)
+        {
+            UNITTEST_CHECK(valueIndex < expected.size(), "There are more than the %i values expected", (int)expected.size());
+            UNITTEST_CHECK(chunkOutput.tokenIndices[index] == (int)valueIndex, "Token %i was given the index %i", (int)valueIndex, chunkOutput.tokenIndices[index]);
+            UNITTEST_CHECK(chunkOutput.values[index] == expected[valueIndex], "Token %i parsed as %f, not %f", (int)valueIndex, chunkOutput.values[index], expected[valueIndex]);
+        }
+    }
+    UNITTEST_CHECK(valueIndex == expected.size(), "Got %i values, not %i", (int)valueIndex, (int)expected.size());
+
+    return true;
+}
+
+// Compiles a shader to its own text with the includes pasted in, reading only lines like #include "file".
+// Includes are relative to the shader file, and missing ones are left out, but still reported as read.
+class StubShaderCompiler : public ShaderCompiler
+{
+public:
+    std::string GetIdentity() override
+    {
+        return "stub 1";
+    }
+
+    bool Compile(const ShaderCompileRequest& request, std::vector<unsigned char>& byteCode, std::vector<std::string>& filesRead) override
+    {
+        compileCount++;
+        byteCode.clear();
+        filesRead.clear();
+
+        std::filesystem::path directory = std::filesystem::path(request.fileName).parent_path();
+        filesRead.push_back(request.fileName);
+        if (!AppendFile(request.fileName, byteCode))
+            return false;
+
+        std::string source(byteCode.begin(), byteCode.end());
+        size_t includePos = 0;
+        while ((includePos = source.find("#include \"", includePos)) != std::string::npos)
+        {
+            size_t nameBegin = includePos + 10;
+            size_t nameEnd = source.find('"', nameBegin);
+            std::string includeFileName = (directory / source.substr(nameBegin, nameEnd - nameBegin)).string();
+            filesRead.push_back(includeFileName);
+            AppendFile(includeFileName, byteCode);
+            includePos = nameEnd;
+        }
+
+        for (const std::pair<std::string, std::string>& define : request.defines)
+            byteCode.insert(byteCode.end(), define.second.begin(), define.second.end());
+
+        // Big enough that a few entries go over the budget of the eviction test
+        byteCode.resize(byteCode.size() + 1000, 0);
+        return true;
+    }
+
+    int compileCount = 0;
+
+private:
+    static bool AppendFile(const std::string& fileName, std::vector<unsigned char>& data)
+    {
+        std::ifstream file(fileName, std::ios::binary);
+        if (!file)
+            return false;
+        data.insert(data.end(), std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+};
+
+static void WriteTestFile(const std::filesystem::path& fileName, const char* contents)
+{
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    file << contents;
+}
+
+// A compile hits only if the request, the shader file and every include it read, or tried to read, are the same as when it was stored
+static bool TestShaderCacheHits(const std::filesystem::path& testDirectory, ShaderCompileRequest& request)
+{
+    StubShaderCompiler compiler;
+    ShaderCache cache((testDirectory / "Cache").string(), 1024 * 1024);
+    std::vector<unsigned char> compiledByteCode;
+    std::vector<unsigned char> byteCode;
+    std::vector<std::string> allFiles;
+
+    // Miss, then hit, with the same bytecode and files read
+    UNITTEST_CHECK(cache.Compile(compiler, request, compiledByteCode, nullptr), "Compiling %s failed", request.fileName.c_str());
+    UNITTEST_CHECK(cache.Compile(compiler, request, byteCode, &allFiles), "Compiling %s from the cache failed", request.fileName.c_str());
+    UNITTEST_CHECK(compiler.compileCount == 1 && cache.GetHits() == 1 && cache.GetMisses() == 1, "Expected 1 compile, 1 hit and 1 miss, got %i, %i and %i", compiler.compileCount, cache.GetHits(), cache.GetMisses());
+    UNITTEST_CHECK(byteCode == compiledByteCode, "The cached bytecode is %i bytes, not the %i compiled", (int)byteCode.size(), (int)compiledByteCode.size());
+    UNITTEST_CHECK(allFiles.size() == 3, "The hit gave %i files read, not the shader and both includes", (int)allFiles.size());
+
+    // A different define is a different key
+    request.defines[0].second = "2";
+    cache.Compile(compiler, request, byteCode, nullptr);
+    UNITTEST_CHECK(compiler.compileCount == 2, "Changing a define gave %i compiles, not 2", compiler.compileCount);
+    request.defines[0].second = "1";
+    cache.Compile(compiler, request, byteCode, nullptr);
+    UNITTEST_CHECK(compiler.compileCount == 2, "Changing a define back gave %i compiles, instead of hitting the first entry", compiler.compileCount);
+
+    // Changing an include invalidates the entry, even though the shader file and request are the same
+    WriteTestFile(testDirectory / "Shaders" / "Common.hlsli", "common 2\n");
+    cache.Compile(compiler, request, byteCode, nullptr);
+    UNITTEST_CHECK(compiler.compileCount == 3, "Changing an include gave %i compiles, not 3", compiler.compileCount);
+    std::string byteCodeText(byteCode.begin(), byteCode.end());
+    UNITTEST_CHECK(byteCodeText.find("common 2") != std::string::npos, "The %i bytes of bytecode are from the old include", (int)byteCode.size());
+
+    // So does making an include that wasn't there
+    WriteTestFile(testDirectory / "Shaders" / "Optional.hlsli", "optional\n");
+    cache.Compile(compiler, request, byteCode, nullptr);
+    UNITTEST_CHECK(compiler.compileCount == 4, "Making a missing include gave %i compiles, not 4", compiler.compileCount);
+    cache.Compile(compiler, request, byteCode, nullptr);
+    UNITTEST_CHECK(compiler.compileCount == 4, "The compile after making the include gave %i compiles, instead of hitting", compiler.compileCount);
+
+    return true;
+}
+
+// Stores that go over the budget evict the least recently used entries, but not the one just stored
+static bool TestShaderCacheEviction(const std::filesystem::path& testDirectory, ShaderCompileRequest& request)
+{
+    // About three entries
+    const uint64_t maxBytes = 4000;
+
+    StubShaderCompiler compiler;
+    ShaderCache cache((testDirectory / "EvictionCache").string(), maxBytes);
+    std::vector<unsigned char> byteCode;
+    for (int index = 0; index < 10; ++index)
+    {
+        request.defines[0].second = std::to_string(index);
+        UNITTEST_CHECK(cache.Compile(compiler, request, byteCode, nullptr), "Compile %i failed", index);
+
+        uint64_t totalBytes = 0;
+        for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(testDirectory / "EvictionCache"))
+            totalBytes += entry.file_size();
+        UNITTEST_CHECK(totalBytes <= maxBytes, "After compile %i the cache is %i bytes, over the budget of %i", index, (int)totalBytes, (int)maxBytes);
+
+        int compileCount = compiler.compileCount;
+        cache.Compile(compiler, request, byteCode, nullptr);
+        UNITTEST_CHECK(compiler.compileCount == compileCount, "The entry stored by compile %i was evicted", index);
+    }
+    UNITTEST_CHECK(cache.GetMisses() == 10, "Expected every new define to miss, got %i misses", cache.GetMisses());
+
+    return true;
+}
+
+// Drives ShaderCache with a stub compiler, in a directory of its own in the temp directory
+static bool TestShaderCache()
+{
+    std::error_code ec;
+    std::filesystem::path testDirectory = std::filesystem::temp_directory_path(ec) / "Gigi" / "ShaderCacheUnitTest";
+    UNITTEST_CHECK(!ec, "Could not get the temp directory: %s", ec.message().c_str());
+    std::filesystem::remove_all(testDirectory, ec);
+    std::filesystem::create_directories(testDirectory / "Shaders", ec);
+    UNITTEST_CHECK(!ec, "Could not make %s", (testDirectory / "Shaders").string().c_str());
+
+    WriteTestFile(testDirectory / "Shaders" / "Main.hlsl", "#include \"Common.hlsli\"\n#include \"Optional.hlsli\"\nmain\n");
+    WriteTestFile(testDirectory / "Shaders" / "Common.hlsli", "common 1\n");
+
+    ShaderCompileRequest request;
+    request.fileName = (testDirectory / "Shaders" / "Main.hlsl").string();
+    request.entryPoint = "main";
+    request.shaderModel = "cs_6_0";
+    request.defines.push_back({ "VALUE", "1" });
+
+    bool ret = TestShaderCacheHits(testDirectory, request) && TestShaderCacheEviction(testDirectory, request);
+
+    std::filesystem::remove_all(testDirectory, ec);
+    return ret;
+}
+
+bool RunCompilerUnitTests()
+{
+    struct UnitTest
+    {
+        const char* name;
+        bool (*function)();
+    };
+
+    static const UnitTest c_unitTests[] =
+    {
+        { "SchedulersWithImportedResources", TestSchedulersWithImportedResources },
+        { "ExhaustiveWithFullMemo", TestExhaustiveWithFullMemo },
+        { "BeamMergesOnlyEquivalentOrderings", TestBeamMergesOnlyEquivalentOrderings },
+        { "HazardDependenciesWithIndexBuffer", TestHazardDependenciesWithIndexBuffer },
+        { "AliasingPlanOffsets", TestAliasingPlanOffsets },
+        { "AliasingWithIndexBuffers", TestAliasingWithIndexBuffers },
+        { "FusedVisitorFailsLikeSequential", TestFusedVisitorFailsLikeSequential },
+        { "VisitorGroups", TestVisitorGroups },
+        { "FusedVisitorsMatchSequential", TestFusedVisitorsMatchSequential },
+        { "ParseNumber", TestParseNumber },
+        { "ParseCSVChunkBoundaries", TestParseCSVChunkBoundaries },
+        { "ShaderCache", TestShaderCache },
+    };
+
+    int failedCount = 0;
+    for (const UnitTest& unitTest : c_unitTests)
+    {
+        if (!unitTest.function())
+        {
+            ShowErrorMessage("Compiler unit test %s failed", unitTest.name);
+            failedCount++;
+        }
+    }
+
+    if (failedCount > 0)
+    {
+        ShowErrorMessage("%i of %i compiler unit tests failed", failedCount, (int)(sizeof(c_unitTests) / sizeof(c_unitTests[0])));
+        return false;
+    }
+
+    ShowInfoMessage("%i compiler unit tests passed", (int)(sizeof(c_unitTests) / sizeof(c_unitTests[0])));
+    return true;
+}
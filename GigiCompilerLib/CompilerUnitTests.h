@@ -0,0 +1,11 @@
+///////////////////////////////////////////////////////////////////////////////
+//         Gigi Rapid Graphics Prototyping and Code Generation Suite         //
+//        Copyright (c) 2024 Electronic Arts Inc. All rights reserved.       //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Tests of compiler internals whose results don't show up directly in generated code, like which node ordering the schedulers find.
+// Run by GigiCompiler.exe -unittests, which MakeCode_UnitTests_DX12.py does before generating code.
+// Returns false if any test failed. Failures are reported with ShowErrorMessage().
+bool RunCompilerUnitTests();
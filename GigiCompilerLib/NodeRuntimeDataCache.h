@@ -0,0 +1,118 @@
+///////////////////////////////////////////////////////////////////////////////
+//         Gigi Rapid Graphics Prototyping and Code Generation Suite         //
+//        Copyright (c) 2024 Electronic Arts Inc. All rights reserved.       //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Runtime data for render graph nodes, stored densely and addressed by node index.
+// A node is bound to a slot the first time it is seen, after which looking it up by node index is an array access.
+// Lookups by name (UI, python) go through a side index from node name to slot.
+// Storage is a deque so references handed out stay valid as more nodes are bound.
+template <typename TStorage>
+class NodeRuntimeDataCache
+{
+public:
+    void Clear()
+    {
+        m_storage.clear();
+        m_slotByNodeIndex.clear();
+        m_slotByName.clear();
+    }
+
+    TStorage& GetOrCreate(int nodeIndex, const std::string& name)
+    {
+        if (nodeIndex >= 0 && nodeIndex < (int)m_slotByNodeIndex.size() && m_slotByNodeIndex[nodeIndex] != -1)
+            return m_storage[m_slotByNodeIndex[nodeIndex]];
+
+        int slot = GetOrCreateSlot(name);
+        if (nodeIndex >= 0)
+        {
+            if (nodeIndex >= (int)m_slotByNodeIndex.size())
+                m_slotByNodeIndex.resize(nodeIndex + 1, -1);
+            m_slotByNodeIndex[nodeIndex] = slot;
+        }
+
+        return m_storage[slot];
+    }
+
+    TStorage& GetOrCreate(const std::string& name)
+    {
+        return m_storage[GetOrCreateSlot(name)];
+    }
+
+    const TStorage& Get(int nodeIndex, bool& existed) const
+    {
+        static const TStorage c_invalid = {};
+        int slot = GetSlot(nodeIndex);
+        existed = (slot != -1);
+        return existed ? m_storage[slot] : c_invalid;
+    }
+
+    TStorage& Get(int nodeIndex, bool& existed)
+    {
+        static TStorage c_invalid = {};
+        int slot = GetSlot(nodeIndex);
+        existed = (slot != -1);
+        return existed ? m_storage[slot] : c_invalid;
+    }
+
+    const TStorage& Get(const std::string& name, bool& existed) const
+    {
+        static const TStorage c_invalid = {};
+        int slot = GetSlot(name);
+        existed = (slot != -1);
+        return existed ? m_storage[slot] : c_invalid;
+    }
+
+    TStorage& Get(const std::string& name, bool& existed)
+    {
+        static TStorage c_invalid = {};
+        int slot = GetSlot(name);
+        existed = (slot != -1);
+        return existed ? m_storage[slot] : c_invalid;
+    }
+
+    template <typename LAMBDA>
+    void ForEach(const LAMBDA& lambda)
+    {
+        for (TStorage& storage : m_storage)
+            lambda(storage);
+    }
+
+private:
+    int GetSlot(int nodeIndex) const
+    {
+        if (nodeIndex < 0 || nodeIndex >= (int)m_slotByNodeIndex.size())
+            return -1;
+        return m_slotByNodeIndex[nodeIndex];
+    }
+
+    int GetSlot(const std::string& name) const
+    {
+        auto it = m_slotByName.find(name);
+        return (it == m_slotByName.end()) ? -1 : it->second;
+    }
+
+    int GetOrCreateSlot(const std::string& name)
+    {
+        auto it = m_slotByName.find(name);
+        if (it != m_slotByName.end())
+            return it->second;
+
+        int slot = (int)m_storage.size();
+        m_storage.emplace_back();
+        m_slotByName[name] = slot;
+        return slot;
+    }
+
+private:
+    std::deque<TStorage> m_storage;
+    std::vector<int> m_slotByNodeIndex;
+    std::unordered_map<std::string, int> m_slotByName;
+};
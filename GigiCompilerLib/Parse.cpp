@@ -443,13 +443,19 @@ const char* strstrOptimized(const char* X, const char* Y, int m, int n)
 
 const char* stristrOptimized(const char* X, const char* Y, int m, int n)
 {
-	static char tab[256];
-	if (!tab[1])
+	// build table to avoid costly localization functions.
+	// A static local is initialized once even when compiles run on several threads.
+	struct UpperTable
 	{
-		// build table to avoid costly localization functions
-		for (int i = 1; i < 256; ++i)
-			tab[i] = toupper(i);
-	}
+		char tab[256] = {};
+		UpperTable()
+		{
+			for (int i = 1; i < 256; ++i)
+				tab[i] = toupper(i);
+		}
+	};
+	static const UpperTable s_upperTable;
+	const char* tab = s_upperTable.tab;
 
 	// base case 1: `Y` is NULL or empty
 	if (*Y == '\0' || n == 0) {
@@ -91,4 +91,68 @@ namespace ParseCSV
 
 		return true;
 	}
+
+	// Like ForEachValue, but for large files. The tokens aren't copied into strings, and are handled on multiple threads.
+	// The text is split into chunks of whole lines. Each chunk gets its own TChunkOutput, which the caller combines in chunk order afterwards.
+	// lambda(TChunkOutput& chunkOutput, int tokenIndex, std::string_view token) is called in order within a chunk, with the same tokenIndex ForEachValue would give.
+	template <typename TChunkOutput, typename LAMBDA>
+	bool ForEachValueParallel(const char* csv, bool skipHeader, std::vector<TChunkOutput>& chunkOutputs, const LAMBDA& lambda)
+	{
+		chunkOutputs.clear();
+		if (!csv)
+			return true;
+
+		std::string_view csvData = csv;
+		if (skipHeader)
+			csvData = SkipToNewLine(csvData);
+
+		std::vector<std::string_view> chunks = SplitIntoLineChunks(csvData);
+		chunkOutputs.resize(chunks.size());
+
+		// Count the tokens in each chunk, to know the token index each chunk starts at
+		std::vector<int> chunkTokenIndex(chunks.size(), 0);
+		if (chunks.size() > 1)
+		{
+			ForEachChunkParallel(chunks.size(),
+				[&](size_t chunkIndex)
+				{
+					std::string_view chunk = chunks[chunkIndex];
+					std::string_view token;
+					int tokenCount = 0;
+					while (GetNextCSVToken(chunk, token))
+						tokenCount++;
+					chunkTokenIndex[chunkIndex] = tokenCount;
+				}
+			);
+
+			int tokenIndex = 0;
+			for (int& index : chunkTokenIndex)
+			{
+				int tokenCount = index;
+				index = tokenIndex;
+				tokenIndex += tokenCount;
+			}
+		}
+
+		std::atomic<bool> success = true;
+		ForEachChunkParallel(chunks.size(),
+			[&](size_t chunkIndex)
+			{
+				std::string_view chunk = chunks[chunkIndex];
+				std::string_view token;
+				int tokenIndex = chunkTokenIndex[chunkIndex];
+				while (success && GetNextCSVToken(chunk, token))
+				{
+					if (!lambda(chunkOutputs[chunkIndex], tokenIndex, token))
+					{
+						success = false;
+						return;
+					}
+					tokenIndex++;
+				}
+			}
+		);
+
+		return success;
+	}
 }
\ No newline at end of file
@@ -6,6 +6,13 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cctype>
 
 namespace ParseText
 {
@@ -24,6 +31,19 @@ namespace ParseText
 		return c == '\'' || c == '\"';
 	}
 
+	inline bool EqualsNoCase(const std::string_view& a, const std::string_view& b)
+	{
+		if (a.length() != b.length())
+			return false;
+
+		for (size_t i = 0; i < a.length(); ++i)
+		{
+			if (std::tolower((unsigned char)a[i]) != std::tolower((unsigned char)b[i]))
+				return false;
+		}
+		return true;
+	}
+
 	inline std::string_view SkipToNewLine(const std::string_view& string)
 	{
 		// Skip forward until a new line or null
@@ -52,10 +72,7 @@ namespace ParseText
 		// skip all new line characters
 		while (i < string.length() && IsNewLine(string[i]))
 			i++;
-		if (i < string.length())
-			string = std::string_view(&string[i]);
-		else
-			string = std::string_view("");
+		string.remove_prefix(i);
 
 		// return whether or not we got anything
 		return line.size() > 0;
@@ -77,12 +94,190 @@ namespace ParseText
 		word = string.substr(start, end - start);
 
 		// remove the word from the string
-		if (end < string.length())
-			string = std::string_view(&string[end]);
-		else
-			string = std::string_view("");
+		string.remove_prefix(end);
 
 		// return whether or not we got anything
 		return word.size() > 0;
 	}
-};
\ No newline at end of file
+
+	// Number parsing with std::from_chars, which doesn't need a null terminated string, doesn't copy and doesn't look at the locale.
+	// These accept the same things sscanf does for %i, %u, %f and %lf: leading white space, a + or - sign, and anything after the number is ignored.
+	// They return false if there is no number.
+	namespace Detail
+	{
+		inline const char* SkipSpaceAndSign(const char* begin, const char* end, bool& negative)
+		{
+			while (begin < end && (IsWhiteSpace(*begin) || IsNewLine(*begin)))
+				begin++;
+
+			negative = false;
+			if (begin < end && (*begin == '+' || *begin == '-'))
+			{
+				negative = (*begin == '-');
+				begin++;
+			}
+			return begin;
+		}
+
+		inline bool IsHexPrefix(const char* begin, const char* end)
+		{
+			return (end - begin) > 2 && begin[0] == '0' && (begin[1] == 'x' || begin[1] == 'X');
+		}
+
+		template <typename T>
+		bool ParseFloat(std::string_view string, T& value)
+		{
+			const char* begin = string.data();
+			const char* end = begin + string.size();
+
+			bool negative;
+			begin = SkipSpaceAndSign(begin, end, negative);
+
+			std::chars_format format = std::chars_format::general;
+			if (IsHexPrefix(begin, end))
+			{
+				format = std::chars_format::hex;
+				begin += 2;
+			}
+
+			std::from_chars_result result = std::from_chars(begin, end, value, format);
+			if (result.ec == std::errc::result_out_of_range)
+			{
+				// from_chars leaves the value alone when it's out of range, but sscanf gives inf or 0, so let strtod decide.
+				std::string copy(string);
+				value = (T)strtod(copy.c_str(), nullptr);
+				return true;
+			}
+
+			if (result.ec != std::errc())
+				return false;
+
+			if (negative)
+				value = -value;
+			return true;
+		}
+	}
+
+	inline bool ParseNumber(std::string_view string, int& value)
+	{
+		const char* begin = string.data();
+		const char* end = begin + string.size();
+
+		bool negative;
+		begin = Detail::SkipSpaceAndSign(begin, end, negative);
+
+		// Like %i, 0x means hex and a leading 0 means octal
+		int base = 10;
+		if (Detail::IsHexPrefix(begin, end))
+		{
+			base = 16;
+			begin += 2;
+		}
+		else if (begin < end && *begin == '0')
+			base = 8;
+
+		uint64_t magnitude = 0;
+		if (std::from_chars(begin, end, magnitude, base).ec != std::errc())
+			return false;
+
+		value = (int)(negative ? (0 - magnitude) : magnitude);
+		return true;
+	}
+
+	inline bool ParseNumber(std::string_view string, unsigned int& value)
+	{
+		const char* begin = string.data();
+		const char* end = begin + string.size();
+
+		bool negative;
+		begin = Detail::SkipSpaceAndSign(begin, end, negative);
+
+		uint64_t magnitude = 0;
+		if (std::from_chars(begin, end, magnitude, 10).ec != std::errc())
+			return false;
+
+		// Like %u, negative numbers wrap around
+		value = (unsigned int)(negative ? (0 - magnitude) : magnitude);
+		return true;
+	}
+
+	inline bool ParseNumber(std::string_view string, float& value)
+	{
+		return Detail::ParseFloat(string, value);
+	}
+
+	inline bool ParseNumber(std::string_view string, double& value)
+	{
+		return Detail::ParseFloat(string, value);
+	}
+
+	// Splits text into roughly equal chunks to be parsed on different threads.
+	// Every chunk but the first starts at the beginning of a line, and every chunk but the last ends after the new line characters of a line,
+	// so reading lines or words from each chunk gives the same results as reading them from the whole string.
+	inline std::vector<std::string_view> SplitIntoLineChunks(std::string_view string, size_t minChunkSize = 1024 * 1024)
+	{
+		std::vector<std::string_view> chunks;
+
+		// A few chunks per thread, so that a thread that gets easy chunks can help with the rest
+		size_t maxChunkCount = (size_t)std::thread::hardware_concurrency() * 4;
+		size_t chunkCount = string.size() / minChunkSize;
+		if (chunkCount > maxChunkCount)
+			chunkCount = maxChunkCount;
+
+		if (chunkCount <= 1)
+		{
+			chunks.push_back(string);
+			return chunks;
+		}
+
+		size_t chunkSize = string.size() / chunkCount;
+		while (!string.empty())
+		{
+			// Move the end of the chunk forward to the start of the next line
+			size_t end = chunkSize < string.size() ? chunkSize : string.size();
+			while (end < string.size() && !IsNewLine(string[end]))
+				end++;
+			while (end < string.size() && IsNewLine(string[end]))
+				end++;
+
+			chunks.push_back(string.substr(0, end));
+			string.remove_prefix(end);
+		}
+
+		return chunks;
+	}
+
+	// Calls lambda(chunkIndex) for each chunk, spread across all hardware threads
+	template <typename LAMBDA>
+	void ForEachChunkParallel(size_t chunkCount, const LAMBDA& lambda)
+	{
+		size_t threadCount = (size_t)std::thread::hardware_concurrency();
+		if (threadCount > chunkCount)
+			threadCount = chunkCount;
+
+		if (threadCount <= 1)
+		{
+			for (size_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+				lambda(chunkIndex);
+			return;
+		}
+
+		std::atomic<size_t> nextChunkIndex = 0;
+		std::vector<std::thread> threads;
+		threads.reserve(threadCount);
+		for (size_t threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+		{
+			threads.emplace_back(
+				[&]()
+				{
+					size_t chunkIndex;
+					while ((chunkIndex = nextChunkIndex.fetch_add(1)) < chunkCount)
+						lambda(chunkIndex);
+				}
+			);
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+	}
+};
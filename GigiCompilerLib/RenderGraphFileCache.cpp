@@ -0,0 +1,225 @@
+///////////////////////////////////////////////////////////////////////////////
+//         Gigi Rapid Graphics Prototyping and Code Generation Suite         //
+//        Copyright (c) 2024 Electronic Arts Inc. All rights reserved.       //
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderGraphFileCache.h"
+#include "Utils.h"
+
+#include "Schemas/JSON.h"
+#include "Schemas/Binary.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+
+// Starts every key. Entries written by a different entry format don't match the key, and are loaded from the .gg file instead.
+static const char* c_entryMagic = "GIGIGGC1";
+
+static const std::string& GetCacheDirectory()
+{
+    static std::string s_directory = []()
+    {
+        std::error_code ec;
+        std::filesystem::path tempDirectory = std::filesystem::temp_directory_path(ec);
+        if (ec)
+            return std::string();
+        return (tempDirectory / "Gigi" / "GGCache").string();
+    }();
+    return s_directory;
+}
+
+static uint64_t GetLayoutHash()
+{
+    static uint64_t s_layoutHash = []()
+    {
+        uint64_t hash = 14695981039346656037ull;
+        BinaryLayoutHash((const RenderGraph*)nullptr, hash);
+        return hash;
+    }();
+    return s_layoutHash;
+}
+
+// These aren't serialized, but are set by loading the JSON, so they are stored after the render graph
+static void WriteLoadState(const RenderGraph& renderGraph, std::vector<char>& output)
+{
+    BinaryWrite(renderGraph.schema, output);
+    BinaryWrite(renderGraph.versionUpgraded, output);
+    BinaryWrite(renderGraph.versionUpgradedFrom, output);
+    BinaryWrite(renderGraph.versionUpgradedMessage, output);
+}
+
+static bool ReadLoadState(RenderGraph& renderGraph, const std::vector<char>& data, size_t& offset)
+{
+    return
+        BinaryRead(renderGraph.schema, data, offset) &&
+        BinaryRead(renderGraph.versionUpgraded, data, offset) &&
+        BinaryRead(renderGraph.versionUpgradedFrom, data, offset) &&
+        BinaryRead(renderGraph.versionUpgradedMessage, data, offset);
+}
+
+static bool LoadStateEquals(const RenderGraph& a, const RenderGraph& b)
+{
+    return
+        a.schema == b.schema &&
+        a.versionUpgraded == b.versionUpgraded &&
+        a.versionUpgradedFrom == b.versionUpgradedFrom &&
+        a.versionUpgradedMessage == b.versionUpgradedMessage;
+}
+
+static std::vector<char> MakeEntry(const std::string& keyText, const RenderGraph& renderGraph)
+{
+    std::vector<char> output;
+    BinaryWrite(keyText, output);
+    BinaryWrite(renderGraph, output);
+    WriteLoadState(renderGraph, output);
+    return output;
+}
+
+// Reads the render graph from the data of an entry, if the entry was made with the same key
+static bool ParseEntry(const std::vector<char>& data, const std::string& keyText, RenderGraph& renderGraph)
+{
+    size_t offset = 0;
+    std::string entryKeyText;
+    if (!BinaryRead(entryKeyText, data, offset) || entryKeyText != keyText)
+        return false;
+
+    RenderGraph loadedGraph = renderGraph;
+    if (!BinaryRead(loadedGraph, data, offset) || !ReadLoadState(loadedGraph, data, offset) || offset != data.size())
+        return false;
+
+    renderGraph = std::move(loadedGraph);
+    return true;
+}
+
+// Reads an entry into renderGraph, if the entry was made with the same key
+static bool ReadEntry(const std::string& entryFileName, const std::string& keyText, RenderGraph& renderGraph)
+{
+    std::vector<char> data;
+    {
+        std::ifstream file(entryFileName, std::ios::binary | std::ios::ate);
+        if (!file)
+            return false;
+
+        std::streamoff size = file.tellg();
+        if (size <= 0)
+            return false;
+
+        data.resize((size_t)size);
+        file.seekg(0);
+        if (!file.read(data.data(), size))
+            return false;
+    }
+
+    return ParseEntry(data, keyText, renderGraph);
+}
+
+static void WriteEntry(const std::string& entryFileName, const std::string& keyText, const RenderGraph& renderGraph)
+{
+    std::vector<char> output = MakeEntry(keyText, renderGraph);
+
+    std::error_code ec;
+    std::filesystem::create_directories(GetCacheDirectory(), ec);
+
+    // If another process has the entry open, it is just left as it is
+    WriteFileAtomically(entryFileName, output.data(), output.size());
+}
+
+bool ReadRenderGraphFile(RenderGraph& renderGraph, const std::string& fileName)
+{
+    std::vector<char> fileData;
+    if (!LoadTextFile(fileName.c_str(), fileData))
+    {
+        DFS_LOG("Could not read file %s", fileName.c_str());
+        return false;
+    }
+
+    return ReadRenderGraphBuffer(renderGraph, fileName, fileData);
+}
+
+bool ReadRenderGraphBuffer(RenderGraph& renderGraph, const std::string& fileName, const std::vector<char>& fileData)
+{
+    const std::string& directory = GetCacheDirectory();
+    if (directory.empty())
+        return ReadFromJSONBuffer(renderGraph, fileData);
+
+    // One entry per file, named by its path. The key says which contents, version and layout the entry was made from.
+    std::error_code ec;
+    std::string path = std::filesystem::weakly_canonical(fileName, ec).string();
+    if (ec)
+        path = fileName;
+    std::transform(path.begin(), path.end(), path.begin(), [](unsigned char c) { return std::tolower(c); });
+
+    size_t fileSize = fileData.empty() ? 0 : fileData.size() - 1;
+    char keyPrefix[256];
+    snprintf(keyPrefix, sizeof(keyPrefix), "%s|%s|%016llx|%llu|%016llx|", c_entryMagic, GIGI_VERSION(), (unsigned long long)GetLayoutHash(), (unsigned long long)fileSize, (unsigned long long)HashBytes(fileData.data(), fileSize));
+    std::string keyText = keyPrefix + path;
+
+    char entryName[64];
+    snprintf(entryName, sizeof(entryName), "%016llx.ggbin", (unsigned long long)HashBytes(path.data(), path.size()));
+    std::string entryFileName = (std::filesystem::path(directory) / entryName).string();
+
+    if (ReadEntry(entryFileName, keyText, renderGraph))
+        return true;
+
+    if (!ReadFromJSONBuffer(renderGraph, fileData))
+        return false;
+
+    WriteEntry(entryFileName, keyText, renderGraph);
+    return true;
+}
+
+bool VerifyRenderGraphFileCache(const std::string& fileName)
+{
+    std::vector<char> fileData;
+    if (!LoadTextFile(fileName.c_str(), fileData))
+    {
+        ShowErrorMessage("Could not read file %s", fileName.c_str());
+        return false;
+    }
+
+    RenderGraph jsonGraph;
+    if (!ReadFromJSONBuffer(jsonGraph, fileData))
+    {
+        ShowErrorMessage("Could not read %s as JSON", fileName.c_str());
+        return false;
+    }
+
+    auto Matches = [&jsonGraph](const RenderGraph& renderGraph)
+    {
+        return renderGraph == jsonGraph && LoadStateEquals(renderGraph, jsonGraph);
+    };
+
+    bool ret = true;
+
+    // The streaming JSON reader, which ReadFromJSONBuffer() uses when it can, against the DOM reader
+    RenderGraph domGraph;
+    if (!ReadFromJSONBuffer_DOM(domGraph, fileData.data()) || !Matches(domGraph))
+    {
+        ShowErrorMessage("%s: reading the JSON with the DOM reader doesn't give the same render graph as the streaming reader", fileName.c_str());
+        ret = false;
+    }
+
+    // The entry format itself
+    RenderGraph entryGraph;
+    if (!ParseEntry(MakeEntry(fileName, jsonGraph), fileName, entryGraph) || !Matches(entryGraph))
+    {
+        ShowErrorMessage("%s: writing the render graph to a cache entry and reading it back doesn't give the same render graph as the JSON", fileName.c_str());
+        ret = false;
+    }
+
+    // The cache itself. The first read writes the entry if it isn't there already, and the second reads it.
+    for (int readIndex = 0; readIndex < 2; ++readIndex)
+    {
+        RenderGraph cachedGraph;
+        if (!ReadRenderGraphBuffer(cachedGraph, fileName, fileData) || !Matches(cachedGraph))
+        {
+            ShowErrorMessage("%s: reading through the cache doesn't give the same render graph as the JSON", fileName.c_str());
+            ret = false;
+            break;
+        }
+    }
+
+    return ret;
+}
@@ -0,0 +1,32 @@
+///////////////////////////////////////////////////////////////////////////////
+//         Gigi Rapid Graphics Prototyping and Code Generation Suite         //
+//        Copyright (c) 2024 Electronic Arts Inc. All rights reserved.       //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// clang-format off
+#include "Schemas/Types.h"
+
+#include <string>
+#include <vector>
+// clang-format on
+
+// Loads .gg files, using a pre-parsed binary copy of the loaded (and version upgraded) render graph when one is there for the file.
+//
+// Each .gg file gets one cache entry, in Gigi/GGCache in the temp directory.
+// An entry is only used if it was made from the same file contents, by a build with the same Gigi version and schema layout (see MakeBinaryLayoutHash.h).
+// Otherwise the file is read from JSON and the entry is written again.
+// GigiCompiler.exe -verifycache checks that entries give the same render graphs as the JSON, and that the streaming and DOM JSON readers agree.
+// The unit tests run it on every technique.
+// Anything that goes wrong with the cache files just means a JSON load, so those errors are not reported.
+
+// Like ReadFromJSONFile()
+bool ReadRenderGraphFile(RenderGraph& renderGraph, const std::string& fileName);
+
+// Like ReadFromJSONBuffer(), for when the file has already been loaded. fileData is null terminated, as from LoadTextFile().
+bool ReadRenderGraphBuffer(RenderGraph& renderGraph, const std::string& fileName, const std::vector<char>& fileData);
+
+// Reads the file from JSON, and checks that the DOM JSON reader, a cache entry made from the JSON, and ReadRenderGraphFile() all give the same render graph.
+// Leaves the file's entry in the cache. Returns false if anything differs, and reports it with ShowErrorMessage().
+bool VerifyRenderGraphFileCache(const std::string& fileName);
@@ -6,6 +6,7 @@
 #include "SubGraphs.h"
 
 #include "gigicompiler.h"
+#include "RenderGraphFileCache.h"
 
 #include "Schemas/JSON.h"
 #include "Schemas/Visitor.h"
@@ -14,6 +15,7 @@
 #include "RenderGraph/Visitors.h"
 #include "FlattenRenderGraph.h"
 #include <unordered_map>
+#include <algorithm>
 
 #define INLINING_DEBUG() false // if true, prints info about inlining steps
 
@@ -44,50 +46,22 @@
 
 static bool NodeNameExists(const RenderGraph& renderGraph, const char* name)
 {
-    for (const RenderGraphNode& baseNode : renderGraph.nodes)
-    {
-        bool matches = false;
-        RenderGraphNodeLambda(baseNode,
-            [&matches, name](auto& node)
-            {
-                matches = !_stricmp(name, node.name.c_str());
-            }
-        );
-        if (matches)
-            return true;
-    }
-
-    return false;
+    return SymbolTableFindNode(renderGraph, name) != -1;
 }
 
 static bool VariableNameExists(const RenderGraph& renderGraph, const char* name)
 {
-    for (const Variable& variable : renderGraph.variables)
-    {
-        if (!_stricmp(name, variable.name.c_str()))
-            return true;
-    }
-    return false;
+    return SymbolTableFindVariable(renderGraph, name) != -1;
 }
 
 static bool StructNameExists(const RenderGraph& renderGraph, const char* name)
 {
-    for (const Struct& s : renderGraph.structs)
-    {
-        if (!_stricmp(name, s.name.c_str()))
-            return true;
-    }
-    return false;
+    return SymbolTableFindStruct(renderGraph, name) != -1;
 }
 
 static bool ShaderNameExists(const RenderGraph& renderGraph, const char* name)
 {
-    for (const Shader& s : renderGraph.shaders)
-    {
-        if (!_stricmp(name, s.name.c_str()))
-            return true;
-    }
-    return false;
+    return SymbolTableFindShader(renderGraph, name) != -1;
 }
 
 static bool EnumNameExists(const RenderGraph& renderGraph, const char* name)
@@ -211,25 +185,25 @@ struct RenameReferencesVisitor
     }
 
     template <typename TDATA>
-    bool Visit(TDATA& data, const std::string& path)
+    bool Visit(TDATA& data, const VisitPath& path)
     {
         return true;
     }
 
-    bool Visit(SetCBFromVar& setVar, const std::string& path)
+    bool Visit(SetCBFromVar& setVar, const VisitPath& path)
     {
         m_renameData.UpdateVariableName(setVar.variable.name);
         return true;
     }
 
-    bool Visit(Condition& condition, const std::string& path)
+    bool Visit(Condition& condition, const VisitPath& path)
     {
         m_renameData.UpdateVariableName(condition.variable1);
         m_renameData.UpdateVariableName(condition.variable2);
         return true;
     }
 
-    bool Visit(SetVariable& setVariable, const std::string& path)
+    bool Visit(SetVariable& setVariable, const VisitPath& path)
     {
         m_renameData.UpdateVariableName(setVariable.destination.name);
         m_renameData.UpdateVariableName(setVariable.AVar.name);
@@ -237,7 +211,7 @@ struct RenameReferencesVisitor
         return true;
     }
 
-    bool Visit(RTHitGroup& hitGroup, const std::string& path)
+    bool Visit(RTHitGroup& hitGroup, const VisitPath& path)
     {
         m_renameData.UpdateShaderName(hitGroup.closestHit.name);
         m_renameData.UpdateShaderName(hitGroup.anyHit.name);
@@ -245,7 +219,7 @@ struct RenameReferencesVisitor
         return true;
     }
 
-    bool Visit(RenderGraphNode& nodeBase, const std::string& path)
+    bool Visit(RenderGraphNode& nodeBase, const VisitPath& path)
     {
         switch (nodeBase._index)
         {
@@ -406,13 +380,13 @@ struct RenameChildVisitor
     }
 
     template <typename TDATA>
-    bool Visit(TDATA& data, const std::string& path)
+    bool Visit(TDATA& data, const VisitPath& path)
     {
         return true;
     }
 
     // Rename nodes
-    bool Visit(RenderGraphNode_Base& node, const std::string& path)
+    bool Visit(RenderGraphNode_Base& node, const VisitPath& path)
     {
         // prepend the sub graph node name to make it unique.
         char newName[1024];
@@ -437,7 +411,7 @@ struct RenameChildVisitor
     }
 
     // Rename variables
-    bool Visit(Variable& variable, const std::string& path)
+    bool Visit(Variable& variable, const VisitPath& path)
     {
         // prepend the sub graph node name to make it unique.
         char newName[1024];
@@ -451,6 +425,11 @@ struct RenameChildVisitor
         // remember this renaming
         m_renameData.m_variableRenames[variable.name] = newName;
 
+        // keep the child graph's symbol table up to date
+        int variableIndex = GetSymbolItemIndex(m_childGraph.variables, variable);
+        if (variableIndex != -1)
+            SymbolTableRemoveVariable(m_childGraph, variableIndex);
+
         // renaming book keeping
         if (variable.originalName.empty())
             variable.originalName = variable.name;
@@ -459,11 +438,14 @@ struct RenameChildVisitor
         // Set the new name
         variable.name = newName;
 
+        if (variableIndex != -1)
+            SymbolTableAddVariable(m_childGraph, variableIndex);
+
         return true;
     }
 
     // Rename structs
-    bool Visit(Struct& s, const std::string& path)
+    bool Visit(Struct& s, const VisitPath& path)
     {
         // prepend the sub graph node name and add numbers if needed, to make it unique.
         char newName[1024];
@@ -480,6 +462,11 @@ struct RenameChildVisitor
         // remember this renaming
         m_renameData.m_structRenames[s.name] = newName;
 
+        // keep the child graph's symbol table up to date, since the loop above looks up names in it
+        int structIndex = GetSymbolItemIndex(m_childGraph.structs, s);
+        if (structIndex != -1)
+            SymbolTableRemoveStruct(m_childGraph, structIndex);
+
         // renaming book keeping
         if (s.originalName.empty())
             s.originalName = s.name;
@@ -488,11 +475,14 @@ struct RenameChildVisitor
         // Set the new name
         s.name = newName;
 
+        if (structIndex != -1)
+            SymbolTableAddStruct(m_childGraph, structIndex);
+
         return true;
     }
 
     // Rename shaders
-    bool Visit(Shader& s, const std::string& path)
+    bool Visit(Shader& s, const VisitPath& path)
     {
         // Make sure this shader has a unique name
         // prepend the sub graph node name and add numbers if needed, to make it unique.
@@ -510,6 +500,11 @@ struct RenameChildVisitor
         // remember this renaming
         m_renameData.m_shaderRenames[s.name] = newName;
 
+        // keep the child graph's symbol table up to date, since the loop above looks up names in it
+        int shaderIndex = GetSymbolItemIndex(m_childGraph.shaders, s);
+        if (shaderIndex != -1)
+            SymbolTableRemoveShader(m_childGraph, shaderIndex);
+
         // renaming book keeping
         if (s.originalName.empty())
             s.originalName = s.name;
@@ -518,6 +513,9 @@ struct RenameChildVisitor
         // Set the new name
         s.name = newName;
 
+        if (shaderIndex != -1)
+            SymbolTableAddShader(m_childGraph, shaderIndex);
+
         // Update where the file should be written out to.
         // Need to handle the subgraph possibly being in a parent directory etc.
         if (s.destFileName.empty())
@@ -534,7 +532,7 @@ struct RenameChildVisitor
     }
 
     // Rename enums
-    bool Visit(Enum& e, const std::string& path)
+    bool Visit(Enum& e, const VisitPath& path)
     {
         // prepend the sub graph node name and add numbers if needed, to make it unique.
         char newName[1024];
@@ -563,7 +561,7 @@ struct RenameChildVisitor
     }
 
     // Rename hit groups
-    bool Visit(RTHitGroup& hitGroup, const std::string& path)
+    bool Visit(RTHitGroup& hitGroup, const VisitPath& path)
     {
         // prepend the sub graph node name and add numbers if needed, to make it unique.
         char newName[1024];
@@ -592,7 +590,7 @@ struct RenameChildVisitor
     }
 
     // Update file copy paths
-    bool Visit(FileCopy& fileCopy, const std::string& path)
+    bool Visit(FileCopy& fileCopy, const VisitPath& path)
     {
         // Update where the file should be written out to.
         // Need to handle the subgraph possibly being in a parent directory etc.
@@ -791,6 +789,7 @@ static void HandleSubgraphInputPins(RenderGraph& parentGraph, RenderGraph& child
             ),
             childGraph.nodes.end()
         );
+        InvalidateSymbolTable(childGraph);
 
         // 1) Any node/pin reference to the imported resource should be replaced by what is plugged into that input pin.
         {
@@ -836,28 +835,76 @@ static void HandleSubgraphInputPins(RenderGraph& parentGraph, RenderGraph& child
     }
 }
 
-static bool InlineSubGraph(RenderGraph& parentGraph, RenderGraphNode_Action_SubGraph& subGraphNode)
+bool SubGraphCache::Get(const std::string& fileName, RenderGraph& renderGraph)
 {
-    // load the child graph
-    std::string childFileName = (std::filesystem::path(parentGraph.baseDirectory) / std::filesystem::path(subGraphNode.fileName)).string();
-    RenderGraph childGraph;
-    if (ReadFromJSONFile(childGraph, childFileName.c_str()))
+    std::vector<char> fileData;
+    if (!LoadTextFile(fileName.c_str(), fileData))
+    {
+        ShowErrorMessage("Could not load subgraph %s.", fileName.c_str());
+        return false;
+    }
+
+    std::string key = std::filesystem::weakly_canonical(fileName).string();
+    std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return std::tolower(c); });
+
     {
-        if (childGraph.version != std::string(GIGI_VERSION()))
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_cache.find(key);
+        if (it != m_cache.end() && it->second.fileData == fileData)
         {
-            ShowErrorMessage("Could not load subgraph. File %s is version %s and couldn't be upgraded to version %s.", childFileName.c_str(), childGraph.version.c_str(), GIGI_VERSION());
-            return false;
+            m_hits++;
+            renderGraph = it->second.renderGraph;
+            return true;
         }
+        m_misses++;
+    }
 
-        if (childGraph.versionUpgraded)
-            ShowInfoMessage("Sub Graph \"%s\" Upgraded from %s to %s%s%s", childFileName.c_str(), childGraph.versionUpgradedFrom.c_str(), childGraph.version.c_str(), childGraph.versionUpgradedMessage.empty() ? "" : ":\n", childGraph.versionUpgradedMessage.c_str());
+    // Parse outside of the lock, so other compiles sharing the cache aren't held up
+    RenderGraph loadedGraph;
+    if (!ReadRenderGraphBuffer(loadedGraph, fileName, fileData))
+    {
+        ShowErrorMessage("Could not load subgraph %s.", fileName.c_str());
+        return false;
     }
-    else
+
+    if (loadedGraph.version != std::string(GIGI_VERSION()))
     {
-        ShowErrorMessage("Could not load subgraph %s.", childFileName.c_str());
+        ShowErrorMessage("Could not load subgraph. File %s is version %s and couldn't be upgraded to version %s.", fileName.c_str(), loadedGraph.version.c_str(), GIGI_VERSION());
         return false;
     }
 
+    if (loadedGraph.versionUpgraded)
+        ShowInfoMessage("Sub Graph \"%s\" Upgraded from %s to %s%s%s", fileName.c_str(), loadedGraph.versionUpgradedFrom.c_str(), loadedGraph.version.c_str(), loadedGraph.versionUpgradedMessage.empty() ? "" : ":\n", loadedGraph.versionUpgradedMessage.c_str());
+
+    renderGraph = loadedGraph;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry& entry = m_cache[key];
+    entry.fileData = std::move(fileData);
+    entry.renderGraph = std::move(loadedGraph);
+    return true;
+}
+
+int SubGraphCache::GetHits() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hits;
+}
+
+int SubGraphCache::GetMisses() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_misses;
+}
+
+static bool InlineSubGraph(RenderGraph& parentGraph, RenderGraphNode_Action_SubGraph& subGraphNode, SubGraphCache& subGraphCache)
+{
+    // load the child graph
+    std::string childFileName = (std::filesystem::path(parentGraph.baseDirectory) / std::filesystem::path(subGraphNode.fileName)).string();
+    RenderGraph childGraph;
+    if (!subGraphCache.Get(childFileName, childGraph))
+        return false;
+
     // get the base directory of the render graph
     {
         std::string rgPath = childFileName.c_str();
@@ -969,6 +1016,7 @@ static bool InlineSubGraph(RenderGraph& parentGraph, RenderGraphNode_Action_SubG
             ),
             childGraph.variables.end()
         );
+        InvalidateSymbolTable(childGraph);
     }
 
     // Make the child graph ready to have it's information inserted into the parent graph by giving everything a unique name and fixing up the references.
@@ -977,6 +1025,9 @@ static bool InlineSubGraph(RenderGraph& parentGraph, RenderGraphNode_Action_SubG
         RenameChildVisitor visitor(parentGraph, childGraph, subGraphNode, renameData);
         if (!Visit(childGraph, visitor, "childGraph"))
             return false;
+
+        // Nodes are visited as RenderGraphNode_Base, which doesn't say which node it is, so their symbols are rebuilt instead of updated
+        childGraph.symbols.nodes.count = -1;
     }
     {
         RenameReferencesVisitor visitor(renameData);
@@ -1191,6 +1242,7 @@ bool ExpandLoopedSubgraphs(RenderGraph& renderGraph)
 		if (node._index == RenderGraphNode::c_index_actionSubGraph)
 		{
 			renderGraph.nodes.erase(renderGraph.nodes.begin() + nodeIndex);
+			InvalidateSymbolTable(renderGraph);
 			goto startErase;
 		}
 	}
@@ -1210,7 +1262,7 @@ bool ExpandLoopedSubgraphs(RenderGraph& renderGraph)
 	return true;
 }
 
-bool InlineSubGraphs(RenderGraph& renderGraph)
+bool InlineSubGraphs(RenderGraph& renderGraph, SubGraphCache* sharedSubGraphCache)
 {
 	// First expand any looped graphs
 	if (!ExpandLoopedSubgraphs(renderGraph))
@@ -1228,6 +1280,8 @@ bool InlineSubGraphs(RenderGraph& renderGraph)
     // Note that this process is recursive because the act of inlining a subgraph may bring another subgraph with it, by a subgraph having
     // a subgraph inside of it.
     //
+    SubGraphCache localSubGraphCache;
+    SubGraphCache& subGraphCache = sharedSubGraphCache ? *sharedSubGraphCache : localSubGraphCache;
     int maxLoopIndex = -1;
     bool subgraphNodesRemain = true;
     bool madeProgress = true;
@@ -1333,7 +1387,7 @@ bool InlineSubGraphs(RenderGraph& renderGraph)
                 maxLoopIndex = std::max(maxLoopIndex, node.actionSubGraph.loopIndex);
 
                 // inline the node
-                if (!InlineSubGraph(renderGraph, node.actionSubGraph))
+                if (!InlineSubGraph(renderGraph, node.actionSubGraph, subGraphCache))
                 {
                     INLINE_DEBUG("  %s: Failed to inline", subgraphNodeName.c_str());
                     return false;
@@ -1345,6 +1399,7 @@ bool InlineSubGraphs(RenderGraph& renderGraph)
 
                 // delete the node
                 renderGraph.nodes.erase(renderGraph.nodes.begin() + nodeIndex);
+                InvalidateSymbolTable(renderGraph);
 
                 // remember that we made progress
                 madeProgress = true;
@@ -1371,6 +1426,10 @@ bool InlineSubGraphs(RenderGraph& renderGraph)
         }
     }
 
+    // A shared cache's counts cover every compile sharing it, so are reported by whoever owns it
+    if (!sharedSubGraphCache && subGraphCache.GetHits() + subGraphCache.GetMisses() > 0)
+        ShowInfoMessage("Sub graph cache: %i hits, %i misses", subGraphCache.GetHits(), subGraphCache.GetMisses());
+
     // make the loop index variables needed
     for (int loopIndexValueVarIndex = 0; loopIndexValueVarIndex <= maxLoopIndex; ++loopIndexValueVarIndex)
     {
@@ -1432,6 +1491,8 @@ Subgraph Object Names
 RenameChildVisitor is used to rename items from the child graph to ensure unique names when inlined into the parent graph.
 This includes: nodes, variables, structs, shaders, enums, hitgroups, and file copy paths.
 The RenameReferencesVisitor makes sure all references in the child graph are updated to use the new names
+Names are looked up through the render graph symbol table (RenderGraph/SymbolTable.h), which RenameChildVisitor keeps up to date as it renames.
+The RenameReferencesVisitor only changes references, which aren't in the symbol table.
 The editor should have child graph structs, enums, etc exposed to the parent graph, but that doesn't currently happen.
 
 Subgraph Node Pins
@@ -5,5 +5,40 @@
 
 #pragma once
 
-struct RenderGraph;
-bool InlineSubGraphs(RenderGraph& renderGraph);
+// clang-format off
+#include "Schemas/Types.h"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+// clang-format on
+
+// The same sub graph file is often used by many nodes, especially with looped and nested sub graphs.
+// This loads each file once, and gives out copies of the loaded (and upgraded) render graph.
+// Entries are keyed by canonical path and remember the file contents, so a file that changes on disk is loaded again.
+// A compile makes its own cache unless it's given one to share, like the jobs of a batch compile do. Sharing a cache is thread safe.
+class SubGraphCache
+{
+public:
+    bool Get(const std::string& fileName, RenderGraph& renderGraph);
+
+    int GetHits() const;
+    int GetMisses() const;
+
+private:
+    // One entry per file, keyed by its canonical lower case path.
+    // A hit needs the file contents to match the ones the graph was loaded from, and a miss replaces the entry.
+    struct Entry
+    {
+        std::vector<char> fileData;
+        RenderGraph renderGraph;
+    };
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, Entry> m_cache;
+    int m_hits = 0;
+    int m_misses = 0;
+};
+
+bool InlineSubGraphs(RenderGraph& renderGraph, SubGraphCache* sharedSubGraphCache = nullptr);
@@ -7,6 +7,12 @@
 
 #include <Windows.h>
 
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <thread>
+
 std::wstring ToWideString(const char* string)
 {
 	int size = MultiByteToWideChar(CP_UTF8, 0, string, (int)strlen(string), nullptr, 0);
@@ -21,4 +27,47 @@ std::string FromWideString(const wchar_t* string)
 	std::string result(size, 0);
 	WideCharToMultiByte(CP_ACP, 0, string, -1, result.data(), size, nullptr, nullptr);
 	return result;
-}
\ No newline at end of file
+}
+
+uint64_t HashBytes(const void* data, size_t size, uint64_t hash)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	for (size_t index = 0; index < size; ++index)
+	{
+		hash ^= bytes[index];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+bool WriteFileAtomically(const std::string& fileName, const void* data, size_t size)
+{
+	std::random_device randomDevice;
+	uint64_t unique = ((uint64_t)randomDevice() << 32) ^ randomDevice() ^ std::hash<std::thread::id>()(std::this_thread::get_id()) ^ (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+	char tempSuffix[64];
+	snprintf(tempSuffix, sizeof(tempSuffix), ".%016llx.tmp", (unsigned long long)unique);
+	std::string tempFileName = fileName + tempSuffix;
+
+	std::error_code ec;
+	{
+		std::ofstream file(tempFileName, std::ios::binary | std::ios::trunc);
+		if (!file)
+			return false;
+		file.write((const char*)data, size);
+		if (!file)
+		{
+			file.close();
+			std::filesystem::remove(tempFileName, ec);
+			return false;
+		}
+	}
+
+	std::filesystem::rename(tempFileName, fileName, ec);
+	if (ec)
+	{
+		std::filesystem::remove(tempFileName, ec);
+		return false;
+	}
+
+	return true;
+}
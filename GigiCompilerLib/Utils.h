@@ -6,6 +6,7 @@
 #pragma once
 
 // clang-format off
+#include <cstdint>
 #include <string>
 #include <codecvt>
 #include "gigicompiler.h"
@@ -23,6 +24,13 @@ using LogFn = void (*)(LogLevel level, const char* msg, ...);
 std::wstring ToWideString(const char* string);
 std::string FromWideString(const wchar_t* string);
 
+// FNV-1a. Pass the result back in as hash to continue hashing more bytes.
+uint64_t HashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ull);
+
+// Writes the file by writing a uniquely named temp file next to it, and renaming it over the file, so readers never see a partial file.
+// If another process has the file open, the rename fails, the file is left as it was, and this returns false.
+bool WriteFileAtomically(const std::string& fileName, const void* data, size_t size);
+
 template <typename LAMBDA>
 void RenderGraphNodeLambda(RenderGraphNode& node, const LAMBDA& lambda)
 {
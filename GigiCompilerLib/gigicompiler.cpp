@@ -13,6 +13,8 @@
 #include "RenderGraph/Visitors.h"
 #include "FlattenRenderGraph.h"
 #include "SubGraphs.h"
+#include "RenderGraphFileCache.h"
+#include <chrono>
 // clang-format on
 
 // Backend Run prototype functions
@@ -23,6 +25,58 @@
 #include "Schemas/BackendList.h"
 // clang-format on
 
+// The name of a visitor pass, for timings, and the result to return if it fails
+struct VisitorPassInfo
+{
+    const char* name;
+    GigiCompileResult failResult;
+};
+
+template <size_t BEGIN, typename... TVISITORS>
+static GigiCompileResult RunVisitorGroups(RenderGraph& renderGraph, const VisitorPassInfo* passes, std::string& timings, std::tuple<TVISITORS&...>& visitors)
+{
+    if constexpr (BEGIN == sizeof...(TVISITORS))
+    {
+        return GigiCompileResult::OK;
+    }
+    else
+    {
+        constexpr size_t END = VisitorGroupEnd<TVISITORS...>(BEGIN);
+
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        int failedIndex = VisitFusedGroup<BEGIN>(renderGraph, visitors, "renderGraph", std::make_index_sequence<END - BEGIN>());
+        std::chrono::duration<float, std::milli> duration = std::chrono::high_resolution_clock::now() - start;
+
+        if (!timings.empty())
+            timings += "\n";
+        for (size_t index = BEGIN; index < END; ++index)
+        {
+            timings += passes[index].name;
+            timings += (index + 1 < END) ? ", " : ": ";
+        }
+        char buffer[64];
+        sprintf_s(buffer, "%0.2f ms", duration.count());
+        timings += buffer;
+
+        if (failedIndex != -1)
+            return passes[failedIndex].failResult;
+
+        return RunVisitorGroups<END>(renderGraph, passes, timings, visitors);
+    }
+}
+
+// Runs visitors over the render graph, as if one after another in the order given.
+// Visitors share a traversal when what they declare in c_access allows it, see VisitorGroupEnd(). Each traversal's wall time is appended to timings.
+template <typename... TVISITORS>
+static GigiCompileResult RunVisitorPasses(RenderGraph& renderGraph, std::initializer_list<VisitorPassInfo> passes, std::string& timings, TVISITORS&... visitors)
+{
+    static_assert(sizeof...(TVISITORS) > 0, "RunVisitorPasses needs at least one visitor");
+    Assert(passes.size() == sizeof...(TVISITORS), "RunVisitorPasses was given %i visitors but %i passes", (int)sizeof...(TVISITORS), (int)passes.size());
+
+    std::tuple<TVISITORS&...> visitorTuple(visitors...);
+    return RunVisitorGroups<0>(renderGraph, passes.begin(), timings, visitorTuple);
+}
+
 bool RemoveBackendData(RenderGraph& renderGraph)
 {
     // Resolve all backend restrictions
@@ -77,6 +131,7 @@ bool RemoveBackendData(RenderGraph& renderGraph)
         ),
         renderGraph.nodes.end()
     );
+    InvalidateSymbolTable(renderGraph);
 
     // Delete any shader resources that aren't for this backend
     for (Shader& shader : renderGraph.shaders)
@@ -178,7 +233,7 @@ bool RemoveBackendData(RenderGraph& renderGraph)
     return true;
 }
 
-GigiCompileResult GigiCompile(GigiBuildFlavor buildFlavor, const std::string& jsonFile, const std::string& outputDir, void (*PostLoad)(RenderGraph&), RenderGraph* outRenderGraph, bool GENERATE_GRAPHVIZ_FLAG)
+GigiCompileResult GigiCompile(GigiBuildFlavor buildFlavor, const std::string& jsonFile, const std::string& outputDir, void (*PostLoad)(RenderGraph&), RenderGraph* outRenderGraph, bool GENERATE_GRAPHVIZ_FLAG, SubGraphCache* subGraphCache)
 {
     Backend backend;
     if (!GigiBuildFlavorBackend(buildFlavor, backend))
@@ -193,7 +248,7 @@ GigiCompileResult GigiCompile(GigiBuildFlavor buildFlavor, const std::string& js
     // Load the render graph
     RenderGraph renderGraph_;
     RenderGraph& renderGraph = outRenderGraph ? *outRenderGraph : renderGraph_;
-    if (!ReadFromJSONFile(renderGraph, jsonFile.c_str()))
+    if (!ReadRenderGraphFile(renderGraph, jsonFile))
     {
         Assert(false, "could not load %s", jsonFile.c_str());
         return GigiCompileResult::CantLoadRenderGraph;
@@ -231,7 +286,7 @@ GigiCompileResult GigiCompile(GigiBuildFlavor buildFlavor, const std::string& js
 
     // Inline SubGraph nodes
     {
-        if (!InlineSubGraphs(renderGraph))
+        if (!InlineSubGraphs(renderGraph, subGraphCache))
             return GigiCompileResult::InlineSubGraphs;
     }
 
@@ -241,94 +296,81 @@ GigiCompileResult GigiCompile(GigiBuildFlavor buildFlavor, const std::string& js
             return GigiCompileResult::BackendData;
     }
 
-    // Sanitize IDs
-    {
-        SanitizeVisitor visitor(renderGraph);
-        if (!Visit(renderGraph, visitor, "renderGraph"))
-            return GigiCompileResult::Sanitize;
-    }
+    // The visitor passes. Each visitor declares what it reads and writes, and visitors share a traversal when that allows it.
+    std::string passTimings;
+    GigiCompileResult passResult = GigiCompileResult::OK;
 
-    // Make sure no two shaders write to the same output file
+    // Sanitize IDs, and make sure no two shaders write to the same output file
     {
-        ShaderFileDuplicationVisitor visitor(renderGraph);
-        if (!Visit(renderGraph, visitor, "renderGraph"))
-            return GigiCompileResult::ShaderFileDuplication;
+        SanitizeVisitor sanitizeVisitor(renderGraph);
+        ShaderFileDuplicationVisitor shaderFileDuplicationVisitor(renderGraph);
+        passResult = RunVisitorPasses(renderGraph,
+            { { "Sanitize", GigiCompileResult::Sanitize }, { "ShaderFileDuplication", GigiCompileResult::ShaderFileDuplication } }, passTimings,
+            sanitizeVisitor, shaderFileDuplicationVisitor);
+        if (passResult != GigiCompileResult::OK)
+            return passResult;
     }
 
     // Do a post load
     if (PostLoad)
         PostLoad(renderGraph);
 
+    // Sanitizing and the post load rename things in place
+    InvalidateSymbolTable(renderGraph);
+
     // Shader references need to be resolved first
     {
         ShaderReferenceFixupVisitor visitor(renderGraph);
-        if (!Visit(renderGraph, visitor, "renderGraph"))
-            return GigiCompileResult::ReferenceFixup;
+        passResult = RunVisitorPasses(renderGraph, { { "ShaderReferenceFixup", GigiCompileResult::ReferenceFixup } }, passTimings, visitor);
+        if (passResult != GigiCompileResult::OK)
+            return passResult;
     }
 
-    // Process Asserts declarations inside shaders
+    // Process Asserts declarations inside shaders.
+    // This visits nodes before their shader references, so needs every shader reference resolved first.
     if (backend == Backend::Interpreter)
     {
-       ShaderAssertsVisitor visitor{ renderGraph };
-       if (!Visit(renderGraph, visitor, "renderGraph"))
-           return GigiCompileResult::ShaderAsserts;
+        ShaderAssertsVisitor visitor{ renderGraph };
+        passResult = RunVisitorPasses(renderGraph, { { "ShaderAsserts", GigiCompileResult::ShaderAsserts } }, passTimings, visitor);
+        if (passResult != GigiCompileResult::OK)
+            return passResult;
     }
 
-    // Get data from shaders
+    // * Get data from shaders
+    // * Do render graph validation
+    // * resolve the node references from names into indices
+    // * De-pluralize file copies
+    // * Other error checks. Draw call checks use the buffer references that ReferenceFixupVisitor resolves when visiting the draw call node.
+    // * Add node info to shaders as defines
+    // * Dflt fixup to make sure variable dflts are correctly formatted (like that floats have an f on the end). Comes after validation fills in empty dflts.
+    // * Data fixup to simplify backend handling of data cases. Uses the condition variable indices from ReferenceFixupVisitor.
     {
-        ShaderDataVisitor visitor(renderGraph);
-        if (!Visit(renderGraph, visitor, "renderGraph"))
-            return GigiCompileResult::ShaderReflection;
-    }
-
-    // Do render graph validation
-    {
-        ValidationVisitor visitor(renderGraph);
-        if (!Visit(renderGraph, visitor, "renderGraph"))
-            return GigiCompileResult::Validation;
-    }
-
-    // resolve the node references from names into indices
-    {
-        ReferenceFixupVisitor visitor(renderGraph);
-        if (!Visit(renderGraph, visitor, "renderGraph"))
-            return GigiCompileResult::ReferenceFixup;
-    }
-
-    // De-pluralize file copies
-    {
-        DepluralizeFileCopiesVisitor visitor;
-        if (!Visit(renderGraph, visitor, "renderGraph"))
-            return GigiCompileResult::DepluralizeFileCopies;
-    }
-
-    // Other error checks
-    {
-        ErrorCheckVisitor visitor;
-        if (!Visit(renderGraph, visitor, "renderGraph"))
-            return GigiCompileResult::ErrorCheck;
-    }
-
-    // Add node info to shaders as defines
-    {
-        AddNodeInfoToShadersVisitor visitor;
-        if (!Visit(renderGraph, visitor, "renderGraph"))
-            return GigiCompileResult::AddNodeInfoToShaders;
-    }
-
-    // Dflt fixup to make sure variable dflts are correctly formatted (like that floats have an f on the end)
-    {
-        DfltFixupVisitor visitor;
-        if (!Visit(renderGraph, visitor, "renderGraph"))
-            return GigiCompileResult::DfltFixup;
+        ShaderDataVisitor shaderDataVisitor(renderGraph);
+        ValidationVisitor validationVisitor(renderGraph);
+        ReferenceFixupVisitor referenceFixupVisitor(renderGraph);
+        DepluralizeFileCopiesVisitor depluralizeFileCopiesVisitor;
+        ErrorCheckVisitor errorCheckVisitor;
+        AddNodeInfoToShadersVisitor addNodeInfoToShadersVisitor;
+        DfltFixupVisitor dfltFixupVisitor;
+        DataFixupVisitor dataFixupVisitor;
+        passResult = RunVisitorPasses(renderGraph,
+            {
+                { "ShaderData", GigiCompileResult::ShaderReflection },
+                { "Validation", GigiCompileResult::Validation },
+                { "ReferenceFixup", GigiCompileResult::ReferenceFixup },
+                { "DepluralizeFileCopies", GigiCompileResult::DepluralizeFileCopies },
+                { "ErrorCheck", GigiCompileResult::ErrorCheck },
+                { "AddNodeInfoToShaders", GigiCompileResult::AddNodeInfoToShaders },
+                { "DfltFixup", GigiCompileResult::DfltFixup },
+                { "DataFixup", GigiCompileResult::DataFixup },
+            }, passTimings,
+            shaderDataVisitor, validationVisitor, referenceFixupVisitor, depluralizeFileCopiesVisitor, errorCheckVisitor, addNodeInfoToShadersVisitor, dfltFixupVisitor, dataFixupVisitor);
+        if (passResult != GigiCompileResult::OK)
+            return passResult;
     }
 
-    // Data fixup to simplify backend handling of data cases.
-    {
-        DataFixupVisitor visitor;
-        if (!Visit(renderGraph, visitor, "renderGraph"))
-            return GigiCompileResult::DataFixup;
-    }
+    if (renderGraph.buildSettings.showVisitorPassTimings)
+        ShowInfoMessage("Visitor passes:\n%s", passTimings.c_str());
 
     // Calculate optimized flattened render graph
     OptimizeAndFlattenRenderGraph(renderGraph);
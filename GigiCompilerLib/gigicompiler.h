@@ -12,7 +12,10 @@
 #include <string>
 // clang-format on
 
-GigiCompileResult GigiCompile(GigiBuildFlavor buildFlavor, const std::string& jsonFile, const std::string& outputDir, void (*PostLoad)(RenderGraph&), RenderGraph* outRenderGraph, bool GENERATE_GRAPHVIZ_FLAG);
+class SubGraphCache;
+
+// Compiles running at the same time may share a subGraphCache. If it's null, the compile uses a cache of its own.
+GigiCompileResult GigiCompile(GigiBuildFlavor buildFlavor, const std::string& jsonFile, const std::string& outputDir, void (*PostLoad)(RenderGraph&), RenderGraph* outRenderGraph, bool GENERATE_GRAPHVIZ_FLAG, SubGraphCache* subGraphCache = nullptr);
 
 // Backend PostLoad prototype functions
 // clang-format off
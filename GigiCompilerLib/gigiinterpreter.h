@@ -7,6 +7,7 @@
 
 // clang-format off
 #include "Backends/Shared.h"
+#include "NodeRuntimeDataCache.h"
 #include "TupleCache.h"
 #include "Utils.h"
 #include "gigicompiler.h"
@@ -309,6 +310,7 @@ public:
 
 		// Make runtime storage for variables
 		CreateVariableStorage(m_renderGraph);
+		CompileConditionsAndSetVars();
 
 		OnCompileOK();
 
@@ -330,7 +332,7 @@ public:
 #define VARIANT_TYPE(_TYPE, _NAME, _DEFAULT, _DESCRIPTION)                                                                                            \
 	case RenderGraphNode::c_index_##_NAME:                                                                                                            \
 	{                                                                                                                                                 \
-		if (!OnNodeAction(node.##_NAME, m_##_TYPE##_RuntimeData.GetOrCreate(node.##_NAME.name), NodeAction::Init))                                    \
+		if (!OnNodeAction(node.##_NAME, m_##_TYPE##_RuntimeData.GetOrCreate(nodeIndex, node.##_NAME.name), NodeAction::Init))                         \
 		{                                                                                                                                             \
 			m_logFn(LogLevel::Error, "Error during IGigiInterpreter::Compile OnNodeAction(Init) in node %s (" #_NAME ")", node.##_NAME.name.c_str()); \
 			return GigiCompileResult::InterpreterError;                                                                                               \
@@ -443,150 +445,161 @@ public:
 		}
 	}
 
-	template<typename T>
-	void DoSetVarOperation(const SetVariable& setVar, void* ABytes, void* BBytes, void* destBytes, int componentCount, int componentByteCount = sizeof(T))
-	{
-		// Get the typed pointers
-		T* A	= (T*)ABytes;
-		T* B	= (T*)BBytes;
-		T* dest = (T*)destBytes;
-
-		std::vector<char> ABuffer;
-		std::vector<char> BBuffer;
+	// Conditions and set variables are compiled once after GigiCompile, so that running them each frame doesn't parse literals,
+	// look up enum labels or allocate. Operands point straight at variable storage, or at constants parsed at compile time.
+	static const int c_maxCompiledComponents = 16;
 
-		// Set the A value from texture size, buffer count, or literal, if not previously set by a variable
-		if (setVar.ANode.textureNode)
-		{
-			const auto& runtimeResourceData = m_RenderGraphNode_Resource_Texture_RuntimeData.GetOrCreate(setVar.ANode.textureNode->name);
+	struct CompiledCondition
+	{
+		// nullptr means the condition is always true, unless alwaysFalse is set
+		bool (IGigiInterpreter::*evaluate)(const CompiledCondition& condition) = nullptr;
+		bool alwaysFalse = false;
+
+		ConditionComparison comparison = ConditionComparison::Count;
+		int componentCount = 0;
+		const void* A = nullptr;
+		const void* B = nullptr; // nullptr means B is BConstant
+		uint32_t BConstant[c_maxCompiledComponents] = {};
+	};
 
-			char sizeAsString[256];
-			sprintf_s(sizeAsString, "%u, %u, %u", runtimeResourceData.m_size[0], runtimeResourceData.m_size[1], runtimeResourceData.m_size[2]);
+	struct CompiledSetVarOperand
+	{
+		// Exactly one of these is used, in this order: the size of a texture node, the count of a buffer node, variable storage, or the constant
+		const std::string* textureNodeName = nullptr;
+		const std::string* bufferNodeName = nullptr;
+		int nodeIndex = -1;
+		const void* value = nullptr;
+		uint32_t constant[c_maxCompiledComponents] = {};
+
+		// The component selected by AVarIndex or BVarIndex
+		int componentOffset = 0;
+	};
 
-			ABuffer.resize(3 * componentByteCount);
-			A = (T*)ABuffer.data();
+	struct CompiledSetVar
+	{
+		// nullptr means the destination type isn't handled, so this does nothing
+		void (IGigiInterpreter::*execute)(const CompiledSetVar& setVar) = nullptr;
+		bool setBefore = true;
+		CompiledCondition condition;
+
+		SetVariableOperator op = SetVariableOperator::Noop;
+		int componentCount = 0;
+		void* dest = nullptr; // already offset to destinationIndex
+		CompiledSetVarOperand A;
+		CompiledSetVarOperand B;
+	};
 
-			VariableStorage::SetFromString(sizeAsString, 3, A);
-		}
-		else if (setVar.ANode.bufferNode)
-		{
-			const auto& runtimeResourceData = m_RenderGraphNode_Resource_Buffer_RuntimeData.GetOrCreate(setVar.ANode.bufferNode->name);
+	// Converts resource sizes to components the same way parsing them from "%u, %u, %u" would
+	template<typename T>
+	static void SizesToComponents(const unsigned int* sizes, int count, T* components)
+	{
+		for (int i = 0; i < count; ++i)
+			components[i] = (T)sizes[i];
+	}
 
-			char sizeAsString[256];
-			sprintf_s(sizeAsString, "%u", runtimeResourceData.m_count);
+	static void SizesToComponents(const unsigned int* sizes, int count, bool* components)
+	{
+		// Only "0" and "1" parse as bools, and parsing stops at the first thing that doesn't
+		for (int i = 0; i < count && sizes[i] <= 1; ++i)
+			components[i] = (sizes[i] == 1);
+	}
 
-			ABuffer.resize(1 * componentByteCount);
-			A = (T*)ABuffer.data();
+	template<typename T>
+	void CompileSetVarOperand(const TextureOrBufferNodeReference& node, int variableIndex, const std::string& literal, int componentIndex, int componentCount, CompiledSetVarOperand& operand)
+	{
+		operand.nodeIndex = node.nodeIndex;
+		if (node.textureNode)
+			operand.textureNodeName = &node.textureNode->name;
+		else if (node.bufferNode)
+			operand.bufferNodeName = &node.bufferNode->name;
+		else if (variableIndex != -1)
+			operand.value = GetRuntimeVariable(variableIndex).storage.value;
+		else
+			VariableStorage::SetFromString(literal.c_str(), componentCount, (T*)operand.constant);
 
-			VariableStorage::SetFromString(sizeAsString, 1, A);
-		}
-		else if (setVar.AVar.variableIndex == -1)
-		{
-			VariableStorage::SetFromString(setVar.ALiteral.c_str(), componentCount, A);
-		}
+		operand.componentOffset = (componentIndex != -1) ? componentIndex : 0;
+	}
 
-		// Set the B value from texture size, buffer count, or literal, if not previously set by a variable
-		if (setVar.BNode.textureNode)
-		{
-			const auto& runtimeResourceData = m_RenderGraphNode_Resource_Texture_RuntimeData.GetOrCreate(setVar.BNode.textureNode->name);
+	template<typename T>
+	void CompileSetVarTyped(const SetVariable& setVar, int componentCount, CompiledSetVar& compiledSetVar)
+	{
+		T* dest = (T*)GetRuntimeVariable(setVar.destination.variableIndex).storage.value;
+		compiledSetVar.dest = (setVar.destinationIndex != -1) ? &dest[setVar.destinationIndex] : dest;
 
-			char sizeAsString[256];
-			sprintf_s(sizeAsString, "%u, %u, %u", runtimeResourceData.m_size[0], runtimeResourceData.m_size[1], runtimeResourceData.m_size[2]);
+		CompileSetVarOperand<T>(setVar.ANode, setVar.AVar.variableIndex, setVar.ALiteral, setVar.AVarIndex, componentCount, compiledSetVar.A);
+		CompileSetVarOperand<T>(setVar.BNode, setVar.BVar.variableIndex, setVar.BLiteral, setVar.BVarIndex, componentCount, compiledSetVar.B);
 
-			BBuffer.resize(3 * componentByteCount);
-			B = (T*)BBuffer.data();
+		compiledSetVar.execute = &IGigiInterpreter::ExecuteCompiledSetVarTyped<T>;
+	}
 
-			VariableStorage::SetFromString(sizeAsString, 3, B);
-		}
-		else if (setVar.BNode.bufferNode)
-		{
-			const auto& runtimeResourceData = m_RenderGraphNode_Resource_Buffer_RuntimeData.GetOrCreate(setVar.BNode.bufferNode->name);
+	CompiledSetVar CompileSetVar(const SetVariable& setVar)
+	{
+		CompiledSetVar ret;
+		ret.setBefore = setVar.setBefore;
+		ret.condition = CompileCondition(setVar.condition);
+		ret.op = setVar.op;
 
-			char sizeAsString[256];
-			sprintf_s(sizeAsString, "%u", runtimeResourceData.m_count);
+		DataFieldType			type	 = m_renderGraph.variables[setVar.destination.variableIndex].type;
+		DataFieldTypeInfoStruct typeInfo = DataFieldTypeInfo(type);
 
-			BBuffer.resize(1 * componentByteCount);
-			B = (T*)BBuffer.data();
+		// Indexing into any of the values limits the operation to a single component
+		ret.componentCount = typeInfo.componentCount;
+		if (setVar.destinationIndex != -1 || setVar.AVarIndex != -1 || setVar.BVarIndex != -1)
+			ret.componentCount = 1;
 
-			VariableStorage::SetFromString(sizeAsString, 1, B);
+		switch (typeInfo.componentType2)
+		{
+			case DataFieldType::Bool: CompileSetVarTyped<bool>(setVar, typeInfo.componentCount, ret); break;
+			case DataFieldType::Int: CompileSetVarTyped<int>(setVar, typeInfo.componentCount, ret); break;
+			case DataFieldType::Uint_16: CompileSetVarTyped<uint16_t>(setVar, typeInfo.componentCount, ret); break;
+			case DataFieldType::Uint: CompileSetVarTyped<uint32_t>(setVar, typeInfo.componentCount, ret); break;
+			case DataFieldType::Float: CompileSetVarTyped<float>(setVar, typeInfo.componentCount, ret); break;
 		}
-		else if (setVar.BVar.variableIndex == -1)
-			VariableStorage::SetFromString(setVar.BLiteral.c_str(), componentCount, B);
 
-		// Limit the values involved to the appropriate index
-		if (setVar.destinationIndex != -1)
+		return ret;
+	}
+
+	template<typename T>
+	const T* GetCompiledSetVarOperand(const CompiledSetVarOperand& operand, T* scratch)
+	{
+		const T* ret = (const T*)operand.value;
+		if (operand.textureNodeName)
 		{
-			componentCount = 1;
-			dest = &dest[setVar.destinationIndex];
+			const auto& runtimeResourceData = m_RenderGraphNode_Resource_Texture_RuntimeData.GetOrCreate(operand.nodeIndex, *operand.textureNodeName);
+			unsigned int sizes[3] = { (unsigned int)runtimeResourceData.m_size[0], (unsigned int)runtimeResourceData.m_size[1], (unsigned int)runtimeResourceData.m_size[2] };
+			SizesToComponents(sizes, 3, scratch);
+			ret = scratch;
 		}
-
-		if (setVar.AVarIndex != -1)
+		else if (operand.bufferNodeName)
 		{
-			componentCount = 1;
-			A = &A[setVar.AVarIndex];
+			const auto& runtimeResourceData = m_RenderGraphNode_Resource_Buffer_RuntimeData.GetOrCreate(operand.nodeIndex, *operand.bufferNodeName);
+			unsigned int count = (unsigned int)runtimeResourceData.m_count;
+			SizesToComponents(&count, 1, scratch);
+			ret = scratch;
 		}
-
-		if (setVar.BVarIndex != -1)
+		else if (!ret)
 		{
-			componentCount = 1;
-			B = &B[setVar.BVarIndex];
+			ret = (const T*)operand.constant;
 		}
 
-		// Do the operation on each component
-		for (int i = 0; i < componentCount; ++i)
-			DoOp(A[i], B[i], dest[i], setVar.op);
+		return &ret[operand.componentOffset];
 	}
 
-	void ExecuteSetvar(const SetVariable& setVar)
+	template<typename T>
+	void ExecuteCompiledSetVarTyped(const CompiledSetVar& setVar)
 	{
-		DataFieldType			type	 = m_renderGraph.variables[setVar.destination.variableIndex].type;
-		DataFieldTypeInfoStruct typeInfo = DataFieldTypeInfo(type);
-
-		void* destBytes = GetRuntimeVariable(setVar.destination.variableIndex).storage.value;
-		void* ABytes	= (setVar.AVar.variableIndex != -1) ? GetRuntimeVariable(setVar.AVar.variableIndex).storage.value : nullptr;
-		void* BBytes	= (setVar.BVar.variableIndex != -1) ? GetRuntimeVariable(setVar.BVar.variableIndex).storage.value : nullptr;
-
-		std::vector<char> ABuffer;
-		std::vector<char> BBuffer;
-
-		if (!ABytes)
-		{
-			ABuffer.resize(typeInfo.typeBytes);
-			ABytes = ABuffer.data();
-		}
+		T AScratch[c_maxCompiledComponents] = {};
+		T BScratch[c_maxCompiledComponents] = {};
+		const T* A = GetCompiledSetVarOperand(setVar.A, AScratch);
+		const T* B = GetCompiledSetVarOperand(setVar.B, BScratch);
+		T* dest = (T*)setVar.dest;
 
-		if (!BBytes)
+		// Do the operation on each component
+		for (int i = 0; i < setVar.componentCount; ++i)
 		{
-			BBuffer.resize(typeInfo.typeBytes);
-			BBytes = BBuffer.data();
-		}
-
-		switch (typeInfo.componentType2)
-		{
-			case DataFieldType::Bool:
-			{
-				DoSetVarOperation<bool>(setVar, ABytes, BBytes, destBytes, typeInfo.componentCount, 4);
-				break;
-			}
-			case DataFieldType::Int:
-			{
-				DoSetVarOperation<int>(setVar, ABytes, BBytes, destBytes, typeInfo.componentCount);
-				break;
-			}
-			case DataFieldType::Uint_16:
-			{
-				DoSetVarOperation<uint16_t>(setVar, ABytes, BBytes, destBytes, typeInfo.componentCount);
-				break;
-			}
-			case DataFieldType::Uint:
-			{
-				DoSetVarOperation<uint32_t>(setVar, ABytes, BBytes, destBytes, typeInfo.componentCount);
-				break;
-			}
-			case DataFieldType::Float:
-			{
-				DoSetVarOperation<float>(setVar, ABytes, BBytes, destBytes, typeInfo.componentCount);
-				break;
-			}
+			T AValue = A[i];
+			T BValue = B[i];
+			DoOp(AValue, BValue, dest[i], setVar.op);
 		}
 	}
 
@@ -636,12 +649,10 @@ public:
 	{
 		// If the literal contain "EnumName::", then skip that part
 		const char* literalValue = label;
-		std::string enumPrefix	 = e.originalName + "::";
-		if (StringBeginsWithCaseInsensitive(literalValue, enumPrefix.c_str()))
-			literalValue += enumPrefix.length();
+		if (StringBeginsWithCaseInsensitive(literalValue, e.originalName.c_str()) && !strncmp(&literalValue[e.originalName.length()], "::", 2))
+			literalValue += e.originalName.length() + 2;
 
 		// Convert from enum name to integer value
-		bool validEnum = false;
 		for (size_t i = 0; i < e.items.size(); ++i)
 		{
 			if (!_stricmp(literalValue, e.items[i].label.c_str()))
@@ -650,41 +661,88 @@ public:
 		return -1;
 	}
 
-	bool EvaluateConditionTyped_Enum(const Condition& condition, void* ABytes, void* BBytes, int componentCount)
+	template<typename T>
+	bool EvaluateCompiledConditionTyped(const CompiledCondition& condition)
 	{
-		// Get the typed pointers
-		int* A = (int*)ABytes;
-		int* B = (int*)BBytes;
-
-		// Get the integer value from the enum label
-		const Enum& e = m_renderGraph.enums[m_renderGraph.variables[condition.variable1Index].enumIndex];
-		*B			  = EnumLabelToValue(e, condition.value2.c_str());
+		const T* A = (const T*)condition.A;
+		const T* B = condition.B ? (const T*)condition.B : (const T*)condition.BConstant;
 
 		// Do the operation on each component
 		bool ret = true;
-		for (int i = 0; i < componentCount; ++i)
-			ret = ret && DoComparison(A[i], B[i], condition.comparison);
+		for (int i = 0; i < condition.componentCount; ++i)
+		{
+			T AValue = A[i];
+			T BValue = B[i];
+			ret = ret && DoComparison(AValue, BValue, condition.comparison);
+		}
 		return ret;
 	}
 
 	template<typename T>
-	bool EvaluateConditionTyped(const Condition& condition, void* ABytes, void* BBytes, int componentCount)
+	void CompileConditionTyped(const Condition& condition, CompiledCondition& compiledCondition)
 	{
-		// Get the typed pointers
-		T* A = (T*)ABytes;
-		T* B = (T*)BBytes;
-
 		// Read from literals as needed
-		if (condition.variable2Index == -1)
-			VariableStorage::SetFromString(condition.value2.c_str(), componentCount, B);
+		if (!compiledCondition.B)
+			VariableStorage::SetFromString(condition.value2.c_str(), compiledCondition.componentCount, (T*)compiledCondition.BConstant);
+
+		compiledCondition.evaluate = &IGigiInterpreter::EvaluateCompiledConditionTyped<T>;
+	}
+
+	CompiledCondition CompileCondition(const Condition& condition)
+	{
+		CompiledCondition ret;
+		ret.alwaysFalse = condition.alwaysFalse;
+		if (condition.alwaysFalse || !IsConditional(condition) || condition.variable1Index == -1)
+			return ret;
+
+		const Variable&			variable1 = m_renderGraph.variables[condition.variable1Index];
+		DataFieldTypeInfoStruct typeInfo  = DataFieldTypeInfo(variable1.type);
+
+		ret.comparison	   = condition.comparison;
+		ret.componentCount = typeInfo.componentCount;
+		ret.A			   = GetRuntimeVariable(condition.variable1Index).storage.value;
+		if (condition.variable2Index != -1)
+			ret.B = GetRuntimeVariable(condition.variable2Index).storage.value;
+
+		if (variable1.type == DataFieldType::Bool)
+		{
+			CompileConditionTyped<bool>(condition, ret);
+			return ret;
+		}
+
+		switch (typeInfo.componentType)
+		{
+			case DataFieldComponentType::_int:
+			{
+				// If variable 1 is an enum, and the RHS is a literal, get the integer value from the enum label
+				if (variable1.enumIndex != -1 && condition.variable2Index == -1)
+				{
+					*(int*)ret.BConstant = EnumLabelToValue(m_renderGraph.enums[variable1.enumIndex], condition.value2.c_str());
+					ret.evaluate		 = &IGigiInterpreter::EvaluateCompiledConditionTyped<int>;
+				}
+				else
+					CompileConditionTyped<int>(condition, ret);
+				break;
+			}
+			case DataFieldComponentType::_uint16_t: CompileConditionTyped<uint16_t>(condition, ret); break;
+			case DataFieldComponentType::_uint32_t: CompileConditionTyped<uint32_t>(condition, ret); break;
+			case DataFieldComponentType::_float: CompileConditionTyped<float>(condition, ret); break;
+		}
 
-		// Do the operation on each component
-		bool ret = true;
-		for (int i = 0; i < componentCount; ++i)
-			ret = ret && DoComparison(A[i], B[i], condition.comparison);
 		return ret;
 	}
 
+	bool EvaluateCompiledCondition(const CompiledCondition& condition)
+	{
+		if (condition.alwaysFalse)
+			return false;
+
+		if (!condition.evaluate)
+			return true;
+
+		return (this->*condition.evaluate)(condition);
+	}
+
 	bool IsConditional(const Condition& condition)
 	{
 		return condition.comparison != ConditionComparison::Count || condition.alwaysFalse;
@@ -698,59 +756,26 @@ public:
 		if (condition.variable1Index == -1 || condition.comparison == ConditionComparison::Count)
 			return true;
 
-		DataFieldType			type	 = m_renderGraph.variables[condition.variable1Index].type;
-		DataFieldTypeInfoStruct typeInfo = DataFieldTypeInfo(type);
-
-		void* ABytes = GetRuntimeVariable(condition.variable1Index).storage.value;
-
-		void*			  BBytes = nullptr;
-		std::vector<char> BBuffer;
-		if (condition.variable2Index != -1)
-		{
-			BBytes = GetRuntimeVariable(condition.variable2Index).storage.value;
-		}
-		else
-		{
-			BBuffer.resize(typeInfo.typeBytes);
-			BBytes = BBuffer.data();
-		}
-
-		if (type == DataFieldType::Bool)
-		{
-			return EvaluateConditionTyped<bool>(condition, ABytes, BBytes, typeInfo.componentCount);
-		}
-		else
-		{
-			switch (typeInfo.componentType)
-			{
-				case DataFieldComponentType::_int:
-				{
-					// If variable 1 is an enum, and the RHS is a literal, set as an enm
-					if (m_renderGraph.variables[condition.variable1Index].enumIndex != -1 && condition.variable2Index == -1)
-						return EvaluateConditionTyped_Enum(condition, ABytes, BBytes, typeInfo.componentCount);
-					else
-						return EvaluateConditionTyped<int>(condition, ABytes, BBytes, typeInfo.componentCount);
-				}
-				case DataFieldComponentType::_uint16_t: return EvaluateConditionTyped<uint16_t>(condition, ABytes, BBytes, typeInfo.componentCount);
-				case DataFieldComponentType::_uint32_t: return EvaluateConditionTyped<uint32_t>(condition, ABytes, BBytes, typeInfo.componentCount);
-				case DataFieldComponentType::_float: return EvaluateConditionTyped<float>(condition, ABytes, BBytes, typeInfo.componentCount);
-			}
-		}
+		// Conditions in the render graph were compiled after GigiCompile.
+		// Any others are compiled each time they are evaluated.
+		auto it = m_compiledConditionIndices.find(&condition);
+		if (it != m_compiledConditionIndices.end())
+			return EvaluateCompiledCondition(m_compiledConditions[it->second]);
 
-		return true;
+		return EvaluateCompiledCondition(CompileCondition(condition));
 	}
 
 	void ExecuteSetVars(bool beforeExecution)
 	{
-		for (const SetVariable& setVar : m_renderGraph.setVars)
+		for (const CompiledSetVar& setVar : m_compiledSetVars)
 		{
-			if (setVar.destination.variableIndex == -1 || setVar.setBefore != beforeExecution)
+			if (setVar.setBefore != beforeExecution || !setVar.execute)
 				continue;
 
-			if (!EvaluateCondition(setVar.condition))
+			if (!EvaluateCompiledCondition(setVar.condition))
 				continue;
 
-			ExecuteSetvar(setVar);
+			(this->*setVar.execute)(setVar);
 		}
 	}
 
@@ -768,12 +793,12 @@ public:
 			switch (node._index)
 			{
 #include "external/df_serialize/_common.h"
-#define VARIANT_TYPE(_TYPE, _NAME, _DEFAULT, _DESCRIPTION)                                                            \
-	case RenderGraphNode::c_index_##_NAME:                                                                            \
-	{                                                                                                                 \
-		if (!OnNodeAction(node.##_NAME, m_##_TYPE##_RuntimeData.GetOrCreate(node.##_NAME.name), NodeAction::Execute)) \
-			return false;                                                                                             \
-		break;                                                                                                        \
+#define VARIANT_TYPE(_TYPE, _NAME, _DEFAULT, _DESCRIPTION)                                                                       \
+	case RenderGraphNode::c_index_##_NAME:                                                                                       \
+	{                                                                                                                            \
+		if (!OnNodeAction(node.##_NAME, m_##_TYPE##_RuntimeData.GetOrCreate(nodeIndex, node.##_NAME.name), NodeAction::Execute)) \
+			return false;                                                                                                        \
+		break;                                                                                                                   \
 	}
 // clang-format off
 #include "external/df_serialize/_fillunsetdefines.h"
@@ -792,6 +817,10 @@ public:
 		m_compileResult = GigiCompileResult::NotCompiledYet;
 		m_variableStorage.Clear();
 		m_runtimeVariables.clear();
+		m_runtimeVariableIndices.clear();
+		m_compiledSetVars.clear();
+		m_compiledConditions.clear();
+		m_compiledConditionIndices.clear();
 	}
 
 	virtual void ShowUI() {}
@@ -818,15 +847,8 @@ public:
 
 	int GetRuntimeVariableIndex(const char* name) const
 	{
-		int index = -1;
-		for (const auto& rtVar : m_runtimeVariables)
-		{
-			index++;
-			if (!strcmp(rtVar.variable->name.c_str(), name))
-				return index;
-		}
-
-		return -1;
+		auto it = m_runtimeVariableIndices.find(name);
+		return (it != m_runtimeVariableIndices.end()) ? it->second : -1;
 	}
 
 	const int GetRuntimeVariableCount() const
@@ -889,6 +911,24 @@ public:
 	{                                                                                                       \
 		bool exists = false;                                                                                \
 		return m_##_TYPE##_RuntimeData.Get(name, exists);                                                   \
+	}                                                                                                       \
+	const typename TRuntimeTypes::_TYPE& GetRuntimeNodeData_##_TYPE##(int nodeIndex, bool& exists) const    \
+	{                                                                                                       \
+		return m_##_TYPE##_RuntimeData.Get(nodeIndex, exists);                                              \
+	}                                                                                                       \
+	typename TRuntimeTypes::_TYPE& GetRuntimeNodeData_##_TYPE##(int nodeIndex, bool& exists)                \
+	{                                                                                                       \
+		return m_##_TYPE##_RuntimeData.Get(nodeIndex, exists);                                              \
+	}                                                                                                       \
+	const typename TRuntimeTypes::_TYPE& GetRuntimeNodeData_##_TYPE##(int nodeIndex) const                  \
+	{                                                                                                       \
+		bool exists = false;                                                                                \
+		return m_##_TYPE##_RuntimeData.Get(nodeIndex, exists);                                              \
+	}                                                                                                       \
+	typename TRuntimeTypes::_TYPE& GetRuntimeNodeData_##_TYPE##(int nodeIndex)                              \
+	{                                                                                                       \
+		bool exists = false;                                                                                \
+		return m_##_TYPE##_RuntimeData.Get(nodeIndex, exists);                                              \
 	}
 // clang-format off
 #include "external/df_serialize/_fillunsetdefines.h"
@@ -948,7 +988,7 @@ protected:
 #include "external/df_serialize/_common.h"
 #define VARIANT_TYPE(_TYPE, _NAME, _DEFAULT, _DESCRIPTION)                                                                                                         \
 	virtual bool										   OnNodeAction(const _TYPE& node, typename TRuntimeTypes::_TYPE& runtimeData, NodeAction nodeAction) = 0; \
-	TupleCache<typename TRuntimeTypes::_TYPE, std::string> m_##_TYPE##_RuntimeData;
+	NodeRuntimeDataCache<typename TRuntimeTypes::_TYPE>	   m_##_TYPE##_RuntimeData;
 // clang-format off
 #include "external/df_serialize/_fillunsetdefines.h"
 #include "Schemas/RenderGraphNodesVariant.h"
@@ -982,15 +1022,52 @@ protected:
 	};
 
 private:
+	static const Condition* GetActionCondition(const RenderGraphNode_ActionBase& node)
+	{
+		return &node.condition;
+	}
+
+	static const Condition* GetActionCondition(const RenderGraphNode_ResourceBase& node)
+	{
+		return nullptr;
+	}
+
+	// Compiles the set variables, and the conditions of the action nodes. Needs the variable storage to exist.
+	void CompileConditionsAndSetVars()
+	{
+		m_compiledSetVars.clear();
+		for (const SetVariable& setVar : m_renderGraph.setVars)
+		{
+			if (setVar.destination.variableIndex != -1)
+				m_compiledSetVars.push_back(CompileSetVar(setVar));
+		}
+
+		m_compiledConditions.clear();
+		m_compiledConditionIndices.clear();
+		for (const RenderGraphNode& node : m_renderGraph.nodes)
+		{
+			const Condition* condition = nullptr;
+			ExecuteOnNode(node, [&condition](auto& typedNode) { condition = GetActionCondition(typedNode); });
+			if (!condition)
+				continue;
+
+			m_compiledConditionIndices[condition] = (int)m_compiledConditions.size();
+			m_compiledConditions.push_back(CompileCondition(*condition));
+		}
+	}
+
 	void CreateVariableStorage(const RenderGraph& renderGraph)
 	{
 		// Make runtime storage for variables
 		m_runtimeVariables.clear();
 		m_runtimeVariables.resize(renderGraph.variables.size());
+		m_runtimeVariableIndices.clear();
+		m_runtimeVariableIndices.reserve(renderGraph.variables.size());
 		for (size_t i = 0; i < renderGraph.variables.size(); ++i)
 		{
 			m_runtimeVariables[i].variable = &renderGraph.variables[i];
 			m_runtimeVariables[i].storage  = m_variableStorage.Get(*m_runtimeVariables[i].variable);
+			m_runtimeVariableIndices.emplace(renderGraph.variables[i].name, (int)i); // the first one wins if names repeat
 		}
 	}
 
@@ -1001,5 +1078,10 @@ protected:
 
 	VariableStorage				 m_variableStorage;
 	std::vector<RuntimeVariable> m_runtimeVariables;
+	std::unordered_map<std::string, int> m_runtimeVariableIndices; // name to index in m_runtimeVariables. Case sensitive.
+
+	std::vector<CompiledSetVar>					  m_compiledSetVars;
+	std::vector<CompiledCondition>				  m_compiledConditions;
+	std::unordered_map<const Condition*, int> m_compiledConditionIndices; // into m_compiledConditions
 	LogFn						 m_logFn = [](LogLevel level, const char* msg, ...) {};
 };
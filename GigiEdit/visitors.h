@@ -6,6 +6,7 @@
 #pragma once
 
 #include "Schemas/Types.h"
+#include "Schemas/Visitor.h"
 
 struct OnNodeRenameVisitor
 {
@@ -16,40 +17,40 @@ struct OnNodeRenameVisitor
     { }
 
     template <typename TDATA>
-    bool Visit(TDATA& data, const std::string& path)
+    bool Visit(TDATA& data, const VisitPath& path)
     {
         return true;
     }
 
-    bool Visit(NodePinReference& data, const std::string& path)
+    bool Visit(NodePinReference& data, const VisitPath& path)
     {
         if (data.node == oldName)
             data.node = newName;
         return true;
     }
 
-    bool Visit(NodePinReferenceOptional& data, const std::string& path)
+    bool Visit(NodePinReferenceOptional& data, const VisitPath& path)
     {
         if (data.node == oldName)
             data.node = newName;
         return true;
     }
 
-    bool Visit(TextureOrBufferNodeReference& data, const std::string& path)
+    bool Visit(TextureOrBufferNodeReference& data, const VisitPath& path)
     {
         if (data.name == oldName)
             data.name = newName;
         return true;
     }
 
-    bool Visit(BufferNodeReference& data, const std::string& path)
+    bool Visit(BufferNodeReference& data, const VisitPath& path)
     {
         if (data.name == oldName)
             data.name = newName;
         return true;
     }
 
-    bool Visit(TextureNodeReference& data, const std::string& path)
+    bool Visit(TextureNodeReference& data, const VisitPath& path)
     {
         if (data.name == oldName)
             data.name = newName;
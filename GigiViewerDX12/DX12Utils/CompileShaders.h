@@ -7,6 +7,9 @@
 
 #include <d3d12.h>
 #include "GigiCompilerLib/Utils.h"
+#include "ShaderCache.h"
+
+// Compiles go through ShaderCache::Get(), so a shader that hasn't changed since it was last compiled, by this or any other run of the viewer, isn't compiled again.
 
 bool MakeComputePSO_dxc(
     ID3D12Device* device,
@@ -52,4 +55,16 @@ std::vector<unsigned char> CompileShaderToByteCode_fxc(
     const D3D_SHADER_MACRO* defines,
     bool debugShaders,
     LogFn logFn,
-    std::vector<std::string>* allFiles = nullptr);
\ No newline at end of file
+    std::vector<std::string>* allFiles = nullptr);
+
+inline ShaderCompileRequest MakeShaderCompileRequest(const char* fileName, const char* entryPoint, const char* shaderModel, const D3D_SHADER_MACRO* defines, const std::string& flags)
+{
+    ShaderCompileRequest request;
+    request.fileName = fileName;
+    request.entryPoint = entryPoint ? entryPoint : "";
+    request.shaderModel = shaderModel ? shaderModel : "";
+    request.flags = flags;
+    for (int defineIndex = 0; defines && defines[defineIndex].Name; ++defineIndex)
+        request.defines.push_back({ defines[defineIndex].Name, defines[defineIndex].Definition ? defines[defineIndex].Definition : "" });
+    return request;
+}
@@ -4,6 +4,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "CompileShaders.h"
+#include "ShaderCache.h"
 
 #include <d3d12.h>
 
@@ -212,6 +213,106 @@ static IDxcBlob* CompileShaderToByteCode_Private(
 }
 
 
+// Compiles with dxc, for ShaderCache
+class ShaderCompilerDXC : public ShaderCompiler
+{
+public:
+    ShaderCompilerDXC(const char* entryPoint, const D3D_SHADER_MACRO* defines, bool debugShaders, bool HV2021, LogFn logFn)
+        : m_entryPoint(entryPoint)
+        , m_defines(defines)
+        , m_debugShaders(debugShaders)
+        , m_HV2021(HV2021)
+        , m_logFn(logFn)
+    {
+    }
+
+    std::string GetIdentity() override
+    {
+        static const std::string s_identity = []()
+        {
+            std::string identity = "dxc";
+
+            IDxcCompiler3* compiler = nullptr;
+            if (FAILED(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&compiler))))
+                return identity;
+
+            IDxcVersionInfo* versionInfo = nullptr;
+            if (SUCCEEDED(compiler->QueryInterface(IID_PPV_ARGS(&versionInfo))))
+            {
+                UINT32 major = 0, minor = 0;
+                versionInfo->GetVersion(&major, &minor);
+                identity += " " + std::to_string(major) + "." + std::to_string(minor);
+                versionInfo->Release();
+            }
+
+            // The commit tells apart builds that have the same version number
+            IDxcVersionInfo2* versionInfo2 = nullptr;
+            if (SUCCEEDED(compiler->QueryInterface(IID_PPV_ARGS(&versionInfo2))))
+            {
+                UINT32 commitCount = 0;
+                char* commitHash = nullptr;
+                if (SUCCEEDED(versionInfo2->GetCommitInfo(&commitCount, &commitHash)) && commitHash)
+                {
+                    identity += " " + std::to_string(commitCount) + " " + commitHash;
+                    CoTaskMemFree(commitHash);
+                }
+                versionInfo2->Release();
+            }
+
+            compiler->Release();
+            return identity;
+        }();
+        return s_identity;
+    }
+
+    bool Compile(const ShaderCompileRequest& request, std::vector<unsigned char>& byteCode, std::vector<std::string>& filesRead) override
+    {
+        IDxcBlob* code = CompileShaderToByteCode_Private(request.fileName.c_str(), m_entryPoint, request.shaderModel.c_str(), m_defines, m_debugShaders, m_HV2021, m_logFn, &filesRead);
+        if (!code)
+            return false;
+
+        byteCode.resize(code->GetBufferSize());
+        memcpy(byteCode.data(), code->GetBufferPointer(), byteCode.size());
+
+        code->Release();
+        return true;
+    }
+
+    // The arguments other than defines, entry point and shader model that change the bytecode
+    static std::string GetFlags(bool debugShaders, bool HV2021)
+    {
+        std::string flags;
+        if (debugShaders)
+            flags += "-Zi -Fd -Od -Qembed_debug ";
+        if (HV2021)
+            flags += "-HV 2021 ";
+        return flags;
+    }
+
+private:
+    const char* m_entryPoint = nullptr;
+    const D3D_SHADER_MACRO* m_defines = nullptr;
+    bool m_debugShaders = false;
+    bool m_HV2021 = false;
+    LogFn m_logFn;
+};
+
+static bool CompileShaderToByteCode_Cached(
+    const char* fileName,
+    const char* entryPoint,
+    const char* shaderModel,
+    const D3D_SHADER_MACRO* defines,
+    bool debugShaders,
+    bool HV2021,
+    LogFn logFn,
+    std::vector<std::string>* allFiles,
+    std::vector<unsigned char>& byteCode)
+{
+    ShaderCompilerDXC compiler(entryPoint, defines, debugShaders, HV2021, logFn);
+    ShaderCompileRequest request = MakeShaderCompileRequest(fileName, entryPoint, shaderModel, defines, ShaderCompilerDXC::GetFlags(debugShaders, HV2021));
+    return ShaderCache::Get().Compile(compiler, request, byteCode, allFiles);
+}
+
 bool MakeComputePSO_dxc(
     ID3D12Device* device,
     const char* fileName,
@@ -226,21 +327,19 @@ bool MakeComputePSO_dxc(
     LogFn logFn,
     std::vector<std::string>* allFiles)
 {
-    IDxcBlob* code = CompileShaderToByteCode_Private(fileName, entryPoint, shaderModel, defines, debugShaders, HV2021, logFn, allFiles);
-    if (!code)
+    std::vector<unsigned char> code;
+    if (!CompileShaderToByteCode_Cached(fileName, entryPoint, shaderModel, defines, debugShaders, HV2021, logFn, allFiles, code))
         return false;
 
     D3D12_COMPUTE_PIPELINE_STATE_DESC psoDesc = {};
     psoDesc.pRootSignature = rootSig;
-    psoDesc.CS.BytecodeLength = code->GetBufferSize();
-    psoDesc.CS.pShaderBytecode = code->GetBufferPointer();
+    psoDesc.CS.BytecodeLength = code.size();
+    psoDesc.CS.pShaderBytecode = code.data();
 
     HRESULT  hr = device->CreateComputePipelineState(&psoDesc, IID_PPV_ARGS(pso));
     if (FAILED(hr))
         return false;
 
-    code->Release();
-
     if (debugName)
         (*pso)->SetName(ToWideString(debugName).c_str());
 
@@ -258,14 +357,7 @@ std::vector<unsigned char> CompileShaderToByteCode_dxc(
     std::vector<std::string>* allFiles)
 {
     std::vector<unsigned char> ret;
-
-    IDxcBlob* code = CompileShaderToByteCode_Private(fileName, entryPoint, shaderModel, defines, debugShaders, HV2021, logFn, allFiles);
-    if (!code)
-        return ret;
-
-    ret.resize(code->GetBufferSize());
-    memcpy(ret.data(), code->GetBufferPointer(), ret.size());
-
-    code->Release();
+    if (!CompileShaderToByteCode_Cached(fileName, entryPoint, shaderModel, defines, debugShaders, HV2021, logFn, allFiles, ret))
+        ret.clear();
     return ret;
-}
+}
\ No newline at end of file
@@ -4,6 +4,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "CompileShaders.h"
+#include "ShaderCache.h"
 
 #include <d3d12.h>
 #include <D3Dcompiler.h>
@@ -107,6 +108,65 @@ static ID3DBlob* CompileShaderToByteCode_Private(
     return shader;
 }
 
+// Compiles with fxc, for ShaderCache
+class ShaderCompilerFXC : public ShaderCompiler
+{
+public:
+    ShaderCompilerFXC(const char* entryPoint, const D3D_SHADER_MACRO* defines, bool debugShaders, LogFn logFn)
+        : m_entryPoint(entryPoint)
+        , m_defines(defines)
+        , m_debugShaders(debugShaders)
+        , m_logFn(logFn)
+    {
+    }
+
+    std::string GetIdentity() override
+    {
+        return "fxc " D3DCOMPILER_DLL_A;
+    }
+
+    bool Compile(const ShaderCompileRequest& request, std::vector<unsigned char>& byteCode, std::vector<std::string>& filesRead) override
+    {
+        ID3DBlob* shader = CompileShaderToByteCode_Private(request.fileName.c_str(), m_entryPoint, request.shaderModel.c_str(), m_defines, m_debugShaders, m_logFn, &filesRead);
+        if (!shader)
+            return false;
+
+        byteCode.resize(shader->GetBufferSize());
+        memcpy(byteCode.data(), shader->GetBufferPointer(), byteCode.size());
+
+        shader->Release();
+        return true;
+    }
+
+    // The compile flags that change the bytecode
+    static std::string GetFlags(bool debugShaders)
+    {
+        return debugShaders ? "/Zi /Od" : "";
+    }
+
+private:
+    const char* m_entryPoint = nullptr;
+    const D3D_SHADER_MACRO* m_defines = nullptr;
+    bool m_debugShaders = false;
+    LogFn m_logFn;
+};
+
+// Warnings are only reported when the shader is actually compiled, not when it comes from the cache
+static bool CompileShaderToByteCode_Cached(
+    const char* fileName,
+    const char* entryPoint,
+    const char* shaderModel,
+    const D3D_SHADER_MACRO* defines,
+    bool debugShaders,
+    LogFn logFn,
+    std::vector<std::string>* allFiles,
+    std::vector<unsigned char>& byteCode)
+{
+    ShaderCompilerFXC compiler(entryPoint, defines, debugShaders, logFn);
+    ShaderCompileRequest request = MakeShaderCompileRequest(fileName, entryPoint, shaderModel, defines, ShaderCompilerFXC::GetFlags(debugShaders));
+    return ShaderCache::Get().Compile(compiler, request, byteCode, allFiles);
+}
+
 bool MakeComputePSO_fxc(
     ID3D12Device* device,
     const char* fileName,
@@ -120,15 +180,15 @@ bool MakeComputePSO_fxc(
     LogFn logFn,
     std::vector<std::string>* allFiles)
 {
-    ID3DBlob* shader = CompileShaderToByteCode_Private(fileName, entryPoint, shaderModel, defines, debugShaders, logFn, allFiles);
-    if (!shader)
+    std::vector<unsigned char> shader;
+    if (!CompileShaderToByteCode_Cached(fileName, entryPoint, shaderModel, defines, debugShaders, logFn, allFiles, shader))
         return false;
 
     // Put shader bytecode into PSO
     D3D12_COMPUTE_PIPELINE_STATE_DESC desc = {};
     desc.pRootSignature = rootSig;
-    desc.CS.pShaderBytecode = shader->GetBufferPointer();
-    desc.CS.BytecodeLength = shader->GetBufferSize();
+    desc.CS.pShaderBytecode = shader.data();
+    desc.CS.BytecodeLength = shader.size();
 
     // Make PSO
     HRESULT hr = device->CreateComputePipelineState(&desc, IID_PPV_ARGS(pso));
@@ -138,9 +198,6 @@ bool MakeComputePSO_fxc(
         return false;
     }
 
-    if (shader) shader->Release();
-    shader = nullptr;
-
     if (debugName)
         (*pso)->SetName(ToWideString(debugName).c_str());
 
@@ -157,14 +214,7 @@ std::vector<unsigned char> CompileShaderToByteCode_fxc(
     std::vector<std::string>* allFiles)
 {
     std::vector<unsigned char> ret;
-
-    ID3DBlob* shader = CompileShaderToByteCode_Private(fileName, entryPoint, shaderModel, defines, debugShaders, logFn, allFiles);
-    if (!shader)
-        return ret;
-
-    ret.resize(shader->GetBufferSize());
-    memcpy(ret.data(), shader->GetBufferPointer(), ret.size());
-
-    shader->Release();
+    if (!CompileShaderToByteCode_Cached(fileName, entryPoint, shaderModel, defines, debugShaders, logFn, allFiles, ret))
+        ret.clear();
     return ret;
 }
\ No newline at end of file
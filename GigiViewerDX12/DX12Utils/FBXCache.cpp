@@ -4,29 +4,13 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "FBXCache.h"
+#include "TangentGenerator.h"
 
 #include "../external/OpenFBX/ofbx.h"
 
 #include <filesystem>
 #include <algorithm>
 
-static Vec2 ToVec2(const ofbx::Vec2& v)
-{
-	Vec2 ret;
-	ret[0] = (float)v.x;
-	ret[1] = (float)v.y;
-	return ret;
-}
-
-static Vec3 ToVec3(const ofbx::Vec3& v)
-{
-	Vec3 ret;
-	ret[0] = (float)v.x;
-	ret[1] = (float)v.y;
-	ret[2] = (float)v.z;
-	return ret;
-}
-
 FBXCache::FBXData& FBXCache::Get(FileCache& fileCache, const char* fileName_)
 {
 	// normalize the string by making it canonical and making it lower case
@@ -70,6 +54,8 @@ FBXCache::FBXData& FBXCache::Get(FileCache& fileCache, const char* fileName_)
 	// Flatten the fbx so that it doesn't use indices
 	std::vector<FlattenedVertex>& geometry = fbxData.flattenedVertices;
 	{
+		TangentGenerator tangentGenerator;
+		std::vector<int> tangentKeys;
 		int meshCount = fbxScene->getMeshCount();
 		for (int meshIndex = 0; meshIndex < meshCount; ++meshIndex)
 		{
@@ -78,7 +64,6 @@ FBXCache::FBXData& FBXCache::Get(FileCache& fileCache, const char* fileName_)
 			const ofbx::Mesh& mesh = *fbxScene->getMesh(meshIndex);
 			const ofbx::Geometry& geom = *mesh.getGeometry();
 
-			int vertexCount = geom.getVertexCount();
 			int indexCount = geom.getIndexCount();
 
 			const ofbx::Vec3* vertices = geom.getVertices();
@@ -144,85 +129,11 @@ FBXCache::FBXData& FBXCache::Get(FileCache& fileCache, const char* fileName_)
 			if (!uvs)
 				continue;
 
-			// Calculate tangents and bitangents, using uv0
-			std::vector<Vec3> tangents(vertexCount, Vec3{ 0.0f, 0.0f, 0.0f });
-			std::vector<Vec3> bitangents(vertexCount, Vec3{ 0.0f, 0.0f, 0.0f });
-			for (int i = 0; i < indexCount; i += 3)
-			{
-				int vertexIndex1 = (faceIndices[i + 0] < 0) ? -(faceIndices[i + 0] + 1) : faceIndices[i + 0];
-				int vertexIndex2 = (faceIndices[i + 1] < 0) ? -(faceIndices[i + 1] + 1) : faceIndices[i + 1];
-				int vertexIndex3 = (faceIndices[i + 2] < 0) ? -(faceIndices[i + 2] + 1) : faceIndices[i + 2];
-
-				int vi1 = vertexIndex1;
-				int ti1 = i + 0;
-
-				int vi2 = vertexIndex2;
-				int ti2 = i + 1;
-
-				int vi3 = vertexIndex3;
-				int ti3 = i + 2;
-
-				Vec3 pos1 = ToVec3(vertices[vi1]);
-				Vec3 pos2 = ToVec3(vertices[vi2]);
-				Vec3 pos3 = ToVec3(vertices[vi3]);
-
-				Vec2 uv1 = ToVec2(uvs[ti1]);
-				Vec2 uv2 = ToVec2(uvs[ti2]);
-				Vec2 uv3 = ToVec2(uvs[ti3]);
-
-				Vec3 pos21 = pos2 - pos1;
-				Vec3 pos31 = pos3 - pos1;
-
-				Vec2 uv21 = uv2 - uv1;
-				Vec2 uv31 = uv3 - uv1;
-
-				float r = 1.0f / (uv21[0] * uv31[1] - uv21[1] * uv31[0]);
-
-				if (std::isfinite(r))
-				{
-					Vec3 u = Vec3{ (uv31[1] * pos21[0] - uv21[1] * pos31[0]) * r, (uv31[1] * pos21[1] - uv21[1] * pos31[1]) * r, (uv31[1] * pos21[2] - uv21[1] * pos31[2]) * r };
-					Vec3 v = Vec3{ (uv21[0] * pos31[0] - uv31[0] * pos21[0]) * r, (uv21[0] * pos31[1] - uv31[0] * pos21[1]) * r, (uv21[0] * pos31[2] - uv31[0] * pos21[2]) * r };
-
-					tangents[vi1] += u;
-					tangents[vi2] += u;
-					tangents[vi3] += u;
-
-					bitangents[vi1] += v;
-					bitangents[vi2] += v;
-					bitangents[vi3] += v;
-				}
-			}
-
-			for (size_t indexIndex = 0; indexIndex < indexCount; ++indexIndex)
-			{
-				int vi = (faceIndices[indexIndex] < 0) ? -(faceIndices[indexIndex] + 1) : faceIndices[indexIndex];
-				int ni = (int)indexIndex;
-
-				Vec3 normal = ToVec3(normals[ni]);
-
-				Vec3& tangent = tangents[vi];
-				Vec3& bitangent = bitangents[vi];
-
-				Vec3 tangentOut = tangent - normal * Dot(normal, tangent);
-				if (Dot(tangentOut, tangentOut) < 0.00001f)
-					tangentOut = tangent;
-
-				if (Dot(tangentOut, tangentOut) > 0.0f)
-				{
-					tangentOut = Normalize(tangentOut);
-					geometry[geometryIndexStart + indexIndex].tangent[0] = tangentOut[0];
-					geometry[geometryIndexStart + indexIndex].tangent[1] = tangentOut[1];
-					geometry[geometryIndexStart + indexIndex].tangent[2] = tangentOut[2];
-					geometry[geometryIndexStart + indexIndex].tangent[3] = (Dot(Cross(normal, tangent), bitangent) < 0.0f) ? 0.0f : 1.0f;
-				}
-				else
-				{
-					geometry[geometryIndexStart + indexIndex].tangent[0] = 1.0f;
-					geometry[geometryIndexStart + indexIndex].tangent[1] = 0.0f;
-					geometry[geometryIndexStart + indexIndex].tangent[2] = 0.0f;
-					geometry[geometryIndexStart + indexIndex].tangent[3] = 1.0f;
-				}
-			}
+			// Calculate tangents, using uv0. Vertices that share a position index share tangents.
+			tangentKeys.resize(indexCount);
+			for (int i = 0; i < indexCount; ++i)
+				tangentKeys[i] = (faceIndices[i] < 0) ? -(faceIndices[i] + 1) : faceIndices[i];
+			tangentGenerator.Generate(geometry.data() + geometryIndexStart, indexCount, tangentKeys.data());
 		}
 	}
 
@@ -230,3 +141,11 @@ FBXCache::FBXData& FBXCache::Get(FileCache& fileCache, const char* fileName_)
 	m_cache[fileName] = fbxData;
 	return m_cache[fileName];
 }
+
+FBXCache::FBXData& FBXCache::GetIndexed(FileCache& fileCache, const char* fileName)
+{
+	FBXData& data = Get(fileCache, fileName);
+	if (data.valid && !data.indexedMesh.built)
+		data.indexedMesh.Build(data.flattenedVertices);
+	return data;
+}
@@ -13,6 +13,7 @@
 
 #include "FileCache.h"
 #include "FlattenedVertex.h"
+#include "IndexedMesh.h"
 // clang-format on
 
 class FBXCache
@@ -23,11 +24,15 @@ public:
 	{
 		std::string warn, error;
 		std::vector<FlattenedVertex> flattenedVertices;
+		IndexedMesh indexedMesh; // Only built when asked for through GetIndexed()
 		bool valid = false;
 	};
 
 	FBXData& Get(FileCache& fileCache, const char* fileName);
 
+	// Same as Get(), but also makes sure indexedMesh is built
+	FBXData& GetIndexed(FileCache& fileCache, const char* fileName);
+
 	bool Remove(const char* fileName)
 	{
 		if (m_cache.count(fileName) == 0)
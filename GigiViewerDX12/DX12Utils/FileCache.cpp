@@ -5,36 +5,170 @@
 
 #include "FileCache.h"
 
+#include <algorithm>
 #include <filesystem>
+#include <windows.h>
 
-FileCache::File& FileCache::Get(const char* fileName)
+// Files smaller than this are read into memory. Mapping is for the big assets (splats, meshes, raw binary data),
+// and keeps small text files that are edited while the viewer is running from being held open.
+static const size_t c_minMappedFileSize = 16 * 1024 * 1024;
+
+FileCache::Storage::~Storage()
+{
+	if (m_mappingHandle)
+	{
+		UnmapViewOfFile(m_data);
+		CloseHandle((HANDLE)m_mappingHandle);
+	}
+
+	if (m_fileHandle)
+		CloseHandle((HANDLE)m_fileHandle);
+}
+
+bool FileCache::Storage::Load(const char* fileName)
+{
+	std::error_code ec;
+	size_t fileSize = (size_t)std::filesystem::file_size(fileName, ec);
+	if (ec)
+		return false;
+
+	// The OS zero fills the rest of the last page of a mapped file, which gives us the null terminator for free.
+	// If the file ends exactly on a page boundary there is no room for it, so read those instead.
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+	if (fileSize >= c_minMappedFileSize && (fileSize % systemInfo.dwPageSize) != 0 && Map(fileName, fileSize))
+		return true;
+
+	return Read(fileName, fileSize);
+}
+
+bool FileCache::Storage::Map(const char* fileName, size_t fileSize)
+{
+	// Share write and delete so that the file can still be replaced on disk while it's mapped
+	HANDLE fileHandle = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER actualSize;
+	if (!GetFileSizeEx(fileHandle, &actualSize) || (size_t)actualSize.QuadPart != fileSize)
+	{
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mappingHandle)
+	{
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	const char* data = (const char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (!data)
+	{
+		CloseHandle(mappingHandle);
+		CloseHandle(fileHandle);
+		return false;
+	}
+
+	m_fileHandle = fileHandle;
+	m_mappingHandle = mappingHandle;
+	m_data = data;
+	m_size = fileSize;
+	m_loaded = true;
+	return true;
+}
+
+bool FileCache::Storage::Read(const char* fileName, size_t fileSize)
+{
+	FILE* file = nullptr;
+	fopen_s(&file, fileName, "rb");
+	if (!file)
+		return false;
+
+	// Add an extra null character at the end for text files.
+	m_buffer.resize(fileSize + 1);
+	size_t bytesRead = fread(m_buffer.data(), 1, fileSize, file);
+	fclose(file);
+
+	m_buffer.resize(bytesRead + 1);
+	m_buffer[bytesRead] = 0;
+
+	m_data = m_buffer.data();
+	m_size = bytesRead;
+	m_loaded = true;
+	return true;
+}
+
+FileCache::File FileCache::Get(const char* fileName)
 {
 	// normalize the string by making it canonical and making it lower case
 	std::string s = std::filesystem::weakly_canonical(fileName).string();
 	std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
 
-	// If we don't have an entry for this file, create one
-	// Add an extra null character at the end for text files.
-	// We'll report the size as size-1 to account for this.
-	if (m_cache.count(s) == 0)
+	Entry& entry = m_cache[s];
+	entry.lastUsed = ++m_useCounter;
+
+	// A mapped file is still mapped if someone is still using it
+	if (entry.loaded && !entry.file.m_storage)
 	{
-		File newFile;
+		File file;
+		file.m_storage = entry.mapped.lock();
+		if (file.m_storage)
+			return file;
+		entry.loaded = false;
+	}
 
-		FILE* file = nullptr;
-		fopen_s(&file, s.c_str(), "rb");
-		if (file)
+	// Load the file if this is the first time we've seen it, or if it was evicted or unmapped.
+	// A file that fails to load is still cached, as an invalid file.
+	if (!entry.loaded)
+	{
+		std::shared_ptr<Storage> storage = std::make_shared<Storage>();
+		storage->Load(s.c_str());
+		entry.loaded = true;
+
+		if (storage->m_mappingHandle)
 		{
-			fseek(file, 0, SEEK_END);
-			newFile.bytes.resize(ftell(file) + 1);
-			fseek(file, 0, SEEK_SET);
-			fread(newFile.bytes.data(), 1, newFile.bytes.size() - 1, file);
-			newFile.bytes[newFile.bytes.size() - 1] = 0;
-			fclose(file);
+			entry.mapped = storage;
+
+			File file;
+			file.m_storage = storage;
+			return file;
 		}
 
-		m_cache[s] = newFile;
+		entry.file.m_storage = storage;
+		m_totalBytes += entry.file.GetSize();
+
+		EvictToBudget(&entry);
 	}
 
-	// return the entry for this file
-	return m_cache[s];
-}
\ No newline at end of file
+	return entry.file;
+}
+
+void FileCache::EvictToBudget(const Entry* keep)
+{
+	if (m_byteBudget == 0)
+		return;
+
+	while (m_totalBytes > m_byteBudget)
+	{
+		Entry* oldest = nullptr;
+		for (auto& it : m_cache)
+		{
+			Entry& entry = it.second;
+			if (&entry == keep || !entry.file.m_storage || entry.file.GetSize() == 0)
+				continue;
+
+			if (!oldest || entry.lastUsed < oldest->lastUsed)
+				oldest = &entry;
+		}
+
+		if (!oldest)
+			break;
+
+		// Anyone still holding a File for this keeps the bytes alive. The cache just lets go of them.
+		m_totalBytes -= oldest->file.GetSize();
+		oldest->file = File();
+		oldest->loaded = false;
+	}
+}
@@ -8,60 +8,134 @@
 #include <vector>
 #include <unordered_map>
 #include <string>
+#include <memory>
 
 class FileCache
 {
 public:
+	// The bytes of a file. Large files are memory mapped, smaller ones are read into a buffer.
+	// Either way the bytes are followed by a null character, so text files can be parsed in place.
+	// Windows won't let a mapped file be truncated or replaced, so the cache doesn't keep mapped files alive. See Entry.
+	// Storage is not copyable. Files share it through File handles.
+	class Storage
+	{
+	public:
+		Storage() = default;
+		~Storage();
+
+		Storage(const Storage&) = delete;
+		Storage& operator=(const Storage&) = delete;
+
+		bool Load(const char* fileName);
+
+	private:
+		friend class FileCache;
+
+		bool Map(const char* fileName, size_t fileSize);
+		bool Read(const char* fileName, size_t fileSize);
+
+		bool m_loaded = false;
+		const char* m_data = nullptr;
+		size_t m_size = 0;
+
+		// Used when the file is read instead of mapped. Includes the null terminator.
+		std::vector<char> m_buffer;
+
+		// Used when the file is mapped
+		void* m_fileHandle = nullptr;
+		void* m_mappingHandle = nullptr;
+	};
+
+	// A read only view of a cached file. Copying a File shares the bytes, it doesn't copy them.
+	// The bytes stay alive as long as any File refers to them, even if the cache evicts or removes the file.
 	struct File
 	{
-		bool Valid()
+		// True if the file was read, even if it was empty
+		bool Valid() const
 		{
-			return bytes.size() > 0;
+			return m_storage && m_storage->m_loaded;
 		}
 
 		size_t GetSize() const
 		{
-			// Note that we add an extra null character on the end for text files, so size is really size-1
-			size_t ret = bytes.size();
-			if (ret > 0)
-				ret--;
-			return ret;
+			return m_storage ? m_storage->m_size : 0;
 		}
 
 		const char* GetBytes() const
 		{
-			return bytes.data();
+			return m_storage ? m_storage->m_data : "";
+		}
+
+		bool IsMapped() const
+		{
+			return m_storage && m_storage->m_mappingHandle != nullptr;
 		}
 
 	private:
 		friend class FileCache;
 
-		// Hidden away because we add an extra character for a null terminator for text files
-		std::vector<char> bytes;
+		std::shared_ptr<const Storage> m_storage;
+	};
+
+	// Files that were read into a buffer are held by file, and count against the byte budget.
+	// Mapped files are only referenced weakly by mapped, so they are unmapped once the last File using them is gone,
+	// and a program that overwrites them while the viewer is running isn't blocked. They are mapped again on the next Get().
+	struct Entry
+	{
+		File file;
+		std::weak_ptr<const Storage> mapped;
+		bool loaded = false;
+		unsigned long long lastUsed = 0;
 	};
 
-	File& Get(const char* fileName);
+	File Get(const char* fileName);
 
 	bool Remove(const char* fileName)
 	{
-		if (m_cache.count(fileName) == 0)
+		auto it = m_cache.find(fileName);
+		if (it == m_cache.end())
 			return false;
 
-		m_cache.erase(fileName);
+		m_totalBytes -= it->second.file.GetSize();
+		m_cache.erase(it);
 		return true;
 	}
 
 	void ClearCache()
 	{
-		std::unordered_map<std::string, File> empty;
+		std::unordered_map<std::string, Entry> empty;
 		std::swap(m_cache, empty);
+		m_totalBytes = 0;
 	}
 
-	std::unordered_map<std::string, File> getCache()
+	// Files that have been evicted or unmapped still have an entry, with loaded false or mapped expired, so that FileWatcher can still remove them
+	const std::unordered_map<std::string, Entry>& getCache() const
 	{
 		return m_cache;
 	}
 
+	// The least recently used files are evicted once the loaded files total more than this. 0 means no limit.
+	void SetByteBudget(size_t byteBudget)
+	{
+		m_byteBudget = byteBudget;
+		EvictToBudget(nullptr);
+	}
+
+	size_t GetByteBudget() const
+	{
+		return m_byteBudget;
+	}
+
+	size_t GetTotalBytes() const
+	{
+		return m_totalBytes;
+	}
+
 private:
-	std::unordered_map<std::string, File> m_cache;
-};
\ No newline at end of file
+	void EvictToBudget(const Entry* keep);
+
+	std::unordered_map<std::string, Entry> m_cache;
+	size_t m_byteBudget = size_t(2) * 1024 * 1024 * 1024;
+	size_t m_totalBytes = 0;
+	unsigned long long m_useCounter = 0;
+};
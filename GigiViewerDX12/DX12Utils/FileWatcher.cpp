@@ -0,0 +1,263 @@
+///////////////////////////////////////////////////////////////////////////////
+//         Gigi Rapid Graphics Prototyping and Code Generation Suite         //
+//        Copyright (c) 2024 Electronic Arts Inc. All rights reserved.       //
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FileWatcher.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+
+// Watches directories with overlapped ReadDirectoryChangesW calls, which are checked without blocking in GetChanges.
+class FileWatcherBackend_Windows : public FileWatcherBackend
+{
+public:
+	~FileWatcherBackend_Windows()
+	{
+		Clear();
+	}
+
+	bool WatchDirectory(const std::string& directory) override
+	{
+		std::unique_ptr<Directory> watchedDirectory = std::make_unique<Directory>();
+		watchedDirectory->path = directory;
+
+		watchedDirectory->handle = CreateFileA(directory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+		if (watchedDirectory->handle == INVALID_HANDLE_VALUE)
+			return false;
+
+		watchedDirectory->overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+		if (!watchedDirectory->overlapped.hEvent || !StartRead(*watchedDirectory))
+		{
+			Close(*watchedDirectory);
+			return false;
+		}
+
+		m_directories.push_back(std::move(watchedDirectory));
+		return true;
+	}
+
+	void Clear() override
+	{
+		for (std::unique_ptr<Directory>& directory : m_directories)
+			Close(*directory);
+		m_directories.clear();
+	}
+
+	void GetChanges(std::vector<std::string>& changedFiles, std::vector<std::string>& changedDirectories, std::vector<std::string>& unwatchedDirectories) override
+	{
+		for (size_t directoryIndex = 0; directoryIndex < m_directories.size();)
+		{
+			Directory& directory = *m_directories[directoryIndex];
+
+			// Re-arm the watch once its read is done. If that fails, such as from the directory being deleted, stop watching it.
+			if (CollectChanges(directory, changedFiles, changedDirectories) && !StartRead(directory))
+			{
+				unwatchedDirectories.push_back(directory.path);
+				Close(directory);
+				m_directories.erase(m_directories.begin() + directoryIndex);
+				continue;
+			}
+
+			directoryIndex++;
+		}
+	}
+
+private:
+	struct Directory
+	{
+		std::string path;
+		HANDLE handle = INVALID_HANDLE_VALUE;
+		OVERLAPPED overlapped = {};
+		bool reading = false;
+		alignas(DWORD) unsigned char buffer[64 * 1024];
+	};
+
+	// Returns true if the directory's read has finished, successfully or not, and needs to be started again
+	static bool CollectChanges(Directory& directory, std::vector<std::string>& changedFiles, std::vector<std::string>& changedDirectories)
+	{
+		if (!directory.reading)
+			return true;
+
+		DWORD bytesReturned = 0;
+		if (!GetOverlappedResult(directory.handle, &directory.overlapped, &bytesReturned, FALSE))
+		{
+			if (GetLastError() == ERROR_IO_INCOMPLETE)
+				return false;
+
+			// The read failed, so events may have been lost
+			directory.reading = false;
+			changedDirectories.push_back(directory.path);
+			return true;
+		}
+		directory.reading = false;
+
+		// Zero bytes means the buffer overflowed and the events were lost
+		if (bytesReturned == 0)
+		{
+			changedDirectories.push_back(directory.path);
+			return true;
+		}
+
+		const unsigned char* entry = directory.buffer;
+		while (true)
+		{
+			const FILE_NOTIFY_INFORMATION* info = (const FILE_NOTIFY_INFORMATION*)entry;
+
+			int nameLength = (int)(info->FileNameLength / sizeof(WCHAR));
+			int size = WideCharToMultiByte(CP_ACP, 0, info->FileName, nameLength, nullptr, 0, nullptr, nullptr);
+			std::string name(size, 0);
+			WideCharToMultiByte(CP_ACP, 0, info->FileName, nameLength, name.data(), size, nullptr, nullptr);
+			changedFiles.push_back((std::filesystem::path(directory.path) / name).string());
+
+			if (info->NextEntryOffset == 0)
+				break;
+			entry += info->NextEntryOffset;
+		}
+		return true;
+	}
+
+	static bool StartRead(Directory& directory)
+	{
+		const DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_CREATION;
+		ResetEvent(directory.overlapped.hEvent);
+		directory.reading = ReadDirectoryChangesW(directory.handle, directory.buffer, sizeof(directory.buffer), FALSE, filter, nullptr, &directory.overlapped, nullptr) != 0;
+		return directory.reading;
+	}
+
+	static void Close(Directory& directory)
+	{
+		if (directory.reading)
+		{
+			// Wait for the cancel to finish, since the OS writes into the buffer until then
+			DWORD bytesReturned = 0;
+			CancelIoEx(directory.handle, &directory.overlapped);
+			GetOverlappedResult(directory.handle, &directory.overlapped, &bytesReturned, TRUE);
+			directory.reading = false;
+		}
+
+		if (directory.overlapped.hEvent)
+		{
+			CloseHandle(directory.overlapped.hEvent);
+			directory.overlapped.hEvent = nullptr;
+		}
+
+		if (directory.handle != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(directory.handle);
+			directory.handle = INVALID_HANDLE_VALUE;
+		}
+	}
+
+	// Directories are heap allocated because the OS holds pointers to their buffer and overlapped structure
+	std::vector<std::unique_ptr<Directory>> m_directories;
+};
+
+#elif defined(__linux__)
+
+// Watches directories with a non blocking inotify instance
+class FileWatcherBackend_Inotify : public FileWatcherBackend
+{
+public:
+	FileWatcherBackend_Inotify()
+	{
+		m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	}
+
+	~FileWatcherBackend_Inotify()
+	{
+		if (m_fd != -1)
+			close(m_fd);
+	}
+
+	bool Valid() const
+	{
+		return m_fd != -1;
+	}
+
+	bool WatchDirectory(const std::string& directory) override
+	{
+		const uint32_t mask = IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+		int wd = inotify_add_watch(m_fd, directory.c_str(), mask);
+		if (wd == -1)
+			return false;
+
+		m_directories[wd] = directory;
+		return true;
+	}
+
+	void Clear() override
+	{
+		for (auto& it : m_directories)
+			inotify_rm_watch(m_fd, it.first);
+		m_directories.clear();
+	}
+
+	void GetChanges(std::vector<std::string>& changedFiles, std::vector<std::string>& changedDirectories, std::vector<std::string>& unwatchedDirectories) override
+	{
+		alignas(inotify_event) char buffer[64 * 1024];
+		while (true)
+		{
+			ssize_t bytesRead = read(m_fd, buffer, sizeof(buffer));
+			if (bytesRead <= 0)
+				break;
+
+			for (char* entry = buffer; entry < buffer + bytesRead;)
+			{
+				const inotify_event* event = (const inotify_event*)entry;
+				entry += sizeof(inotify_event) + event->len;
+
+				// The event queue overflowed and events were lost
+				if (event->mask & IN_Q_OVERFLOW)
+				{
+					for (auto& it : m_directories)
+						changedDirectories.push_back(it.second);
+					continue;
+				}
+
+				auto it = m_directories.find(event->wd);
+				if (it == m_directories.end())
+					continue;
+
+				// Events without a name are about the directory itself, such as it being deleted or moved
+				if (event->len > 0)
+					changedFiles.push_back((std::filesystem::path(it->second) / event->name).string());
+				else
+					changedDirectories.push_back(it->second);
+
+				// The watch was removed, such as from the directory being deleted
+				if (event->mask & IN_IGNORED)
+				{
+					unwatchedDirectories.push_back(it->second);
+					m_directories.erase(it);
+				}
+			}
+		}
+	}
+
+private:
+	int m_fd = -1;
+	std::unordered_map<int, std::string> m_directories;
+};
+
+#endif
+
+std::unique_ptr<FileWatcherBackend> FileWatcherBackend::Create()
+{
+#if defined(_WIN32)
+	return std::make_unique<FileWatcherBackend_Windows>();
+#elif defined(__linux__)
+	std::unique_ptr<FileWatcherBackend_Inotify> backend = std::make_unique<FileWatcherBackend_Inotify>();
+	if (!backend->Valid())
+		return nullptr;
+	return backend;
+#else
+	return nullptr;
+#endif
+}
@@ -8,16 +8,54 @@
 #include <unordered_map>
 #include <filesystem>
 #include <string>
+#include <vector>
+#include <memory>
 #include <chrono>
+#include <algorithm>
+
+// Tells FileWatcher which files may have changed, so it only has to look at those, instead of polling every file.
+// Backends watch whole directories, since editors often save by writing a temp file and renaming it over the original.
+class FileWatcherBackend
+{
+public:
+	virtual ~FileWatcherBackend() {}
+
+	// Returns false if the directory can't be watched, in which case FileWatcher polls the files in it.
+	virtual bool WatchDirectory(const std::string& directory) = 0;
+
+	virtual void Clear() = 0;
+
+	// Gets the files that have had events since the last call. Doesn't block.
+	// A directory in changedDirectories means events were lost, so any file in it may have changed.
+	// A directory in unwatchedDirectories is no longer watched, such as from being deleted, so the files in it need to be polled.
+	virtual void GetChanges(std::vector<std::string>& changedFiles, std::vector<std::string>& changedDirectories, std::vector<std::string>& unwatchedDirectories) = 0;
+
+	// ReadDirectoryChangesW on windows, inotify on linux. Returns nullptr if there is no backend for this platform.
+	static std::unique_ptr<FileWatcherBackend> Create();
+};
 
 template <typename TENTRYDATA>
 class FileWatcher
 {
 public:
-	FileWatcher(float checkIntervalSeconds)
+	// Files that can't be watched by the backend are polled every checkIntervalSeconds.
+	// Files with events are checked once they have gone debounceSeconds without another event, so that a burst of writes is reported once.
+	FileWatcher(float checkIntervalSeconds, float debounceSeconds = 0.1f)
 	{
 		m_lastTick = std::chrono::steady_clock::now();
 		m_checkIntervalSeconds = checkIntervalSeconds;
+		m_debounceSeconds = debounceSeconds;
+		m_backend = FileWatcherBackend::Create();
+	}
+
+	// A null backend polls every file
+	void SetBackend(std::unique_ptr<FileWatcherBackend> backend)
+	{
+		m_backend = std::move(backend);
+		m_watchedDirectories.clear();
+		m_pendingChanges.clear();
+		for (auto& it : m_trackedFiles)
+			it.second.polled = !WatchDirectoryOf(it.first);
 	}
 
 	void Add(const char* fileName_, const TENTRYDATA& data)
@@ -35,6 +73,7 @@ public:
 		EntryData entryData;
 		entryData.time = time;
 		entryData.data = data;
+		entryData.polled = !WatchDirectoryOf(s);
 
 		m_trackedFiles[fileName] = entryData;
 	}
@@ -42,34 +81,104 @@ public:
 	void Clear()
 	{
 		m_trackedFiles.clear();
+		m_watchedDirectories.clear();
+		m_pendingChanges.clear();
+		if (m_backend)
+			m_backend->Clear();
 	}
 
 	template <typename LAMBDA>
 	bool Tick(const LAMBDA& lambda)
 	{
 		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
-		if (std::chrono::duration_cast<std::chrono::duration<float>>(now - m_lastTick).count() < m_checkIntervalSeconds)
-			return false;
-		m_lastTick = now;
+
+		// Gather events every tick, so the debounce timing is accurate
+		if (m_backend)
+		{
+			m_changedFiles.clear();
+			m_changedDirectories.clear();
+			m_unwatchedDirectories.clear();
+			m_backend->GetChanges(m_changedFiles, m_changedDirectories, m_unwatchedDirectories);
+
+			for (std::string& fileName : m_changedFiles)
+			{
+				std::transform(fileName.begin(), fileName.end(), fileName.begin(), [](unsigned char c) { return std::tolower(c); });
+				if (m_trackedFiles.count(fileName) != 0)
+					m_pendingChanges[fileName] = now;
+			}
+
+			for (std::string& directory : m_changedDirectories)
+			{
+				std::transform(directory.begin(), directory.end(), directory.begin(), [](unsigned char c) { return std::tolower(c); });
+				for (auto& it : m_trackedFiles)
+				{
+					if (std::filesystem::path(it.first).parent_path() == directory)
+						m_pendingChanges[it.first] = now;
+				}
+			}
+
+			// Fall back to polling. The directory is watched again the next time a file in it is added.
+			for (std::string& directory : m_unwatchedDirectories)
+			{
+				std::transform(directory.begin(), directory.end(), directory.begin(), [](unsigned char c) { return std::tolower(c); });
+				m_watchedDirectories.erase(directory);
+				for (auto& it : m_trackedFiles)
+				{
+					if (std::filesystem::path(it.first).parent_path() == directory)
+					{
+						it.second.polled = true;
+						m_pendingChanges[it.first] = now;
+					}
+				}
+			}
+		}
+
+		// Check the files whose events have settled
+		m_filesToCheck.clear();
+		for (auto it = m_pendingChanges.begin(); it != m_pendingChanges.end();)
+		{
+			if (std::chrono::duration_cast<std::chrono::duration<float>>(now - it->second).count() >= m_debounceSeconds)
+			{
+				m_filesToCheck.push_back(it->first);
+				it = m_pendingChanges.erase(it);
+			}
+			else
+				++it;
+		}
+
+		// Poll the files that the backend can't watch
+		if (std::chrono::duration_cast<std::chrono::duration<float>>(now - m_lastTick).count() >= m_checkIntervalSeconds)
+		{
+			m_lastTick = now;
+			for (auto& it : m_trackedFiles)
+			{
+				if (it.second.polled)
+					m_filesToCheck.push_back(it.first);
+			}
+		}
 
 		bool ret = false;
-		for (auto& it : m_trackedFiles)
+		for (const std::string& fileName : m_filesToCheck)
 		{
+			auto it = m_trackedFiles.find(fileName);
+			if (it == m_trackedFiles.end())
+				continue;
+
 			std::error_code ec;
-			std::filesystem::file_time_type time = std::filesystem::last_write_time(it.first, ec);
+			std::filesystem::file_time_type time = std::filesystem::last_write_time(it->first, ec);
 			if (ec)
 			{
-				lambda(it.first, it.second.data);
+				lambda(it->first, it->second.data);
 				ret = true;
-				m_trackedFiles.erase(it.first);
+				m_trackedFiles.erase(it);
 			}
 			else
 			{
-				if (time != it.second.time)
+				if (time != it->second.time)
 				{
-					lambda(it.first, it.second.data);
+					lambda(it->first, it->second.data);
 					ret = true;
-					m_trackedFiles[it.first].time = time;
+					it->second.time = time;
 				}
 			}
 		}
@@ -80,16 +189,42 @@ public:
 	{
 		TENTRYDATA data;
 		std::filesystem::file_time_type time;
+		bool polled = true; // true if the backend couldn't watch the file's directory
 	};
 
-	std::unordered_map<std::string, EntryData> getTrackedFiles()
+	const std::unordered_map<std::string, EntryData>& getTrackedFiles() const
 	{
 		return m_trackedFiles;
 	}
 
 private:
+	bool WatchDirectoryOf(const std::string& fileName)
+	{
+		if (!m_backend)
+			return false;
+
+		std::string directory = std::filesystem::path(fileName).parent_path().string();
+		auto it = m_watchedDirectories.find(directory);
+		if (it != m_watchedDirectories.end())
+			return it->second;
+
+		bool watched = m_backend->WatchDirectory(directory);
+		m_watchedDirectories[directory] = watched;
+		return watched;
+	}
 
 	std::unordered_map<std::string, EntryData> m_trackedFiles;
 	float m_checkIntervalSeconds = 0.0f;
+	float m_debounceSeconds = 0.0f;
 	std::chrono::steady_clock::time_point m_lastTick;
-};
\ No newline at end of file
+
+	std::unique_ptr<FileWatcherBackend> m_backend;
+	std::unordered_map<std::string, bool> m_watchedDirectories; // whether the backend is watching each directory
+	std::unordered_map<std::string, std::chrono::steady_clock::time_point> m_pendingChanges; // files with events, and the time of the last one
+
+	// Scratch memory, reused between ticks
+	std::vector<std::string> m_changedFiles;
+	std::vector<std::string> m_changedDirectories;
+	std::vector<std::string> m_unwatchedDirectories;
+	std::vector<std::string> m_filesToCheck;
+};
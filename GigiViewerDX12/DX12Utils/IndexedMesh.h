@@ -0,0 +1,101 @@
+///////////////////////////////////////////////////////////////////////////////
+//         Gigi Rapid Graphics Prototyping and Code Generation Suite         //
+//        Copyright (c) 2024 Electronic Arts Inc. All rights reserved.       //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// clang-format off
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+#include "FlattenedVertex.h"
+// clang-format on
+
+// A mesh with identical vertices welded together, and an index buffer to draw it with.
+// Built from the flattened (three vertices per triangle) meshes that ObjCache and FBXCache make.
+struct IndexedMesh
+{
+	std::vector<FlattenedVertex> vertices;
+	std::vector<uint32_t> indices;
+	bool built = false;
+
+	bool Fits16BitIndices() const
+	{
+		return vertices.size() <= 65536;
+	}
+
+	// Vertices are welded only if every attribute is bitwise identical, so the indexed mesh renders exactly like the flattened one.
+	// Vertices are kept in order of first use, which keeps the index buffer cache friendly.
+	void Build(const std::vector<FlattenedVertex>& flattenedVertices)
+	{
+		vertices.clear();
+		indices.clear();
+		built = true;
+
+		if (flattenedVertices.empty())
+			return;
+
+		// Open addressing hash table of vertex index + 1, at most half full
+		size_t tableSize = 1;
+		while (tableSize < flattenedVertices.size() * 2)
+			tableSize *= 2;
+		std::vector<uint32_t> table(tableSize, 0);
+		const size_t tableMask = tableSize - 1;
+
+		vertices.reserve(flattenedVertices.size() / 2);
+		indices.resize(flattenedVertices.size());
+
+		for (size_t flattenedIndex = 0; flattenedIndex < flattenedVertices.size(); ++flattenedIndex)
+		{
+			const FlattenedVertex& vertex = flattenedVertices[flattenedIndex];
+
+			size_t slot = HashVertex(vertex) & tableMask;
+			while (true)
+			{
+				uint32_t entry = table[slot];
+				if (entry == 0)
+				{
+					table[slot] = (uint32_t)vertices.size() + 1;
+					indices[flattenedIndex] = (uint32_t)vertices.size();
+					vertices.push_back(vertex);
+					break;
+				}
+
+				if (memcmp(&vertices[entry - 1], &vertex, sizeof(FlattenedVertex)) == 0)
+				{
+					indices[flattenedIndex] = entry - 1;
+					break;
+				}
+
+				slot = (slot + 1) & tableMask;
+			}
+		}
+
+		vertices.shrink_to_fit();
+	}
+
+private:
+	static_assert(sizeof(FlattenedVertex) % sizeof(uint32_t) == 0, "FlattenedVertex is hashed and compared as an array of 32 bit words, so can't have padding");
+
+	static size_t HashVertex(const FlattenedVertex& vertex)
+	{
+		// FNV-1a over the 32 bit words of the vertex, with a final mix so the low bits are usable as a table index
+		uint32_t words[sizeof(FlattenedVertex) / sizeof(uint32_t)];
+		memcpy(words, &vertex, sizeof(FlattenedVertex));
+
+		uint64_t hash = 14695981039346656037ull;
+		for (uint32_t word : words)
+		{
+			hash ^= word;
+			hash *= 1099511628211ull;
+		}
+
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdull;
+		hash ^= hash >> 33;
+		return (size_t)hash;
+	}
+};
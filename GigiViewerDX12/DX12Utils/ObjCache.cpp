@@ -4,12 +4,29 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "ObjCache.h"
+#include "TangentGenerator.h"
 
 #define TINYOBJLOADER_IMPLEMENTATION
 #include "tinyobjloader/tiny_obj_loader.h"
 
 #include <filesystem>
 #include <algorithm>
+#include <istream>
+#include <streambuf>
+
+namespace
+{
+	// Lets tinyobj read the cached bytes of a file in place, instead of from a copy of them in a stringstream
+	class ViewStreamBuf : public std::streambuf
+	{
+	public:
+		ViewStreamBuf(const char* data, size_t size)
+		{
+			char* begin = const_cast<char*>(data);
+			setg(begin, begin, begin + size);
+		}
+	};
+}
 
 ObjCache::OBJData& ObjCache::Get(FileCache& fileCache, const char* fileName_)
 {
@@ -25,9 +42,8 @@ ObjCache::OBJData& ObjCache::Get(FileCache& fileCache, const char* fileName_)
 
 	FileCache::File fileData = fileCache.Get(fileName);
 
-	std::stringstream objStream;
-	if (fileData.Valid())
-		objStream << fileData.GetBytes();
+	ViewStreamBuf objStreamBuf(fileData.GetBytes(), fileData.GetSize());
+	std::istream objStream(&objStreamBuf);
 
 	OBJData objData;
 	if (!tinyobj::LoadObj(
@@ -46,6 +62,8 @@ ObjCache::OBJData& ObjCache::Get(FileCache& fileCache, const char* fileName_)
 
 	// Flatten the obj so that it doesn't use indices
 	std::vector<FlattenedVertex>& geometry = objData.flattenedVertices;
+	TangentGenerator tangentGenerator;
+	std::vector<int> tangentKeys;
 	int shapeIndex = -1;
 	for (const auto& shape : objData.shapes)
 	{
@@ -105,120 +123,23 @@ ObjCache::OBJData& ObjCache::Get(FileCache& fileCache, const char* fileName_)
 			geometry[geometryIndexStart + faceIndex * 3 + 2].materialID = shape.mesh.material_ids[faceIndex];
 		}
 
-		// Calculate tangents and bitangents
-		std::vector<Vec3> tangents(objData.attrib.vertices.size(), Vec3{ 0.0f, 0.0f, 0.0f });
-		std::vector<Vec3> bitangents(objData.attrib.vertices.size(), Vec3{ 0.0f, 0.0f, 0.0f });
-		for (size_t indexIndex = 0; indexIndex < shape.mesh.indices.size(); indexIndex += 3)
-		{
-			int vi1 = shape.mesh.indices[indexIndex + 0].vertex_index;
-			int ti1 = shape.mesh.indices[indexIndex + 0].texcoord_index;
-
-			int vi2 = shape.mesh.indices[indexIndex + 1].vertex_index;
-			int ti2 = shape.mesh.indices[indexIndex + 1].texcoord_index;
-
-			int vi3 = shape.mesh.indices[indexIndex + 2].vertex_index;
-			int ti3 = shape.mesh.indices[indexIndex + 2].texcoord_index;
-
-			Vec3 pos1 = Vec3
-			{
-				objData.attrib.vertices[3 * vi1 + 0],
-				objData.attrib.vertices[3 * vi1 + 1],
-				objData.attrib.vertices[3 * vi1 + 2],
-			};
-
-			Vec3 pos2 = Vec3
-			{
-				objData.attrib.vertices[3 * vi2 + 0],
-				objData.attrib.vertices[3 * vi2 + 1],
-				objData.attrib.vertices[3 * vi2 + 2],
-			};
-
-			Vec3 pos3 = Vec3
-			{
-				objData.attrib.vertices[3 * vi3 + 0],
-				objData.attrib.vertices[3 * vi3 + 1],
-				objData.attrib.vertices[3 * vi3 + 2],
-			};
-
-			Vec2 uv1 = Vec2
-			{
-				objData.attrib.texcoords[2 * ti1 + 0],
-				objData.attrib.texcoords[2 * ti1 + 1],
-			};
-
-			Vec2 uv2 = Vec2
-			{
-				objData.attrib.texcoords[2 * ti2 + 0],
-				objData.attrib.texcoords[2 * ti2 + 1],
-			};
-
-			Vec2 uv3 = Vec2
-			{
-				objData.attrib.texcoords[2 * ti3 + 0],
-				objData.attrib.texcoords[2 * ti3 + 1],
-			};
-
-			Vec3 pos21 = pos2 - pos1;
-			Vec3 pos31 = pos3 - pos1;
-
-			Vec2 uv21 = uv2 - uv1;
-			Vec2 uv31 = uv3 - uv1;
-
-			float r = 1.0f / (uv21[0] * uv31[1] - uv21[1] * uv31[0]);
-
-			if (std::isfinite(r))
-			{
-				Vec3 u = Vec3{ (uv31[1] * pos21[0] - uv21[1] * pos31[0]) * r, (uv31[1] * pos21[1] - uv21[1] * pos31[1]) * r, (uv31[1] * pos21[2] - uv21[1] * pos31[2]) * r };
-				Vec3 v = Vec3{ (uv21[0] * pos31[0] - uv31[0] * pos21[0]) * r, (uv21[0] * pos31[1] - uv31[0] * pos21[1]) * r, (uv21[0] * pos31[2] - uv31[0] * pos21[2]) * r };
-
-				tangents[vi1] += u;
-				tangents[vi2] += u;
-				tangents[vi3] += u;
-
-				bitangents[vi1] += v;
-				bitangents[vi2] += v;
-				bitangents[vi3] += v;
-			}
-		}
-
+		// Calculate tangents. Vertices that share a position index share tangents.
+		// uvs[0] has v flipped relative to the file, which flips the bitangent.
+		tangentKeys.resize(shape.mesh.indices.size());
 		for (size_t indexIndex = 0; indexIndex < shape.mesh.indices.size(); ++indexIndex)
-		{
-			int vi = shape.mesh.indices[indexIndex].vertex_index;
-			int ni = shape.mesh.indices[indexIndex].normal_index;
-
-			Vec3 normal = Vec3
-			{
-				objData.attrib.normals[3 * ni + 0],
-				objData.attrib.normals[3 * ni + 1],
-				objData.attrib.normals[3 * ni + 2]
-			};
-
-			Vec3& tangent = tangents[vi];
-			Vec3& bitangent = bitangents[vi];
-
-			Vec3 tangentOut = tangent - normal * Dot(normal, tangent);
-			if (Dot(tangentOut, tangentOut) < 0.00001f)
-				tangentOut = tangent;
-
-			if (Dot(tangentOut, tangentOut) > 0.0f)
-			{
-				tangentOut = Normalize(tangentOut);
-				geometry[geometryIndexStart + indexIndex].tangent[0] = tangentOut[0];
-				geometry[geometryIndexStart + indexIndex].tangent[1] = tangentOut[1];
-				geometry[geometryIndexStart + indexIndex].tangent[2] = tangentOut[2];
-				geometry[geometryIndexStart + indexIndex].tangent[3] = (Dot(Cross(normal, tangent), bitangent) < 0.0f) ? 0.0f : 1.0f;
-			}
-			else
-			{
-				geometry[geometryIndexStart + indexIndex].tangent[0] = 1.0f;
-				geometry[geometryIndexStart + indexIndex].tangent[1] = 0.0f;
-				geometry[geometryIndexStart + indexIndex].tangent[2] = 0.0f;
-				geometry[geometryIndexStart + indexIndex].tangent[3] = 1.0f;
-			}
-		}
+			tangentKeys[indexIndex] = shape.mesh.indices[indexIndex].vertex_index;
+		tangentGenerator.Generate(geometry.data() + geometryIndexStart, shape.mesh.indices.size(), tangentKeys.data(), true);
 	}
 
 	objData.valid = geometry.size() > 0;
 	m_cache[fileName] = objData;
 	return m_cache[fileName];
 }
+
+ObjCache::OBJData& ObjCache::GetIndexed(FileCache& fileCache, const char* fileName)
+{
+	OBJData& data = Get(fileCache, fileName);
+	if (data.valid && !data.indexedMesh.built)
+		data.indexedMesh.Build(data.flattenedVertices);
+	return data;
+}
@@ -14,6 +14,7 @@
 #include "FileCache.h"
 #include "tinyobjloader/tiny_obj_loader.h"
 #include "FlattenedVertex.h"
+#include "IndexedMesh.h"
 // clang-format on
 
 class ObjCache
@@ -27,12 +28,16 @@ public:
 		std::string warn, error;
 
 		std::vector<FlattenedVertex> flattenedVertices;
+		IndexedMesh indexedMesh; // Only built when asked for through GetIndexed()
 
 		bool valid = false;
 	};
 
 	OBJData& Get(FileCache& fileCache, const char* fileName);
 
+	// Same as Get(), but also makes sure indexedMesh is built
+	OBJData& GetIndexed(FileCache& fileCache, const char* fileName);
+
 	bool Remove(const char* fileName)
 	{
 		if (m_cache.count(fileName) == 0)
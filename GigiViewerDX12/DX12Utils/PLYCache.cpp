@@ -7,6 +7,7 @@
 #include <filesystem>
 #include "intrin.h"
 #include <bit>
+#include <atomic>
 
 #include "GigiCompilerLib/ParseText.h"
 
@@ -71,85 +72,165 @@ namespace
 		memcpy(&buffer[start], &value, sizeof(T));
 	}
 
-	bool ReadValueIntoBuffer(std::string_view& fileView, const char*& binaryData, Format format, PLYCache::FieldType type, std::vector<unsigned char>& buffer, uint64_t& valueOut)
+	// Parses the same way as sscanf did, including the casts, and reads 0 for anything that isn't a number.
+	bool ParseAsciiValueIntoBuffer(std::string_view word, PLYCache::FieldType type, std::vector<unsigned char>& buffer, uint64_t& valueOut)
 	{
-		if (format == Format::ascii)
+		switch (type)
 		{
-			std::string_view word;
-			if (!ReadWord(fileView, word))
+			case PLYCache::FieldType::i8:
+			{
+				int32_t val = 0;
+				ParseNumber(word, val);
+				PushValueIntoBuffer(buffer, (int8_t)val);
+				valueOut = (uint64_t)val;
+				break;
+			}
+			case PLYCache::FieldType::u8:
+			{
+				uint32_t val = 0;
+				ParseNumber(word, val);
+				PushValueIntoBuffer(buffer, (uint8_t)val);
+				valueOut = (uint64_t)val;
+				break;
+			}
+			case PLYCache::FieldType::i16:
+			{
+				int32_t val = 0;
+				ParseNumber(word, val);
+				PushValueIntoBuffer(buffer, (int16_t)val);
+				valueOut = (uint64_t)val;
+				break;
+			}
+			case PLYCache::FieldType::u16:
+			{
+				uint32_t val = 0;
+				ParseNumber(word, val);
+				PushValueIntoBuffer(buffer, (uint16_t)val);
+				valueOut = (uint64_t)val;
+				break;
+			}
+			case PLYCache::FieldType::i32:
+			{
+				int32_t val = 0;
+				ParseNumber(word, val);
+				PushValueIntoBuffer(buffer, (int32_t)val);
+				valueOut = (uint64_t)val;
+				break;
+			}
+			case PLYCache::FieldType::u32:
+			{
+				uint32_t val = 0;
+				ParseNumber(word, val);
+				PushValueIntoBuffer(buffer, (uint32_t)val);
+				valueOut = (uint64_t)val;
+				break;
+			}
+			case PLYCache::FieldType::f32:
+			{
+				float val = 0.0f;
+				ParseNumber(word, val);
+				PushValueIntoBuffer(buffer, val);
+				valueOut = (uint64_t)val;
+				break;
+			}
+			case PLYCache::FieldType::f64:
+			{
+				double val = 0.0;
+				ParseNumber(word, val);
+				PushValueIntoBuffer(buffer, val);
+				valueOut = (uint64_t)val;
+				break;
+			}
+			default:
+			{
 				return false;
+			}
+		}
 
-			switch (type)
+		return true;
+	}
+
+	// Reads ascii elements that are one per line, as the format says they should be.
+	// Returns false if any line doesn't hold exactly one element.
+	bool ReadAsciiElementLines(std::string_view lines, const PLYCache::ElementGroup& elementGroup, std::vector<unsigned char>& buffer)
+	{
+		std::string_view line;
+		std::string_view word;
+		while (ReadLine(lines, line))
+		{
+			for (const PLYCache::Property& property : elementGroup.properties)
 			{
-				case PLYCache::FieldType::i8:
-				{
-					int32_t val;
-					sscanf_s(&word[0], "%i", &val);
-					PushValueIntoBuffer(buffer, (int8_t)val);
-					valueOut = (uint64_t)val;
-					break;
-				}
-				case PLYCache::FieldType::u8:
-				{
-					uint32_t val;
-					sscanf_s(&word[0], "%u", &val);
-					PushValueIntoBuffer(buffer, (uint8_t)val);
-					valueOut = (uint64_t)val;
-					break;
-				}
-				case PLYCache::FieldType::i16:
-				{
-					int32_t val;
-					sscanf_s(&word[0], "%i", &val);
-					PushValueIntoBuffer(buffer, (int16_t)val);
-					valueOut = (uint64_t)val;
-					break;
-				}
-				case PLYCache::FieldType::u16:
-				{
-					uint32_t val;
-					sscanf_s(&word[0], "%u", &val);
-					PushValueIntoBuffer(buffer, (uint16_t)val);
-					valueOut = (uint64_t)val;
-					break;
-				}
-				case PLYCache::FieldType::i32:
-				{
-					int32_t val;
-					sscanf_s(&word[0], "%i", &val);
-					PushValueIntoBuffer(buffer, (int32_t)val);
-					valueOut = (uint64_t)val;
-					break;
-				}
-				case PLYCache::FieldType::u32:
-				{
-					uint32_t val;
-					sscanf_s(&word[0], "%u", &val);
-					PushValueIntoBuffer(buffer, (uint32_t)val);
-					valueOut = (uint64_t)val;
-					break;
-				}
-				case PLYCache::FieldType::f32:
-				{
-					float val;
-					sscanf_s(&word[0], "%f", &val);
-					PushValueIntoBuffer(buffer, val);
-					valueOut = (uint64_t)val;
-					break;
-				}
-				case PLYCache::FieldType::f64:
+				uint64_t listSize = 1;
+				if (property.isList)
 				{
-					double val;
-					sscanf_s(&word[0], "%lf", &val);
-					PushValueIntoBuffer(buffer, val);
-					valueOut = (uint64_t)val;
-					break;
+					if (!ReadWord(line, word) || !ParseAsciiValueIntoBuffer(word, property.listSizeType, buffer, listSize))
+						return false;
 				}
-				default:
+
+				for (uint64_t listIndex = 0; listIndex < listSize; ++listIndex)
 				{
-					return false;
+					uint64_t dummy = 0;
+					if (!ReadWord(line, word) || !ParseAsciiValueIntoBuffer(word, property.type, buffer, dummy))
+						return false;
 				}
 			}
+
+			if (ReadWord(line, word))
+				return false;
+		}
+		return true;
+	}
+
+	// Ascii element groups are parsed in chunks of lines, on multiple threads. Returns false if the lines aren't one element each,
+	// in which case the caller should read the group word by word instead.
+	bool ReadAsciiElementGroupParallel(std::string_view& fileView, PLYCache::ElementGroup& elementGroup)
+	{
+		// Find the lines of this element group
+		std::string_view remaining = fileView;
+		std::string_view line;
+		for (unsigned int index = 0; index < elementGroup.count; ++index)
+		{
+			if (!ReadLine(remaining, line))
+				return false;
+		}
+		std::string_view groupLines = fileView.substr(0, fileView.size() - remaining.size());
+
+		std::vector<std::string_view> chunks = SplitIntoLineChunks(groupLines);
+		std::vector<std::vector<unsigned char>> chunkData(chunks.size());
+		std::atomic<bool> success = true;
+		ForEachChunkParallel(chunks.size(),
+			[&](size_t chunkIndex)
+			{
+				if (success && !ReadAsciiElementLines(chunks[chunkIndex], elementGroup, chunkData[chunkIndex]))
+					success = false;
+			}
+		);
+
+		if (!success)
+			return false;
+
+		size_t totalSize = 0;
+		for (const std::vector<unsigned char>& data : chunkData)
+			totalSize += data.size();
+
+		elementGroup.data.clear();
+		elementGroup.data.reserve(totalSize);
+		for (const std::vector<unsigned char>& data : chunkData)
+			elementGroup.data.insert(elementGroup.data.end(), data.begin(), data.end());
+
+		fileView = remaining;
+		return true;
+	}
+
+	bool ReadValueIntoBuffer(std::string_view& fileView, const char*& binaryData, Format format, PLYCache::FieldType type, std::vector<unsigned char>& buffer, uint64_t& valueOut)
+	{
+		if (format == Format::ascii)
+		{
+			std::string_view word;
+			if (!ReadWord(fileView, word))
+				return false;
+
+			return ParseAsciiValueIntoBuffer(word, type, buffer, valueOut);
 		}
 		// else binary. big endian or little endian
 		else
@@ -222,32 +303,73 @@ namespace
 
 		return true;
 	}
-}
 
-PLYCache::PLYData& PLYCache::Get(FileCache& fileCache, const char* fileName_)
-{
-	// normalize the string by making it canonical and making it lower case
-	std::string s = std::filesystem::weakly_canonical(fileName_).string();
-	std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
-	const char* fileName = s.c_str();
+	// Loads a value of type T from unaligned memory, reversing the bytes if the file's endianness is different
+	template <typename T, bool BYTESWAP>
+	T LoadValue(const unsigned char* src)
+	{
+		T value;
+		if constexpr (BYTESWAP && sizeof(T) > 1)
+		{
+			unsigned char bytes[sizeof(T)];
+			for (size_t i = 0; i < sizeof(T); ++i)
+				bytes[i] = src[sizeof(T) - 1 - i];
+			memcpy(&value, bytes, sizeof(T));
+		}
+		else
+		{
+			memcpy(&value, src, sizeof(T));
+		}
+		return value;
+	}
 
-	// Return the data if we already have it in the cache
-	if (m_cache.count(fileName) != 0)
-		return m_cache[fileName];
+	// Copies one property of count elements into a strided destination, casting it like ReadFromBinaryAndCastTo does
+	typedef void (*CopyColumnFn)(const unsigned char* src, size_t srcStride, unsigned char* dest, size_t destStride, size_t count);
 
-	// load the file
-	FileCache::File fileData = fileCache.Get(fileName);
+	template <typename TSrc, typename TDest, bool BYTESWAP>
+	void CopyColumn(const unsigned char* src, size_t srcStride, unsigned char* dest, size_t destStride, size_t count)
+	{
+		for (size_t index = 0; index < count; ++index)
+		{
+			TDest value = (TDest)LoadValue<TSrc, BYTESWAP>(src);
+			memcpy(dest, &value, sizeof(TDest));
+			src += srcStride;
+			dest += destStride;
+		}
+	}
 
-	// Parse the file
-	const char* binaryData = nullptr;
-	PLYData plyData;
-	if (fileData.Valid())
+	template <typename TDest, bool BYTESWAP>
+	CopyColumnFn GetCopyColumnFn(PLYCache::FieldType srcType)
 	{
-		plyData.valid = true;
+		switch (srcType)
+		{
+			case PLYCache::FieldType::i8: return &CopyColumn<int8_t, TDest, BYTESWAP>;
+			case PLYCache::FieldType::u8: return &CopyColumn<uint8_t, TDest, BYTESWAP>;
+			case PLYCache::FieldType::i16: return &CopyColumn<int16_t, TDest, BYTESWAP>;
+			case PLYCache::FieldType::u16: return &CopyColumn<uint16_t, TDest, BYTESWAP>;
+			case PLYCache::FieldType::i32: return &CopyColumn<int32_t, TDest, BYTESWAP>;
+			case PLYCache::FieldType::u32: return &CopyColumn<uint32_t, TDest, BYTESWAP>;
+			case PLYCache::FieldType::f32: return &CopyColumn<float, TDest, BYTESWAP>;
+			case PLYCache::FieldType::f64: return &CopyColumn<double, TDest, BYTESWAP>;
+			default: return nullptr;
+		}
+	}
 
-		std::string_view fileView = fileData.GetBytes();
-		Format format = Format::unknown;
-		ElementGroup* elementGroup = nullptr;
+	CopyColumnFn GetCopyColumnFn(PLYCache::FieldType srcType, PLYCache::FieldType destType, bool byteSwap)
+	{
+		switch (destType)
+		{
+			case PLYCache::FieldType::i32: return byteSwap ? GetCopyColumnFn<int32_t, true>(srcType) : GetCopyColumnFn<int32_t, false>(srcType);
+			case PLYCache::FieldType::u32: return byteSwap ? GetCopyColumnFn<uint32_t, true>(srcType) : GetCopyColumnFn<uint32_t, false>(srcType);
+			case PLYCache::FieldType::f32: return byteSwap ? GetCopyColumnFn<float, true>(srcType) : GetCopyColumnFn<float, false>(srcType);
+			default: return nullptr;
+		}
+	}
+
+	// Reads the header, leaving fileView after it. binaryData is set to where binary data starts.
+	bool ParseHeader(std::string_view& fileView, PLYCache::PLYData& plyData, Format& format, const char*& binaryData)
+	{
+		PLYCache::ElementGroup* elementGroup = nullptr;
 
 		// read the header
 		{
@@ -326,10 +448,10 @@ PLYCache::PLYData& PLYCache::Get(FileCache& fileCache, const char* fileName_)
 						break;
 					}
 
-					ElementGroup newElementGroup;
+					PLYCache::ElementGroup newElementGroup;
 					newElementGroup.name = word;
 
-					if (!ReadWord(line, word) || !sscanf_s(&word[0], "%u", &newElementGroup.count))
+					if (!ReadWord(line, word) || !ParseNumber(word, newElementGroup.count))
 					{
 						plyData.error += "Could not read vertex count\n";
 						fileView = "";
@@ -349,8 +471,11 @@ PLYCache::PLYData& PLYCache::Get(FileCache& fileCache, const char* fileName_)
 				// end_header
 				else if (word == "end_header")
 				{
+					// The data starts right after the new line. Only skip one, since binary data can start with bytes that look like new lines.
 					binaryData = &word.data()[word.size()];
-					while (IsNewLine(*binaryData))
+					if (*binaryData == '\r')
+						binaryData++;
+					if (*binaryData == '\n')
 						binaryData++;
 					headerEnded = true;
 					break;
@@ -367,7 +492,7 @@ PLYCache::PLYData& PLYCache::Get(FileCache& fileCache, const char* fileName_)
 						break;
 					}
 
-					std::vector<Property>& properties = elementGroup->properties;
+					std::vector<PLYCache::Property>& properties = elementGroup->properties;
 
 					if (!ReadWord(line, word))
 					{
@@ -378,7 +503,7 @@ PLYCache::PLYData& PLYCache::Get(FileCache& fileCache, const char* fileName_)
 					}
 
 					// handle lists
-					Property newProperty;
+					PLYCache::Property newProperty;
 					if (word == "list")
 					{
 						newProperty.isList = true;
@@ -392,7 +517,7 @@ PLYCache::PLYData& PLYCache::Get(FileCache& fileCache, const char* fileName_)
 						}
 
 						newProperty.listSizeType = StringToFieldType(word);
-						if (newProperty.listSizeType == FieldType::unknown)
+						if (newProperty.listSizeType == PLYCache::FieldType::unknown)
 						{
 							plyData.error += "unknown list size type\n";
 							fileView = "";
@@ -409,7 +534,7 @@ PLYCache::PLYData& PLYCache::Get(FileCache& fileCache, const char* fileName_)
 						}
 
 						newProperty.type = StringToFieldType(word);
-						if (newProperty.type == FieldType::unknown)
+						if (newProperty.type == PLYCache::FieldType::unknown)
 						{
 							plyData.error += "unknown list value type\n";
 							fileView = "";
@@ -421,7 +546,7 @@ PLYCache::PLYData& PLYCache::Get(FileCache& fileCache, const char* fileName_)
 					else
 					{
 						newProperty.type = StringToFieldType(word);
-						if (newProperty.type == FieldType::unknown)
+						if (newProperty.type == PLYCache::FieldType::unknown)
 						{
 							plyData.error += "unknown field property type\n";
 							fileView = "";
@@ -465,9 +590,44 @@ PLYCache::PLYData& PLYCache::Get(FileCache& fileCache, const char* fileName_)
 			}
 		}
 
+		return plyData.valid;
+	}
+}
+
+PLYCache::PLYData& PLYCache::Get(FileCache& fileCache, const char* fileName_)
+{
+	// normalize the string by making it canonical and making it lower case
+	std::string s = std::filesystem::weakly_canonical(fileName_).string();
+	std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+	const char* fileName = s.c_str();
+
+	// Return the data if we already have it in the cache
+	if (m_cache.count(fileName) != 0)
+		return m_cache[fileName];
+
+	// load the file
+	FileCache::File fileData = fileCache.Get(fileName);
+
+	// Parse the file
+	const char* binaryData = nullptr;
+	PLYData plyData;
+	if (fileData.Valid())
+	{
+		plyData.valid = true;
+
+		std::string_view fileView = fileData.GetBytes();
+		Format format = Format::unknown;
+		ParseHeader(fileView, plyData, format, binaryData);
+
 		// read each element group
 		for (ElementGroup& elementGroup : plyData.elementGroups)
 		{
+			if (!plyData.valid)
+				break;
+
+			if (format == Format::ascii && ReadAsciiElementGroupParallel(fileView, elementGroup))
+				continue;
+
 			for (unsigned int index = 0; index < elementGroup.count; ++index)
 			{
 				for (const Property& property : elementGroup.properties)
@@ -580,6 +740,7 @@ PLYCache::PLYData PLYCache::GetFlattened(FileCache& fileCache, const char* fileN
 	{
 		//prepare data
 		ret.valid = true;
+		ret.flattenedFaces = true;
 		ret.elementGroups.resize(1);
 		ElementGroup& newVertexElementGroup = ret.elementGroups[0];
 		newVertexElementGroup.name = vertexElementGroup.name;
@@ -666,3 +827,250 @@ PLYCache::PLYData PLYCache::GetFlattened(FileCache& fileCache, const char* fileN
 
 	return ret;
 }
+
+int PLYCache::FindProperty(const ElementGroup& elementGroup, const char* name)
+{
+	for (size_t index = 0; index < elementGroup.properties.size(); ++index)
+	{
+		if (elementGroup.properties[index].name == name)
+			return (int)index;
+	}
+	return -1;
+}
+
+void PLYCache::ReadFlattenedVertices(const ElementGroup& vertexElementGroup, std::vector<FlattenedVertex>& vertices)
+{
+	// Find where each property we want lives within a vertex
+	struct Source
+	{
+		const char* names[3];
+		int propertyIndex = -1;
+		size_t offset = 0;
+	};
+
+	Source sources[] =
+	{
+		{ { "x" } }, { { "y" } }, { { "z" } },
+		{ { "nx" } }, { { "ny" } }, { { "nz" } },
+		{ { "u", "s", "texture_u" } }, { { "v", "t", "texture_v" } },
+	};
+
+	for (Source& source : sources)
+	{
+		for (const char* name : source.names)
+		{
+			if (name && (source.propertyIndex = FindProperty(vertexElementGroup, name)) != -1)
+				break;
+		}
+
+		for (int propertyIndex = 0; propertyIndex < source.propertyIndex; ++propertyIndex)
+			source.offset += FieldTypeSizeBytes(vertexElementGroup.properties[propertyIndex].type);
+	}
+
+	vertices.resize(vertexElementGroup.count);
+	for (size_t vertexIndex = 0; vertexIndex < vertexElementGroup.count; ++vertexIndex)
+	{
+		const unsigned char* src = &vertexElementGroup.data[vertexIndex * vertexElementGroup.propertiesSizeBytes];
+
+		float values[_countof(sources)] = {};
+		for (size_t sourceIndex = 0; sourceIndex < _countof(sources); ++sourceIndex)
+		{
+			const Source& source = sources[sourceIndex];
+			if (source.propertyIndex != -1)
+				ReadFromBinaryAndCastTo(src + source.offset, vertexElementGroup.properties[source.propertyIndex].type, values[sourceIndex]);
+		}
+
+		FlattenedVertex& vertex = vertices[vertexIndex];
+		vertex.position = Vec3{ values[0], values[1], values[2] };
+		vertex.normal = Vec3{ values[3], values[4], values[5] };
+		vertex.tangent = Vec4{ 1.0f, 0.0f, 0.0f, 1.0f };
+		vertex.albedo = Vec4{ 1.0f, 1.0f, 1.0f, 1.0f };
+		vertex.uvs[0] = Vec2{ values[6], values[7] };
+		vertex.uvs[1] = Vec2{ 0.0f, 0.0f };
+		vertex.uvs[2] = Vec2{ 0.0f, 0.0f };
+		vertex.uvs[3] = Vec2{ 0.0f, 0.0f };
+	}
+}
+
+bool PLYCache::ReadHeader(const char* fileName, StreamHeader& header)
+{
+	header = StreamHeader();
+
+	FILE* file = nullptr;
+	fopen_s(&file, fileName, "rb");
+	if (!file)
+	{
+		header.plyData.error += "Could not open file\n";
+		return false;
+	}
+
+	// Read until we have the whole header, including the new line after end_header.
+	// Headers are usually well under the first read, even with many properties.
+	std::vector<char> bytes;
+	size_t readSize = 64 * 1024;
+	while (true)
+	{
+		size_t start = bytes.size();
+		bytes.resize(start + readSize);
+		size_t bytesRead = fread(&bytes[start], 1, readSize, file);
+		bytes.resize(start + bytesRead);
+
+		if (bytesRead < readSize)
+			break;
+
+		size_t endHeader = std::string_view(bytes.data(), bytes.size()).find("end_header");
+		if (endHeader != std::string_view::npos && endHeader + 12 <= bytes.size())
+			break;
+
+		readSize *= 2;
+	}
+	fclose(file);
+	bytes.push_back(0);
+
+	header.plyData.valid = true;
+	std::string_view fileView = bytes.data();
+	Format format = Format::unknown;
+	const char* binaryData = nullptr;
+	if (!ParseHeader(fileView, header.plyData, format, binaryData))
+		return false;
+
+	header.binary = (format == Format::binary_LE || format == Format::binary_BE);
+	header.bigEndian = (format == Format::binary_BE);
+	header.dataOffset = (uint64_t)(binaryData - bytes.data());
+	return true;
+}
+
+bool PLYCache::CanStream(const StreamHeader& header, const char* elementGroupName)
+{
+	if (!header.plyData.valid || !header.binary)
+		return false;
+
+	for (const ElementGroup& elementGroup : header.plyData.elementGroups)
+	{
+		for (const Property& property : elementGroup.properties)
+		{
+			if (property.isList)
+				return false;
+		}
+
+		if (elementGroup.name == elementGroupName)
+			return true;
+	}
+
+	return false;
+}
+
+bool PLYCache::StreamColumns(const char* fileName, const StreamHeader& header, const char* elementGroupName, const std::vector<Column>& columns, size_t destStride, std::vector<char>& dest, std::string& error, size_t chunkSizeBytes)
+{
+	dest.clear();
+
+	if (!CanStream(header, elementGroupName))
+	{
+		error += "Element group can't be streamed\n";
+		return false;
+	}
+
+	// Find the element group, and where it starts in the file
+	uint64_t groupOffset = header.dataOffset;
+	const ElementGroup* elementGroup = nullptr;
+	for (const ElementGroup& group : header.plyData.elementGroups)
+	{
+		if (group.name == elementGroupName)
+		{
+			elementGroup = &group;
+			break;
+		}
+		groupOffset += (uint64_t)group.count * group.propertiesSizeBytes;
+	}
+	const size_t elementSize = elementGroup->propertiesSizeBytes;
+
+	// Resolve where each column is in the element, and how to copy it
+	struct ResolvedColumn
+	{
+		size_t srcOffset = 0;
+		size_t destOffset = 0;
+		CopyColumnFn copyFn = nullptr;
+	};
+	std::vector<ResolvedColumn> resolvedColumns;
+	bool doByteSwap = header.bigEndian != (std::endian::native == std::endian::big);
+	for (const Column& column : columns)
+	{
+		if (column.destOffset + FieldTypeSizeBytes(column.destType) > destStride)
+		{
+			error += "Column doesn't fit in the destination stride\n";
+			return false;
+		}
+
+		// Columns without a property are left as zero
+		if (column.propertyIndex < 0)
+			continue;
+
+		if (column.propertyIndex >= (int)elementGroup->properties.size())
+		{
+			error += "Column property index out of range\n";
+			return false;
+		}
+
+		ResolvedColumn resolvedColumn;
+		for (int propertyIndex = 0; propertyIndex < column.propertyIndex; ++propertyIndex)
+			resolvedColumn.srcOffset += FieldTypeSizeBytes(elementGroup->properties[propertyIndex].type);
+		resolvedColumn.destOffset = column.destOffset;
+		resolvedColumn.copyFn = GetCopyColumnFn(elementGroup->properties[column.propertyIndex].type, column.destType, doByteSwap);
+
+		if (!resolvedColumn.copyFn)
+		{
+			error += "Unsupported column type\n";
+			return false;
+		}
+
+		resolvedColumns.push_back(resolvedColumn);
+	}
+
+	dest.resize((size_t)elementGroup->count * destStride, 0);
+	if (elementGroup->count == 0 || elementSize == 0 || resolvedColumns.empty())
+		return true;
+
+	FILE* file = nullptr;
+	fopen_s(&file, fileName, "rb");
+	if (!file)
+	{
+		error += "Could not open file\n";
+		dest.clear();
+		return false;
+	}
+
+	if (_fseeki64(file, (long long)groupOffset, SEEK_SET) != 0)
+	{
+		error += "Could not seek to element data\n";
+		fclose(file);
+		dest.clear();
+		return false;
+	}
+
+	// Read whole elements a chunk at a time, and copy the columns out of each chunk
+	size_t elementsPerChunk = chunkSizeBytes / elementSize;
+	if (elementsPerChunk == 0)
+		elementsPerChunk = 1;
+	std::vector<unsigned char> chunk(elementsPerChunk * elementSize);
+
+	for (size_t firstElement = 0; firstElement < elementGroup->count; firstElement += elementsPerChunk)
+	{
+		size_t remainingElements = elementGroup->count - firstElement;
+		size_t chunkElements = (remainingElements < elementsPerChunk) ? remainingElements : elementsPerChunk;
+
+		if (fread(chunk.data(), elementSize, chunkElements, file) != chunkElements)
+		{
+			error += "Not enough elements found\n";
+			fclose(file);
+			dest.clear();
+			return false;
+		}
+
+		unsigned char* destChunk = (unsigned char*)&dest[firstElement * destStride];
+		for (const ResolvedColumn& resolvedColumn : resolvedColumns)
+			resolvedColumn.copyFn(&chunk[resolvedColumn.srcOffset], elementSize, &destChunk[resolvedColumn.destOffset], destStride, chunkElements);
+	}
+
+	fclose(file);
+	return true;
+}
@@ -60,12 +60,48 @@ public:
 		std::string warn, error;
 		std::vector<ElementGroup> elementGroups;
 		bool valid = false;
+		bool flattenedFaces = false; // True if GetFlattened() made the vertices into a triangle list from the faces in the file
 	};
 
 	PLYData& Get(FileCache& fileCache, const char* fileName);
 
 	PLYData GetFlattened(FileCache& fileCache, const char* fileName);
 
+	// Returns the index of the named property, or -1 if there isn't one
+	static int FindProperty(const ElementGroup& elementGroup, const char* name);
+
+	// Reads the vertex element group of flattened ply data into FlattenedVertex, such as for generating tangents.
+	// Uses x,y,z for position, nx,ny,nz for normal, and u,v or s,t or texture_u,texture_v for uvs[0]. Anything not in the file is zero.
+	static void ReadFlattenedVertices(const ElementGroup& vertexElementGroup, std::vector<FlattenedVertex>& vertices);
+
+	// The header of a ply file, read without loading the rest of the file, for streaming.
+	struct StreamHeader
+	{
+		PLYData plyData; // The element groups have no data
+		bool binary = false;
+		bool bigEndian = false;
+		uint64_t dataOffset = 0; // Where the data starts in the file
+	};
+
+	// A property to read from each element of a streamed element group, and where in the destination element to write it.
+	// The value is cast to destType, which must be i32, u32 or f32. A propertyIndex of -1 writes zero.
+	struct Column
+	{
+		int propertyIndex = -1;
+		FieldType destType = FieldType::f32;
+		size_t destOffset = 0;
+	};
+
+	static bool ReadHeader(const char* fileName, StreamHeader& header);
+
+	// Element groups can be streamed if the file is binary, and neither the group nor any group before it has lists,
+	// so that every element is the same size and the group starts at a known offset.
+	static bool CanStream(const StreamHeader& header, const char* elementGroupName);
+
+	// Reads columns of an element group straight from the file into dest, which gets destStride bytes per element.
+	// Offsets, types and byte swapping are worked out once per column, and only chunkSizeBytes of the file are in memory at a time.
+	static bool StreamColumns(const char* fileName, const StreamHeader& header, const char* elementGroupName, const std::vector<Column>& columns, size_t destStride, std::vector<char>& dest, std::string& error, size_t chunkSizeBytes = 8 * 1024 * 1024);
+
 	bool Remove(const char* fileName)
 	{
 		if (m_cache.count(fileName) == 0)
@@ -98,6 +134,7 @@ public:
 				int8_t val;
 				memcpy(&val, srcPointer, sizeof(val));
 				srcPointer += sizeof(val);
+				out = (T)val;
 				break;
 			}
 			case PLYCache::FieldType::u8:
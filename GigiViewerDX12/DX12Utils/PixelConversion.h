@@ -0,0 +1,313 @@
+///////////////////////////////////////////////////////////////////////////////
+//         Gigi Rapid Graphics Prototyping and Code Generation Suite         //
+//        Copyright (c) 2024 Electronic Arts Inc. All rights reserved.       //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cfloat>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "Utils.h"
+#include "sRGB.h"
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define PIXELCONVERTER_SSE2 1
+#endif
+
+// Converts pixels between uncompressed formats described by DXGI_FORMAT_Info.
+// The per channel math is the same as the double based ConvertPixelData path, so results are identical:
+// decode to a normalized double, add or drop channels, apply sRGB to the color channels, then scale, clamp and truncate.
+// Kernels are typed per (source, destination) channel type, 8 bit sources go through lookup tables, and nothing is allocated per texel.
+class PixelConverter
+{
+public:
+	// How a channel type is decoded to, and encoded from, a normalized double.
+	// 8 and 16 bit signed values are stored through their unsigned types, like the double based path does.
+	struct ChannelCodec
+	{
+		bool canDecode = false;
+		double decodeMultiplier = 1.0;
+
+		bool canEncode = false;
+		double encodeMultiplier = 1.0;
+		double encodeMin = 0.0;
+		double encodeMax = 0.0;
+	};
+
+	static ChannelCodec GetChannelCodec(DXGI_FORMAT_Info::ChannelType channelType)
+	{
+		switch (channelType)
+		{
+			case DXGI_FORMAT_Info::ChannelType::_uint8_t: return { true, 1.0 / 255.0, true, 256.0, 0.0, 255.0 };
+			case DXGI_FORMAT_Info::ChannelType::_uint16_t: return { true, 1.0 / 65535.0, true, 65536.0, 0.0, 65535.0 };
+			case DXGI_FORMAT_Info::ChannelType::_uint32_t: return { true, 1.0 / 4294967296.0, true, 4294967296.0, 0.0, 4294967295.0 };
+			case DXGI_FORMAT_Info::ChannelType::_int8_t: return { false, 1.0, true, 256.0, -128.0, 127.0 };
+			case DXGI_FORMAT_Info::ChannelType::_int16_t: return { true, 1.0 / 32767.0, true, 65536.0, -32768.0, 32767.0 };
+			case DXGI_FORMAT_Info::ChannelType::_half: return { true, 1.0, true, 1.0, -65504.0, 65504.0 };
+			case DXGI_FORMAT_Info::ChannelType::_float: return { true, 1.0, true, 1.0, -FLT_MAX, FLT_MAX };
+			default: return {};
+		}
+	}
+
+	PixelConverter(const DXGI_FORMAT_Info& srcFormat, const DXGI_FORMAT_Info& destFormat)
+		: m_srcFormat(srcFormat)
+		, m_destFormat(destFormat)
+	{
+		if (srcFormat.isCompressed || destFormat.isCompressed || srcFormat.channelCount < 1 || destFormat.channelCount < 1 || destFormat.channelCount > 4)
+			return;
+
+		m_srcCodec = GetChannelCodec(srcFormat.channelType);
+		m_destCodec = GetChannelCodec(destFormat.channelType);
+
+		// sRGB conversion happens on the color channels after the channel count has been converted
+		m_sRGBOp = (srcFormat.sRGB == destFormat.sRGB) ? SRGBOp::None : (srcFormat.sRGB ? SRGBOp::ToLinear : SRGBOp::ToSRGB);
+		m_sRGBChannelCount = (m_sRGBOp == SRGBOp::None) ? 0 : (destFormat.channelCount < 3 ? destFormat.channelCount : 3);
+
+		m_kernel = ChooseKernel();
+	}
+
+	// Returns false if there is no typed kernel for this pair of formats, in which case the caller should use the generic path
+	bool Valid() const
+	{
+		return m_kernel != nullptr;
+	}
+
+	size_t DestSize(size_t srcSize) const
+	{
+		return (srcSize / m_srcFormat.bytesPerPixel) * m_destFormat.bytesPerPixel;
+	}
+
+	// Large conversions are split across threads. threadCount 0 means to use all hardware threads.
+	void Convert(const unsigned char* src, unsigned char* dest, size_t pixelCount, int threadCount = 0) const
+	{
+		static const size_t c_pixelsPerJob = 64 * 1024;
+		size_t jobCount = (pixelCount + c_pixelsPerJob - 1) / c_pixelsPerJob;
+
+		if (threadCount <= 0)
+			threadCount = (int)std::thread::hardware_concurrency();
+		if ((size_t)threadCount > jobCount)
+			threadCount = (int)jobCount;
+
+		if (threadCount <= 1)
+		{
+			(this->*m_kernel)(src, dest, pixelCount);
+			return;
+		}
+
+		std::vector<std::thread> threads;
+		threads.reserve(threadCount);
+		size_t pixelsPerThread = (pixelCount + threadCount - 1) / threadCount;
+		for (int threadIndex = 0; threadIndex < threadCount; ++threadIndex)
+		{
+			size_t begin = pixelsPerThread * threadIndex;
+			if (begin >= pixelCount)
+				break;
+			size_t count = (pixelCount - begin < pixelsPerThread) ? pixelCount - begin : pixelsPerThread;
+			threads.emplace_back(
+				[this, src, dest, begin, count]()
+				{
+					(this->*m_kernel)(&src[begin * m_srcFormat.bytesPerPixel], &dest[begin * m_destFormat.bytesPerPixel], count);
+				}
+			);
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+	}
+
+private:
+	enum class SRGBOp
+	{
+		None,
+		ToLinear,
+		ToSRGB
+	};
+
+	typedef void (PixelConverter::*Kernel)(const unsigned char* src, unsigned char* dest, size_t pixelCount) const;
+
+	// Channels the source doesn't have are 0 for color and 1 for alpha
+	double MissingChannelValue(int channelIndex) const
+	{
+		return (channelIndex < 3) ? 0.0 : 1.0;
+	}
+
+	double ApplySRGB(double value, int channelIndex) const
+	{
+		if (channelIndex >= m_sRGBChannelCount)
+			return value;
+		if (m_sRGBOp == SRGBOp::ToLinear)
+			return (float)SRGBToLinear((float)value);
+		return (float)LinearTosRGB((float)value);
+	}
+
+	template <typename TDest>
+	TDest Encode(double value) const
+	{
+		value *= m_destCodec.encodeMultiplier;
+		value = (value < m_destCodec.encodeMax) ? value : m_destCodec.encodeMax;
+		value = (value > m_destCodec.encodeMin) ? value : m_destCodec.encodeMin;
+		return (TDest)value;
+	}
+
+	// 8 bit sources: every output value is a function of the source byte, so it's a table lookup
+	template <typename TDest>
+	void Kernel_U8(const unsigned char* src, unsigned char* dest, size_t pixelCount) const
+	{
+		const int srcChannels = m_srcFormat.channelCount;
+		const int destChannels = m_destFormat.channelCount;
+
+		// half has no default constructor, so the tables are explicitly initialized
+		std::vector<TDest> table(4 * 256, TDest(0.0));
+		TDest missing[4] = { TDest(0.0), TDest(0.0), TDest(0.0), TDest(0.0) };
+		for (int c = 0; c < destChannels; ++c)
+		{
+			if (c < srcChannels)
+			{
+				for (int i = 0; i < 256; ++i)
+					table[c * 256 + i] = Encode<TDest>(ApplySRGB(m_srcCodec.decodeMultiplier * (double)i, c));
+			}
+			else
+				missing[c] = Encode<TDest>(ApplySRGB(MissingChannelValue(c), c));
+		}
+
+		const int copyChannels = (srcChannels < destChannels) ? srcChannels : destChannels;
+		TDest* destValues = (TDest*)dest;
+		for (size_t pixelIndex = 0; pixelIndex < pixelCount; ++pixelIndex)
+		{
+			int c = 0;
+			for (; c < copyChannels; ++c)
+				destValues[c] = table[c * 256 + src[c]];
+			for (; c < destChannels; ++c)
+				destValues[c] = missing[c];
+
+			src += srcChannels;
+			destValues += destChannels;
+		}
+	}
+
+	template <typename TSrc, typename TDest>
+	void Kernel_Typed(const unsigned char* src, unsigned char* dest, size_t pixelCount) const
+	{
+		const int srcChannels = m_srcFormat.channelCount;
+		const int destChannels = m_destFormat.channelCount;
+		const int copyChannels = (srcChannels < destChannels) ? srcChannels : destChannels;
+
+		TDest missing[4] = { TDest(0.0), TDest(0.0), TDest(0.0), TDest(0.0) };
+		for (int c = copyChannels; c < destChannels; ++c)
+			missing[c] = Encode<TDest>(ApplySRGB(MissingChannelValue(c), c));
+
+		const TSrc* srcValues = (const TSrc*)src;
+		TDest* destValues = (TDest*)dest;
+		for (size_t pixelIndex = 0; pixelIndex < pixelCount; ++pixelIndex)
+		{
+			int c = 0;
+			for (; c < copyChannels; ++c)
+				destValues[c] = Encode<TDest>(ApplySRGB(m_srcCodec.decodeMultiplier * (double)srcValues[c], c));
+			for (; c < destChannels; ++c)
+				destValues[c] = missing[c];
+
+			srcValues += srcChannels;
+			destValues += destChannels;
+		}
+	}
+
+#ifdef PIXELCONVERTER_SSE2
+	// float to 8 bit without sRGB, with matching channel counts. Same double math as Encode, two values at a time.
+	void Kernel_F32ToU8_SSE2(const unsigned char* src, unsigned char* dest, size_t pixelCount) const
+	{
+		const float* srcValues = (const float*)src;
+		const size_t valueCount = pixelCount * m_destFormat.channelCount;
+
+		const __m128d multiplier = _mm_set1_pd(m_destCodec.encodeMultiplier);
+		const __m128d theMin = _mm_set1_pd(m_destCodec.encodeMin);
+		const __m128d theMax = _mm_set1_pd(m_destCodec.encodeMax);
+
+		size_t i = 0;
+		for (; i + 4 <= valueCount; i += 4)
+		{
+			__m128 values = _mm_loadu_ps(&srcValues[i]);
+			__m128d lo = _mm_mul_pd(_mm_cvtps_pd(values), multiplier);
+			__m128d hi = _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(values, values)), multiplier);
+			lo = _mm_max_pd(_mm_min_pd(lo, theMax), theMin);
+			hi = _mm_max_pd(_mm_min_pd(hi, theMax), theMin);
+			__m128i ints = _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi));
+			ints = _mm_packs_epi32(ints, ints);
+			ints = _mm_packus_epi16(ints, ints);
+			uint32_t packed = (uint32_t)_mm_cvtsi128_si32(ints);
+			memcpy(&dest[i], &packed, sizeof(packed));
+		}
+		for (; i < valueCount; ++i)
+			dest[i] = Encode<uint8_t>(m_srcCodec.decodeMultiplier * (double)srcValues[i]);
+	}
+#endif
+
+	template <typename TSrc>
+	Kernel ChooseKernel_Typed() const
+	{
+		switch (m_destFormat.channelType)
+		{
+			case DXGI_FORMAT_Info::ChannelType::_uint8_t:
+			case DXGI_FORMAT_Info::ChannelType::_int8_t: return &PixelConverter::Kernel_Typed<TSrc, uint8_t>;
+			case DXGI_FORMAT_Info::ChannelType::_uint16_t:
+			case DXGI_FORMAT_Info::ChannelType::_int16_t: return &PixelConverter::Kernel_Typed<TSrc, uint16_t>;
+			case DXGI_FORMAT_Info::ChannelType::_uint32_t: return &PixelConverter::Kernel_Typed<TSrc, uint32_t>;
+			case DXGI_FORMAT_Info::ChannelType::_half: return &PixelConverter::Kernel_Typed<TSrc, half>;
+			case DXGI_FORMAT_Info::ChannelType::_float: return &PixelConverter::Kernel_Typed<TSrc, float>;
+			default: return nullptr;
+		}
+	}
+
+	// Rarer source types (16 bit signed, 32 bit unsigned) are left to the generic path
+	Kernel ChooseKernel() const
+	{
+		if (!m_srcCodec.canDecode || !m_destCodec.canEncode)
+			return nullptr;
+
+		switch (m_srcFormat.channelType)
+		{
+			case DXGI_FORMAT_Info::ChannelType::_uint8_t:
+			{
+				switch (m_destFormat.channelType)
+				{
+					case DXGI_FORMAT_Info::ChannelType::_uint8_t:
+					case DXGI_FORMAT_Info::ChannelType::_int8_t: return &PixelConverter::Kernel_U8<uint8_t>;
+					case DXGI_FORMAT_Info::ChannelType::_uint16_t:
+					case DXGI_FORMAT_Info::ChannelType::_int16_t: return &PixelConverter::Kernel_U8<uint16_t>;
+					case DXGI_FORMAT_Info::ChannelType::_uint32_t: return &PixelConverter::Kernel_U8<uint32_t>;
+					case DXGI_FORMAT_Info::ChannelType::_half: return &PixelConverter::Kernel_U8<half>;
+					case DXGI_FORMAT_Info::ChannelType::_float: return &PixelConverter::Kernel_U8<float>;
+					default: return nullptr;
+				}
+			}
+			case DXGI_FORMAT_Info::ChannelType::_uint16_t: return ChooseKernel_Typed<uint16_t>();
+			case DXGI_FORMAT_Info::ChannelType::_half: return ChooseKernel_Typed<half>();
+			case DXGI_FORMAT_Info::ChannelType::_float:
+			{
+#ifdef PIXELCONVERTER_SSE2
+				if (m_destFormat.channelType == DXGI_FORMAT_Info::ChannelType::_uint8_t && m_sRGBOp == SRGBOp::None && m_srcFormat.channelCount == m_destFormat.channelCount)
+					return &PixelConverter::Kernel_F32ToU8_SSE2;
+#endif
+				return ChooseKernel_Typed<float>();
+			}
+			default: return nullptr;
+		}
+	}
+
+private:
+	DXGI_FORMAT_Info m_srcFormat;
+	DXGI_FORMAT_Info m_destFormat;
+	ChannelCodec m_srcCodec;
+	ChannelCodec m_destCodec;
+	SRGBOp m_sRGBOp = SRGBOp::None;
+	int m_sRGBChannelCount = 0;
+	Kernel m_kernel = nullptr;
+};
+
+// Converts test pixels between every pair of formats that PixelConverter has a kernel for, both with PixelConverter and with the
+// double based path, and reports the pairs where they aren't bit exact. Run by GigiViewerDX12.exe -verifypixelconversion,
+// which MakeCode_UnitTests_DX12.py runs. Defined in RenderGraphNode_Resource_Texture.cpp, next to the double based path.
+bool VerifyPixelConversion();
@@ -0,0 +1,414 @@
+///////////////////////////////////////////////////////////////////////////////
+//         Gigi Rapid Graphics Prototyping and Code Generation Suite         //
+//        Copyright (c) 2024 Electronic Arts Inc. All rights reserved.       //
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShaderCache.h"
+#include "GigiCompilerLib/Utils.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+// The first bytes of every entry file. Entries that start with anything else, such as from an older layout, are treated as misses.
+static const char c_entryMagic[8] = { 'G', 'I', 'G', 'I', 'S', 'H', 'C', '1' };
+
+static const uint64_t c_defaultMaxBytes = 512 * 1024 * 1024;
+
+static bool ReadWholeFile(const std::string& fileName, std::vector<unsigned char>& data)
+{
+	std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+	if (!file)
+		return false;
+
+	std::streamoff size = file.tellg();
+	if (size < 0)
+		return false;
+
+	data.resize((size_t)size);
+	file.seekg(0);
+	return size == 0 || (bool)file.read((char*)data.data(), size);
+}
+
+// Reads the values of an entry, keeping track of whether it ran off the end
+class EntryReader
+{
+public:
+	EntryReader(const std::vector<unsigned char>& data)
+		: m_data(data)
+	{
+	}
+
+	bool Read(void* dest, size_t size)
+	{
+		if (!m_ok || size > m_data.size() - m_offset)
+		{
+			m_ok = false;
+			return false;
+		}
+		memcpy(dest, &m_data[m_offset], size);
+		m_offset += size;
+		return true;
+	}
+
+	template <typename T>
+	T Read()
+	{
+		T value = {};
+		Read(&value, sizeof(T));
+		return value;
+	}
+
+	std::string ReadString()
+	{
+		uint32_t length = Read<uint32_t>();
+		if (!m_ok || length > m_data.size() - m_offset)
+		{
+			m_ok = false;
+			return std::string();
+		}
+		std::string ret((const char*)&m_data[m_offset], length);
+		m_offset += length;
+		return ret;
+	}
+
+	bool Ok() const
+	{
+		return m_ok;
+	}
+
+	bool AtEnd() const
+	{
+		return m_offset == m_data.size();
+	}
+
+private:
+	const std::vector<unsigned char>& m_data;
+	size_t m_offset = 0;
+	bool m_ok = true;
+};
+
+class EntryWriter
+{
+public:
+	void Write(const void* data, size_t size)
+	{
+		const unsigned char* bytes = (const unsigned char*)data;
+		m_data.insert(m_data.end(), bytes, bytes + size);
+	}
+
+	template <typename T>
+	void Write(const T& value)
+	{
+		Write(&value, sizeof(T));
+	}
+
+	void WriteString(const std::string& value)
+	{
+		Write<uint32_t>((uint32_t)value.size());
+		Write(value.data(), value.size());
+	}
+
+	std::vector<unsigned char> m_data;
+};
+
+struct CacheFile
+{
+	std::filesystem::path path;
+	uint64_t size = 0;
+	std::filesystem::file_time_type lastUsed;
+};
+
+// Returns the total size of the entries in the directory. files, if not null, gets each entry.
+static uint64_t ScanCacheFiles(const std::string& directory, std::vector<CacheFile>* files)
+{
+	uint64_t totalBytes = 0;
+
+	std::error_code ec;
+	for (std::filesystem::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec))
+	{
+		// Temp files belong to writes that are in progress
+		if (it->path().extension() != ".bin")
+			continue;
+
+		CacheFile file;
+		file.path = it->path();
+		file.size = it->file_size(ec);
+		if (ec)
+		{
+			ec.clear();
+			continue;
+		}
+		file.lastUsed = it->last_write_time(ec);
+		if (ec)
+		{
+			ec.clear();
+			continue;
+		}
+
+		totalBytes += file.size;
+		if (files)
+			files->push_back(file);
+	}
+
+	return totalBytes;
+}
+
+ShaderCache::ShaderCache(const std::string& directory, uint64_t maxBytes)
+	: m_maxBytes(maxBytes)
+{
+	if (directory.empty())
+		return;
+
+	std::error_code ec;
+	std::filesystem::create_directories(directory, ec);
+	if (!std::filesystem::is_directory(directory, ec))
+		return;
+
+	m_directory = directory;
+	m_totalBytes = ScanCacheFiles(m_directory, nullptr);
+}
+
+ShaderCache& ShaderCache::Get()
+{
+	static ShaderCache s_shaderCache = []()
+	{
+		std::error_code ec;
+		std::filesystem::path tempDirectory = std::filesystem::temp_directory_path(ec);
+		if (ec)
+			return ShaderCache(std::string(), 0);
+		return ShaderCache((tempDirectory / "Gigi" / "ShaderCache").string(), c_defaultMaxBytes);
+	}();
+	return s_shaderCache;
+}
+
+ShaderCache::FileHash ShaderCache::HashFile(const std::string& fileName)
+{
+	FileHash ret;
+	ret.fileName = fileName;
+
+	std::vector<unsigned char> data;
+	if (!ReadWholeFile(fileName, data))
+		return ret;
+
+	ret.exists = true;
+	ret.size = data.size();
+	ret.hash = HashBytes(data.data(), data.size());
+	return ret;
+}
+
+std::string ShaderCache::MakeKeyText(ShaderCompiler& compiler, const ShaderCompileRequest& request, const FileHash& shaderFile)
+{
+	// Each value is on its own line, with its length, so that no two different requests make the same text
+	std::ostringstream keyText;
+	auto AddValue = [&keyText](const char* label, const std::string& value)
+	{
+		keyText << label << " " << value.size() << " " << value << "\n";
+	};
+
+	AddValue("compiler", compiler.GetIdentity());
+	AddValue("file", shaderFile.fileName);
+	keyText << "fileContents " << shaderFile.exists << " " << shaderFile.size << " " << shaderFile.hash << "\n";
+	AddValue("entryPoint", request.entryPoint);
+	AddValue("shaderModel", request.shaderModel);
+	AddValue("flags", request.flags);
+	for (const std::pair<std::string, std::string>& define : request.defines)
+	{
+		AddValue("defineName", define.first);
+		AddValue("defineValue", define.second);
+	}
+	return keyText.str();
+}
+
+bool ShaderCache::Compile(ShaderCompiler& compiler, const ShaderCompileRequest& request, std::vector<unsigned char>& byteCode, std::vector<std::string>* allFiles)
+{
+	std::vector<std::string> filesRead;
+
+	if (m_directory.empty())
+	{
+		bool compiled = compiler.Compile(request, byteCode, filesRead);
+		if (allFiles)
+			allFiles->insert(allFiles->end(), filesRead.begin(), filesRead.end());
+		return compiled;
+	}
+
+	std::error_code ec;
+	std::string shaderFileName = std::filesystem::weakly_canonical(request.fileName, ec).string();
+	if (ec)
+		shaderFileName = request.fileName;
+
+	std::string keyText = MakeKeyText(compiler, request, HashFile(shaderFileName));
+
+	char entryName[64];
+	snprintf(entryName, sizeof(entryName), "%016llx.bin", (unsigned long long)HashBytes(keyText.data(), keyText.size()));
+	std::string entryFileName = (std::filesystem::path(m_directory) / entryName).string();
+
+	if (Load(entryFileName, keyText, byteCode, filesRead))
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_hits++;
+		}
+
+		// Mark the entry as recently used, for eviction
+		std::filesystem::last_write_time(entryFileName, std::filesystem::file_time_type::clock::now(), ec);
+
+		if (allFiles)
+			allFiles->insert(allFiles->end(), filesRead.begin(), filesRead.end());
+		return true;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_misses++;
+	}
+
+	filesRead.clear();
+	bool compiled = compiler.Compile(request, byteCode, filesRead);
+	if (allFiles)
+		allFiles->insert(allFiles->end(), filesRead.begin(), filesRead.end());
+
+	if (compiled)
+	{
+		Store(entryFileName, keyText, byteCode, filesRead);
+		EvictToBudget();
+	}
+	return compiled;
+}
+
+int ShaderCache::GetHits() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_hits;
+}
+
+int ShaderCache::GetMisses() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_misses;
+}
+
+bool ShaderCache::Load(const std::string& entryFileName, const std::string& keyText, std::vector<unsigned char>& byteCode, std::vector<std::string>& filesRead) const
+{
+	std::vector<unsigned char> data;
+	if (!ReadWholeFile(entryFileName, data))
+		return false;
+
+	EntryReader reader(data);
+
+	char magic[sizeof(c_entryMagic)];
+	if (!reader.Read(magic, sizeof(magic)) || memcmp(magic, c_entryMagic, sizeof(magic)) != 0)
+		return false;
+
+	// The whole key is stored, so a hash collision is a miss instead of the wrong bytecode
+	if (reader.ReadString() != keyText)
+		return false;
+
+	// Every file the compile read has to be the same as it was then, including files that didn't exist
+	uint32_t fileCount = reader.Read<uint32_t>();
+	std::vector<std::string> entryFilesRead;
+	for (uint32_t fileIndex = 0; fileIndex < fileCount && reader.Ok(); ++fileIndex)
+	{
+		FileHash fileHash;
+		fileHash.fileName = reader.ReadString();
+		fileHash.exists = reader.Read<uint8_t>() != 0;
+		fileHash.size = reader.Read<uint64_t>();
+		fileHash.hash = reader.Read<uint64_t>();
+		if (!reader.Ok())
+			return false;
+
+		// The shader file itself is in the key
+		if (fileIndex > 0 && !(HashFile(fileHash.fileName) == fileHash))
+			return false;
+
+		entryFilesRead.push_back(fileHash.fileName);
+	}
+
+	uint64_t byteCodeSize = reader.Read<uint64_t>();
+	if (!reader.Ok() || byteCodeSize > data.size())
+		return false;
+
+	std::vector<unsigned char> entryByteCode((size_t)byteCodeSize);
+	if (!reader.Read(entryByteCode.data(), entryByteCode.size()) || !reader.AtEnd())
+		return false;
+
+	byteCode = std::move(entryByteCode);
+	filesRead = std::move(entryFilesRead);
+	return true;
+}
+
+void ShaderCache::Store(const std::string& entryFileName, const std::string& keyText, const std::vector<unsigned char>& byteCode, const std::vector<std::string>& filesRead)
+{
+	EntryWriter writer;
+	writer.Write(c_entryMagic, sizeof(c_entryMagic));
+	writer.WriteString(keyText);
+
+	writer.Write<uint32_t>((uint32_t)filesRead.size());
+	for (size_t fileIndex = 0; fileIndex < filesRead.size(); ++fileIndex)
+	{
+		// The shader file is hashed as part of the key, and isn't hashed again
+		FileHash fileHash;
+		if (fileIndex == 0)
+			fileHash.fileName = filesRead[0];
+		else
+			fileHash = HashFile(filesRead[fileIndex]);
+
+		writer.WriteString(fileHash.fileName);
+		writer.Write<uint8_t>(fileHash.exists ? 1 : 0);
+		writer.Write<uint64_t>(fileHash.size);
+		writer.Write<uint64_t>(fileHash.hash);
+	}
+
+	writer.Write<uint64_t>(byteCode.size());
+	writer.Write(byteCode.data(), byteCode.size());
+
+	// The entry may be replacing one that's there already
+	std::error_code ec;
+	uint64_t replacedSize = std::filesystem::file_size(entryFileName, ec);
+	if (ec)
+		replacedSize = 0;
+
+	// If another process has the entry open, it is just left as it is
+	if (!WriteFileAtomically(entryFileName, writer.m_data.data(), writer.m_data.size()))
+		return;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_totalBytes += writer.m_data.size();
+	m_totalBytes -= std::min(replacedSize, m_totalBytes);
+}
+
+void ShaderCache::EvictToBudget()
+{
+	if (m_maxBytes == 0)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_totalBytes <= m_maxBytes)
+		return;
+
+	// Other processes may have added or evicted entries, so look at what is really there
+	std::vector<CacheFile> files;
+	uint64_t totalBytes = ScanCacheFiles(m_directory, &files);
+
+	// Go down to three quarters of the budget, so that eviction doesn't happen on every store once the cache is full
+	if (totalBytes > m_maxBytes)
+	{
+		std::sort(files.begin(), files.end(), [](const CacheFile& a, const CacheFile& b) { return a.lastUsed < b.lastUsed; });
+		uint64_t targetBytes = m_maxBytes - m_maxBytes / 4;
+		std::error_code ec;
+		for (const CacheFile& file : files)
+		{
+			if (totalBytes <= targetBytes)
+				break;
+
+			// Another process may be reading it, in which case it stays for now
+			if (std::filesystem::remove(file.path, ec))
+				totalBytes -= file.size;
+			ec.clear();
+		}
+	}
+
+	m_totalBytes = totalBytes;
+}
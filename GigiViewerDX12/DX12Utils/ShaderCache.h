@@ -0,0 +1,93 @@
+///////////////////////////////////////////////////////////////////////////////
+//         Gigi Rapid Graphics Prototyping and Code Generation Suite         //
+//        Copyright (c) 2024 Electronic Arts Inc. All rights reserved.       //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Everything about a shader compile other than the contents of the files it reads
+struct ShaderCompileRequest
+{
+	std::string fileName;
+	std::string entryPoint;
+	std::string shaderModel;
+	std::vector<std::pair<std::string, std::string>> defines;
+	std::string flags; // compiler specific, such as the debug and language version arguments
+};
+
+// A shader compiler that ShaderCache can sit in front of.
+// Doesn't depend on D3D, so the cache can be driven by a stub compiler. ShaderCache.cpp is built into GigiCompilerLib so that the compiler unit tests can.
+class ShaderCompiler
+{
+public:
+	virtual ~ShaderCompiler() {}
+
+	// The compiler and its version. Part of the cache key, so that updating the compiler doesn't use old bytecode.
+	virtual std::string GetIdentity() = 0;
+
+	// filesRead gets the shader file and every include the compiler tried to open, found or not.
+	// Errors are reported by the compiler. Failed compiles are never cached, so they are reported every time.
+	virtual bool Compile(const ShaderCompileRequest& request, std::vector<unsigned char>& byteCode, std::vector<std::string>& filesRead) = 0;
+};
+
+// A persistent on disk cache of shader bytecode, shared by every viewer that is running.
+//
+// Entries are found by a hash of the request, the compiler identity and the shader file's path and contents.
+// An entry also lists each include that the compile read, with a hash of its contents, and is only used if they all still match.
+// That gives the same answer as keying on the preprocessed source, without running the preprocessor to find out.
+//
+// Entries are written to a temporary file which is then renamed over the entry, so other processes never see half of one.
+// The size of the cache is found by scanning the directory once, at startup, and then kept up to date as entries are stored.
+// When that goes over the budget, the directory is scanned again and the least recently used entries are deleted.
+// Entries stored by other processes are only counted by those scans.
+// Anything that goes wrong with the cache files just means a compile, so errors are not reported.
+class ShaderCache
+{
+public:
+	// An empty directory disables the cache, and every request goes to the compiler.
+	ShaderCache(const std::string& directory, uint64_t maxBytes);
+
+	// Gets the bytecode from the cache, or compiles it and adds it. allFiles gets filesRead, like the compilers give.
+	bool Compile(ShaderCompiler& compiler, const ShaderCompileRequest& request, std::vector<unsigned char>& byteCode, std::vector<std::string>* allFiles);
+
+	int GetHits() const;
+	int GetMisses() const;
+
+	// The cache used by CompileShaders_dxc and CompileShaders_fxc. Lives in the temp directory.
+	static ShaderCache& Get();
+
+private:
+	struct FileHash
+	{
+		std::string fileName;
+		uint64_t size = 0;
+		uint64_t hash = 0;
+		bool exists = false;
+
+		bool operator == (const FileHash& other) const
+		{
+			return fileName == other.fileName && size == other.size && hash == other.hash && exists == other.exists;
+		}
+	};
+
+	static FileHash HashFile(const std::string& fileName);
+	static std::string MakeKeyText(ShaderCompiler& compiler, const ShaderCompileRequest& request, const FileHash& shaderFile);
+
+	bool Load(const std::string& entryFileName, const std::string& keyText, std::vector<unsigned char>& byteCode, std::vector<std::string>& filesRead) const;
+	void Store(const std::string& entryFileName, const std::string& keyText, const std::vector<unsigned char>& byteCode, const std::vector<std::string>& filesRead);
+	void EvictToBudget();
+
+	std::string m_directory;
+	uint64_t m_maxBytes = 0;
+
+	mutable std::mutex m_mutex;
+	uint64_t m_totalBytes = 0;
+	int m_hits = 0;
+	int m_misses = 0;
+};
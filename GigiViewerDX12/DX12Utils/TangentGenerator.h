@@ -0,0 +1,185 @@
+///////////////////////////////////////////////////////////////////////////////
+//         Gigi Rapid Graphics Prototyping and Code Generation Suite         //
+//        Copyright (c) 2024 Electronic Arts Inc. All rights reserved.       //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// clang-format off
+#include <array>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "FlattenedVertex.h"
+// clang-format on
+
+// Generates tangents for a triangle list of FlattenedVertex, from the positions, normals and uvs[0].
+// Each triangle adds its tangent and bitangent to its vertices, and vertices that are the same point on the mesh share the sums.
+// The scratch memory is kept between calls and the work is proportional to the vertices given,
+// so one generator can be used for every shape in a file without any per shape cost for the size of the whole file.
+class TangentGenerator
+{
+public:
+	// keys say which vertices share tangents, such as the position index in an OBJ file. They must not be negative.
+	// flipBitangent is for when uvs[0] has been flipped vertically from the uv space the tangents should be in.
+	void Generate(FlattenedVertex* vertices, size_t vertexCount, const int* keys, bool flipBitangent = false)
+	{
+		m_vertexSlots.resize(vertexCount);
+		int slotCount = 0;
+		for (size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+		{
+			size_t key = (size_t)keys[vertexIndex];
+			if (key >= m_slotByKey.size())
+				m_slotByKey.resize(key + 1, -1);
+
+			int& slot = m_slotByKey[key];
+			if (slot == -1)
+			{
+				slot = slotCount++;
+				m_usedKeys.push_back(key);
+			}
+			m_vertexSlots[vertexIndex] = slot;
+		}
+
+		// Only reset what we touched, so the cost doesn't depend on how big the keys get
+		for (size_t key : m_usedKeys)
+			m_slotByKey[key] = -1;
+		m_usedKeys.clear();
+
+		Accumulate(vertices, vertexCount, slotCount, flipBitangent);
+	}
+
+	// For when there are no keys. Vertices with identical positions share tangents.
+	void Generate(FlattenedVertex* vertices, size_t vertexCount, bool flipBitangent = false)
+	{
+		size_t tableSize = 1;
+		while (tableSize < vertexCount * 2)
+			tableSize *= 2;
+		const size_t tableMask = tableSize - 1;
+		m_positionTable.assign(tableSize, -1);
+
+		m_vertexSlots.resize(vertexCount);
+		int slotCount = 0;
+		for (size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+		{
+			const Vec3& position = vertices[vertexIndex].position;
+
+			size_t tableIndex = HashPosition(position) & tableMask;
+			while (true)
+			{
+				int firstVertexIndex = m_positionTable[tableIndex];
+				if (firstVertexIndex == -1)
+				{
+					m_positionTable[tableIndex] = (int)vertexIndex;
+					m_vertexSlots[vertexIndex] = slotCount++;
+					break;
+				}
+
+				if (memcmp(&vertices[firstVertexIndex].position, &position, sizeof(Vec3)) == 0)
+				{
+					m_vertexSlots[vertexIndex] = m_vertexSlots[firstVertexIndex];
+					break;
+				}
+
+				tableIndex = (tableIndex + 1) & tableMask;
+			}
+		}
+
+		Accumulate(vertices, vertexCount, slotCount, flipBitangent);
+	}
+
+private:
+	void Accumulate(FlattenedVertex* vertices, size_t vertexCount, int slotCount, bool flipBitangent)
+	{
+		m_tangents.assign(slotCount, Vec3{ 0.0f, 0.0f, 0.0f });
+		m_bitangents.assign(slotCount, Vec3{ 0.0f, 0.0f, 0.0f });
+
+		// Calculate tangents and bitangents
+		for (size_t vertexIndex = 0; vertexIndex + 2 < vertexCount; vertexIndex += 3)
+		{
+			const FlattenedVertex& v1 = vertices[vertexIndex + 0];
+			const FlattenedVertex& v2 = vertices[vertexIndex + 1];
+			const FlattenedVertex& v3 = vertices[vertexIndex + 2];
+
+			Vec3 pos21 = v2.position - v1.position;
+			Vec3 pos31 = v3.position - v1.position;
+
+			Vec2 uv21 = v2.uvs[0] - v1.uvs[0];
+			Vec2 uv31 = v3.uvs[0] - v1.uvs[0];
+
+			float r = 1.0f / (uv21[0] * uv31[1] - uv21[1] * uv31[0]);
+
+			if (std::isfinite(r))
+			{
+				Vec3 u = Vec3{ (uv31[1] * pos21[0] - uv21[1] * pos31[0]) * r, (uv31[1] * pos21[1] - uv21[1] * pos31[1]) * r, (uv31[1] * pos21[2] - uv21[1] * pos31[2]) * r };
+				Vec3 v = Vec3{ (uv21[0] * pos31[0] - uv31[0] * pos21[0]) * r, (uv21[0] * pos31[1] - uv31[0] * pos21[1]) * r, (uv21[0] * pos31[2] - uv31[0] * pos21[2]) * r };
+
+				for (size_t i = 0; i < 3; ++i)
+				{
+					int slot = m_vertexSlots[vertexIndex + i];
+					m_tangents[slot] += u;
+					m_bitangents[slot] += v;
+				}
+			}
+		}
+
+		// Orthogonalize against the normal and work out handedness
+		for (size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex)
+		{
+			FlattenedVertex& vertex = vertices[vertexIndex];
+			const Vec3& normal = vertex.normal;
+			const Vec3& tangent = m_tangents[m_vertexSlots[vertexIndex]];
+			const Vec3& bitangent = m_bitangents[m_vertexSlots[vertexIndex]];
+
+			Vec3 tangentOut = tangent - normal * Dot(normal, tangent);
+			if (Dot(tangentOut, tangentOut) < 0.00001f)
+				tangentOut = tangent;
+
+			if (Dot(tangentOut, tangentOut) > 0.0f)
+			{
+				tangentOut = Normalize(tangentOut);
+				bool negative = (Dot(Cross(normal, tangent), bitangent) < 0.0f) != flipBitangent;
+				vertex.tangent[0] = tangentOut[0];
+				vertex.tangent[1] = tangentOut[1];
+				vertex.tangent[2] = tangentOut[2];
+				vertex.tangent[3] = negative ? 0.0f : 1.0f;
+			}
+			else
+			{
+				vertex.tangent[0] = 1.0f;
+				vertex.tangent[1] = 0.0f;
+				vertex.tangent[2] = 0.0f;
+				vertex.tangent[3] = 1.0f;
+			}
+		}
+	}
+
+	static size_t HashPosition(const Vec3& position)
+	{
+		uint32_t words[3];
+		memcpy(words, position.data(), sizeof(words));
+
+		uint64_t hash = 14695981039346656037ull;
+		for (uint32_t word : words)
+		{
+			hash ^= word;
+			hash *= 1099511628211ull;
+		}
+
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdull;
+		hash ^= hash >> 33;
+		return (size_t)hash;
+	}
+
+private:
+	// Scratch memory, reused between calls
+	std::vector<int> m_slotByKey;
+	std::vector<size_t> m_usedKeys;
+	std::vector<int> m_positionTable;
+	std::vector<int> m_vertexSlots;
+	std::vector<Vec3> m_tangents;
+	std::vector<Vec3> m_bitangents;
+};
@@ -42,6 +42,11 @@ public:
 		trackedResource.debugText = debugText;
 		#endif
 
+		// If it is re-tracked while in the pending list, keep it marked as pending so it isn't added twice
+		auto it = m_trackedResources.find(resource);
+		if (it != m_trackedResources.end())
+			trackedResource.pending = it->second.pending;
+
 		m_trackedResources[resource] = trackedResource;
 	}
 	
@@ -64,6 +69,7 @@ public:
 
 		TrackedResource& trackedResource = m_trackedResources[resource];
 		trackedResource.wantsUAVBarrier = true;
+		MarkPending(resource, trackedResource);
 	}
 
 	// Needed for dealing with state promotions and decay
@@ -110,16 +116,24 @@ public:
 			trackedResource.wantsUAVBarrier = true;
 
 		trackedResource.desiredState = newState;
+		MarkPending(resource, trackedResource);
 	}
 
+	// Issues all pending transitions as a single batch, in the order they were first requested since the last flush.
+	// Only resources which had a transition requested are visited, not every tracked resource.
 	void Flush(ID3D12GraphicsCommandList* commandList)
 	{
 		m_barriers.clear();
 
-		for (auto& it : m_trackedResources)
+		for (ID3D12Resource* resource : m_pendingResources)
 		{
-			ID3D12Resource* resource = it.first;
-			TrackedResource& trackedResource = it.second;
+			// It may have been untracked since the transition was requested
+			auto it = m_trackedResources.find(resource);
+			if (it == m_trackedResources.end())
+				continue;
+
+			TrackedResource& trackedResource = it->second;
+			trackedResource.pending = false;
 
 			if (trackedResource.currentState != trackedResource.desiredState)
 			{
@@ -144,6 +158,7 @@ public:
 			trackedResource.currentState = trackedResource.desiredState;
 			trackedResource.wantsUAVBarrier = false;
 		}
+		m_pendingResources.clear();
 
 		if (m_barriers.size() > 0)
 			commandList->ResourceBarrier((UINT)m_barriers.size(), m_barriers.data());
@@ -161,6 +176,7 @@ public:
 	void Clear()
 	{
 		m_trackedResources.clear();
+		m_pendingResources.clear();
 	}
 
 private:
@@ -170,13 +186,23 @@ private:
 		D3D12_RESOURCE_STATES currentState;
 		D3D12_RESOURCE_STATES desiredState;
 		bool wantsUAVBarrier = false;
+		bool pending = false;
 
 		#if DO_DEBUG()
 			std::string debugText;
 		#endif
 	};
 
+	void MarkPending(ID3D12Resource* resource, TrackedResource& trackedResource)
+	{
+		if (trackedResource.pending)
+			return;
+		trackedResource.pending = true;
+		m_pendingResources.push_back(resource);
+	}
+
 	std::unordered_map<ID3D12Resource*, TrackedResource> m_trackedResources;
+	std::vector<ID3D12Resource*> m_pendingResources; // resources with a transition requested since the last flush, in request order
 	std::vector<D3D12_RESOURCE_BARRIER> m_barriers; // a member to minimize allocations
 
 	#if DO_DEBUG()
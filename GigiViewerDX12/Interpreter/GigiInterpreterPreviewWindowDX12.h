@@ -368,6 +368,13 @@ public:
 							m_logFn(LogLevel::Error, "Tried to remove modifiled file from the PLY cache, but it wasn't there! \"%s\"", fileName.c_str());
 						break;
 					}
+					case FileWatchOwner::PLYStream:
+					{
+						// Streamed ply files are read straight from disk, but another buffer may have loaded the same file through the caches
+						m_plys.Remove(fileName.c_str());
+						m_files.Remove(fileName.c_str());
+						return;
+					}
 				}
 
 				// Remove from the file cache
@@ -525,6 +532,7 @@ public:
 	{
 		std::string fileName;
 		bool CSVHeaderRow = true; // If reading a CSV, and this is true, it will skip everything up to the first newline, to ignore a header row.
+		GGUserFile_ImportedBuffer_MeshLayout meshLayout = GGUserFile_ImportedBuffer_MeshLayout::Flattened; // If reading a mesh, whether to load flattened vertices, welded vertices, or the welded vertex indices.
 		int structIndex = -1;
 		DataFieldType type = DataFieldType::Count;
 		int count = 1;
@@ -638,7 +646,7 @@ public:
 		return m_textures;
 	}
 
-	FileCache getFileCache() {
+	const FileCache& getFileCache() const {
 		return m_files;
 	}
 
@@ -666,12 +674,13 @@ public:
 		ObjCache,
 		FBXCache,
 		PLYCache,
+		PLYStream,
 		GGFile,
 
 		Count
 	};
 
-	FileWatcher<FileWatchOwner> getFileWatcher()
+	const FileWatcher<FileWatchOwner>& getFileWatcher() const
 	{
 		return m_fileWatcher;
 	}
@@ -693,6 +702,7 @@ private:
 	bool OnNodeActionImported(const RenderGraphNode_Resource_Buffer& node, RuntimeTypes::RenderGraphNode_Resource_Buffer& runtimeData, NodeAction nodeAction);
 	bool OnNodeActionNotImported(const RenderGraphNode_Resource_Buffer& node, RuntimeTypes::RenderGraphNode_Resource_Buffer& runtimeData, NodeAction nodeAction);
 	bool MakeAccelerationStructures(const RenderGraphNode_Resource_Buffer& node, const ImportedResourceDesc& resourceDesc, RuntimeTypes::RenderGraphNode_Resource_Buffer& runtimeData);
+	std::vector<char> LoadMeshBuffer(const RenderGraphNode_Resource_Buffer& node, const ImportedResourceDesc& desc, const std::vector<FlattenedVertex>& flattenedVertices, const IndexedMesh& indexedMesh);
 	bool DrawCall_MakeRootSignature(const RenderGraphNode_Action_DrawCall& node, RuntimeTypes::RenderGraphNode_Action_DrawCall& runtimeData);
 	bool DrawCall_MakeDescriptorTableDesc(std::vector<DescriptorTableCache::ResourceDescriptor>& descs, const RenderGraphNode_Action_DrawCall& node, const Shader& shader, int pinOffset, std::vector<TransitionTracker::Item>& queuedTransitions, const std::unordered_map<ID3D12Resource*, D3D12_RESOURCE_STATES>& importantResourceStates);
 
@@ -766,6 +776,7 @@ inline const char* EnumToString(GigiInterpreterPreviewWindowDX12::FileWatchOwner
 		case GigiInterpreterPreviewWindowDX12::FileWatchOwner::ObjCache: return "ObjCache";
 		case GigiInterpreterPreviewWindowDX12::FileWatchOwner::FBXCache: return "FBXCache";
 		case GigiInterpreterPreviewWindowDX12::FileWatchOwner::PLYCache: return "PLYCache";
+		case GigiInterpreterPreviewWindowDX12::FileWatchOwner::PLYStream: return "PLYStream";
 		case GigiInterpreterPreviewWindowDX12::FileWatchOwner::GGFile: return "GGFile";
 		default: return "<unknown>";
 	}
@@ -37,10 +37,10 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeAction(const RenderGraphNode_Action
 				std::string destNodeName = dest.resourceBuffer.name;
 
 				bool srcExists;
-				RuntimeTypes::RenderGraphNode_Resource_Buffer& srcRT = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(srcNodeName.c_str(), srcExists);
+				RuntimeTypes::RenderGraphNode_Resource_Buffer& srcRT = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(node.source.resourceNodeIndex, srcExists);
 
 				bool destExists;
-				RuntimeTypes::RenderGraphNode_Resource_Buffer& destRT = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(destNodeName.c_str(), destExists);
+				RuntimeTypes::RenderGraphNode_Resource_Buffer& destRT = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(node.dest.resourceNodeIndex, destExists);
 
 				if (!srcExists || !srcRT.m_resource || !destExists || !destRT.m_resource)
 				{
@@ -83,10 +83,10 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeAction(const RenderGraphNode_Action
 				std::string destNodeName = dest.resourceTexture.name;
 
 				bool srcExists;
-				RuntimeTypes::RenderGraphNode_Resource_Texture& srcRT = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(srcNodeName.c_str(), srcExists);
+				RuntimeTypes::RenderGraphNode_Resource_Texture& srcRT = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(node.source.resourceNodeIndex, srcExists);
 
 				bool destExists;
-				RuntimeTypes::RenderGraphNode_Resource_Texture& destRT = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(destNodeName.c_str(), destExists);
+				RuntimeTypes::RenderGraphNode_Resource_Texture& destRT = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(node.dest.resourceNodeIndex, destExists);
 
 				if (!srcExists || !srcRT.m_resource || !destExists || !destRT.m_resource)
 				{
@@ -133,10 +133,10 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeAction(const RenderGraphNode_Action
 				std::string destNodeName = dest.resourceTexture.name;
 
 				bool srcExists;
-				RuntimeTypes::RenderGraphNode_Resource_Buffer& srcRT = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(srcNodeName.c_str(), srcExists);
+				RuntimeTypes::RenderGraphNode_Resource_Buffer& srcRT = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(node.source.resourceNodeIndex, srcExists);
 
 				bool destExists;
-				RuntimeTypes::RenderGraphNode_Resource_Texture& destRT = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(destNodeName.c_str(), destExists);
+				RuntimeTypes::RenderGraphNode_Resource_Texture& destRT = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(node.dest.resourceNodeIndex, destExists);
 
 				if (!srcExists || !srcRT.m_resource || !destExists || !destRT.m_resource)
 				{
@@ -195,10 +195,10 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeAction(const RenderGraphNode_Action
 				std::string destNodeName = dest.resourceBuffer.name;
 
 				bool srcExists;
-				RuntimeTypes::RenderGraphNode_Resource_Texture& srcRT = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(srcNodeName.c_str(), srcExists);
+				RuntimeTypes::RenderGraphNode_Resource_Texture& srcRT = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(node.source.resourceNodeIndex, srcExists);
 
 				bool destExists;
-				RuntimeTypes::RenderGraphNode_Resource_Buffer& destRT = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(destNodeName.c_str(), destExists);
+				RuntimeTypes::RenderGraphNode_Resource_Buffer& destRT = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(node.dest.resourceNodeIndex, destExists);
 
 				if (!srcExists || !srcRT.m_resource || !destExists || !destRT.m_resource)
 				{
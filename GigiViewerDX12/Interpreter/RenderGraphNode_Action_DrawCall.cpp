@@ -369,7 +369,7 @@ bool GigiInterpreterPreviewWindowDX12::DrawCall_MakeRootSignature(const RenderGr
 			if (node.vertexBuffer.resourceNodeIndex != -1)
 			{
 				bool exists = false;
-				const RuntimeTypes::RenderGraphNode_Resource_Buffer& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(m_renderGraph.nodes[node.vertexBuffer.resourceNodeIndex].resourceBuffer.name.c_str(), exists);
+				const RuntimeTypes::RenderGraphNode_Resource_Buffer& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(node.vertexBuffer.resourceNodeIndex, exists);
 				if (exists && resourceInfo.m_resource && resourceInfo.m_structIndex != -1)
 				{
 					const Struct& structDesc = m_renderGraph.structs[resourceInfo.m_structIndex];
@@ -383,7 +383,7 @@ bool GigiInterpreterPreviewWindowDX12::DrawCall_MakeRootSignature(const RenderGr
 			if (node.instanceBuffer.resourceNodeIndex != -1)
 			{
 				bool exists = false;
-				const RuntimeTypes::RenderGraphNode_Resource_Buffer& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(m_renderGraph.nodes[node.instanceBuffer.resourceNodeIndex].resourceBuffer.name.c_str(), exists);
+				const RuntimeTypes::RenderGraphNode_Resource_Buffer& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(node.instanceBuffer.resourceNodeIndex, exists);
 				if (exists && resourceInfo.m_resource && resourceInfo.m_structIndex != -1)
 				{
 					const Struct& structDesc = m_renderGraph.structs[resourceInfo.m_structIndex];
@@ -404,7 +404,7 @@ bool GigiInterpreterPreviewWindowDX12::DrawCall_MakeRootSignature(const RenderGr
 				return false;
 
 			bool exists = false;
-			const RuntimeTypes::RenderGraphNode_Resource_Buffer& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(m_renderGraph.nodes[node.vertexBuffer.resourceNodeIndex].resourceBuffer.name.c_str(), exists);
+			const RuntimeTypes::RenderGraphNode_Resource_Buffer& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(node.vertexBuffer.resourceNodeIndex, exists);
 			if (!exists || !resourceInfo.m_resource)
 			{
 				std::ostringstream ss;
@@ -467,7 +467,7 @@ bool GigiInterpreterPreviewWindowDX12::DrawCall_MakeRootSignature(const RenderGr
 				return false;
 
 			bool exists = false;
-			const RuntimeTypes::RenderGraphNode_Resource_Buffer& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(m_renderGraph.nodes[node.instanceBuffer.resourceNodeIndex].resourceBuffer.name.c_str(), exists);
+			const RuntimeTypes::RenderGraphNode_Resource_Buffer& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(node.instanceBuffer.resourceNodeIndex, exists);
 			if (!exists || !resourceInfo.m_resource)
 				return true;
 
@@ -582,7 +582,7 @@ bool GigiInterpreterPreviewWindowDX12::DrawCall_MakeRootSignature(const RenderGr
 					break;
 
 				bool exists = false;
-				const RuntimeTypes::RenderGraphNode_Resource_Texture& textureInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(resourceNode.resourceTexture.name.c_str(), exists);
+				const RuntimeTypes::RenderGraphNode_Resource_Texture& textureInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(node.colorTargets[i].resourceNodeIndex, exists);
 				if (!exists || !textureInfo.m_resource)
 					return SetupPSODescRet::True;
 
@@ -600,7 +600,7 @@ bool GigiInterpreterPreviewWindowDX12::DrawCall_MakeRootSignature(const RenderGr
 					return SetupPSODescRet::True;
 
 				bool exists = false;
-				const RuntimeTypes::RenderGraphNode_Resource_Texture& textureInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(resourceNode.resourceTexture.name.c_str(), exists);
+				const RuntimeTypes::RenderGraphNode_Resource_Texture& textureInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(node.depthTarget.resourceNodeIndex, exists);
 				if (exists && textureInfo.m_resource)
 				{
 					psoDesc.DepthStencilState.DepthEnable = TRUE;
@@ -736,7 +736,7 @@ bool GigiInterpreterPreviewWindowDX12::DrawCall_MakeRootSignature(const RenderGr
 		{
 			case RenderGraphNode::c_index_resourceTexture:
 			{
-				const RuntimeTypes::RenderGraphNode_Resource_Texture& resourceInfo =  GetRuntimeNodeData_RenderGraphNode_Resource_Texture(resourceNode.resourceTexture.name.c_str());
+				const RuntimeTypes::RenderGraphNode_Resource_Texture& resourceInfo =  GetRuntimeNodeData_RenderGraphNode_Resource_Texture(dep.nodeIndex);
 				desc.m_resource = resourceInfo.m_resource;
 				desc.m_format = resourceInfo.m_format;
 
@@ -751,7 +751,7 @@ bool GigiInterpreterPreviewWindowDX12::DrawCall_MakeRootSignature(const RenderGr
 			}
 			case RenderGraphNode::c_index_resourceShaderConstants:
 			{
-				const RuntimeTypes::RenderGraphNode_Resource_ShaderConstants& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_ShaderConstants(resourceNode.resourceShaderConstants.name.c_str());
+				const RuntimeTypes::RenderGraphNode_Resource_ShaderConstants& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_ShaderConstants(dep.nodeIndex);
 				desc.m_resource = resourceInfo.m_buffer->buffer;
 				desc.m_format = DXGI_FORMAT_UNKNOWN;
 				desc.m_stride = (UINT)resourceInfo.m_buffer->size;
@@ -760,7 +760,7 @@ bool GigiInterpreterPreviewWindowDX12::DrawCall_MakeRootSignature(const RenderGr
 			}
 			case RenderGraphNode::c_index_resourceBuffer:
 			{
-				const RuntimeTypes::RenderGraphNode_Resource_Buffer& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(resourceNode.resourceBuffer.name.c_str());
+				const RuntimeTypes::RenderGraphNode_Resource_Buffer& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(dep.nodeIndex);
 
 				if (dep.access == ShaderResourceAccessType::RTScene)
 				{
@@ -973,7 +973,7 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeAction(const RenderGraphNode_Action
 			if (resourceNode._index == RenderGraphNode::c_index_resourceTexture)
 			{
 				bool exists = false;
-				const auto& textureInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(resourceNode.resourceTexture.name.c_str(), exists);
+				const auto& textureInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(node.shadingRateImage.resourceNodeIndex, exists);
 				if (exists && textureInfo.m_resource)
 				{
 					// publish as a viewable resource
@@ -1005,7 +1005,7 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeAction(const RenderGraphNode_Action
 			if (vbNode._index == RenderGraphNode::c_index_resourceBuffer)
 			{
 				bool exists = false;
-				const auto& bufferInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(vbNode.resourceBuffer.name.c_str(), exists);
+				const auto& bufferInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(node.vertexBuffer.resourceNodeIndex, exists);
 				if (exists && bufferInfo.m_resource)
 				{
 					// Set the vertex count
@@ -1037,7 +1037,7 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeAction(const RenderGraphNode_Action
 			if (ibNode._index == RenderGraphNode::c_index_resourceBuffer)
 			{
 				bool exists = false;
-				const auto& bufferInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(ibNode.resourceBuffer.name.c_str(), exists);
+				const auto& bufferInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(node.indexBuffer.resourceNodeIndex, exists);
 				if (exists && bufferInfo.m_resource)
 				{
 					// Set the index count
@@ -1069,7 +1069,7 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeAction(const RenderGraphNode_Action
 			if (ibNode._index == RenderGraphNode::c_index_resourceBuffer)
 			{
 				bool exists = false;
-				const auto& bufferInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(ibNode.resourceBuffer.name.c_str(), exists);
+				const auto& bufferInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(node.instanceBuffer.resourceNodeIndex, exists);
 				if (exists && bufferInfo.m_resource)
 				{
 					// Set the instance count
@@ -1157,7 +1157,7 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeAction(const RenderGraphNode_Action
 				sprintf_s(buffer, "%s.colorTarget%i (Before)", node.name.c_str(), i);
 
 				bool exists = false;
-				auto& textureInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(colorTargetNode.resourceTexture.name.c_str(), exists);
+				auto& textureInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(node.colorTargets[i].resourceNodeIndex, exists);
 				if (!exists || !textureInfo.m_resource)
 					break;
 				const ColorTargetSettings& ctSettings = node.colorTargetSettings[i];
@@ -1213,7 +1213,7 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeAction(const RenderGraphNode_Action
 				if (depthTargetNode._index == RenderGraphNode::c_index_resourceTexture)
 				{
 					bool exists = false;
-					auto& textureInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(depthTargetNode.resourceTexture.name.c_str(), exists);
+					auto& textureInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(node.depthTarget.resourceNodeIndex, exists);
 					if (exists && textureInfo.m_resource)
 					{
 						int textureMipSize[3] = { textureInfo.m_size[0], textureInfo.m_size[1], textureInfo.m_size[2] };
@@ -1366,7 +1366,7 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeAction(const RenderGraphNode_Action
 					else
 						label = label + " (SRV)";
 
-					const RuntimeTypes::RenderGraphNode_Resource_Texture& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(resourceNode.resourceTexture.name.c_str());
+					const RuntimeTypes::RenderGraphNode_Resource_Texture& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(dep.nodeIndex);
 					runtimeData.HandleViewableTexture(*this, TextureDimensionTypeToViewableResourceType(resourceNode.resourceTexture.dimension), label.c_str(), resourceInfo.m_resource, resourceInfo.m_format, resourceInfo.m_size, resourceInfo.m_numMips, false, false);
 					break;
 				}
@@ -1375,7 +1375,7 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeAction(const RenderGraphNode_Action
 					std::string label = node.name + std::string(".") + shaderResourceName + std::string(": ") + resourceNode.resourceShaderConstants.name;
 					label = label + " (CBV)";
 
-					const RuntimeTypes::RenderGraphNode_Resource_ShaderConstants& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_ShaderConstants(resourceNode.resourceShaderConstants.name.c_str());
+					const RuntimeTypes::RenderGraphNode_Resource_ShaderConstants& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_ShaderConstants(dep.nodeIndex);
 					runtimeData.HandleViewableConstantBuffer(*this, label.c_str(), resourceInfo.m_buffer->buffer, (int)resourceInfo.m_buffer->size, shader->resources[dep.pinIndex - shaderBasePinIndex].constantBufferStructIndex, false, false);
 					break;
 				}
@@ -1387,7 +1387,7 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeAction(const RenderGraphNode_Action
 					else
 						label = label + " (SRV)";
 
-					const RuntimeTypes::RenderGraphNode_Resource_Buffer& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(resourceNode.resourceBuffer.name.c_str());
+					const RuntimeTypes::RenderGraphNode_Resource_Buffer& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(dep.nodeIndex);
 					runtimeData.HandleViewableBuffer(*this, label.c_str(), resourceInfo.m_resource, resourceInfo.m_format, resourceInfo.m_formatCount, resourceInfo.m_structIndex, resourceInfo.m_size, resourceInfo.m_stride, resourceInfo.m_count, false, false);
 					break;
 				}
@@ -1686,7 +1686,7 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeAction(const RenderGraphNode_Action
 				sprintf_s(buffer, "%s.colorTarget%i (After)", node.name.c_str(), i);
 
 				bool exists = false;
-				const auto& textureInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(colorTargetNode.resourceTexture.name.c_str(), exists);
+				const auto& textureInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(node.colorTargets[i].resourceNodeIndex, exists);
 				if (!exists || !textureInfo.m_resource)
 					break;
 
@@ -1699,7 +1699,7 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeAction(const RenderGraphNode_Action
 				if (depthTargetNode._index == RenderGraphNode::c_index_resourceTexture)
 				{
 					bool exists = false;
-					const auto& textureInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(depthTargetNode.resourceTexture.name.c_str(), exists);
+					const auto& textureInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(node.depthTarget.resourceNodeIndex, exists);
 					if (exists && textureInfo.m_resource)
 					{
 						char buffer[256];
@@ -1800,7 +1800,7 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeAction(const RenderGraphNode_Action
 					else
 						continue;
 
-					const RuntimeTypes::RenderGraphNode_Resource_Texture& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(resourceNode.resourceTexture.name.c_str());
+					const RuntimeTypes::RenderGraphNode_Resource_Texture& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Texture(dep.nodeIndex);
 					runtimeData.HandleViewableTexture(*this, TextureDimensionTypeToViewableResourceType(resourceNode.resourceTexture.dimension), label.c_str(), resourceInfo.m_resource, resourceInfo.m_format, resourceInfo.m_size, resourceInfo.m_numMips, false, true);
 					break;
 				}
@@ -1812,7 +1812,7 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeAction(const RenderGraphNode_Action
 					else
 						continue;
 
-					const RuntimeTypes::RenderGraphNode_Resource_Buffer& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(resourceNode.resourceBuffer.name.c_str());
+					const RuntimeTypes::RenderGraphNode_Resource_Buffer& resourceInfo = GetRuntimeNodeData_RenderGraphNode_Resource_Buffer(dep.nodeIndex);
 					runtimeData.HandleViewableBuffer(*this, label.c_str(), resourceInfo.m_resource, resourceInfo.m_format, resourceInfo.m_formatCount, resourceInfo.m_structIndex, resourceInfo.m_size, resourceInfo.m_stride, resourceInfo.m_count, false, true);
 					break;
 				}
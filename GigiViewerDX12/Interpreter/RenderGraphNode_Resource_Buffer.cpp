@@ -7,6 +7,7 @@
 #include "GigiInterpreterPreviewWindowDX12.h"
 #include "NodesShared.h"
 #include "DX12Utils/Utils.h"
+#include "DX12Utils/TangentGenerator.h"
 #include "GigiCompilerLib/ParseCSV.h"
 #include <filesystem>
 
@@ -415,9 +416,27 @@ static std::vector<char> LoadStructuredBufferPly(const GigiInterpreterPreviewWin
 		return ret;
 	const PLYCache::ElementGroup& vertexElementGroup = plyData.elementGroups[vertexElementGroupIndex];
 
+	// If the struct has a tangent field, and the file has triangles but no tangents, generate them.
+	// The tangent field still takes its properties from the file, like any other field, but writes the generated tangent instead,
+	// so that the fields after it get the same properties either way.
+	const Struct& structDesc = renderGraph.structs[desc.buffer.structIndex];
+	bool generateTangents = false;
+	std::vector<FlattenedVertex> tangentVertices;
+	{
+		bool wantsTangents = false;
+		for (const StructField& field : structDesc.fields)
+			wantsTangents |= (field.semantic == StructFieldSemantic::Tangent);
+
+		if (wantsTangents && plyData.flattenedFaces && PLYCache::FindProperty(vertexElementGroup, "tx") == -1 && PLYCache::FindProperty(vertexElementGroup, "tangent_x") == -1)
+		{
+			PLYCache::ReadFlattenedVertices(vertexElementGroup, tangentVertices);
+			TangentGenerator().Generate(tangentVertices.data(), tangentVertices.size());
+			generateTangents = true;
+		}
+	}
+
 	// Get the number of components to copy
 	unsigned int copyComponentCount = 0;
-	const Struct& structDesc = renderGraph.structs[desc.buffer.structIndex];
 	{
 		unsigned int componentCount = 0;
 		for (const StructField& field : structDesc.fields)
@@ -439,6 +458,30 @@ static std::vector<char> LoadStructuredBufferPly(const GigiInterpreterPreviewWin
 			for (const StructField& field : structDesc.fields)
 			{
 				const auto& fieldInfo = DataFieldTypeInfo(field.type);
+
+				if (generateTangents && field.semantic == StructFieldSemantic::Tangent)
+				{
+					const Vec4& tangent = tangentVertices[vertIndex].tangent;
+					for (int componentIndex = 0; componentIndex < fieldInfo.componentCount; ++componentIndex)
+					{
+						float val = (componentIndex < 4) ? tangent[componentIndex] : 0.0f;
+						switch (fieldInfo.componentType2)
+						{
+							case DataFieldType::Int: AppendBytes(ret, (int)val); break;
+							case DataFieldType::Uint: AppendBytes(ret, (unsigned int)val); break;
+							case DataFieldType::Float: AppendBytes(ret, val); break;
+							default: return ret;
+						}
+
+						// Skip the property this component would have read
+						float skipped = 0.0f;
+						if (srcPropertyIndex < copyComponentCount)
+							src = PLYCache::ReadFromBinaryAndCastTo(src, vertexElementGroup.properties[srcPropertyIndex].type, skipped);
+						srcPropertyIndex++;
+					}
+					continue;
+				}
+
 				for (int componentIndex = 0; componentIndex < fieldInfo.componentCount; ++componentIndex)
 				{
 					switch (fieldInfo.componentType2)
@@ -478,6 +521,50 @@ static std::vector<char> LoadStructuredBufferPly(const GigiInterpreterPreviewWin
 	return ret;
 }
 
+// Makes the columns to stream a ply vertex element group into a buffer with, giving the same result as LoadTypedBufferPly and LoadStructuredBufferPly.
+// The buffer's components take the vertex properties in order, and any components past the last property are zero.
+// Only files without faces are streamed, and those don't get generated tangents, so tangent fields take properties like any other field.
+// Returns false if the buffer has components that aren't int, uint or float.
+static bool MakePlyStreamColumns(const GigiInterpreterPreviewWindowDX12::ImportedResourceDesc& desc, const RenderGraph& renderGraph, const PLYCache::ElementGroup& vertexElementGroup, std::vector<PLYCache::Column>& columns, size_t& destStride)
+{
+	// Get the type of each component of a buffer element
+	std::vector<DataFieldType> componentTypes;
+	if (desc.buffer.type != DataFieldType::Count)
+	{
+		const auto& typeInfo = DataFieldTypeInfo(desc.buffer.type);
+		componentTypes.resize(typeInfo.componentCount, typeInfo.componentType2);
+	}
+	else
+	{
+		for (const StructField& field : renderGraph.structs[desc.buffer.structIndex].fields)
+		{
+			const auto& fieldInfo = DataFieldTypeInfo(field.type);
+			componentTypes.insert(componentTypes.end(), fieldInfo.componentCount, fieldInfo.componentType2);
+		}
+	}
+
+	columns.clear();
+	destStride = 0;
+	for (size_t componentIndex = 0; componentIndex < componentTypes.size(); ++componentIndex)
+	{
+		PLYCache::Column column;
+		switch (componentTypes[componentIndex])
+		{
+			case DataFieldType::Int: column.destType = PLYCache::FieldType::i32; break;
+			case DataFieldType::Uint: column.destType = PLYCache::FieldType::u32; break;
+			case DataFieldType::Float: column.destType = PLYCache::FieldType::f32; break;
+			default: return false;
+		}
+
+		column.propertyIndex = (componentIndex < vertexElementGroup.properties.size()) ? (int)componentIndex : -1;
+		column.destOffset = destStride;
+		destStride += 4;
+		columns.push_back(column);
+	}
+
+	return true;
+}
+
 static std::vector<char> LoadStructuredBuffer(const GigiInterpreterPreviewWindowDX12::ImportedResourceDesc& desc, const RenderGraph &renderGraph, const std::vector<FlattenedVertex>& flattenedVertices)
 {
 	// Allocate space to hold the results
@@ -688,31 +775,76 @@ static std::vector<char> LoadTypedBuffer(const GigiInterpreterPreviewWindowDX12:
 	return ret;
 }
 
-static std::vector<char> LoadCSVStructuredBuffer(const GigiInterpreterPreviewWindowDX12::ImportedResourceDesc& desc, const RenderGraph& renderGraph, const char* csvData)
+static std::vector<char> LoadIndexBuffer(const GigiInterpreterPreviewWindowDX12::ImportedResourceDesc& desc, const IndexedMesh& indexedMesh)
 {
 	std::vector<char> ret;
 
-	int offset = 0;
-	int fieldIndex = 0;
-	int componentIndex = 0;
+	switch (desc.buffer.type)
+	{
+		case DataFieldType::Uint:
+		{
+			ret.resize(indexedMesh.indices.size() * sizeof(uint32_t));
+			memcpy(ret.data(), indexedMesh.indices.data(), ret.size());
+			break;
+		}
+		case DataFieldType::Uint_16:
+		{
+			if (!indexedMesh.Fits16BitIndices())
+				break;
+
+			ret.resize(indexedMesh.indices.size() * sizeof(uint16_t));
+			uint16_t* dest = (uint16_t*)ret.data();
+			for (uint32_t index : indexedMesh.indices)
+				*dest++ = (uint16_t)index;
+			break;
+		}
+	}
+
+	return ret;
+}
+
+// Puts the output of each chunk of ParseCSV::ForEachValueParallel together, in order
+static std::vector<char> JoinChunks(std::vector<std::vector<char>>& chunks)
+{
+	if (chunks.size() == 1)
+		return std::move(chunks[0]);
+
+	size_t totalSize = 0;
+	for (const std::vector<char>& chunk : chunks)
+		totalSize += chunk.size();
 
+	std::vector<char> ret;
+	ret.reserve(totalSize);
+	for (const std::vector<char>& chunk : chunks)
+		ret.insert(ret.end(), chunk.begin(), chunk.end());
+	return ret;
+}
+
+static std::vector<char> LoadCSVStructuredBuffer(const GigiInterpreterPreviewWindowDX12::ImportedResourceDesc& desc, const RenderGraph& renderGraph, const char* csvData)
+{
 	const Struct& s = renderGraph.structs[desc.buffer.structIndex];
 
-	bool success = ParseCSV::ForEachValue(csvData, desc.buffer.CSVHeaderRow,
-		[&](int tokenIndex, const char* token)
+	// The csv values go through the struct fields in order, one value per component, and then start over at the first field.
+	// Knowing the field of each value from just its token index lets the chunks be parsed independently.
+	std::vector<int> valueFieldIndices;
+	for (int fieldIndex = 0; fieldIndex < (int)s.fields.size(); ++fieldIndex)
+	{
+		DataFieldTypeInfoStruct typeInfo = DataFieldTypeInfo(s.fields[fieldIndex].type);
+		for (int componentIndex = 0; componentIndex < typeInfo.componentCount; ++componentIndex)
+			valueFieldIndices.push_back(fieldIndex);
+	}
+
+	if (valueFieldIndices.empty())
+		return std::vector<char>();
+
+	std::vector<std::vector<char>> chunks;
+	bool success = ParseCSV::ForEachValueParallel(csvData, desc.buffer.CSVHeaderRow, chunks,
+		[&](std::vector<char>& ret, int tokenIndex, std::string_view token)
 		{
 			// get the field and field type info
-			const StructField& field = s.fields[fieldIndex];
+			const StructField& field = s.fields[valueFieldIndices[tokenIndex % valueFieldIndices.size()]];
 			DataFieldTypeInfoStruct typeInfo = DataFieldTypeInfo(field.type);
 
-			// Advance componentIndex and fieldIndex as appropriate, for next iteration
-			componentIndex++;
-			if (componentIndex >= typeInfo.componentCount)
-			{
-				componentIndex = 0;
-				fieldIndex = (fieldIndex + 1) % s.fields.size();
-			}
-
 			// read a value
 			switch (typeInfo.componentType)
 			{
@@ -726,7 +858,7 @@ static std::vector<char> LoadCSVStructuredBuffer(const GigiInterpreterPreviewWin
 						for (const EnumItem& item : renderGraph.enums[field.enumIndex].items)
 						{
 							v++;
-							if (!_stricmp(item.displayLabel.c_str(), token))
+							if (ParseText::EqualsNoCase(item.displayLabel, token))
 							{
 								enumFound = true;
 								break;
@@ -738,7 +870,7 @@ static std::vector<char> LoadCSVStructuredBuffer(const GigiInterpreterPreviewWin
 					}
 					else
 					{
-						if (sscanf_s(token, "%i", &v) != 1)
+						if (!ParseText::ParseNumber(token, v))
 							return false;
 					}
 					AppendBytes(ret, v);
@@ -747,7 +879,7 @@ static std::vector<char> LoadCSVStructuredBuffer(const GigiInterpreterPreviewWin
 				case DataFieldComponentType::_uint16_t:
 				{
 					unsigned int v;
-					if (sscanf_s(token, "%u", &v) != 1)
+					if (!ParseText::ParseNumber(token, v))
 						return false;
 					AppendBytes(ret, (uint16_t)v);
 					return true;
@@ -757,16 +889,16 @@ static std::vector<char> LoadCSVStructuredBuffer(const GigiInterpreterPreviewWin
 					unsigned int v;
 					if (field.type == DataFieldType::Bool)
 					{
-						if (!_stricmp(token, "true") || !_stricmp(token, "1"))
+						if (ParseText::EqualsNoCase(token, "true") || ParseText::EqualsNoCase(token, "1"))
 							v = 1;
-						else if (!_stricmp(token, "false") || !_stricmp(token, "0"))
+						else if (ParseText::EqualsNoCase(token, "false") || ParseText::EqualsNoCase(token, "0"))
 							v = 0;
 						else
 							return false;
 					}
 					else
 					{
-						if (sscanf_s(token, "%u", &v) != 1)
+						if (!ParseText::ParseNumber(token, v))
 							return false;
 					}
 					AppendBytes(ret, v);
@@ -775,7 +907,7 @@ static std::vector<char> LoadCSVStructuredBuffer(const GigiInterpreterPreviewWin
 				case DataFieldComponentType::_float:
 				{
 					float v;
-					if (sscanf_s(token, "%f", &v) != 1)
+					if (!ParseText::ParseNumber(token, v))
 						return false;
 					AppendBytes(ret, v);
 					return true;
@@ -786,23 +918,21 @@ static std::vector<char> LoadCSVStructuredBuffer(const GigiInterpreterPreviewWin
 	);
 
 	if (!success)
-		ret.clear();
+		return std::vector<char>();
 
-	return ret;
+	return JoinChunks(chunks);
 }
 
 static std::vector<char> LoadCSVTypedBuffer(const GigiInterpreterPreviewWindowDX12::ImportedResourceDesc& desc, const char* csvData)
 {
-	std::vector<char> ret;
-
-	int offset = 0;
 	DataFieldTypeInfoStruct typeInfo = DataFieldTypeInfo(desc.buffer.type);
 
-	bool success = ParseCSV::ForEachValue(csvData, desc.buffer.CSVHeaderRow,
-		[&](int tokenIndex, const char* token)
+	std::vector<std::vector<char>> chunks;
+	bool success = ParseCSV::ForEachValueParallel(csvData, desc.buffer.CSVHeaderRow, chunks,
+		[&](std::vector<char>& ret, int tokenIndex, std::string_view token)
 		{
 			// skip empty tokens, caused by trailing commas
-			if (token[0] == 0)
+			if (token.empty())
 				return true;
 
 			switch (typeInfo.componentType)
@@ -810,7 +940,7 @@ static std::vector<char> LoadCSVTypedBuffer(const GigiInterpreterPreviewWindowDX
 				case DataFieldComponentType::_int:
 				{
 					int v;
-					if (sscanf_s(token, "%i", &v) != 1)
+					if (!ParseText::ParseNumber(token, v))
 						return false;
 					AppendBytes(ret, v);
 					return true;
@@ -818,7 +948,7 @@ static std::vector<char> LoadCSVTypedBuffer(const GigiInterpreterPreviewWindowDX
 				case DataFieldComponentType::_uint16_t:
 				{
 					unsigned int v;
-					if (sscanf_s(token, "%u", &v) != 1)
+					if (!ParseText::ParseNumber(token, v))
 						return false;
 					AppendBytes(ret, (uint16_t)v);
 					return true;
@@ -826,7 +956,7 @@ static std::vector<char> LoadCSVTypedBuffer(const GigiInterpreterPreviewWindowDX
 				case DataFieldComponentType::_uint32_t:
 				{
 					unsigned int v;
-					if (sscanf_s(token, "%u", &v) != 1)
+					if (!ParseText::ParseNumber(token, v))
 						return false;
 					AppendBytes(ret, v);
 					return true;
@@ -834,7 +964,7 @@ static std::vector<char> LoadCSVTypedBuffer(const GigiInterpreterPreviewWindowDX
 				case DataFieldComponentType::_float:
 				{
 					float v;
-					if (sscanf_s(token, "%f", &v) != 1)
+					if (!ParseText::ParseNumber(token, v))
 						return false;
 					AppendBytes(ret, v);
 					return true;
@@ -845,9 +975,46 @@ static std::vector<char> LoadCSVTypedBuffer(const GigiInterpreterPreviewWindowDX
 	);
 
 	if (!success)
-		ret.clear();
+		return std::vector<char>();
 
-	return ret;
+	return JoinChunks(chunks);
+}
+
+std::vector<char> GigiInterpreterPreviewWindowDX12::LoadMeshBuffer(const RenderGraphNode_Resource_Buffer& node, const ImportedResourceDesc& desc, const std::vector<FlattenedVertex>& flattenedVertices, const IndexedMesh& indexedMesh)
+{
+	switch (desc.buffer.meshLayout)
+	{
+		case GGUserFile_ImportedBuffer_MeshLayout::Flattened:
+		case GGUserFile_ImportedBuffer_MeshLayout::IndexedVertices:
+		{
+			const std::vector<FlattenedVertex>& vertices = (desc.buffer.meshLayout == GGUserFile_ImportedBuffer_MeshLayout::Flattened) ? flattenedVertices : indexedMesh.vertices;
+
+			// Load a typed buffer
+			if (desc.buffer.type != DataFieldType::Count)
+				return LoadTypedBuffer(desc, vertices);
+			// Load a structured buffer
+			else
+				return LoadStructuredBuffer(desc, m_renderGraph, vertices);
+		}
+		case GGUserFile_ImportedBuffer_MeshLayout::Indices:
+		{
+			if (desc.buffer.type != DataFieldType::Uint && desc.buffer.type != DataFieldType::Uint_16)
+			{
+				m_logFn(LogLevel::Error, "Buffer \"%s\" loads mesh indices, so needs to be of type Uint or Uint_16", node.name.c_str());
+				return {};
+			}
+
+			if (desc.buffer.type == DataFieldType::Uint_16 && !indexedMesh.Fits16BitIndices())
+			{
+				m_logFn(LogLevel::Error, "Buffer \"%s\" loads mesh indices as Uint_16, but the mesh has %zu unique vertices. Use Uint instead.", node.name.c_str(), indexedMesh.vertices.size());
+				return {};
+			}
+
+			return LoadIndexBuffer(desc, indexedMesh);
+		}
+	}
+
+	return {};
 }
 
 bool GigiInterpreterPreviewWindowDX12::OnNodeActionImported(const RenderGraphNode_Resource_Buffer& node, RuntimeTypes::RenderGraphNode_Resource_Buffer& runtimeData, NodeAction nodeAction)
@@ -908,7 +1075,35 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeActionImported(const RenderGraphNod
 
 				m_fileWatcher.Add(desc.buffer.fileName.c_str(), fileWatchOwner);
 
-				if (p.extension() == ".ply")
+				// Binary ply files without faces, like gaussian splats, are streamed straight from disk, reading only the properties the buffer uses.
+				PLYCache::StreamHeader plyStreamHeader;
+				std::vector<PLYCache::Column> plyStreamColumns;
+				size_t plyStreamStride = 0;
+				bool streamPly = false;
+				if (p.extension() == ".ply" && PLYCache::ReadHeader(desc.buffer.fileName.c_str(), plyStreamHeader) && PLYCache::CanStream(plyStreamHeader, "vertex"))
+				{
+					const PLYCache::ElementGroup* vertexElementGroup = nullptr;
+					bool hasFaces = false;
+					for (const PLYCache::ElementGroup& elementGroup : plyStreamHeader.plyData.elementGroups)
+					{
+						if (elementGroup.name == "vertex" && !vertexElementGroup)
+							vertexElementGroup = &elementGroup;
+						hasFaces |= (elementGroup.name == "face");
+					}
+
+					streamPly = !hasFaces && MakePlyStreamColumns(desc, m_renderGraph, *vertexElementGroup, plyStreamColumns, plyStreamStride);
+				}
+
+				if (streamPly)
+				{
+					// Streamed files don't go through the file cache or the ply cache
+					m_fileWatcher.Add(desc.buffer.fileName.c_str(), FileWatchOwner::PLYStream);
+
+					std::string error;
+					if (!PLYCache::StreamColumns(desc.buffer.fileName.c_str(), plyStreamHeader, "vertex", plyStreamColumns, plyStreamStride, rawBytes, error))
+						m_logFn(LogLevel::Warn, "Loading PLY for buffer \"%s\": %s", node.name.c_str(), error.c_str());
+				}
+				else if (p.extension() == ".ply")
 				{
 					// Load the ply data
 					PLYCache::PLYData plyData = m_plys.GetFlattened(m_files, desc.buffer.fileName.c_str());
@@ -933,7 +1128,9 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeActionImported(const RenderGraphNod
 				{
 					// Load the obj data
 					std::vector<char> ret;
-					const ObjCache::OBJData& objData = m_objs.Get(m_files, desc.buffer.fileName.c_str());
+					const ObjCache::OBJData& objData = (desc.buffer.meshLayout == GGUserFile_ImportedBuffer_MeshLayout::Flattened)
+						? m_objs.Get(m_files, desc.buffer.fileName.c_str())
+						: m_objs.GetIndexed(m_files, desc.buffer.fileName.c_str());
 					if (!objData.warn.empty())
 						m_logFn(LogLevel::Warn, "Loading Obj for buffer \"%s\": %s", node.name.c_str(), objData.warn.c_str());
 					if (!objData.error.empty())
@@ -962,19 +1159,16 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeActionImported(const RenderGraphNod
 							runtimeData.materials.push_back(RuntimeTypes::RenderGraphNode_Resource_Buffer::MaterialInfo(material.name, used));
 						}
 
-						// Load a typed buffer
-						if (desc.buffer.type != DataFieldType::Count)
-							rawBytes = LoadTypedBuffer(desc, objData.flattenedVertices);
-						// Load a structured buffer
-						else
-							rawBytes = LoadStructuredBuffer(desc, m_renderGraph, objData.flattenedVertices);
+						rawBytes = LoadMeshBuffer(node, desc, objData.flattenedVertices, objData.indexedMesh);
 					}
 				}
 				else if (p.extension() == ".fbx")
 				{
 					// Load the fbx data
 					std::vector<char> ret;
-					const FBXCache::FBXData& fbxData = m_fbxs.Get(m_files, desc.buffer.fileName.c_str());
+					const FBXCache::FBXData& fbxData = (desc.buffer.meshLayout == GGUserFile_ImportedBuffer_MeshLayout::Flattened)
+						? m_fbxs.Get(m_files, desc.buffer.fileName.c_str())
+						: m_fbxs.GetIndexed(m_files, desc.buffer.fileName.c_str());
 					if (!fbxData.warn.empty())
 						m_logFn(LogLevel::Warn, "Loading fbx for buffer \"%s\": %s", node.name.c_str(), fbxData.warn.c_str());
 					if (!fbxData.error.empty())
@@ -982,17 +1176,12 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeActionImported(const RenderGraphNod
 
 					if (fbxData.valid)
 					{
-						// Load a typed buffer
-						if (desc.buffer.type != DataFieldType::Count)
-							rawBytes = LoadTypedBuffer(desc, fbxData.flattenedVertices);
-						// Load a structured buffer
-						else
-							rawBytes = LoadStructuredBuffer(desc, m_renderGraph, fbxData.flattenedVertices);
+						rawBytes = LoadMeshBuffer(node, desc, fbxData.flattenedVertices, fbxData.indexedMesh);
 					}
 				}
 				else if (p.extension() == ".csv")
 				{
-					const FileCache::File& file = m_files.Get(desc.buffer.fileName.c_str());
+					FileCache::File file = m_files.Get(desc.buffer.fileName.c_str());
 
 					// Load a typed buffer
 					if (desc.buffer.type != DataFieldType::Count)
@@ -1004,7 +1193,7 @@ bool GigiInterpreterPreviewWindowDX12::OnNodeActionImported(const RenderGraphNod
 				// Anything else, read as binary
 				else
 				{
-					const FileCache::File& file = m_files.Get(desc.buffer.fileName.c_str());
+					FileCache::File file = m_files.Get(desc.buffer.fileName.c_str());
 					rawBytes.resize(file.GetSize());
 					memcpy(rawBytes.data(), file.GetBytes(), file.GetSize());
 				}
@@ -7,9 +7,12 @@
 #include "GigiInterpreterPreviewWindowDX12.h"
 #include "NodesShared.h"
 #include "DX12Utils/CreateResources.h"
+#include "DX12Utils/MipGenerator.h"
+#include "DX12Utils/PixelConversion.h"
 #include "DX12Utils/Utils.h"
 #include "DX12Utils/SRGB.h"
 #include <d3dx12/d3dx12.h>
+#include <random>
 // clang-format on
 
 static const char* c_cubeMapNames[] =
@@ -22,11 +25,6 @@ static const char* c_cubeMapNames[] =
 	"Back"
 };
 
-static inline double Lerp(double A, double B, double t)
-{
-	return A * (1.0 - t) + B * t;
-}
-
 // Return false if there are invalid % format markers
 static bool FileNameSafe(const char* fileName)
 {
@@ -221,18 +219,6 @@ std::vector<double> ConvertToDoubles(const std::vector<unsigned char>& src, doub
 	return ret;
 }
 
-template <typename T>
-std::vector<double> ConvertToDoubles(const unsigned char* src, size_t valueCount, double multiplier)
-{
-	std::vector<double> ret(valueCount, 0);
-
-	const T* srcValues = (const T*)src;
-	for (size_t index = 0; index < valueCount; ++index)
-		ret[index] = multiplier * (double)srcValues[index];
-
-	return ret;
-}
-
 static bool ConvertToDoubles(const std::vector<unsigned char>& src, DXGI_FORMAT_Info::ChannelType type, std::vector<double>& doubles)
 {
 	switch (type)
@@ -248,21 +234,6 @@ static bool ConvertToDoubles(const std::vector<unsigned char>& src, DXGI_FORMAT_
 	return true;
 }
 
-static bool ConvertToDoubles(const unsigned char* src, size_t valueCount, DXGI_FORMAT_Info::ChannelType type, std::vector<double>& doubles)
-{
-	switch (type)
-	{
-		case DXGI_FORMAT_Info::ChannelType::_uint8_t: doubles = ConvertToDoubles<uint8_t>(src, valueCount, 1.0 / 255.0); break;
-		case DXGI_FORMAT_Info::ChannelType::_uint16_t: doubles = ConvertToDoubles<uint16_t>(src, valueCount, 1.0 / 65535.0); break;
-		case DXGI_FORMAT_Info::ChannelType::_int16_t: doubles = ConvertToDoubles<int16_t>(src, valueCount, 1.0 / 32767.0); break;
-		case DXGI_FORMAT_Info::ChannelType::_uint32_t: doubles = ConvertToDoubles<uint32_t>(src, valueCount, 1.0 / 4294967296.0); break;
-		case DXGI_FORMAT_Info::ChannelType::_half: doubles = ConvertToDoubles<half>(src, valueCount, 1.0); break;
-		case DXGI_FORMAT_Info::ChannelType::_float: doubles = ConvertToDoubles<float>(src, valueCount, 1.0); break;
-		default: return false;
-	}
-	return true;
-}
-
 template <typename T>
 std::vector<unsigned char> ConvertFromDoubles(const std::vector<double>& src, double multiplier, double theMin, double theMax)
 {
@@ -293,46 +264,10 @@ static bool ConvertFromDoubles(const std::vector<double>& doubles, DXGI_FORMAT_I
 	return true;
 }
 
-static bool ConvertFromDoubles(const std::vector<double>& doubles, DXGI_FORMAT_Info::ChannelType type, unsigned char* dest)
+// Converts by way of doubles. Handles the formats PixelConverter doesn't have a kernel for.
+static bool ConvertPixelDataGeneric(const std::vector<unsigned char>& src, const DXGI_FORMAT_Info& srcFormat_, std::vector<unsigned char>& dest, const DXGI_FORMAT_Info& destFormat)
 {
-	std::vector<unsigned char> _dest;
-	switch (type)
-	{
-		case DXGI_FORMAT_Info::ChannelType::_uint8_t: _dest = ConvertFromDoubles<uint8_t>(doubles, 256.0, 0.0, 255.0); break;
-		case DXGI_FORMAT_Info::ChannelType::_int8_t: _dest = ConvertFromDoubles<uint8_t>(doubles, 256.0, -128.0, 127.0); break;
-		case DXGI_FORMAT_Info::ChannelType::_int16_t: _dest = ConvertFromDoubles<uint16_t>(doubles, 65536.0, -32768.0, 32767.0); break;
-		case DXGI_FORMAT_Info::ChannelType::_uint16_t: _dest = ConvertFromDoubles<uint16_t>(doubles, 65536.0, 0.0, 65535.0); break;
-		case DXGI_FORMAT_Info::ChannelType::_uint32_t: _dest = ConvertFromDoubles<uint32_t>(doubles, 4294967296.0, 0.0, 4294967295.0); break;
-		case DXGI_FORMAT_Info::ChannelType::_half: _dest = ConvertFromDoubles<half>(doubles, 1.0, -65504.0, 65504.0); break;
-		case DXGI_FORMAT_Info::ChannelType::_float: _dest = ConvertFromDoubles<float>(doubles, 1.0, -FLT_MAX, FLT_MAX); break;
-		default: return false;
-	}
-
-	memcpy(dest, _dest.data(), _dest.size());
-
-	return true;
-}
-
-bool ConvertPixelData(const std::vector<unsigned char>& src, const DXGI_FORMAT_Info& srcFormat_, std::vector<unsigned char>& dest, const DXGI_FORMAT_Info& destFormat)
-{
-	// We don't do conversion on compressed image formats
-	if (srcFormat_.isCompressed || destFormat.isCompressed)
-	{
-		if (srcFormat_.format == destFormat.format)
-		{
-			dest = src;
-			return true;
-		}
-		return false;
-	}
-
-	// Nothing to do if nothing to convert
 	DXGI_FORMAT_Info srcFormat = srcFormat_;
-	if (srcFormat.channelType == destFormat.channelType && srcFormat.sRGB == destFormat.sRGB && srcFormat.channelCount == destFormat.channelCount)
-	{
-		dest = src;
-		return true;
-	}
 
 	// Convert the source pixels to doubles
 	std::vector<double> srcDoubles;
@@ -400,155 +335,163 @@ bool ConvertPixelData(const std::vector<unsigned char>& src, const DXGI_FORMAT_I
 	return true;
 }
 
-static void BilinearSample(const unsigned char* src, const DXGI_FORMAT_Info& formatInfo, const int dims[3], float U, float V, unsigned char* dest)
+bool ConvertPixelData(const std::vector<unsigned char>& src, const DXGI_FORMAT_Info& srcFormat, std::vector<unsigned char>& dest, const DXGI_FORMAT_Info& destFormat)
 {
-	float srcX = U * float(dims[0]) - 0.5f;
-	float srcY = V * float(dims[1]) - 0.5f;
-
-	int x1 = int(srcX);
-	int y1 = int(srcY);
-	int x2 = (x1 + 1) % dims[0];
-	int y2 = (y1 + 1) % dims[1];
-
-	float fracX = std::fmod(srcX, 1.0f);
-	float fracY = std::fmod(srcY, 1.0f);
-
-	// read the source pixels
-	std::vector<double> P00Values, P01Values, P10Values, P11Values;
-	ConvertToDoubles(&src[(y1 * dims[0] + x1) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P00Values);
-	ConvertToDoubles(&src[(y1 * dims[0] + x2) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P10Values);
-	ConvertToDoubles(&src[(y2 * dims[0] + x1) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P01Values);
-	ConvertToDoubles(&src[(y2 * dims[0] + x2) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P11Values);
-
-	// Calculate the result
-	std::vector<double> result(formatInfo.channelCount);
-	for (size_t channelIndex = 0; channelIndex < formatInfo.channelCount; ++channelIndex)
+	// We don't do conversion on compressed image formats
+	if (srcFormat.isCompressed || destFormat.isCompressed)
 	{
-		double resultx0 = Lerp(P00Values[channelIndex], P10Values[channelIndex], fracX);
-		double resultx1 = Lerp(P01Values[channelIndex], P11Values[channelIndex], fracX);
-		result[channelIndex] = Lerp(resultx0, resultx1, fracY);
+		if (srcFormat.format == destFormat.format)
+		{
+			dest = src;
+			return true;
+		}
+		return false;
 	}
 
-	// Write the dest pixel
-	ConvertFromDoubles(result, formatInfo.channelType, dest);
-}
-
-static void TrilinearSample(const unsigned char* src, const DXGI_FORMAT_Info& formatInfo, const int dims[3], float U, float V, float W, unsigned char* dest)
-{
-	float srcX = U * float(dims[0]) - 0.5f;
-	float srcY = V * float(dims[1]) - 0.5f;
-	float srcZ = W * float(dims[2]) - 0.5f;
-
-	int x1 = int(srcX);
-	int y1 = int(srcY);
-	int z1 = int(srcZ);
-	int x2 = (x1 + 1) % dims[0];
-	int y2 = (y1 + 1) % dims[1];
-	int z2 = (z1 + 1) % dims[2];
-
-	float fracX = std::fmod(srcX, 1.0f);
-	float fracY = std::fmod(srcY, 1.0f);
-	float fracZ = std::fmod(srcZ, 1.0f);
-
-	// read the source pixels
-	std::vector<double> P000Values, P010Values, P100Values, P110Values;
-	std::vector<double> P001Values, P011Values, P101Values, P111Values;
-	ConvertToDoubles(&src[(z1 * dims[1] * dims[0] + y1 * dims[0] + x1) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P000Values);
-	ConvertToDoubles(&src[(z1 * dims[1] * dims[0] + y1 * dims[0] + x2) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P100Values);
-	ConvertToDoubles(&src[(z1 * dims[1] * dims[0] + y2 * dims[0] + x1) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P010Values);
-	ConvertToDoubles(&src[(z1 * dims[1] * dims[0] + y2 * dims[0] + x2) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P110Values);
-	ConvertToDoubles(&src[(z2 * dims[1] * dims[0] + y1 * dims[0] + x1) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P001Values);
-	ConvertToDoubles(&src[(z2 * dims[1] * dims[0] + y1 * dims[0] + x2) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P101Values);
-	ConvertToDoubles(&src[(z2 * dims[1] * dims[0] + y2 * dims[0] + x1) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P011Values);
-	ConvertToDoubles(&src[(z2 * dims[1] * dims[0] + y2 * dims[0] + x2) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P111Values);
-
-	// Calculate the result
-	std::vector<double> result(formatInfo.channelCount);
-	for (size_t channelIndex = 0; channelIndex < formatInfo.channelCount; ++channelIndex)
+	// Nothing to do if nothing to convert
+	if (srcFormat.channelType == destFormat.channelType && srcFormat.sRGB == destFormat.sRGB && srcFormat.channelCount == destFormat.channelCount)
 	{
-		double resultx00 = Lerp(P000Values[channelIndex], P100Values[channelIndex], fracX);
-		double resultx10 = Lerp(P010Values[channelIndex], P110Values[channelIndex], fracX);
-
-		double resultx01 = Lerp(P001Values[channelIndex], P101Values[channelIndex], fracX);
-		double resultx11 = Lerp(P011Values[channelIndex], P111Values[channelIndex], fracX);
-
-		double resultxy0 = Lerp(resultx00, resultx10, fracY);
-		double resultxy1 = Lerp(resultx01, resultx11, fracY);
+		dest = src;
+		return true;
+	}
 
-		result[channelIndex] = Lerp(resultxy0, resultxy1, fracZ);
+	// Use a typed kernel if there is one for these formats
+	PixelConverter converter(srcFormat, destFormat);
+	if (converter.Valid())
+	{
+		dest.resize(converter.DestSize(src.size()));
+		converter.Convert(src.data(), dest.data(), src.size() / srcFormat.bytesPerPixel);
+		return true;
 	}
 
-	// Write the dest pixel
-	ConvertFromDoubles(result, formatInfo.channelType, dest);
+	return ConvertPixelDataGeneric(src, srcFormat, dest, destFormat);
 }
 
-static void MakeMip(const std::vector<unsigned char>& src, std::vector<unsigned char>& dest, const DXGI_FORMAT_Info& formatInfo, TextureDimensionType dimension, const int srcDims[3])
+bool VerifyPixelConversion()
 {
-	// calculate the size of the destination dims
-	bool is3D = (dimension == TextureDimensionType::Texture3D);
-	int destDims[3] = { max(srcDims[0] / 2, 1), max(srcDims[1] / 2, 1), is3D ? max(srcDims[2] / 2, 1) : srcDims[2] };
-
-	// Allocate space for the mip
-	dest.resize(destDims[0] * destDims[1] * destDims[2] * formatInfo.bytesPerPixel, 0);
-
-	int srcUnalignedPitch = srcDims[0] * formatInfo.bytesPerPixel;
-	int destUnalignedPitch = destDims[0] * formatInfo.bytesPerPixel;
+	struct ChannelTypeInfo
+	{
+		DXGI_FORMAT_Info::ChannelType type;
+		int bytes;
+		const char* name;
+	};
 
-	if (is3D)
+	static const ChannelTypeInfo c_channelTypes[] =
+	{
+		{ DXGI_FORMAT_Info::ChannelType::_uint8_t, 1, "uint8_t" },
+		{ DXGI_FORMAT_Info::ChannelType::_uint16_t, 2, "uint16_t" },
+		{ DXGI_FORMAT_Info::ChannelType::_uint32_t, 4, "uint32_t" },
+		{ DXGI_FORMAT_Info::ChannelType::_int8_t, 1, "int8_t" },
+		{ DXGI_FORMAT_Info::ChannelType::_int16_t, 2, "int16_t" },
+		{ DXGI_FORMAT_Info::ChannelType::_int32_t, 4, "int32_t" },
+		{ DXGI_FORMAT_Info::ChannelType::_half, 2, "half" },
+		{ DXGI_FORMAT_Info::ChannelType::_float, 4, "float" },
+	};
+
+	// Conversion only depends on the channel type, channel count and sRGB, so every combination of those is a format to test
+	std::vector<DXGI_FORMAT_Info> formats;
+	for (const ChannelTypeInfo& channelType : c_channelTypes)
 	{
-		// For each z slize
-		for (size_t destZ = 0; destZ < destDims[2]; ++destZ)
+		for (int channelCount = 1; channelCount <= 4; ++channelCount)
 		{
-			float W = (float(destZ) + 0.5f) / float(destDims[2]);
-
-			size_t destArrayOffset = destZ * destDims[1] * destUnalignedPitch;
-
-			// for each pixel
-			for (size_t destY = 0; destY < destDims[1]; ++destY)
-			{
-				float V = (float(destY) + 0.5f) / float(destDims[1]);
-
-				size_t destOffset = destArrayOffset + destY * destUnalignedPitch;
-
-				for (size_t destX = 0; destX < destDims[0]; ++destX)
-				{
-					float U = (float(destX) + 0.5f) / float(destDims[0]);
-
-					unsigned char* destPx = &dest[destOffset + destX * formatInfo.bytesPerPixel];
-
-					// trilinear sample src[U, V, W] and write to dest
-					TrilinearSample(src.data(), formatInfo, srcDims, U, V, W, destPx);
-				}
-			}
+			formats.push_back(DXGI_FORMAT_Info(DXGI_FORMAT_UNKNOWN, channelType.name, channelType.bytes, channelCount, channelType.type, false, false, false, 0, 1, DXGI_FORMAT_Info::NormType::None, false));
+			formats.push_back(DXGI_FORMAT_Info(DXGI_FORMAT_UNKNOWN, channelType.name, channelType.bytes, channelCount, channelType.type, true, false, false, 0, 1, DXGI_FORMAT_Info::NormType::None, false));
 		}
 	}
-	else
+
+	// 8 and 16 bit sources get every bit pattern. 32 bit sources get values at the edges of the conversions, then random bit patterns.
+	std::vector<uint32_t> patterns8(256), patterns16(65536), patterns32;
+	for (uint32_t i = 0; i < 256; ++i)
+		patterns8[i] = i;
+	for (uint32_t i = 0; i < 65536; ++i)
+		patterns16[i] = i;
 	{
-		// For each array slize
-		for (size_t iZ = 0; iZ < srcDims[2]; ++iZ)
+		static const float c_floatValues[] = { 0.0f, -0.0f, 1.0f, -1.0f, 0.5f, 255.0f / 256.0f, 1.0f / 255.0f, 65504.0f, -65504.0f, 65520.0f, 1.0e10f, -1.0e10f, FLT_MAX, -FLT_MAX, FLT_MIN, 1.0e-40f };
+		for (float value : c_floatValues)
 		{
-			size_t srcArrayOffset = iZ * srcDims[1] * srcUnalignedPitch;
-			size_t destArrayOffset = iZ * destDims[1] * destUnalignedPitch;
-
-			// for each pixel
-			for (size_t destY = 0; destY < destDims[1]; ++destY)
-			{
-				float V = (float(destY) + 0.5f) / float(destDims[1]);
+			uint32_t bits;
+			memcpy(&bits, &value, sizeof(bits));
+			patterns32.push_back(bits);
+		}
+		static const uint32_t c_bitValues[] = { 0x7f800000, 0xff800000, 0x7fc00000, 0xffc00000, 0x7f800001, 0x00000001, 0x7fffffff, 0x80000000, 0xffffffff, 0xfffffffe };
+		for (uint32_t bits : c_bitValues)
+			patterns32.push_back(bits);
 
-				size_t destOffset = destArrayOffset + destY * destUnalignedPitch;
+		std::mt19937 rng(1234);
+		while (patterns32.size() < 65536)
+			patterns32.push_back((uint32_t)rng());
+	}
 
-				for (size_t destX = 0; destX < destDims[0]; ++destX)
-				{
-					float U = (float(destX) + 0.5f) / float(destDims[0]);
+	// Enough pixels that the conversion is split across threads, and that a vectorized loop has a remainder
+	static const size_t c_pixelCount = 3 * 64 * 1024 + 17;
 
-					unsigned char* destPx = &dest[destOffset + destX * formatInfo.bytesPerPixel];
+	int pairsChecked = 0;
+	int pairsFailed = 0;
+	for (const DXGI_FORMAT_Info& srcFormat : formats)
+	{
+		const std::vector<uint32_t>& patterns = (srcFormat.bytesPerChannel == 1) ? patterns8 : ((srcFormat.bytesPerChannel == 2) ? patterns16 : patterns32);
 
-					// bilinear sample src[U, V] and write to dest
-					BilinearSample(&src[srcArrayOffset], formatInfo, srcDims, U, V, destPx);
-				}
+		// Each channel starts at a different place in the patterns, so every channel sees every pattern
+		std::vector<unsigned char> src(c_pixelCount * srcFormat.bytesPerPixel);
+		for (size_t pixelIndex = 0; pixelIndex < c_pixelCount; ++pixelIndex)
+		{
+			for (int c = 0; c < srcFormat.channelCount; ++c)
+			{
+				uint32_t bits = patterns[(pixelIndex + c * 7919) % patterns.size()];
+				memcpy(&src[(pixelIndex * srcFormat.channelCount + c) * srcFormat.bytesPerChannel], &bits, srcFormat.bytesPerChannel);
 			}
 		}
+
+		for (const DXGI_FORMAT_Info& destFormat : formats)
+		{
+			PixelConverter converter(srcFormat, destFormat);
+			if (!converter.Valid())
+				continue;
+
+			std::vector<unsigned char> expected;
+			if (!ConvertPixelDataGeneric(src, srcFormat, expected, destFormat))
+				continue;
+
+			std::vector<unsigned char> actual(converter.DestSize(src.size()));
+			converter.Convert(src.data(), actual.data(), c_pixelCount);
+			pairsChecked++;
+
+			if (actual.size() == expected.size() && memcmp(actual.data(), expected.data(), actual.size()) == 0)
+				continue;
+
+			pairsFailed++;
+			size_t byteIndex = 0;
+			while (byteIndex < actual.size() && byteIndex < expected.size() && actual[byteIndex] == expected[byteIndex])
+				byteIndex++;
+			printf("Pixel conversion from %s x%i%s to %s x%i%s differs from the double based path at pixel %zu\n",
+				srcFormat.name, srcFormat.channelCount, srcFormat.sRGB ? " sRGB" : "",
+				destFormat.name, destFormat.channelCount, destFormat.sRGB ? " sRGB" : "",
+				byteIndex / destFormat.bytesPerPixel);
+		}
+	}
+
+	printf("Pixel conversion: %i of %i format pairs match the double based path\n", pairsChecked - pairsFailed, pairsChecked);
+	return pairsFailed == 0;
+}
+
+static void MakeMip(const std::vector<unsigned char>& src, std::vector<unsigned char>& dest, const DXGI_FORMAT_Info& formatInfo, TextureDimensionType dimension, const int srcDims[3])
+{
+	MipGenerator::Format format;
+	format.channelCount = formatInfo.channelCount;
+	format.sRGB = formatInfo.sRGB;
+	switch (formatInfo.channelType)
+	{
+		case DXGI_FORMAT_Info::ChannelType::_uint8_t: format.channelType = MipGenerator::ChannelType::U8; break;
+		case DXGI_FORMAT_Info::ChannelType::_uint16_t: format.channelType = MipGenerator::ChannelType::U16; break;
+		case DXGI_FORMAT_Info::ChannelType::_uint32_t: format.channelType = MipGenerator::ChannelType::U32; break;
+		case DXGI_FORMAT_Info::ChannelType::_int8_t: format.channelType = MipGenerator::ChannelType::S8; break;
+		case DXGI_FORMAT_Info::ChannelType::_int16_t: format.channelType = MipGenerator::ChannelType::S16; break;
+		case DXGI_FORMAT_Info::ChannelType::_int32_t: format.channelType = MipGenerator::ChannelType::S32; break;
+		case DXGI_FORMAT_Info::ChannelType::_half: format.channelType = MipGenerator::ChannelType::F16; break;
+		case DXGI_FORMAT_Info::ChannelType::_float: format.channelType = MipGenerator::ChannelType::F32; break;
 	}
+
+	MipGenerator::MakeMip(src, dest, format, dimension == TextureDimensionType::Texture3D, srcDims);
 }
 
 static TextureCache::Texture LoadTextureFromBinaryFile(FileCache& fileCache, const char* fileName_, int dims[2], int channelCount, TextureCache::Type dataType)
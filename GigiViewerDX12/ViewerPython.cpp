@@ -425,6 +425,19 @@ static PyObject* Python_SetImportedBufferCSVHeaderRow(PyObject* self, PyObject*
     return Py_None;
 }
 
+static PyObject* Python_SetImportedBufferMeshLayout(PyObject* self, PyObject* args)
+{
+    const char* bufferName = nullptr;
+    int meshLayout = 0;
+    if (!PyArg_ParseTuple(args, "si:Python_SetImportedBufferMeshLayout", &bufferName, &meshLayout))
+        return PyErr_Format(PyExc_TypeError, "type error in " __FUNCTION__ "()");
+
+    g_interface->SetImportedBufferMeshLayout(bufferName, (GGUserFile_ImportedBuffer_MeshLayout)meshLayout);
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
 static PyObject* Python_SetImportedTextureFile(PyObject* self, PyObject* args)
 {
     const char* textureName = nullptr;
@@ -884,6 +897,7 @@ void PythonInit(PythonInterface* interface, int argc, char** argv, int firstPyth
         {"SetImportedBufferType", Python_SetImportedBufferType, METH_VARARGS, "Set the type of an imported buffer"},
         {"SetImportedBufferCount", Python_SetImportedBufferCount, METH_VARARGS, "Set the count of an imported buffer"},
         {"SetImportedBufferCSVHeaderRow", Python_SetImportedBufferCSVHeaderRow, METH_VARARGS, "Set whether or not teh csv file has a header row"},
+        {"SetImportedBufferMeshLayout", Python_SetImportedBufferMeshLayout, METH_VARARGS, "Set whether a mesh file loads flattened vertices, welded vertices, or the indices of the welded vertices. Takes a GGUserFile_ImportedBuffer_MeshLayout."},
         {"SetImportedTextureFile", Python_SetImportedTextureFile, METH_VARARGS, "Set the file name of an imported texture"},
         {"SetImportedTextureSourceIsSRGB", Python_SetImportedTextureSourceIsSRGB, METH_VARARGS, "Set whether or not the file on disk is sRGB."},
         {"SetImportedTextureMakeMips", Python_SetImportedTextureMakeMips, METH_VARARGS, "Whether or not to make mips for the imported texture."},
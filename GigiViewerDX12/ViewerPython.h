@@ -47,6 +47,7 @@ public:
 	virtual void Pause(bool pause) = 0;
 	virtual void PixCaptureNextFrames(const char* fileName, int frameCount) = 0;
 	virtual void SetImportedBufferCSVHeaderRow(const char* bufferName, bool CSVHeaderRow) = 0;
+	virtual void SetImportedBufferMeshLayout(const char* bufferName, GGUserFile_ImportedBuffer_MeshLayout meshLayout) = 0;
 	virtual void SetImportedBufferCount(const char* bufferName, int count) = 0;
 	virtual void SetImportedBufferFile(const char* bufferName, const char* fileName) = 0;
 	virtual void SetImportedBufferStruct(const char* bufferName, const char* structName) = 0;
@@ -37,6 +37,7 @@
 #include <unordered_set>
 #include <set>
 
+#include "DX12Utils/PixelConversion.h"
 #include "DX12Utils/Utils.h"
 #include "DX12Utils/sRGB.h"
 #include "version.h"
@@ -596,6 +597,7 @@ GigiInterpreterPreviewWindowDX12::ImportedResourceDesc GGUserFile_ImportedResour
         outDesc.buffer.fileName = std::filesystem::weakly_canonical(outDesc.buffer.fileName).string();
 
         outDesc.buffer.CSVHeaderRow = inDesc.buffer.CSVHeaderRow;
+        outDesc.buffer.meshLayout = inDesc.buffer.meshLayout;
         outDesc.buffer.structIndex = inDesc.buffer.structIndex;
         outDesc.buffer.type = inDesc.buffer.type;
         outDesc.buffer.count = inDesc.buffer.count;
@@ -648,6 +650,7 @@ GGUserFile_ImportedResource ImportedResourceDesc_To_GGUserFile_ImportedResource(
         outDesc.buffer.fileName = relativeFileName;
 
         outDesc.buffer.CSVHeaderRow = inDesc.buffer.CSVHeaderRow;
+        outDesc.buffer.meshLayout = inDesc.buffer.meshLayout;
         outDesc.buffer.structIndex = inDesc.buffer.structIndex;
         outDesc.buffer.type = inDesc.buffer.type;
         outDesc.buffer.count = inDesc.buffer.count;
@@ -2157,7 +2160,7 @@ void ShowInternalVariables()
         for (auto const& ent1 : g_interpreter.getFileCache().getCache()) {
             //auto const& key = ent1.first;
             auto const& val = ent1.second;
-            file_total_size += val.GetSize();
+            file_total_size += val.file.GetSize();
         }
     }
     if (c_upload_buffer_in_use_val <= 0 || has_elapsed) {
@@ -2265,7 +2268,7 @@ void ShowInternalVariables()
                 std::string base_filename = key.substr(key.find_last_of("/\\") + 1);
                 const char* for_display = base_filename.c_str();              
                 c_file_cache_details_file_display.push_back(for_display);
-                c_file_cache_details_size.push_back(val.GetSize());
+                c_file_cache_details_size.push_back(val.file.GetSize());
             }
         }
         if (ImGui::BeginTable("file cache details", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
@@ -3031,6 +3034,33 @@ void ShowImportedResources()
                 "In the file up to the first newline character."
             );
 
+            // Mesh layout
+            std::filesystem::path extension = std::filesystem::path(desc.buffer.fileName).extension();
+            if (extension == ".obj" || extension == ".fbx")
+            {
+                std::vector<const char*> options;
+                float comboWidth = 0.0f;
+                for (int i = 0; i < EnumCount<GGUserFile_ImportedBuffer_MeshLayout>(); ++i)
+                {
+                    const char* label = EnumToString((GGUserFile_ImportedBuffer_MeshLayout)i);
+                    options.push_back(label);
+                    comboWidth = std::max(comboWidth, ImGui::CalcTextSize(label).x + ImGui::GetStyle().FramePadding.x * 2.0f);
+                }
+                ImGui::SetNextItemWidth(comboWidth + ImGui::GetTextLineHeightWithSpacing() + 10);
+
+                int value = (int)desc.buffer.meshLayout;
+                if (ImGui::Combo("Mesh Layout", &value, options.data(), (int)options.size()))
+                {
+                    desc.buffer.meshLayout = (GGUserFile_ImportedBuffer_MeshLayout)value;
+                    desc.state = GigiInterpreterPreviewWindowDX12::ImportedResourceState::dirty;
+                }
+                ShowToolTip(
+                    "Flattened: three vertices per triangle, with no vertices shared.\n"
+                    "IndexedVertices: identical vertices welded together.\n"
+                    "Indices: the index buffer for IndexedVertices. Use type Uint, or Uint_16 if the mesh has no more than 65536 unique vertices."
+                );
+            }
+
             const RenderGraphNode_Resource_Buffer& bufferNode = g_interpreter.GetRenderGraph().nodes[desc.nodeIndex].resourceBuffer;
 
             // Ray tracing specific stuff
@@ -6538,6 +6568,25 @@ public:
         desc.buffer.count = count;
     }
 
+    void SetImportedBufferMeshLayout(const char* bufferName, GGUserFile_ImportedBuffer_MeshLayout meshLayout) override final
+    {
+        if (g_interpreter.m_importedResources.count(bufferName) == 0)
+        {
+            Log(LogLevel::Error, "Python: SetImportedBufferMeshLayout could not find imported buffer %s", bufferName);
+            return;
+        }
+
+        GigiInterpreterPreviewWindowDX12::ImportedResourceDesc& desc = g_interpreter.m_importedResources[bufferName];
+        if (desc.isATexture)
+        {
+            Log(LogLevel::Error, "Python: SetImportedBufferMeshLayout called for %s which is not a buffer", bufferName);
+            return;
+        }
+
+        desc.buffer.meshLayout = meshLayout;
+        desc.state = GigiInterpreterPreviewWindowDX12::ImportedResourceState::dirty;
+    }
+
     void SetImportedBufferFile(const char* bufferName, const char* fileName) override final
     {
         if (g_interpreter.m_importedResources.count(bufferName) == 0)
@@ -7183,6 +7232,10 @@ int main(int argc, char** argv)
             g_GPUValidation = true;
             argIndex++;
         }
+        else if (!_stricmp(argv[argIndex], "-verifypixelconversion"))
+        {
+            return VerifyPixelConversion() ? 0 : 1;
+        }
         else
         {
             argIndex++;
@@ -7,6 +7,7 @@ import os
 import glob
 import subprocess
 import shutil
+import tempfile
 
 requiredTestPrefix = ""
 #requiredTestPrefix = "Compute\\"
@@ -31,12 +32,28 @@ unsupportedTests = [
     "Textures\\Mips_Imported_Cube",
 ]
 
-# ==================== GENERATE CODE FOR TECHNIQUES
+# ==================== COMPILER UNIT TESTS
+
+print(".\\GigiCompiler.exe -unittests")
+subprocess.run(".\\GigiCompiler.exe -unittests", shell=True, check=True)
+print("")
+
+# ==================== VIEWER PIXEL CONVERSION
 
-print(".\\GigiCompiler.exe DX12_Application ./Techniques/UnitTests/UnitTests.gg _GeneratedCode/UnitTests/DX12/")
-subprocess.run(".\\GigiCompiler.exe DX12_Application ./Techniques/UnitTests/UnitTests.gg _GeneratedCode/UnitTests/DX12/")
+# The viewer is a windows app, so its output is only seen when captured
+print(".\\GigiViewerDX12.exe -verifypixelconversion")
+result = subprocess.run([".\\GigiViewerDX12.exe", "-verifypixelconversion"], capture_output=True, text=True)
+print(result.stdout, end="")
+result.check_returncode()
 print("")
 
+# ==================== GENERATE CODE FOR TECHNIQUES
+
+# Every technique is compiled by a single GigiCompiler process, which runs the jobs in parallel and shares work between them.
+# Each line of the manifest has the same arguments as a single GigiCompiler.exe run.
+manifestLines = []
+manifestLines.append("DX12_Application ./Techniques/UnitTests/UnitTests.gg _GeneratedCode/UnitTests/DX12/")
+
 for fileName in glob.glob(os.getcwd() + "/Techniques/UnitTests/**/*.py", recursive = True):
     relFileName = os.path.relpath(fileName, os.getcwd() + "/Techniques/UnitTests/")
     relFileNameNoExtension = os.path.splitext(relFileName)[0]
@@ -56,10 +73,26 @@ for fileName in glob.glob(os.getcwd() + "/Techniques/UnitTests/**/*.py", recursi
         continue
 
     outDirName = "_GeneratedCode/UnitTests/DX12/UnitTests/" + relFileNameNoExtension
-    print(relFileNameNoExtension)
-    print(".\\GigiCompiler.exe DX12_Module " + fileName + " " + outDirName)
-    subprocess.run(".\\GigiCompiler.exe DX12_Module " + fileName + " " + outDirName, shell=True, check=True)
-    print("")
+    manifestLines.append("DX12_Module \"" + fileName + "\" \"" + outDirName + "\"")
+
+manifestFile = tempfile.NamedTemporaryFile(mode = "w", suffix = ".txt", delete = False)
+manifestFile.write("\n".join(manifestLines) + "\n")
+manifestFile.close()
+
+for manifestLine in manifestLines:
+    print(manifestLine)
+print("")
+
+print(".\\GigiCompiler.exe -batch " + manifestFile.name)
+try:
+    subprocess.run(".\\GigiCompiler.exe -batch \"" + manifestFile.name + "\"", shell=True, check=True)
+
+    # Make sure the binary cache of the .gg files gives the same render graphs as their JSON
+    print(".\\GigiCompiler.exe -verifycache " + manifestFile.name)
+    subprocess.run(".\\GigiCompiler.exe -verifycache \"" + manifestFile.name + "\"", shell=True, check=True)
+finally:
+    os.remove(manifestFile.name)
+print("")
 
 def ReplaceSection(data, labelStart, labelEnd, newText):
     start = data.find(labelStart) + len(labelStart)
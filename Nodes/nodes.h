@@ -287,6 +287,8 @@ inline void AddResourceDependency(RenderGraphNode& node, int pinIndex, int resou
     );
 }
 
+#include "RenderGraph/SymbolTable.h"
+
 // A An interface that doesn't rely on node indices etc being calculated yet.
 // A bit redundant. Need to rethink how nodes are interacted with by the editor, compiler, viewer, etc.
 namespace FrontEndNodesNoCaching
@@ -301,12 +303,7 @@ namespace FrontEndNodesNoCaching
     // Returns -1 if it couldn't find it
     inline int GetNodeIndexByName(const RenderGraph& renderGraph, const char* nodeName)
     {
-        for (size_t i = 0; i < renderGraph.nodes.size(); ++i)
-        {
-            if (!_stricmp(GetNodeName(renderGraph.nodes[i]).c_str(), nodeName))
-                return (int)i;
-        }
-        return -1;
+        return SymbolTableFindNode(renderGraph, nodeName);
     }
 
     // gets information about all pins for a specific node
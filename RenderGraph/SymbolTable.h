@@ -0,0 +1,233 @@
+///////////////////////////////////////////////////////////////////////////////
+//         Gigi Rapid Graphics Prototyping and Code Generation Suite         //
+//        Copyright (c) 2024 Electronic Arts Inc. All rights reserved.       //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Name lookups for the render graph, using the hash indices in RenderGraph::symbols.
+// Included by Nodes/nodes.h, which this needs for GetNodeName().
+//
+// Lookups are case insensitive and give the first match, the same as searching the lists.
+// An index is built the first time it's used, and is rebuilt if the number of items changes, or if a name it finds doesn't match.
+// Code that renames things in place needs to keep the index up to date though, so that a lookup of the new name doesn't miss:
+// * To rename one thing, call SymbolTableRemove*() before changing the name and SymbolTableAdd*() after.
+// * To rename many things, or to delete things, call InvalidateSymbolTable() afterwards.
+// A name that was changed without doing that isn't in the index, so looking it up misses. Debug builds check every miss with a search, and assert if it finds the name.
+
+// clang-format off
+#include <cctype>
+#include <string>
+#include "GigiAssert.h"
+#include "Schemas/Types.h"
+// clang-format on
+
+// Scoped names are "scope\nname", so that different splits of the same dotted name don't collide.
+inline std::string MakeSymbolKey(const std::string& scope, const std::string& name)
+{
+    std::string ret;
+    ret.reserve(scope.length() + name.length() + 1);
+    for (char c : scope)
+        ret.push_back((char)tolower((unsigned char)c));
+    ret.push_back('\n');
+    for (char c : name)
+        ret.push_back((char)tolower((unsigned char)c));
+    return ret;
+}
+
+inline std::string MakeSymbolKey(const std::string& name)
+{
+    std::string ret = name;
+    for (char& c : ret)
+        c = (char)tolower((unsigned char)c);
+    return ret;
+}
+
+inline std::string GetSymbolKey(const Variable& variable) { return MakeSymbolKey(variable.name); }
+inline std::string GetScopedSymbolKey(const Variable& variable) { return MakeSymbolKey(variable.scope, variable.originalName); }
+inline std::string GetSymbolKey(const VariableReplacement& replacement) { return MakeSymbolKey(replacement.srcScope, replacement.srcName); }
+inline std::string GetSymbolKey(const RenderGraphNode& node) { return MakeSymbolKey(GetNodeName(node)); }
+inline std::string GetSymbolKey(const Shader& shader) { return MakeSymbolKey(shader.name); }
+inline std::string GetSymbolKey(const Struct& s) { return MakeSymbolKey(s.name); }
+
+template <typename T, typename GETKEY>
+void BuildSymbolIndex(SymbolIndex& index, const std::vector<T>& items, const GETKEY& getKey)
+{
+    index.indices.clear();
+    index.indices.reserve(items.size());
+    index.hasDuplicates = false;
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        if (!index.indices.emplace(getKey(items[i]), (int)i).second)
+            index.hasDuplicates = true;
+    }
+    index.count = (int)items.size();
+}
+
+// Returns -1 if it couldn't find it
+template <typename T, typename GETKEY>
+int FindSymbol(SymbolIndex& index, const std::vector<T>& items, const std::string& key, const GETKEY& getKey)
+{
+    if (index.count != (int)items.size())
+        BuildSymbolIndex(index, items, getKey);
+
+    auto it = index.indices.find(key);
+    if (it == index.indices.end())
+    {
+#ifdef _DEBUG
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            if (getKey(items[i]) == key)
+            {
+                Assert(false, "\"%s\" is item %i, but isn't in the symbol table index. Something was renamed without calling SymbolTableAdd*() or InvalidateSymbolTable().", key.c_str(), (int)i);
+                BuildSymbolIndex(index, items, getKey);
+                return (int)i;
+            }
+        }
+#endif
+        return -1;
+    }
+
+    if (it->second < (int)items.size() && getKey(items[it->second]) == key)
+        return it->second;
+
+    // Something was renamed without updating the index
+    BuildSymbolIndex(index, items, getKey);
+    it = index.indices.find(key);
+    return (it != index.indices.end()) ? it->second : -1;
+}
+
+template <typename T, typename GETKEY>
+void RemoveSymbol(SymbolIndex& index, const std::vector<T>& items, int itemIndex, const GETKEY& getKey)
+{
+    if (index.count != (int)items.size())
+        return;
+
+    if (index.hasDuplicates)
+    {
+        index.count = -1;
+        return;
+    }
+
+    auto it = index.indices.find(getKey(items[itemIndex]));
+    if (it != index.indices.end() && it->second == itemIndex)
+        index.indices.erase(it);
+}
+
+template <typename T, typename GETKEY>
+void AddSymbol(SymbolIndex& index, const std::vector<T>& items, int itemIndex, const GETKEY& getKey)
+{
+    if (index.count != (int)items.size())
+        return;
+
+    // Keep the first item with the name, like a search would find
+    auto result = index.indices.emplace(getKey(items[itemIndex]), itemIndex);
+    if (!result.second)
+    {
+        index.hasDuplicates = true;
+        if (itemIndex < result.first->second)
+            result.first->second = itemIndex;
+    }
+}
+
+// Gives the index of an item, from a reference to it, or -1 if it isn't in the list.
+template <typename T>
+int GetSymbolItemIndex(const std::vector<T>& items, const T& item)
+{
+    if (items.empty() || &item < items.data() || &item >= items.data() + items.size())
+        return -1;
+    return (int)(&item - items.data());
+}
+
+// The symbols are a cache, so they can be updated through a const render graph
+inline SymbolTable& GetSymbolTable(const RenderGraph& renderGraph)
+{
+    return const_cast<RenderGraph&>(renderGraph).symbols;
+}
+
+inline void InvalidateSymbolTable(RenderGraph& renderGraph)
+{
+    renderGraph.symbols.variables.count = -1;
+    renderGraph.symbols.scopedVariables.count = -1;
+    renderGraph.symbols.variableReplacements.count = -1;
+    renderGraph.symbols.nodes.count = -1;
+    renderGraph.symbols.shaders.count = -1;
+    renderGraph.symbols.structs.count = -1;
+}
+
+// Lookups
+
+inline int SymbolTableFindVariable(const RenderGraph& renderGraph, const char* name)
+{
+    return FindSymbol(GetSymbolTable(renderGraph).variables, renderGraph.variables, MakeSymbolKey(name), [](const Variable& variable) { return GetSymbolKey(variable); });
+}
+
+// Finds a variable by the scope and name it had in its own graph, before subgraph inlining renamed it
+inline int SymbolTableFindScopedVariable(const RenderGraph& renderGraph, const std::string& scope, const std::string& originalName)
+{
+    return FindSymbol(GetSymbolTable(renderGraph).scopedVariables, renderGraph.variables, MakeSymbolKey(scope, originalName), [](const Variable& variable) { return GetScopedSymbolKey(variable); });
+}
+
+inline int SymbolTableFindVariableReplacement(const RenderGraph& renderGraph, const std::string& srcScope, const std::string& srcName)
+{
+    return FindSymbol(GetSymbolTable(renderGraph).variableReplacements, renderGraph.variableReplacements, MakeSymbolKey(srcScope, srcName), [](const VariableReplacement& replacement) { return GetSymbolKey(replacement); });
+}
+
+inline int SymbolTableFindNode(const RenderGraph& renderGraph, const char* name)
+{
+    return FindSymbol(GetSymbolTable(renderGraph).nodes, renderGraph.nodes, MakeSymbolKey(name), [](const RenderGraphNode& node) { return GetSymbolKey(node); });
+}
+
+inline int SymbolTableFindShader(const RenderGraph& renderGraph, const char* name)
+{
+    return FindSymbol(GetSymbolTable(renderGraph).shaders, renderGraph.shaders, MakeSymbolKey(name), [](const Shader& shader) { return GetSymbolKey(shader); });
+}
+
+inline int SymbolTableFindStruct(const RenderGraph& renderGraph, const char* name)
+{
+    return FindSymbol(GetSymbolTable(renderGraph).structs, renderGraph.structs, MakeSymbolKey(name), [](const Struct& s) { return GetSymbolKey(s); });
+}
+
+// Renaming. Remove before changing the name, scope or original name, and add after.
+
+inline void SymbolTableRemoveVariable(RenderGraph& renderGraph, int index)
+{
+    RemoveSymbol(renderGraph.symbols.variables, renderGraph.variables, index, [](const Variable& variable) { return GetSymbolKey(variable); });
+    RemoveSymbol(renderGraph.symbols.scopedVariables, renderGraph.variables, index, [](const Variable& variable) { return GetScopedSymbolKey(variable); });
+}
+
+inline void SymbolTableAddVariable(RenderGraph& renderGraph, int index)
+{
+    AddSymbol(renderGraph.symbols.variables, renderGraph.variables, index, [](const Variable& variable) { return GetSymbolKey(variable); });
+    AddSymbol(renderGraph.symbols.scopedVariables, renderGraph.variables, index, [](const Variable& variable) { return GetScopedSymbolKey(variable); });
+}
+
+inline void SymbolTableRemoveNode(RenderGraph& renderGraph, int index)
+{
+    RemoveSymbol(renderGraph.symbols.nodes, renderGraph.nodes, index, [](const RenderGraphNode& node) { return GetSymbolKey(node); });
+}
+
+inline void SymbolTableAddNode(RenderGraph& renderGraph, int index)
+{
+    AddSymbol(renderGraph.symbols.nodes, renderGraph.nodes, index, [](const RenderGraphNode& node) { return GetSymbolKey(node); });
+}
+
+inline void SymbolTableRemoveShader(RenderGraph& renderGraph, int index)
+{
+    RemoveSymbol(renderGraph.symbols.shaders, renderGraph.shaders, index, [](const Shader& shader) { return GetSymbolKey(shader); });
+}
+
+inline void SymbolTableAddShader(RenderGraph& renderGraph, int index)
+{
+    AddSymbol(renderGraph.symbols.shaders, renderGraph.shaders, index, [](const Shader& shader) { return GetSymbolKey(shader); });
+}
+
+inline void SymbolTableRemoveStruct(RenderGraph& renderGraph, int index)
+{
+    RemoveSymbol(renderGraph.symbols.structs, renderGraph.structs, index, [](const Struct& s) { return GetSymbolKey(s); });
+}
+
+inline void SymbolTableAddStruct(RenderGraph& renderGraph, int index)
+{
+    AddSymbol(renderGraph.symbols.structs, renderGraph.structs, index, [](const Struct& s) { return GetSymbolKey(s); });
+}
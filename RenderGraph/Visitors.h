@@ -7,16 +7,37 @@
 
 #include <stdio.h>
 #include "Schemas/Types.h"
+#include "Schemas/Visitor.h"
 #include "Backends/Shared.h"
 #include <unordered_map>
 #include <unordered_set>
 #include <algorithm>
 #include "GigiCompilerLib/Utils.h"
 
+// The kinds of render graph data that the visitors read and write, for their c_access declarations. See VisitorAccess in Schemas/Visitor.h.
+enum VisitorData : unsigned int
+{
+    VisitorData_Names = 1 << 0,             // The names of nodes, shaders, variables, structs and enums
+    VisitorData_Nodes = 1 << 1,             // Which nodes there are. Visitors that look inside nodes read this.
+    VisitorData_Structs = 1 << 2,           // Which structs there are, and their fields
+    VisitorData_Connections = 1 << 3,       // The pin connections of nodes
+    VisitorData_ShaderFiles = 1 << 4,       // The source and destination file names of shaders, and the token replacements made in them
+    VisitorData_ShaderReferences = 1 << 5,  // Shader references resolved to shaders
+    VisitorData_ShaderResources = 1 << 6,   // The resources and constant buffers of shaders
+    VisitorData_NodeIndices = 1 << 7,       // The index of each node
+    VisitorData_References = 1 << 8,        // Node, pin, variable, struct and enum references resolved to indices
+    VisitorData_StructLayout = 1 << 9,      // Struct sizes, and whether they are exported
+    VisitorData_Values = 1 << 10,           // Variable and struct field defaults, and condition comparisons
+    VisitorData_Defines = 1 << 11,          // Shader defines added by nodes
+    VisitorData_FileCopies = 1 << 12,       // The file copies of the render graph
+};
+
 struct DfltFixupVisitor
 {
+    static constexpr VisitorAccess c_access = VisitorAccess().Reads(VisitorData_Values).Writes(VisitorData_Values);
+
     template <typename TDATA>
-    bool Visit(TDATA& data, const std::string& path)
+    bool Visit(TDATA& data, const VisitPath& path)
     {
         return true;
     }
@@ -40,13 +61,13 @@ struct DfltFixupVisitor
         return true;
     }
 
-    bool Visit(StructField& field, const std::string& path)
+    bool Visit(StructField& field, const VisitPath& path)
     {
         FixupTypeDflt(field.type, field.dflt);
         return true;
     }
 
-    bool Visit(Variable& variable, const std::string& path)
+    bool Visit(Variable& variable, const VisitPath& path)
     {
         FixupTypeDflt(variable.type, variable.dflt);
         return true;
@@ -55,13 +76,15 @@ struct DfltFixupVisitor
 
 struct DataFixupVisitor
 {
+    static constexpr VisitorAccess c_access = VisitorAccess().Reads(VisitorData_References | VisitorData_Values).Writes(VisitorData_Values);
+
     template <typename TDATA>
-    bool Visit(TDATA& data, const std::string& path)
+    bool Visit(TDATA& data, const VisitPath& path)
     {
         return true;
     }
 
-    bool Visit(Condition& condition, const std::string& path)
+    bool Visit(Condition& condition, const VisitPath& path)
     {
         if (condition.comparison == ConditionComparison::Count)
             return true;
@@ -75,13 +98,15 @@ struct DataFixupVisitor
 
 struct AddNodeInfoToShadersVisitor
 {
+    static constexpr VisitorAccess c_access = VisitorAccess().Reads(VisitorData_Nodes).Writes(VisitorData_Defines);
+
     template <typename TDATA>
-    bool Visit(TDATA& data, const std::string& path)
+    bool Visit(TDATA& data, const VisitPath& path)
     {
         return true;
     }
 
-    bool Visit(RenderGraphNode_Action_ComputeShader& node, const std::string& path)
+    bool Visit(RenderGraphNode_Action_ComputeShader& node, const VisitPath& path)
     {
         ShaderDefine newDefine;
         std::ostringstream stream;
@@ -116,33 +141,35 @@ struct AddNodeInfoToShadersVisitor
 
 struct ErrorCheckVisitor
 {
+    static constexpr VisitorAccess c_access = VisitorAccess().Reads(VisitorData_Nodes | VisitorData_ShaderReferences | VisitorData_References);
+
     template <typename TDATA>
-    bool Visit(TDATA& data, const std::string& path)
+    bool Visit(TDATA& data, const VisitPath& path)
     {
         return true;
     }
 
-    bool Visit(RenderGraphNode_Action_DrawCall& node, const std::string& path)
+    bool Visit(RenderGraphNode_Action_DrawCall& node, const VisitPath& path)
     {
         // If there's a vertex shader, there can't be a mesh or amplification shader
         if (node.vertexShader.shaderIndex != -1)
         {
             if (node.meshShader.shaderIndex != -1)
             {
-                Assert(false, "Node %s has both a vertex shader and a mesh shader, only one is allowed.\nIn %s\n", node.name.c_str(), path.c_str());
+                Assert(false, "Node %s has both a vertex shader and a mesh shader, only one is allowed.\nIn %s\n", node.name.c_str(), path.ToString().c_str());
                 return false;
             }
 
             if (node.amplificationShader.shaderIndex != -1)
             {
-                Assert(false, "Node %s has both a vertex shader and an amplification shader. Amplification shader is not allowed when a vertex shader is specified.\nIn %s\n", node.name.c_str(), path.c_str());
+                Assert(false, "Node %s has both a vertex shader and an amplification shader. Amplification shader is not allowed when a vertex shader is specified.\nIn %s\n", node.name.c_str(), path.ToString().c_str());
                 return false;
             }
         }
         // else, there needs to be a mesh shader
         else if (node.meshShader.shaderIndex == -1)
         {
-            Assert(false, "Node %s has neither a vertex shader or mesh shader.  One must be specified.\nIn %s\n", node.name.c_str(), path.c_str());
+            Assert(false, "Node %s has neither a vertex shader or mesh shader.  One must be specified.\nIn %s\n", node.name.c_str(), path.ToString().c_str());
             return false;
         }
 
@@ -151,17 +178,17 @@ struct ErrorCheckVisitor
         {
             if (node.vertexBuffer.nodeIndex != -1)
             {
-                Assert(false, "Node %s has uses a mesh shader, but has a vertex buffer plugged in, which is not allowed. You can give this buffer to the shader as an SRV.\nIn %s\n", node.name.c_str(), path.c_str());
+                Assert(false, "Node %s has uses a mesh shader, but has a vertex buffer plugged in, which is not allowed. You can give this buffer to the shader as an SRV.\nIn %s\n", node.name.c_str(), path.ToString().c_str());
                 return false;
             }
             if (node.indexBuffer.nodeIndex != -1)
             {
-                Assert(false, "Node %s has uses a mesh shader, but has an index buffer plugged in, which is not allowed. You can give this buffer to the shader as an SRV\nIn %s\n", node.name.c_str(), path.c_str());
+                Assert(false, "Node %s has uses a mesh shader, but has an index buffer plugged in, which is not allowed. You can give this buffer to the shader as an SRV\nIn %s\n", node.name.c_str(), path.ToString().c_str());
                 return false;
             }
             if (node.instanceBuffer.nodeIndex != -1)
             {
-                Assert(false, "Node %s has uses a mesh shader, but has an instanceBuffer buffer plugged in, which is not allowed. You can give this buffer to the shader as an SRV\nIn %s\n", node.name.c_str(), path.c_str());
+                Assert(false, "Node %s has uses a mesh shader, but has an instanceBuffer buffer plugged in, which is not allowed. You can give this buffer to the shader as an SRV\nIn %s\n", node.name.c_str(), path.ToString().c_str());
                 return false;
             }
         }
@@ -172,13 +199,15 @@ struct ErrorCheckVisitor
 
 struct DepluralizeFileCopiesVisitor
 {
+    static constexpr VisitorAccess c_access = VisitorAccess().ReadsAnywhere(VisitorData_FileCopies).WritesAnywhere(VisitorData_FileCopies);
+
     template <typename TDATA>
-    bool Visit(TDATA& data, const std::string& path)
+    bool Visit(TDATA& data, const VisitPath& path)
     {
         return true;
     }
 
-    bool Visit(RenderGraph& renderGraph, const std::string& path)
+    bool Visit(RenderGraph& renderGraph, const VisitPath& path)
     {
         std::vector<FileCopy> newFileCopies;
 
@@ -199,7 +228,7 @@ struct DepluralizeFileCopiesVisitor
                         }
                         else
                         {
-                            Assert(false, "Plural file copies need to contain a %%i or %%s. Not found in fileName %s!\nIn %s\n", copy.fileName.c_str(), path.c_str());
+                            Assert(false, "Plural file copies need to contain a %%i or %%s. Not found in fileName %s!\nIn %s\n", copy.fileName.c_str(), path.ToString().c_str());
                             return false;
                         }
                     }
@@ -207,7 +236,7 @@ struct DepluralizeFileCopiesVisitor
                     // make sure there is a %i in the dest file name too - or that it is empty
                     if (!copy.destFileName.empty() && copy.destFileName.find("%i") == std::string::npos)
                     {
-                        Assert(false, "Plural file copies need to contain a %%i. Not found in destFileName %s!\nIn %s\n", copy.fileName.c_str(), path.c_str());
+                        Assert(false, "Plural file copies need to contain a %%i. Not found in destFileName %s!\nIn %s\n", copy.fileName.c_str(), path.ToString().c_str());
                         return false;
                     }
 
@@ -243,7 +272,7 @@ struct DepluralizeFileCopiesVisitor
                         {
                             if (fileCopyCount == 0)
                             {
-                                Assert(false, "No files found for file copy pattern %s!\nIn %s\n", copy.fileName.c_str(), path.c_str());
+                                Assert(false, "No files found for file copy pattern %s!\nIn %s\n", copy.fileName.c_str(), path.ToString().c_str());
                                 return false;
                             }
                             break;
@@ -273,17 +302,19 @@ struct DepluralizeFileCopiesVisitor
 
 struct ShaderFileDuplicationVisitor
 {
+    static constexpr VisitorAccess c_access = VisitorAccess().Reads(VisitorData_Names | VisitorData_ShaderFiles).Writes(VisitorData_ShaderFiles);
+
     ShaderFileDuplicationVisitor(RenderGraph& renderGraph_)
         : renderGraph(renderGraph_)
     { }
 
     template <typename TDATA>
-    bool Visit(TDATA& data, const std::string& path)
+    bool Visit(TDATA& data, const VisitPath& path)
     {
         return true;
     }
 
-    bool Visit(Shader& shader, const std::string& path)
+    bool Visit(Shader& shader, const VisitPath& path)
     {
         // Set the destFileName if it hasn't been set yet
         if (shader.destFileName.empty())
@@ -304,7 +335,7 @@ struct ShaderFileDuplicationVisitor
 
         // otherwise, error because the shaders will stomp each other with different shader resources
         // NOTE: warn, not error for now because looping subgraphs (and subgraphs being used multiple times) cause this to trip too. need to sort that out before it can be an error.
-        ShowWarningMessage("Shader \"%s\" wants to write out \"%s\" which is also written out by shader \"%s\" so will be stomped.\nIn %s\n", shader.name.c_str(), fileName.c_str(), it->second.c_str(), path.c_str());
+        ShowWarningMessage("Shader \"%s\" wants to write out \"%s\" which is also written out by shader \"%s\" so will be stomped.\nIn %s\n", shader.name.c_str(), fileName.c_str(), it->second.c_str(), path.ToString().c_str());
         return true;
     }
 
@@ -316,295 +347,288 @@ struct ShaderFileDuplicationVisitor
 
 struct ShaderReferenceFixupVisitor
 {
+    static constexpr VisitorAccess c_access = VisitorAccess().Reads(VisitorData_Nodes | VisitorData_Names).Writes(VisitorData_ShaderReferences).ReadsAnywhere(VisitorData_Names);
+
     ShaderReferenceFixupVisitor(RenderGraph& renderGraph_)
         : renderGraph(renderGraph_)
     { }
 
     template <typename TDATA>
-    bool Visit(TDATA& data, const std::string& path)
+    bool Visit(TDATA& data, const VisitPath& path)
     {
         return true;
     }
 
-    bool Visit(ComputeShaderReference& data, const std::string& path)
+    bool Visit(ComputeShaderReference& data, const VisitPath& path)
     {
-        for (int index = 0; index < (int)renderGraph.shaders.size(); ++index)
+        int index = FindShader(ShaderType::Compute, data.name);
+        if (index != -1)
         {
-            if (renderGraph.shaders[index].type == ShaderType::Compute && !_stricmp(renderGraph.shaders[index].name.c_str(), data.name.c_str()))
-            {
-                data.shaderIndex = index;
-                data.shader = &renderGraph.shaders[index];
-                return true;
-            }
+            data.shaderIndex = index;
+            data.shader = &renderGraph.shaders[index];
+            return true;
         }
-        Assert(false, "Could not find compute shader referenced: %s\nIn %s\n", data.name.c_str(), path.c_str());
+        Assert(false, "Could not find compute shader referenced: %s\nIn %s\n", data.name.c_str(), path.ToString().c_str());
         return false;
     }
 
-    bool Visit(RayGenShaderReference& data, const std::string& path)
+    bool Visit(RayGenShaderReference& data, const VisitPath& path)
     {
-        for (int index = 0; index < (int)renderGraph.shaders.size(); ++index)
+        int index = FindShader(ShaderType::RTRayGen, data.name);
+        if (index != -1)
         {
-            if (renderGraph.shaders[index].type == ShaderType::RTRayGen && !_stricmp(renderGraph.shaders[index].name.c_str(), data.name.c_str()))
-            {
-                data.shaderIndex = index;
-                data.shader = &renderGraph.shaders[index];
-                return true;
-            }
+            data.shaderIndex = index;
+            data.shader = &renderGraph.shaders[index];
+            return true;
         }
-        Assert(false, "Could not find RTRayGen shader referenced: %s\nIn %s\n", data.name.c_str(), path.c_str());
+        Assert(false, "Could not find RTRayGen shader referenced: %s\nIn %s\n", data.name.c_str(), path.ToString().c_str());
         return false;
     }
 
-    bool Visit(RTClosestHitShaderReference& data, const std::string& path)
+    bool Visit(RTClosestHitShaderReference& data, const VisitPath& path)
     {
-        for (int index = 0; index < (int)renderGraph.shaders.size(); ++index)
+        int index = FindShader(ShaderType::RTClosestHit, data.name);
+        if (index != -1)
         {
-            if (renderGraph.shaders[index].type == ShaderType::RTClosestHit && !_stricmp(renderGraph.shaders[index].name.c_str(), data.name.c_str()))
-            {
-                data.shaderIndex = index;
-                data.shader = &renderGraph.shaders[index];
-                return true;
-            }
+            data.shaderIndex = index;
+            data.shader = &renderGraph.shaders[index];
+            return true;
         }
-        Assert(false, "Could not find RTClosestHit shader referenced: %s\nIn %s\n", data.name.c_str(), path.c_str());
+        Assert(false, "Could not find RTClosestHit shader referenced: %s\nIn %s\n", data.name.c_str(), path.ToString().c_str());
         return false;
     }
 
-    bool Visit(RTClosestHitShaderReferenceOptional& data, const std::string& path)
+    bool Visit(RTClosestHitShaderReferenceOptional& data, const VisitPath& path)
     {
         if (data.name.empty())
             return true;
 
-        for (int index = 0; index < (int)renderGraph.shaders.size(); ++index)
+        int index = FindShader(ShaderType::RTClosestHit, data.name);
+        if (index != -1)
         {
-            if (renderGraph.shaders[index].type == ShaderType::RTClosestHit && !_stricmp(renderGraph.shaders[index].name.c_str(), data.name.c_str()))
-            {
-                data.shaderIndex = index;
-                data.shader = &renderGraph.shaders[index];
-                return true;
-            }
+            data.shaderIndex = index;
+            data.shader = &renderGraph.shaders[index];
+            return true;
         }
-        Assert(false, "Could not find RTClosestHit shader referenced: %s\nIn %s\n", data.name.c_str(), path.c_str());
+        Assert(false, "Could not find RTClosestHit shader referenced: %s\nIn %s\n", data.name.c_str(), path.ToString().c_str());
         return false;
     }
 
-    bool Visit(RTAnyHitShaderReference& data, const std::string& path)
+    bool Visit(RTAnyHitShaderReference& data, const VisitPath& path)
     {
-        for (int index = 0; index < (int)renderGraph.shaders.size(); ++index)
+        int index = FindShader(ShaderType::RTAnyHit, data.name);
+        if (index != -1)
         {
-            if (renderGraph.shaders[index].type == ShaderType::RTAnyHit && !_stricmp(renderGraph.shaders[index].name.c_str(), data.name.c_str()))
-            {
-                data.shaderIndex = index;
-                data.shader = &renderGraph.shaders[index];
-                return true;
-            }
+            data.shaderIndex = index;
+            data.shader = &renderGraph.shaders[index];
+            return true;
         }
-        Assert(false, "Could not find RTAnyHit shader referenced: %s\nIn %s\n", data.name.c_str(), path.c_str());
+        Assert(false, "Could not find RTAnyHit shader referenced: %s\nIn %s\n", data.name.c_str(), path.ToString().c_str());
         return false;
     }
 
-    bool Visit(RTAnyHitShaderReferenceOptional& data, const std::string& path)
+    bool Visit(RTAnyHitShaderReferenceOptional& data, const VisitPath& path)
     {
         if (data.name.empty())
             return true;
 
-        for (int index = 0; index < (int)renderGraph.shaders.size(); ++index)
+        int index = FindShader(ShaderType::RTAnyHit, data.name);
+        if (index != -1)
         {
-            if (renderGraph.shaders[index].type == ShaderType::RTAnyHit && !_stricmp(renderGraph.shaders[index].name.c_str(), data.name.c_str()))
-            {
-                data.shaderIndex = index;
-                data.shader = &renderGraph.shaders[index];
-                return true;
-            }
+            data.shaderIndex = index;
+            data.shader = &renderGraph.shaders[index];
+            return true;
         }
-        Assert(false, "Could not find RTAnyHit shader referenced: %s\nIn %s\n", data.name.c_str(), path.c_str());
+        Assert(false, "Could not find RTAnyHit shader referenced: %s\nIn %s\n", data.name.c_str(), path.ToString().c_str());
         return false;
     }
 
-    bool Visit(RTIntersectionShaderReference& data, const std::string& path)
+    bool Visit(RTIntersectionShaderReference& data, const VisitPath& path)
     {
-        for (int index = 0; index < (int)renderGraph.shaders.size(); ++index)
+        int index = FindShader(ShaderType::RTIntersection, data.name);
+        if (index != -1)
         {
-            if (renderGraph.shaders[index].type == ShaderType::RTIntersection && !_stricmp(renderGraph.shaders[index].name.c_str(), data.name.c_str()))
-            {
-                data.shaderIndex = index;
-                data.shader = &renderGraph.shaders[index];
-                return true;
-            }
+            data.shaderIndex = index;
+            data.shader = &renderGraph.shaders[index];
+            return true;
         }
-        Assert(false, "Could not find RTIntersection shader referenced: %s\nIn %s\n", data.name.c_str(), path.c_str());
+        Assert(false, "Could not find RTIntersection shader referenced: %s\nIn %s\n", data.name.c_str(), path.ToString().c_str());
         return false;
     }
 
-    bool Visit(RTIntersectionShaderReferenceOptional& data, const std::string& path)
+    bool Visit(RTIntersectionShaderReferenceOptional& data, const VisitPath& path)
     {
         if (data.name.empty())
             return true;
 
-        for (int index = 0; index < (int)renderGraph.shaders.size(); ++index)
+        int index = FindShader(ShaderType::RTIntersection, data.name);
+        if (index != -1)
         {
-            if (renderGraph.shaders[index].type == ShaderType::RTIntersection && !_stricmp(renderGraph.shaders[index].name.c_str(), data.name.c_str()))
-            {
-                data.shaderIndex = index;
-                data.shader = &renderGraph.shaders[index];
-                return true;
-            }
+            data.shaderIndex = index;
+            data.shader = &renderGraph.shaders[index];
+            return true;
         }
-        Assert(false, "Could not find RTIntersection shader referenced: %s\nIn %s\n", data.name.c_str(), path.c_str());
+        Assert(false, "Could not find RTIntersection shader referenced: %s\nIn %s\n", data.name.c_str(), path.ToString().c_str());
         return false;
     }
 
-    bool Visit(VertexShaderReference& data, const std::string& path)
+    bool Visit(VertexShaderReference& data, const VisitPath& path)
     {
-        for (int index = 0; index < (int)renderGraph.shaders.size(); ++index)
+        int index = FindShader(ShaderType::Vertex, data.name);
+        if (index != -1)
         {
-            if (renderGraph.shaders[index].type == ShaderType::Vertex && !_stricmp(renderGraph.shaders[index].name.c_str(), data.name.c_str()))
-            {
-                data.shaderIndex = index;
-                data.shader = &renderGraph.shaders[index];
-                return true;
-            }
+            data.shaderIndex = index;
+            data.shader = &renderGraph.shaders[index];
+            return true;
         }
-        Assert(false, "Could not find vertex shader referenced: %s\nIn %s\n", data.name.c_str(), path.c_str());
+        Assert(false, "Could not find vertex shader referenced: %s\nIn %s\n", data.name.c_str(), path.ToString().c_str());
         return false;
     }
 
-    bool Visit(PixelShaderReference& data, const std::string& path)
+    bool Visit(PixelShaderReference& data, const VisitPath& path)
     {
-        for (int index = 0; index < (int)renderGraph.shaders.size(); ++index)
+        int index = FindShader(ShaderType::Pixel, data.name);
+        if (index != -1)
         {
-            if (renderGraph.shaders[index].type == ShaderType::Pixel && !_stricmp(renderGraph.shaders[index].name.c_str(), data.name.c_str()))
-            {
-                data.shaderIndex = index;
-                data.shader = &renderGraph.shaders[index];
-                return true;
-            }
+            data.shaderIndex = index;
+            data.shader = &renderGraph.shaders[index];
+            return true;
         }
-        Assert(false, "Could not find pixel shader referenced: %s\nIn %s\n", data.name.c_str(), path.c_str());
+        Assert(false, "Could not find pixel shader referenced: %s\nIn %s\n", data.name.c_str(), path.ToString().c_str());
         return false;
     }
 
-    bool Visit(AmplificationShaderReference& data, const std::string& path)
+    bool Visit(AmplificationShaderReference& data, const VisitPath& path)
     {
-        for (int index = 0; index < (int)renderGraph.shaders.size(); ++index)
+        int index = FindShader(ShaderType::Amplification, data.name);
+        if (index != -1)
         {
-            if (renderGraph.shaders[index].type == ShaderType::Amplification && !_stricmp(renderGraph.shaders[index].name.c_str(), data.name.c_str()))
-            {
-                data.shaderIndex = index;
-                data.shader = &renderGraph.shaders[index];
-                return true;
-            }
+            data.shaderIndex = index;
+            data.shader = &renderGraph.shaders[index];
+            return true;
         }
-        Assert(false, "Could not find amplification shader referenced: %s\nIn %s\n", data.name.c_str(), path.c_str());
+        Assert(false, "Could not find amplification shader referenced: %s\nIn %s\n", data.name.c_str(), path.ToString().c_str());
         return false;
     }
 
-    bool Visit(MeshShaderReference& data, const std::string& path)
+    bool Visit(MeshShaderReference& data, const VisitPath& path)
     {
-        for (int index = 0; index < (int)renderGraph.shaders.size(); ++index)
+        int index = FindShader(ShaderType::Mesh, data.name);
+        if (index != -1)
         {
-            if (renderGraph.shaders[index].type == ShaderType::Mesh && !_stricmp(renderGraph.shaders[index].name.c_str(), data.name.c_str()))
-            {
-                data.shaderIndex = index;
-                data.shader = &renderGraph.shaders[index];
-                return true;
-            }
+            data.shaderIndex = index;
+            data.shader = &renderGraph.shaders[index];
+            return true;
         }
-        Assert(false, "Could not find mesh shader referenced: %s\nIn %s\n", data.name.c_str(), path.c_str());
+        Assert(false, "Could not find mesh shader referenced: %s\nIn %s\n", data.name.c_str(), path.ToString().c_str());
         return false;
     }
 
-    bool Visit(VertexShaderReferenceOptional& data, const std::string& path)
+    bool Visit(VertexShaderReferenceOptional& data, const VisitPath& path)
     {
         if (data.name.empty())
             return true;
 
-        for (int index = 0; index < (int)renderGraph.shaders.size(); ++index)
+        int index = FindShader(ShaderType::Vertex, data.name);
+        if (index != -1)
         {
-            if (renderGraph.shaders[index].type == ShaderType::Vertex && !_stricmp(renderGraph.shaders[index].name.c_str(), data.name.c_str()))
-            {
-                data.shaderIndex = index;
-                data.shader = &renderGraph.shaders[index];
-                return true;
-            }
+            data.shaderIndex = index;
+            data.shader = &renderGraph.shaders[index];
+            return true;
         }
-        Assert(false, "Could not find vertex shader referenced: %s\nIn %s\n", data.name.c_str(), path.c_str());
+        Assert(false, "Could not find vertex shader referenced: %s\nIn %s\n", data.name.c_str(), path.ToString().c_str());
         return false;
     }
 
-    bool Visit(PixelShaderReferenceOptional& data, const std::string& path)
+    bool Visit(PixelShaderReferenceOptional& data, const VisitPath& path)
     {
         if (data.name.empty())
             return true;
 
-        for (int index = 0; index < (int)renderGraph.shaders.size(); ++index)
+        int index = FindShader(ShaderType::Pixel, data.name);
+        if (index != -1)
         {
-            if (renderGraph.shaders[index].type == ShaderType::Pixel && !_stricmp(renderGraph.shaders[index].name.c_str(), data.name.c_str()))
-            {
-                data.shaderIndex = index;
-                data.shader = &renderGraph.shaders[index];
-                return true;
-            }
+            data.shaderIndex = index;
+            data.shader = &renderGraph.shaders[index];
+            return true;
         }
-        Assert(false, "Could not find pixel shader referenced: %s\nIn %s\n", data.name.c_str(), path.c_str());
+        Assert(false, "Could not find pixel shader referenced: %s\nIn %s\n", data.name.c_str(), path.ToString().c_str());
         return false;
     }
 
-    bool Visit(AmplificationShaderReferenceOptional& data, const std::string& path)
+    bool Visit(AmplificationShaderReferenceOptional& data, const VisitPath& path)
     {
         if (data.name.empty())
             return true;
 
-        for (int index = 0; index < (int)renderGraph.shaders.size(); ++index)
+        int index = FindShader(ShaderType::Amplification, data.name);
+        if (index != -1)
         {
-            if (renderGraph.shaders[index].type == ShaderType::Amplification && !_stricmp(renderGraph.shaders[index].name.c_str(), data.name.c_str()))
-            {
-                data.shaderIndex = index;
-                data.shader = &renderGraph.shaders[index];
-                return true;
-            }
+            data.shaderIndex = index;
+            data.shader = &renderGraph.shaders[index];
+            return true;
         }
-        Assert(false, "Could not find amplification shader referenced: %s\nIn %s\n", data.name.c_str(), path.c_str());
+        Assert(false, "Could not find amplification shader referenced: %s\nIn %s\n", data.name.c_str(), path.ToString().c_str());
         return false;
     }
 
-    bool Visit(MeshShaderReferenceOptional& data, const std::string& path)
+    bool Visit(MeshShaderReferenceOptional& data, const VisitPath& path)
     {
         if (data.name.empty())
             return true;
 
-        for (int index = 0; index < (int)renderGraph.shaders.size(); ++index)
+        int index = FindShader(ShaderType::Mesh, data.name);
+        if (index != -1)
         {
-            if (renderGraph.shaders[index].type == ShaderType::Mesh && !_stricmp(renderGraph.shaders[index].name.c_str(), data.name.c_str()))
-            {
-                data.shaderIndex = index;
-                data.shader = &renderGraph.shaders[index];
-                return true;
-            }
+            data.shaderIndex = index;
+            data.shader = &renderGraph.shaders[index];
+            return true;
         }
-        Assert(false, "Could not find mesh shader referenced: %s\nIn %s\n", data.name.c_str(), path.c_str());
+        Assert(false, "Could not find mesh shader referenced: %s\nIn %s\n", data.name.c_str(), path.ToString().c_str());
         return false;
     }
 
+    // Returns the first shader with this name and type, or -1 if there isn't one
+    int FindShader(ShaderType type, const std::string& name)
+    {
+        int index = SymbolTableFindShader(renderGraph, name.c_str());
+        if (index == -1 || renderGraph.shaders[index].type == type)
+            return index;
+
+        // The first shader with this name is a different type, so look at the ones after it
+        for (++index; index < (int)renderGraph.shaders.size(); ++index)
+        {
+            if (renderGraph.shaders[index].type == type && !_stricmp(renderGraph.shaders[index].name.c_str(), name.c_str()))
+                return index;
+        }
+        return -1;
+    }
+
     RenderGraph& renderGraph;
 };
 
 struct ReferenceFixupVisitor
 {
+    // Resolving a node pin reference visits the nodes it passes through to get to the resource node, which resolves their connections
+    // and pin references, so this reads and writes those anywhere. Buffer visits export the struct of the buffer.
+    // The render graph visit gives every node its index before anything else is visited.
+    static constexpr VisitorAccess c_access = VisitorAccess()
+        .Reads(VisitorData_Nodes | VisitorData_Structs | VisitorData_Names | VisitorData_Connections | VisitorData_ShaderReferences | VisitorData_ShaderResources)
+        .Writes(VisitorData_References | VisitorData_Connections | VisitorData_ShaderResources | VisitorData_StructLayout)
+        .ReadsAnywhere(VisitorData_Names | VisitorData_Nodes | VisitorData_Connections | VisitorData_ShaderReferences | VisitorData_ShaderResources | VisitorData_References)
+        .WritesAnywhere(VisitorData_NodeIndices | VisitorData_StructLayout | VisitorData_References | VisitorData_Connections);
+
     ReferenceFixupVisitor(RenderGraph& renderGraph_)
         : renderGraph(renderGraph_)
-    {
-        visitedNode.resize(renderGraph.nodes.size(), false);
-    }
+    { }
 
     template <typename TDATA>
-    bool Visit(TDATA& data, const std::string& path)
+    bool Visit(TDATA& data, const VisitPath& path)
     {
         return true;
     }
 
-    bool Visit(TextureNodeReference& data, const std::string& path)
+    bool Visit(TextureNodeReference& data, const VisitPath& path)
     {
         if (data.name.empty())
             return true;
@@ -621,7 +645,7 @@ struct ReferenceFixupVisitor
             }
             default:
             {
-                Assert(false, "%s was referenced as a texture node, but is not one!\nIn %s\n", data.name.c_str(), path.c_str());
+                Assert(false, "%s was referenced as a texture node, but is not one!\nIn %s\n", data.name.c_str(), path.ToString().c_str());
                 return false;
             }
         }
@@ -629,7 +653,7 @@ struct ReferenceFixupVisitor
         return true;
     }
 
-    bool Visit(BufferNodeReference& data, const std::string& path)
+    bool Visit(BufferNodeReference& data, const VisitPath& path)
     {
         if (data.name.empty())
             return true;
@@ -646,7 +670,7 @@ struct ReferenceFixupVisitor
             }
             default:
             {
-                Assert(false, "%s was referenced as a buffer node, but is not one!\nIn %s\n", data.name.c_str(), path.c_str());
+                Assert(false, "%s was referenced as a buffer node, but is not one!\nIn %s\n", data.name.c_str(), path.ToString().c_str());
                 return false;
             }
         }
@@ -654,7 +678,7 @@ struct ReferenceFixupVisitor
         return true;
     }
 
-    bool Visit(TextureOrBufferNodeReference& data, const std::string& path)
+    bool Visit(TextureOrBufferNodeReference& data, const VisitPath& path)
     {
         if (data.name.empty())
             return true;
@@ -676,7 +700,7 @@ struct ReferenceFixupVisitor
             }
             default:
             {
-                Assert(false, "%s was referenced as a texture or buffer node, but is neither!\nIn %s\n", data.name.c_str(), path.c_str());
+                Assert(false, "%s was referenced as a texture or buffer node, but is neither!\nIn %s\n", data.name.c_str(), path.ToString().c_str());
                 return false;
             }
         }
@@ -684,7 +708,7 @@ struct ReferenceFixupVisitor
         return true;
     }
 
-    bool Visit(NodeReference& data, const std::string& path)
+    bool Visit(NodeReference& data, const VisitPath& path)
     {
         if (data.name.empty())
             return true;
@@ -693,42 +717,28 @@ struct ReferenceFixupVisitor
         if (data.nodeIndex != -1)
             return true;
 
-        Assert(false, "Could not find node referenced: %s\nIn %s\n", data.name.c_str(), path.c_str(), path.c_str());
+        Assert(false, "Could not find node referenced: %s\nIn %s\n", data.name.c_str(), path.ToString().c_str());
         return false;
     }
 
-    bool Visit(NodePinReference& data, const std::string& path)
+    bool Visit(NodePinReference& data, const VisitPath& path)
     {
         // Get the nodeIndex and nodePinIndex
-        bool found = false;
-        for (int nodeIndex = 0; nodeIndex < (int)renderGraph.nodes.size(); ++nodeIndex)
+        int nodeIndex = GetNodeIndexByName(data.node.c_str());
+        if (nodeIndex == -1)
         {
-            RenderGraphNode& node = renderGraph.nodes[nodeIndex];
-            if (!_stricmp(data.node.c_str(), GetNodeName(node).c_str()))
-            {
-                data.nodeIndex = nodeIndex;
-                int pinCount = GetNodePinCount(node);
-                for (int pinIndex = 0; pinIndex < pinCount; ++pinIndex)
-                {
-                    if (!_stricmp(data.pin.c_str(), GetNodePinName(node, pinIndex).c_str()))
-                    {
-                        data.nodePinIndex = pinIndex;
-                        found = true;
-                        break;
-                    }
-                }
-                if (found)
-                    break;
-
-                Assert(false, "Could not find pin referenced: %s:%s\nIn %s\n", data.node.c_str(), data.pin.c_str(), path.c_str());
-                return false;
-            }
+            Assert(false, "Could not find node referenced: %s\nIn %s\n", data.node.c_str(), path.ToString().c_str());
+            return false;
         }
-        if (!found)
+        data.nodeIndex = nodeIndex;
+
+        int pinIndex = GetNodePinIndexByName(renderGraph.nodes[nodeIndex], data.pin.c_str());
+        if (pinIndex == -1)
         {
-            Assert(false, "Could not find node referenced: %s\nIn %s\n", data.node.c_str(), path.c_str());
+            Assert(false, "Could not find pin referenced: %s:%s\nIn %s\n", data.node.c_str(), data.pin.c_str(), path.ToString().c_str());
             return false;
         }
+        data.nodePinIndex = pinIndex;
 
         // Find the resourceNodeIndex!
         data.resourceNodeIndex = data.nodeIndex;
@@ -759,7 +769,7 @@ struct ReferenceFixupVisitor
 
             if (info.nodeIndex == -1)
             {
-                Assert(false, "Could not get resourceNodeIndex for nodePinReference %s.%s\nIn %s\n", data.node.c_str(), data.pin.c_str(), path.c_str());
+                Assert(false, "Could not get resourceNodeIndex for nodePinReference %s.%s\nIn %s\n", data.node.c_str(), data.pin.c_str(), path.ToString().c_str());
                 return false;
             }
 
@@ -770,41 +780,27 @@ struct ReferenceFixupVisitor
         return true;
     }
 
-    bool Visit(NodePinReferenceOptional& data, const std::string& path)
+    bool Visit(NodePinReferenceOptional& data, const VisitPath& path)
     {
         if (data.node.empty() || data.pin.empty())
             return true;
 
         // Get the nodeIndex and nodePinIndex
-        bool found = false;
-        for (int nodeIndex = 0; nodeIndex < (int)renderGraph.nodes.size(); ++nodeIndex)
+        int nodeIndex = GetNodeIndexByName(data.node.c_str());
+        if (nodeIndex == -1)
         {
-            RenderGraphNode& node = renderGraph.nodes[nodeIndex];
-            if (!_stricmp(data.node.c_str(), GetNodeName(node).c_str()))
-            {
-                data.nodeIndex = nodeIndex;
-                int pinCount = GetNodePinCount(node);
-                for (int pinIndex = 0; pinIndex < pinCount; ++pinIndex)
-                {
-                    if (!_stricmp(data.pin.c_str(), GetNodePinName(node, pinIndex).c_str()))
-                    {
-                        data.nodePinIndex = pinIndex;
-                        found = true;
-                        break;
-                    }
-                }
-                if (found)
-                    break;
-
-                Assert(false, "Could not find pin referenced: %s:%s\nIn %s\n", data.node.c_str(), data.pin.c_str(), path.c_str());
-                return false;
-            }
+            Assert(false, "Could not find node referenced: %s\nIn %s\n", data.node.c_str(), path.ToString().c_str());
+            return false;
         }
-        if (!found)
+        data.nodeIndex = nodeIndex;
+
+        int pinIndex = GetNodePinIndexByName(renderGraph.nodes[nodeIndex], data.pin.c_str());
+        if (pinIndex == -1)
         {
-            Assert(false, "Could not find node referenced: %s\nIn %s\n", data.node.c_str(), path.c_str());
+            Assert(false, "Could not find pin referenced: %s:%s\nIn %s\n", data.node.c_str(), data.pin.c_str(), path.ToString().c_str());
             return false;
         }
+        data.nodePinIndex = pinIndex;
 
         // Find the resourceNodeIndex!
         data.resourceNodeIndex = data.nodeIndex;
@@ -836,7 +832,7 @@ struct ReferenceFixupVisitor
 
             if (info.nodeIndex == -1)
             {
-                Assert(false, "Could not get resourceNodeIndex for nodePinReferenceOptional %s.%s\nIn %s\n", data.node.c_str(), data.pin.c_str(), path.c_str());
+                Assert(false, "Could not get resourceNodeIndex for nodePinReferenceOptional %s.%s\nIn %s\n", data.node.c_str(), data.pin.c_str(), path.ToString().c_str());
                 return false;
             }
 
@@ -847,7 +843,7 @@ struct ReferenceFixupVisitor
         return true;
     }
 
-    bool Visit(RenderGraphNode_Resource_Buffer& data, const std::string& path)
+    bool Visit(RenderGraphNode_Resource_Buffer& data, const VisitPath& path)
     {
         if (visitedNode[data.nodeIndex])
             return true;
@@ -867,7 +863,7 @@ struct ReferenceFixupVisitor
         return true;
     }
 
-    bool Visit(RenderGraphNode_Action_ComputeShader& data, const std::string& path)
+    bool Visit(RenderGraphNode_Action_ComputeShader& data, const VisitPath& path)
     {
         if (visitedNode[data.nodeIndex])
             return true;
@@ -890,7 +886,7 @@ struct ReferenceFixupVisitor
             }
             if (connection.srcNodePinIndex == -1)
             {
-                Assert(false, "Could not find source pin \"%s\" (connections[%i]) in shader node \"%s\"\nIn %s\n", connection.srcPin.c_str(), connectionIndex, data.name.c_str(), path.c_str());
+                Assert(false, "Could not find source pin \"%s\" (connections[%i]) in shader node \"%s\"\nIn %s\n", connection.srcPin.c_str(), connectionIndex, data.name.c_str(), path.ToString().c_str());
                 return false;
             }
 
@@ -898,7 +894,7 @@ struct ReferenceFixupVisitor
             connection.dstNodeIndex = GetNodeIndexByName(connection.dstNode.c_str());
             if (connection.dstNodeIndex == -1)
             {
-                Assert(false, "Could not find dest node \"%s\" (connections[%i]) in shader node \"%s\"\nIn %s\n", connection.dstNode.c_str(), connectionIndex, data.name.c_str(), path.c_str());
+                Assert(false, "Could not find dest node \"%s\" (connections[%i]) in shader node \"%s\"\nIn %s\n", connection.dstNode.c_str(), connectionIndex, data.name.c_str(), path.ToString().c_str());
                 return false;
             }
 
@@ -906,14 +902,14 @@ struct ReferenceFixupVisitor
             connection.dstNodePinIndex = GetNodePinIndexByName(renderGraph.nodes[connection.dstNodeIndex], connection.dstPin.c_str());
             if (connection.dstNodePinIndex == -1)
             {
-                Assert(false, "Could not find dest pin %s (connections[%i]) in shader node %s\nIn %s\n", connection.dstPin.c_str(), connectionIndex, data.name.c_str(), path.c_str());
+                Assert(false, "Could not find dest pin %s (connections[%i]) in shader node %s\nIn %s\n", connection.dstPin.c_str(), connectionIndex, data.name.c_str(), path.ToString().c_str());
                 return false;
             }
         }
 
         if (data.connections.size() != shader.resources.size())
         {
-            Assert(false, "node %s doesn't have the right number of connections for shader %s\nIn %s\n", data.name.c_str(), shader.name.c_str(), path.c_str());
+            Assert(false, "node %s doesn't have the right number of connections for shader %s\nIn %s\n", data.name.c_str(), shader.name.c_str(), path.ToString().c_str());
             return false;
         }
 
@@ -923,7 +919,7 @@ struct ReferenceFixupVisitor
         return true;
     }
 
-    bool Visit(RenderGraphNode_Action_RayShader& data, const std::string& path)
+    bool Visit(RenderGraphNode_Action_RayShader& data, const VisitPath& path)
     {
         if (visitedNode[data.nodeIndex])
             return true;
@@ -949,7 +945,7 @@ struct ReferenceFixupVisitor
             }
             if (connection.srcNodePinIndex == -1)
             {
-                Assert(false, "Could not find source pin \"%s\" (connections[%i]) in shader node \"%s\"\nIn %s\n", connection.srcPin.c_str(), connectionIndex, data.name.c_str(), path.c_str());
+                Assert(false, "Could not find source pin \"%s\" (connections[%i]) in shader node \"%s\"\nIn %s\n", connection.srcPin.c_str(), connectionIndex, data.name.c_str(), path.ToString().c_str());
                 return false;
             }
 
@@ -957,7 +953,7 @@ struct ReferenceFixupVisitor
             connection.dstNodeIndex = GetNodeIndexByName(connection.dstNode.c_str());
             if (connection.dstNodeIndex == -1)
             {
-                Assert(false, "Could not find dest node \"%s\" (connections[%i]) in shader node \"%s\"\nIn %s\n", connection.dstNode.c_str(), connectionIndex, data.name.c_str(), path.c_str());
+                Assert(false, "Could not find dest node \"%s\" (connections[%i]) in shader node \"%s\"\nIn %s\n", connection.dstNode.c_str(), connectionIndex, data.name.c_str(), path.ToString().c_str());
                 return false;
             }
 
@@ -965,14 +961,14 @@ struct ReferenceFixupVisitor
             connection.dstNodePinIndex = GetNodePinIndexByName(renderGraph.nodes[connection.dstNodeIndex], connection.dstPin.c_str());
             if (connection.dstNodePinIndex == -1)
             {
-                Assert(false, "Could not find dest pin %s (connections[%i]) in shader node %s\nIn %s\n", connection.dstPin.c_str(), connectionIndex, data.name.c_str(), path.c_str());
+                Assert(false, "Could not find dest pin %s (connections[%i]) in shader node %s\nIn %s\n", connection.dstPin.c_str(), connectionIndex, data.name.c_str(), path.ToString().c_str());
                 return false;
             }
         }
 
         if (data.connections.size() != shader.resources.size())
         {
-            Assert(false, "node %s doesn't have the right number of connections for shader %s\nIn %s\n", data.name.c_str(), shader.name.c_str(), path.c_str());
+            Assert(false, "node %s doesn't have the right number of connections for shader %s\nIn %s\n", data.name.c_str(), shader.name.c_str(), path.ToString().c_str());
             return false;
         }
 
@@ -982,7 +978,7 @@ struct ReferenceFixupVisitor
         return true;
     }
 
-    bool Visit(RenderGraphNode_Action_SubGraph& data, const std::string& path)
+    bool Visit(RenderGraphNode_Action_SubGraph& data, const VisitPath& path)
     {
         if (visitedNode[data.nodeIndex])
             return true;
@@ -998,7 +994,7 @@ struct ReferenceFixupVisitor
             connection.dstNodeIndex = GetNodeIndexByName(connection.dstNode.c_str());
             if (connection.dstNodeIndex == -1)
             {
-                Assert(false, "Could not find dest node \"%s\" (connections[%i]) in SubGraph node \"%s\"\nIn %s\n", connection.dstNode.c_str(), connectionIndex, data.name.c_str(), path.c_str());
+                Assert(false, "Could not find dest node \"%s\" (connections[%i]) in SubGraph node \"%s\"\nIn %s\n", connection.dstNode.c_str(), connectionIndex, data.name.c_str(), path.ToString().c_str());
                 return false;
             }
 
@@ -1006,14 +1002,14 @@ struct ReferenceFixupVisitor
             connection.dstNodePinIndex = GetNodePinIndexByName(renderGraph.nodes[connection.dstNodeIndex], connection.dstPin.c_str());
             if (connection.dstNodePinIndex == -1)
             {
-                Assert(false, "Could not find dest pin \"%s\" (connections[%i]) in SubGraph node \"%s\"\nIn %s\n", connection.dstPin.c_str(), connectionIndex, data.name.c_str(), path.c_str());
+                Assert(false, "Could not find dest pin \"%s\" (connections[%i]) in SubGraph node \"%s\"\nIn %s\n", connection.dstPin.c_str(), connectionIndex, data.name.c_str(), path.ToString().c_str());
                 return false;
             }
         }
         return true;
     }
 
-    bool Visit(RenderGraphNode_Action_Barrier& data, const std::string& path)
+    bool Visit(RenderGraphNode_Action_Barrier& data, const VisitPath& path)
     {
         if (visitedNode[data.nodeIndex])
             return true;
@@ -1029,7 +1025,7 @@ struct ReferenceFixupVisitor
             connection.dstNodeIndex = GetNodeIndexByName(connection.dstNode.c_str());
             if (connection.dstNodeIndex == -1)
             {
-                Assert(false, "Could not find dest node \"%s\" (connections[%i]) in Barrier node \"%s\"\nIn %s\n", connection.dstNode.c_str(), connectionIndex, data.name.c_str(), path.c_str());
+                Assert(false, "Could not find dest node \"%s\" (connections[%i]) in Barrier node \"%s\"\nIn %s\n", connection.dstNode.c_str(), connectionIndex, data.name.c_str(), path.ToString().c_str());
                 return false;
             }
 
@@ -1037,25 +1033,25 @@ struct ReferenceFixupVisitor
             connection.dstNodePinIndex = GetNodePinIndexByName(renderGraph.nodes[connection.dstNodeIndex], connection.dstPin.c_str());
             if (connection.dstNodePinIndex == -1)
             {
-                Assert(false, "Could not find dest pin \"%s\" (connections[%i]) in Barrier node \"%s\"\nIn %s\n", connection.dstPin.c_str(), connectionIndex, data.name.c_str(), path.c_str());
+                Assert(false, "Could not find dest pin \"%s\" (connections[%i]) in Barrier node \"%s\"\nIn %s\n", connection.dstPin.c_str(), connectionIndex, data.name.c_str(), path.ToString().c_str());
                 return false;
             }
         }
         return true;
     }
 
-    bool Visit(RenderGraphNode_Action_CopyResource& data, const std::string& path)
+    bool Visit(RenderGraphNode_Action_CopyResource& data, const VisitPath& path)
     {
         if (visitedNode[data.nodeIndex])
             return true;
         visitedNode[data.nodeIndex] = true;
 
-        Visit(data.source, path + ".source");
-        Visit(data.dest, path + ".dest");
+        Visit(data.source, VisitPath(path, "source"));
+        Visit(data.dest, VisitPath(path, "dest"));
         return true;
     }
 
-    bool Visit(RenderGraphNode_Action_DrawCall& data, const std::string& path)
+    bool Visit(RenderGraphNode_Action_DrawCall& data, const VisitPath& path)
     {
         if (visitedNode[data.nodeIndex])
             return true;
@@ -1069,13 +1065,13 @@ struct ReferenceFixupVisitor
 
         if (vertexShader && meshShader)
         {
-            Assert(false, "Node %s has both a vertex and mesh shader, which is not allowed.\nIn %s\n", data.name.c_str(), path.c_str());
+            Assert(false, "Node %s has both a vertex and mesh shader, which is not allowed.\nIn %s\n", data.name.c_str(), path.ToString().c_str());
             return false;
         }
 
         if (!vertexShader && !meshShader)
         {
-            Assert(false, "Node %s has neither a vertex nor a mesh shader, one must be specified.\nIn %s\n", data.name.c_str(), path.c_str());
+            Assert(false, "Node %s has neither a vertex nor a mesh shader, one must be specified.\nIn %s\n", data.name.c_str(), path.ToString().c_str());
             return false;
         }
 
@@ -1127,7 +1123,7 @@ struct ReferenceFixupVisitor
 
             if (connection.srcNodePinIndex == -1)
             {
-                Assert(false, "Could not find source pin \"%s\" (connections[%i]) in draw call node \"%s\"\nIn %s\n", connection.srcPin.c_str(), connectionIndex, data.name.c_str(), path.c_str());
+                Assert(false, "Could not find source pin \"%s\" (connections[%i]) in draw call node \"%s\"\nIn %s\n", connection.srcPin.c_str(), connectionIndex, data.name.c_str(), path.ToString().c_str());
                 return false;
             }
 
@@ -1135,7 +1131,7 @@ struct ReferenceFixupVisitor
             connection.dstNodeIndex = GetNodeIndexByName(connection.dstNode.c_str());
             if (connection.dstNodeIndex == -1)
             {
-                Assert(false, "Could not find dest node \"%s\" (connections[%i]) in draw call node \"%s\"\nIn %s\n", connection.dstNode.c_str(), connectionIndex, data.name.c_str(), path.c_str());
+                Assert(false, "Could not find dest node \"%s\" (connections[%i]) in draw call node \"%s\"\nIn %s\n", connection.dstNode.c_str(), connectionIndex, data.name.c_str(), path.ToString().c_str());
                 return false;
             }
 
@@ -1143,14 +1139,14 @@ struct ReferenceFixupVisitor
             connection.dstNodePinIndex = GetNodePinIndexByName(renderGraph.nodes[connection.dstNodeIndex], connection.dstPin.c_str());
             if (connection.dstNodePinIndex == -1)
             {
-                Assert(false, "Could not find dest pin %s (connections[%i]) in draw call node %s\nIn %s\n", connection.dstPin.c_str(), connectionIndex, data.name.c_str(), path.c_str());
+                Assert(false, "Could not find dest pin %s (connections[%i]) in draw call node %s\nIn %s\n", connection.dstPin.c_str(), connectionIndex, data.name.c_str(), path.ToString().c_str());
                 return false;
             }
         }
 
         if (data.connections.size() != (vertexPinCount + pixelPinCount + amplificationPinCount + meshPinCount))
         {
-            Assert(false, "node %s doesn't have the right number of connections for shaders\nIn %s\n", data.name.c_str(), path.c_str());
+            Assert(false, "node %s doesn't have the right number of connections for shaders\nIn %s\n", data.name.c_str(), path.ToString().c_str());
             return false;
         }
 
@@ -1158,22 +1154,20 @@ struct ReferenceFixupVisitor
         std::sort(data.connections.begin(), data.connections.end(), [](const NodePinConnection& a, const NodePinConnection& b) { return a.srcNodePinIndex < b.srcNodePinIndex; });
 
         // Also set the pin index etc for depth and color targets!
-        Visit(data.shadingRateImage, path + ".shadingRateImage");
-        Visit(data.vertexBuffer, path + ".vertexBuffer");
-        Visit(data.indexBuffer, path + ".indexBuffer");
-        Visit(data.instanceBuffer, path + ".instanceBuffer");
-        Visit(data.depthTarget, path + ".depthTarget");
+        Visit(data.shadingRateImage, VisitPath(path, "shadingRateImage"));
+        Visit(data.vertexBuffer, VisitPath(path, "vertexBuffer"));
+        Visit(data.indexBuffer, VisitPath(path, "indexBuffer"));
+        Visit(data.instanceBuffer, VisitPath(path, "instanceBuffer"));
+        Visit(data.depthTarget, VisitPath(path, "depthTarget"));
         for (int i = 0; i < data.colorTargets.size(); ++i)
         {
-            char pathBuffer[64];
-            sprintf_s(pathBuffer, ".colorTargets[%i]", i);
-            Visit(data.colorTargets[i], path + pathBuffer);
+            Visit(data.colorTargets[i], VisitPath(path, "colorTargets", i));
         }
 
         return true;
     }
 
-    bool Visit(Shader& data, const std::string& path)
+    bool Visit(Shader& data, const VisitPath& path)
     {
         // make all constant buffers add a CBV resource so a user doesn't need to do double data entry
         int cbIndex = -1;
@@ -1182,9 +1176,7 @@ struct ReferenceFixupVisitor
             cbIndex++;
 
             // Make sure the struct reference is visited first
-            char pathBuffer[64];
-            sprintf_s(pathBuffer, ".constantBuffers[%i]", cbIndex);
-            if (!Visit(cbDesc, path + pathBuffer))
+            if (!Visit(cbDesc, VisitPath(path, "constantBuffers", cbIndex)))
                 return false;
 
             ShaderResource newResource;
@@ -1214,7 +1206,7 @@ struct ReferenceFixupVisitor
                 case ShaderResourceAccessType::CBV: resource.registerIndex = nextRegisterIndexCBV++; break;
                 default:
                 {
-                    Assert(false, "Unhandled shader resource access type %s (%i). Shader = \"%s\", Resource = \"%s\".\nIn %s\n", EnumToString(resource.access), resource.access, data.name.c_str(), resource.name.c_str(), path.c_str());
+                    Assert(false, "Unhandled shader resource access type %s (%i). Shader = \"%s\", Resource = \"%s\".\nIn %s\n", EnumToString(resource.access), resource.access, data.name.c_str(), resource.name.c_str(), path.ToString().c_str());
                     return false;
                 }
             }
@@ -1223,7 +1215,7 @@ struct ReferenceFixupVisitor
         return true;
     }
 
-    bool Visit(Struct& data, const std::string& path)
+    bool Visit(Struct& data, const VisitPath& path)
     {
         if (data.forceHostVisible)
             data.exported = true;
@@ -1239,144 +1231,94 @@ struct ReferenceFixupVisitor
         return true;
     }
 
-    bool Visit(RenderGraph& data, const std::string& path)
+    bool Visit(RenderGraph& data, const VisitPath& path)
     {
+        // Sized when the traversal starts rather than when constructed, since visitors that run between the two may add nodes
+        visitedNode.assign(data.nodes.size(), false);
+
         // let each node know it's index
         for (size_t index = 0; index < data.nodes.size(); ++index)
             ExecuteOnNode(data.nodes[index], [index](auto& node) {node.nodeIndex = (int)index; });
         return true;
     }
 
-    bool Visit(VariableReference& data, const std::string& path)
+    bool Visit(VariableReference& data, const VisitPath& path)
     {
         if (data.name.empty())
             return true;
 
-        for (size_t index = 0; index < renderGraph.variables.size(); ++index)
-        {
-            const Variable& variable = renderGraph.variables[index];
-
-            if (!_stricmp(data.name.c_str(), variable.name.c_str()))
-            {
-                data.variableIndex = (int)index;
-                return true;
-            }
-        }
+        data.variableIndex = GetVariableIndex(renderGraph, data.name.c_str());
+        if (data.variableIndex != -1)
+            return true;
 
-        Assert(data.variableIndex != -1, "Could not find variable %s\nIn %s\n", data.name.c_str(), path.c_str());
+        Assert(data.variableIndex != -1, "Could not find variable %s\nIn %s\n", data.name.c_str(), path.ToString().c_str());
         return false;
     }
 
-    bool Visit(VariableReferenceNoConst& data, const std::string& path)
+    bool Visit(VariableReferenceNoConst& data, const VisitPath& path)
     {
         if (data.name.empty())
             return true;
 
-        for (size_t index = 0; index < renderGraph.variables.size(); ++index)
-        {
-            const Variable& variable = renderGraph.variables[index];
-
-            if (!_stricmp(data.name.c_str(), variable.name.c_str()))
-            {
-                data.variableIndex = (int)index;
-                return true;
-            }
-        }
+        data.variableIndex = GetVariableIndex(renderGraph, data.name.c_str());
+        if (data.variableIndex != -1)
+            return true;
 
-        Assert(data.variableIndex != -1, "Could not find variable %s\nIn %s\n", data.name.c_str(), path.c_str());
+        Assert(data.variableIndex != -1, "Could not find variable %s\nIn %s\n", data.name.c_str(), path.ToString().c_str());
         return false;
     }
 
-    bool Visit(VariableReferenceConstOnly& data, const std::string& path)
+    bool Visit(VariableReferenceConstOnly& data, const VisitPath& path)
     {
         if (data.name.empty())
             return true;
 
-        for (size_t index = 0; index < renderGraph.variables.size(); ++index)
-        {
-            const Variable& variable = renderGraph.variables[index];
-
-            if (!_stricmp(data.name.c_str(), variable.name.c_str()))
-            {
-                data.variableIndex = (int)index;
-                return true;
-            }
-        }
+        data.variableIndex = GetVariableIndex(renderGraph, data.name.c_str());
+        if (data.variableIndex != -1)
+            return true;
 
-        Assert(data.variableIndex != -1, "Could not find variable %s\nIn %s\n", data.name.c_str(), path.c_str());
+        Assert(data.variableIndex != -1, "Could not find variable %s\nIn %s\n", data.name.c_str(), path.ToString().c_str());
         return false;
     }
 
-    bool Visit(StructReference& data, const std::string& path)
+    bool Visit(StructReference& data, const VisitPath& path)
     {
         if (data.name.empty())
             return true;
 
-        for (size_t index = 0; index < renderGraph.structs.size(); ++index)
-        {
-            const Struct& s = renderGraph.structs[index];
-
-            if (!_stricmp(data.name.c_str(), s.name.c_str()))
-            {
-                data.structIndex = (int)index;
-                return true;
-            }
-        }
+        data.structIndex = SymbolTableFindStruct(renderGraph, data.name.c_str());
+        if (data.structIndex != -1)
+            return true;
 
-        Assert(data.structIndex != -1, "Could not find struct %s\nIn %s\n", data.name.c_str(), path.c_str());
+        Assert(data.structIndex != -1, "Could not find struct %s\nIn %s\n", data.name.c_str(), path.ToString().c_str());
         return false;
     }
 
-    bool Visit(ShaderConstantBuffer& data, const std::string& path)
+    bool Visit(ShaderConstantBuffer& data, const VisitPath& path)
     {
         if (data.structName.empty())
             return true;
 
-        for (size_t index = 0; index < renderGraph.structs.size(); ++index)
-        {
-            const Struct& s = renderGraph.structs[index];
-
-            if (!_stricmp(data.structName.c_str(), s.name.c_str()))
-            {
-                data.structIndex = (int)index;
-                return true;
-            }
-        }
+        data.structIndex = SymbolTableFindStruct(renderGraph, data.structName.c_str());
+        if (data.structIndex != -1)
+            return true;
 
-        Assert(data.structIndex != -1, "Could not find struct %s\nIn %s\n", data.structName.c_str(), path.c_str());
+        Assert(data.structIndex != -1, "Could not find struct %s\nIn %s\n", data.structName.c_str(), path.ToString().c_str());
         return false;
     }
 
-    bool Visit(Condition& data, const std::string& path)
+    bool Visit(Condition& data, const VisitPath& path)
     {
         if (!data.variable1.empty())
         {
-            for (size_t index = 0; index < renderGraph.variables.size(); ++index)
-            {
-                const Variable& variable = renderGraph.variables[index];
-
-                if (!_stricmp(data.variable1.c_str(), variable.name.c_str()))
-                {
-                    data.variable1Index = (int)index;
-                    break;
-                }
-            }
-            Assert(data.variable1Index != -1, "Could not find variable %s\nIn %s\n", data.variable1.c_str(), path.c_str());
+            data.variable1Index = GetVariableIndex(renderGraph, data.variable1.c_str());
+            Assert(data.variable1Index != -1, "Could not find variable %s\nIn %s\n", data.variable1.c_str(), path.ToString().c_str());
         }
 
         if (!data.variable2.empty())
         {
-            for (size_t index = 0; index < renderGraph.variables.size(); ++index)
-            {
-                const Variable& variable = renderGraph.variables[index];
-
-                if (!_stricmp(data.variable2.c_str(), variable.name.c_str()))
-                {
-                    data.variable2Index = (int)index;
-                    break;
-                }
-            }
-            Assert(data.variable2Index != -1, "Could not find variable %s\nIn %s\n", data.variable2.c_str(), path.c_str());
+            data.variable2Index = GetVariableIndex(renderGraph, data.variable2.c_str());
+            Assert(data.variable2Index != -1, "Could not find variable %s\nIn %s\n", data.variable2.c_str(), path.ToString().c_str());
         }
 
         return true;
@@ -1388,12 +1330,7 @@ struct ReferenceFixupVisitor
     // Helpers
     int GetNodeIndexByName(const char* name)
     {
-        for (int i = 0; i < (int)renderGraph.nodes.size(); ++i)
-        {
-            if (!_stricmp(name, GetNodeName(renderGraph.nodes[i]).c_str()))
-                return i;
-        }
-        return -1;
+        return SymbolTableFindNode(renderGraph, name);
     }
 
     int GetNodePinIndexByName(RenderGraphNode& node, const char* name)
@@ -1410,17 +1347,23 @@ struct ReferenceFixupVisitor
 
 struct ValidationVisitor
 {
+    // Variable and struct visits resolve enums, and the render graph visit checks that every node and shader name is unique
+    static constexpr VisitorAccess c_access = VisitorAccess()
+        .Reads(VisitorData_Names | VisitorData_Nodes | VisitorData_Structs | VisitorData_ShaderResources | VisitorData_Values)
+        .Writes(VisitorData_Values | VisitorData_References)
+        .ReadsAnywhere(VisitorData_Names | VisitorData_Nodes);
+
     ValidationVisitor(RenderGraph& renderGraph_)
         : renderGraph(renderGraph_)
     { }
 
     template <typename TDATA>
-    bool Visit(TDATA& data, const std::string& path)
+    bool Visit(TDATA& data, const VisitPath& path)
     {
         return true;
     }
 
-    bool Visit(Shader& shader, const std::string& path)
+    bool Visit(Shader& shader, const VisitPath& path)
     {
         switch (shader.type)
         {
@@ -1438,7 +1381,7 @@ struct ValidationVisitor
             {
                 if (shader.resources.size() != 0)
                 {
-                    Assert(false, "Shader type \'%s\' has resources defined, but only the ray gen shader can. Ray gen resources are global so are accessible if they are in the same file or if the ray gen file is #included.\nIn %s\n", EnumToString(shader.type), path.c_str());
+                    Assert(false, "Shader type \'%s\' has resources defined, but only the ray gen shader can. Ray gen resources are global so are accessible if they are in the same file or if the ray gen file is #included.\nIn %s\n", EnumToString(shader.type), path.ToString().c_str());
                     return false;
                 }
             }
@@ -1447,7 +1390,7 @@ struct ValidationVisitor
         return true;
     }
 
-    bool Visit(Condition& condition, const std::string& path)
+    bool Visit(Condition& condition, const VisitPath& path)
     {
         int AVarIndex = GetVariableIndex(renderGraph, condition.variable1.c_str());
         if (AVarIndex == -1)
@@ -1456,13 +1399,13 @@ struct ValidationVisitor
         int BVarIndex = GetVariableIndex(renderGraph, condition.variable2.c_str());
         if (BVarIndex != -1 && renderGraph.variables[AVarIndex].type != renderGraph.variables[BVarIndex].type)
         {
-            Assert(false, "A condition with variable \"%s %s\" and \"%s %s\" is not possible because they are different types.\nIn %s\n", EnumToString(renderGraph.variables[AVarIndex].type), condition.variable1.c_str(), EnumToString(renderGraph.variables[BVarIndex].type), condition.variable2.c_str(), path.c_str());
+            Assert(false, "A condition with variable \"%s %s\" and \"%s %s\" is not possible because they are different types.\nIn %s\n", EnumToString(renderGraph.variables[AVarIndex].type), condition.variable1.c_str(), EnumToString(renderGraph.variables[BVarIndex].type), condition.variable2.c_str(), path.ToString().c_str());
             return false;
         }
         return true;
     }
 
-    bool Visit(SetVariable& setVar, const std::string& path)
+    bool Visit(SetVariable& setVar, const VisitPath& path)
     {
         // Get the destination variable type
         int destVarIndex = GetVariableIndex(renderGraph, setVar.destination.name.c_str());
@@ -1482,7 +1425,7 @@ struct ValidationVisitor
 
             if (destVarType != AVarType)
             {
-                Assert(false, "Setting the variable \"%s %s\" to an equation involving variable \"%s %s\" is not possible because they are different types.\nIn %s\n", EnumToString(renderGraph.variables[destVarIndex].type), setVar.destination.name.c_str(), EnumToString(renderGraph.variables[AVarIndex].type), setVar.AVar.name.c_str(), path.c_str());
+                Assert(false, "Setting the variable \"%s %s\" to an equation involving variable \"%s %s\" is not possible because they are different types.\nIn %s\n", EnumToString(renderGraph.variables[destVarIndex].type), setVar.destination.name.c_str(), EnumToString(renderGraph.variables[AVarIndex].type), setVar.AVar.name.c_str(), path.ToString().c_str());
                 return false;
             }
         }
@@ -1497,7 +1440,7 @@ struct ValidationVisitor
 
             if (destVarType != BVarType)
             {
-                Assert(false, "Setting the variable \"%s %s\" to an equation involving variable \"%s %s\" is not possible because they are different types.\nIn %s\n", EnumToString(renderGraph.variables[destVarIndex].type), setVar.destination.name.c_str(), EnumToString(renderGraph.variables[BVarIndex].type), setVar.BVar.name.c_str(), path.c_str());
+                Assert(false, "Setting the variable \"%s %s\" to an equation involving variable \"%s %s\" is not possible because they are different types.\nIn %s\n", EnumToString(renderGraph.variables[destVarIndex].type), setVar.destination.name.c_str(), EnumToString(renderGraph.variables[BVarIndex].type), setVar.BVar.name.c_str(), path.ToString().c_str());
                 return false;
             }
         }
@@ -1505,7 +1448,7 @@ struct ValidationVisitor
         return true;
     }
 
-    bool Visit(Variable& variable, const std::string& path)
+    bool Visit(Variable& variable, const VisitPath& path)
     {
         // Every variable needs a type
         if (variable.type == DataFieldType::Count)
@@ -1536,7 +1479,7 @@ struct ValidationVisitor
                 case DataFieldType::Uint_16: variable.dflt = "0"; break;
                 default:
                 {
-                    Assert(false, "Unhandled data field type %s (%i).\nIn %s\n", EnumToString(variable.type), variable.type, path.c_str());
+                    Assert(false, "Unhandled data field type %s (%i).\nIn %s\n", EnumToString(variable.type), variable.type, path.ToString().c_str());
                     break;
                 }
             }
@@ -1547,7 +1490,7 @@ struct ValidationVisitor
         {
             if (variable.type != DataFieldType::Int)
             {
-                Assert(false, "Variable \'%s\' uses enum \'%s\' but is not an integer type. Only integers can use enums.\nIn %s\n", variable.name.c_str(), variable.Enum.c_str(), path.c_str());
+                Assert(false, "Variable \'%s\' uses enum \'%s\' but is not an integer type. Only integers can use enums.\nIn %s\n", variable.name.c_str(), variable.Enum.c_str(), path.ToString().c_str());
                 return false;
             }
 
@@ -1562,14 +1505,14 @@ struct ValidationVisitor
                 }
             }
 
-            Assert(false, "Variable \'%s\' uses an undeclared enum \'%s\'.\nIn %s\n", variable.name.c_str(), variable.Enum.c_str(), path.c_str());
+            Assert(false, "Variable \'%s\' uses an undeclared enum \'%s\'.\nIn %s\n", variable.name.c_str(), variable.Enum.c_str(), path.ToString().c_str());
             return false;
         }
 
         return true;
     }
 
-    bool Visit(Struct& s, const std::string& path)
+    bool Visit(Struct& s, const VisitPath& path)
     {
         for (StructField& field : s.fields)
         {
@@ -1578,7 +1521,7 @@ struct ValidationVisitor
 
             if (field.type != DataFieldType::Int)
             {
-                Assert(false, "Struct field \'%s\' uses enum \'%s\' but is not an integer type. Only integers can use enums.\nIn %s\n", field.name.c_str(), field.Enum.c_str(), path.c_str());
+                Assert(false, "Struct field \'%s\' uses enum \'%s\' but is not an integer type. Only integers can use enums.\nIn %s\n", field.name.c_str(), field.Enum.c_str(), path.ToString().c_str());
                 return false;
             }
 
@@ -1595,18 +1538,18 @@ struct ValidationVisitor
             if (enumIndex != -1)
                 continue;
 
-            Assert(false, "Struct \'%s\' field \'%s\' uses an undeclared enum \'%s\'.\nIn %s\n", s.name.c_str(), field.name.c_str(), field.Enum.c_str(), path.c_str());
+            Assert(false, "Struct \'%s\' field \'%s\' uses an undeclared enum \'%s\'.\nIn %s\n", s.name.c_str(), field.name.c_str(), field.Enum.c_str(), path.ToString().c_str());
             return false;
         }
         return true;
     }
 
-    bool Visit(RenderGraph& renderGraph, const std::string& path)
+    bool Visit(RenderGraph& renderGraph, const VisitPath& path)
     {
         // make sure the render graph has a name.
         if (renderGraph.name.empty())
         {
-            Assert(false, "The render graph name is empty. That field is used to make namespaces and folder names, so is required.\nIn %s\n", path.c_str());
+            Assert(false, "The render graph name is empty. That field is used to make namespaces and folder names, so is required.\nIn %s\n", path.ToString().c_str());
             return false;
         }
 
@@ -1630,7 +1573,7 @@ struct ValidationVisitor
                             indices.push_back(nodeIndex);
                     }
 
-                    Assert(false, "node name %s appears more than once in the render graph.\nIn %s\n", name.c_str(), path.c_str());
+                    Assert(false, "node name %s appears more than once in the render graph.\nIn %s\n", name.c_str(), path.ToString().c_str());
                     return false;
                 }
                 names.insert(name);
@@ -1650,7 +1593,7 @@ struct ValidationVisitor
 
                 if (names.find(name) != names.end())
                 {
-                    Assert(false, "shader name %s appears more than once in the render graph.\nIn %s\n", name.c_str(), path.c_str());
+                    Assert(false, "shader name %s appears more than once in the render graph.\nIn %s\n", name.c_str(), path.ToString().c_str());
                     return false;
                 }
                 names.insert(name);
@@ -1665,12 +1608,17 @@ struct ValidationVisitor
 
 struct SanitizeVisitor
 {
+    // Renames things in place, removes incomplete connections, and sanitizes the defaults of enum variables
+    static constexpr VisitorAccess c_access = VisitorAccess()
+        .Reads(VisitorData_Nodes | VisitorData_Structs | VisitorData_Names | VisitorData_Connections | VisitorData_Values)
+        .Writes(VisitorData_Names | VisitorData_Connections | VisitorData_Values);
+
     SanitizeVisitor(RenderGraph& renderGraph_)
         : renderGraph(renderGraph_)
     { }
 
     template <typename TDATA>
-    bool Visit(TDATA& data, const std::string& path)
+    bool Visit(TDATA& data, const VisitPath& path)
     {
         return true;
     }
@@ -1694,13 +1642,13 @@ struct SanitizeVisitor
         Sanitize(s);
     }
 
-    bool Visit(RenderGraph& data, const std::string& path)
+    bool Visit(RenderGraph& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
 
-    bool Visit(Variable& data, const std::string& path)
+    bool Visit(Variable& data, const VisitPath& path)
     {
         Sanitize(data.name, data.originalName);
         Sanitize(data.Enum);
@@ -1711,7 +1659,7 @@ struct SanitizeVisitor
         return true;
     }
 
-    bool Visit(StructField& data, const std::string& path)
+    bool Visit(StructField& data, const VisitPath& path)
     {
         Sanitize(data.name);
         Sanitize(data.Enum);
@@ -1719,7 +1667,7 @@ struct SanitizeVisitor
     }
 
     // Sanitize enum names and all the item labels
-    bool Visit(Enum& data, const std::string& path)
+    bool Visit(Enum& data, const VisitPath& path)
     {
         Sanitize(data.name, data.originalName);
         for (EnumItem& item : data.items)
@@ -1731,21 +1679,21 @@ struct SanitizeVisitor
     }
 
     // Sanitize node names
-    bool Visit(RenderGraphNode_Base& node, const std::string& path)
+    bool Visit(RenderGraphNode_Base& node, const VisitPath& path)
     {
         Sanitize(node.name, node.originalName);
         return true;
     }
 
     // sanitize shader names
-    bool Visit(Shader& data, const std::string& path)
+    bool Visit(Shader& data, const VisitPath& path)
     {
         Sanitize(data.name, data.originalName);
         return true;
     }
 
     // sanitize Condition variable names
-    bool Visit(Condition& data, const std::string& path)
+    bool Visit(Condition& data, const VisitPath& path)
     {
         Sanitize(data.variable1);
         Sanitize(data.variable2);
@@ -1753,111 +1701,111 @@ struct SanitizeVisitor
     }
 
     // sanitize ComputeShaderReference shader names
-    bool Visit(ComputeShaderReference& data, const std::string& path)
+    bool Visit(ComputeShaderReference& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
 
     // sanitize RayGenShaderReference shader names
-    bool Visit(RayGenShaderReference& data, const std::string& path)
+    bool Visit(RayGenShaderReference& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
 
     // sanitize RTClosestHitShaderReference shader names
-    bool Visit(RTClosestHitShaderReference& data, const std::string& path)
+    bool Visit(RTClosestHitShaderReference& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
 
     // sanitize RTAnyHitShaderReference shader names
-    bool Visit(RTAnyHitShaderReference& data, const std::string& path)
+    bool Visit(RTAnyHitShaderReference& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
 
     // sanitize RTIntersectionShaderReference shader names
-    bool Visit(RTIntersectionShaderReference& data, const std::string& path)
+    bool Visit(RTIntersectionShaderReference& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
 
     // sanitize RTClosestHitShaderReferenceOptional shader names
-    bool Visit(RTClosestHitShaderReferenceOptional& data, const std::string& path)
+    bool Visit(RTClosestHitShaderReferenceOptional& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
 
     // sanitize RTAnyHitShaderReferenceOptional shader names
-    bool Visit(RTAnyHitShaderReferenceOptional& data, const std::string& path)
+    bool Visit(RTAnyHitShaderReferenceOptional& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
 
     // sanitize RTIntersectionShaderReferenceOptional shader names
-    bool Visit(RTIntersectionShaderReferenceOptional& data, const std::string& path)
+    bool Visit(RTIntersectionShaderReferenceOptional& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
 
     // sanitize VertexShaderReference shader names
-    bool Visit(VertexShaderReference& data, const std::string& path)
+    bool Visit(VertexShaderReference& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
-    bool Visit(VertexShaderReferenceOptional& data, const std::string& path)
+    bool Visit(VertexShaderReferenceOptional& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
 
     // sanitize PixelShaderReference shader names
-    bool Visit(PixelShaderReference& data, const std::string& path)
+    bool Visit(PixelShaderReference& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
-    bool Visit(PixelShaderReferenceOptional& data, const std::string& path)
+    bool Visit(PixelShaderReferenceOptional& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
 
     // sanitize MeshShaderReference shader names
-    bool Visit(MeshShaderReference& data, const std::string& path)
+    bool Visit(MeshShaderReference& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
-    bool Visit(MeshShaderReferenceOptional& data, const std::string& path)
+    bool Visit(MeshShaderReferenceOptional& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
 
     // sanitize AmplificationShaderReference shader names
-    bool Visit(AmplificationShaderReference& data, const std::string& path)
+    bool Visit(AmplificationShaderReference& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
-    bool Visit(AmplificationShaderReferenceOptional& data, const std::string& path)
+    bool Visit(AmplificationShaderReferenceOptional& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
 
     // sanitize NodePinConnection nodes and pin names
-    bool Visit(NodePinConnection& data, const std::string& path)
+    bool Visit(NodePinConnection& data, const VisitPath& path)
     {
         Sanitize(data.srcPin);
         Sanitize(data.dstNode);
@@ -1866,70 +1814,70 @@ struct SanitizeVisitor
     }
 
     // sanitize ShaderResource names
-    bool Visit(ShaderResource& data, const std::string& path)
+    bool Visit(ShaderResource& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
 
-    bool Visit(TextureOrBufferNodeReference& data, const std::string& path)
+    bool Visit(TextureOrBufferNodeReference& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
 
-    bool Visit(TextureNodeReference& data, const std::string& path)
+    bool Visit(TextureNodeReference& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
 
-    bool Visit(BufferNodeReference& data, const std::string& path)
+    bool Visit(BufferNodeReference& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
 
-    bool Visit(VariableReference& data, const std::string& path)
+    bool Visit(VariableReference& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
 
-    bool Visit(VariableReferenceNoConst& data, const std::string& path)
+    bool Visit(VariableReferenceNoConst& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
 
-    bool Visit(VariableReferenceConstOnly& data, const std::string& path)
+    bool Visit(VariableReferenceConstOnly& data, const VisitPath& path)
     {
         Sanitize(data.name);
         return true;
     }
 
-    bool Visit(NodePinReference& data, const std::string& path)
+    bool Visit(NodePinReference& data, const VisitPath& path)
     {
         Sanitize(data.node);
         Sanitize(data.pin);
         return true;
     }
 
-    bool Visit(NodePinReferenceOptional& data, const std::string& path)
+    bool Visit(NodePinReferenceOptional& data, const VisitPath& path)
     {
         Sanitize(data.node);
         Sanitize(data.pin);
         return true;
     }
 
-    bool Visit(RTHitGroup& data, const std::string& path)
+    bool Visit(RTHitGroup& data, const VisitPath& path)
     {
         Sanitize(data.name, data.originalName);
         return true;
     }
 
     // remove connections which have a src pin, but no dest node
-    bool Visit(RenderGraphNode_Action_ComputeShader& data, const std::string& path)
+    bool Visit(RenderGraphNode_Action_ComputeShader& data, const VisitPath& path)
     {
         data.connections.erase(
             std::remove_if(
@@ -1943,7 +1891,7 @@ struct SanitizeVisitor
         );
         return true;
     }
-    bool Visit(RenderGraphNode_Action_RayShader& data, const std::string& path)
+    bool Visit(RenderGraphNode_Action_RayShader& data, const VisitPath& path)
     {
         data.connections.erase(
             std::remove_if(
@@ -1957,7 +1905,7 @@ struct SanitizeVisitor
                     );
         return true;
     }
-    bool Visit(RenderGraphNode_Action_DrawCall& data, const std::string& path)
+    bool Visit(RenderGraphNode_Action_DrawCall& data, const VisitPath& path)
     {
         data.connections.erase(
             std::remove_if(
@@ -1971,7 +1919,7 @@ struct SanitizeVisitor
         );
         return true;
     }
-    bool Visit(RenderGraphNode_Action_SubGraph& data, const std::string& path)
+    bool Visit(RenderGraphNode_Action_SubGraph& data, const VisitPath& path)
     {
         data.connections.erase(
             std::remove_if(
@@ -1985,7 +1933,7 @@ struct SanitizeVisitor
         );
         return true;
     }
-    bool Visit(RenderGraphNode_Action_Barrier& data, const std::string& path)
+    bool Visit(RenderGraphNode_Action_Barrier& data, const VisitPath& path)
     {
         data.connections.erase(
             std::remove_if(
@@ -2005,6 +1953,13 @@ struct SanitizeVisitor
 
 struct ShaderAssertsVisitor
 {
+    // Adds a struct, and a buffer node for each shader with asserts, and plugs it into the shader and the node.
+    // The assert calls in the shaders the node uses are replaced with token replacements.
+    static constexpr VisitorAccess c_access = VisitorAccess()
+        .Reads(VisitorData_Nodes | VisitorData_ShaderReferences)
+        .ReadsAnywhere(VisitorData_Names | VisitorData_Structs | VisitorData_ShaderFiles | VisitorData_ShaderResources)
+        .WritesAnywhere(VisitorData_Names | VisitorData_Nodes | VisitorData_Structs | VisitorData_ShaderFiles | VisitorData_ShaderResources | VisitorData_Connections);
+
     constexpr static std::string_view AssertUavSuffix = "__GigiAssertUAV";
 
     ShaderAssertsVisitor(RenderGraph& renderGraph_)
@@ -2012,12 +1967,12 @@ struct ShaderAssertsVisitor
     { }
 
     template <typename TDATA>
-    bool Visit(TDATA& data, const std::string& path)
+    bool Visit(TDATA& data, const VisitPath& path)
     {
         return true;
     }
 
-    bool Visit(RenderGraphNode& node, const std::string& path)
+    bool Visit(RenderGraphNode& node, const VisitPath& path)
     {
         std::vector<Shader*> shadersWithAsserts;
         std::string actionNodeName;
@@ -2065,7 +2020,7 @@ struct ShaderAssertsVisitor
         return true;
     }
 
-    bool ProcessNodeShader(Shader* shader, std::vector<Shader*>& shaderWithAssert, const std::string& path)
+    bool ProcessNodeShader(Shader* shader, std::vector<Shader*>& shaderWithAssert, const VisitPath& path)
     {
         if (shader)
         {
@@ -2092,7 +2047,7 @@ struct ShaderAssertsVisitor
         std::unordered_map<std::string, std::string> uniqueAssertsCalls;
     };
 
-    ShaderProcessResult ProcessShader(Shader& shader, const std::string& path)
+    ShaderProcessResult ProcessShader(Shader& shader, const VisitPath& path)
     {
         auto [isValid, uniqueAssertsCalls] = ParseShader(shader, path);
         if (!isValid)
@@ -2105,14 +2060,14 @@ struct ShaderAssertsVisitor
         return { true, hasAsserts };
     }
 
-    ShaderParsingResult ParseShader(Shader& shader, const std::string& path)
+    ShaderParsingResult ParseShader(Shader& shader, const VisitPath& path)
     {
         std::string fileName = (std::filesystem::path(renderGraph.baseDirectory) / shader.fileName).string();
 
         std::vector<unsigned char> fileContents;
         if (!LoadFile(fileName, fileContents))
         {
-            Assert(false, "Could not load file %s\nIn %s\n", fileName.c_str(), path.c_str());
+            Assert(false, "Could not load file %s\nIn %s\n", fileName.c_str(), path.ToString().c_str());
             return {};
         }
         fileContents.push_back(0);
@@ -2412,17 +2367,24 @@ struct ShaderAssertsVisitor
 
 struct ShaderDataVisitor
 {
+    // Adds nodes for constant buffers and loaded textures, and connects them to every node that uses the shader, by name
+    static constexpr VisitorAccess c_access = VisitorAccess()
+        .Reads(VisitorData_Names | VisitorData_ShaderFiles | VisitorData_ShaderResources)
+        .Writes(VisitorData_ShaderResources)
+        .ReadsAnywhere(VisitorData_Names | VisitorData_Nodes)
+        .WritesAnywhere(VisitorData_Names | VisitorData_Nodes | VisitorData_Structs | VisitorData_Connections | VisitorData_FileCopies);
+
     ShaderDataVisitor(RenderGraph& renderGraph_)
         : renderGraph(renderGraph_)
     { }
 
     template <typename TDATA>
-    bool Visit(TDATA& data, const std::string& path)
+    bool Visit(TDATA& data, const VisitPath& path)
     {
         return true;
     }
 
-    bool HookupVariables(Shader& shader, const std::string& path)
+    bool HookupVariables(Shader& shader, const VisitPath& path)
     {
         if (!shader.copyFile)
             return true;
@@ -2433,7 +2395,7 @@ struct ShaderDataVisitor
         std::vector<unsigned char> fileContents;
         if (!LoadFile(fileName, fileContents))
         {
-            Assert(false, "Could not load file %s\nIn %s\n", fileName.c_str(), path.c_str());
+            Assert(false, "Could not load file %s\nIn %s\n", fileName.c_str(), path.ToString().c_str());
             return false;
         }
         fileContents.push_back(0);
@@ -2465,7 +2427,7 @@ struct ShaderDataVisitor
                     int variableIndex = GetScopedVariableIndex(renderGraph, (shader.scope + variableName).c_str());
                     if (variableIndex == -1)
                     {
-                        Assert(false, "Could not find variable \"%s\" referenced in shader file \"%s\".\nIn %s\n", variableName.c_str(), shader.fileName.c_str(), path.c_str());
+                        Assert(false, "Could not find variable \"%s\" referenced in shader file \"%s\".\nIn %s\n", variableName.c_str(), shader.fileName.c_str(), path.ToString().c_str());
                         return;
                     }
 
@@ -2497,7 +2459,7 @@ struct ShaderDataVisitor
                     std::string fileName(fileNameBegin, fileNameEnd);
                     if (fileName.empty())
                     {
-                        Assert(false, "filename is empty.\nIn %s\n", path.c_str());
+                        Assert(false, "filename is empty.\nIn %s\n", path.ToString().c_str());
                         return;
                     }
 
@@ -2535,7 +2497,7 @@ struct ShaderDataVisitor
                     TextureFormat textureFormat;
                     if (!StringToEnum(textureFormatStr.c_str(), textureFormat))
                     {
-                        Assert(false, "Unknown texture format: %s.\nIn %s\n", textureFormatStr.c_str(), path.c_str());
+                        Assert(false, "Unknown texture format: %s.\nIn %s\n", textureFormatStr.c_str(), path.ToString().c_str());
                         return;
                     }
 
@@ -2543,7 +2505,7 @@ struct ShaderDataVisitor
                     TextureViewType viewType;
                     if (!StringToEnum(viewTypeStr.c_str(), viewType))
                     {
-                        Assert(false, "Unknown texture view type: %s.\nIn %s\n", viewTypeStr.c_str(), path.c_str());
+                        Assert(false, "Unknown texture view type: %s.\nIn %s\n", viewTypeStr.c_str(), path.ToString().c_str());
                         return;
                     }
 
@@ -2559,7 +2521,7 @@ struct ShaderDataVisitor
                     }
                     else
                     {
-                        Assert(false, "Couldn't read loadFileNameAsSRGB: %s.\nIn %s\n", loadFileNameAsSRGBStr.c_str(), path.c_str());
+                        Assert(false, "Couldn't read loadFileNameAsSRGB: %s.\nIn %s\n", loadFileNameAsSRGBStr.c_str(), path.ToString().c_str());
                         return;
                     }
 
@@ -2577,7 +2539,7 @@ struct ShaderDataVisitor
                         }
                         else
                         {
-                            Assert(false, "Couldn't read makeMips: %s.\nIn %s\n", makeMipsStr.c_str(), path.c_str());
+                            Assert(false, "Couldn't read makeMips: %s.\nIn %s\n", makeMipsStr.c_str(), path.ToString().c_str());
                             return;
                         }
                     }
@@ -2739,7 +2701,7 @@ struct ShaderDataVisitor
             for (const std::string& variableName : variablesAccessed)
             {
                 int variableIndex = GetVariableIndex(renderGraph, variableName.c_str());
-                Assert(variableIndex >= 0, "Could not find variable %s.\nIn %s\n", variableName.c_str(), path.c_str());
+                Assert(variableIndex >= 0, "Could not find variable %s.\nIn %s\n", variableName.c_str(), path.ToString().c_str());
                 const Variable& variable = renderGraph.variables[variableIndex];
 
                 // automatically pad constant buffers
@@ -2772,7 +2734,7 @@ struct ShaderDataVisitor
                         }
                         default:
                         {
-                            Assert(false, "error while calculating padding.\nIn %s\n", path.c_str());
+                            Assert(false, "error while calculating padding.\nIn %s\n", path.ToString().c_str());
                         }
                     }
                     padding.comment = "Padding";
@@ -2818,7 +2780,7 @@ struct ShaderDataVisitor
                     }
                     default:
                     {
-                        Assert(false, "error while calculating terminating padding.\nIn %s\n", path.c_str());
+                        Assert(false, "error while calculating terminating padding.\nIn %s\n", path.ToString().c_str());
                     }
                 }
                 padding.comment = "Padding";
@@ -2898,7 +2860,7 @@ struct ShaderDataVisitor
         return true;
     }
 
-    bool CheckForUnusedResources(Shader& shader, const std::string& path)
+    bool CheckForUnusedResources(Shader& shader, const VisitPath& path)
     {
         if (shader.resources.size() == 0)
             return true;
@@ -2911,7 +2873,7 @@ struct ShaderDataVisitor
         std::vector<unsigned char> fileContents_;
         if (!LoadFile(fileName, fileContents_))
         {
-            Assert(false, "Could not load file %s.\nIn %s\n", fileName.c_str(), path.c_str());
+            Assert(false, "Could not load file %s.\nIn %s\n", fileName.c_str(), path.ToString().c_str());
             return false;
         }
         fileContents_.push_back(0);
@@ -2941,7 +2903,7 @@ struct ShaderDataVisitor
         return true;
     }
 
-    bool Visit(Shader& shader, const std::string& path)
+    bool Visit(Shader& shader, const VisitPath& path)
     {
         shader.entryPointW = ToWideString(shader.entryPoint.c_str());
 
@@ -2971,12 +2933,12 @@ struct ResolveBackendRestrictions
     { }
 
     template <typename TDATA>
-    bool Visit(TDATA& data, const std::string& path)
+    bool Visit(TDATA& data, const VisitPath& path)
     {
         return true;
     }
 
-    bool Visit(BackendRestriction& data, const std::string& path)
+    bool Visit(BackendRestriction& data, const VisitPath& path)
     {
         if (data.backends.empty())
         {
@@ -0,0 +1,19 @@
+///////////////////////////////////////////////////////////////////////////////
+//         Gigi Rapid Graphics Prototyping and Code Generation Suite         //
+//        Copyright (c) 2024 Electronic Arts Inc. All rights reserved.       //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// clang-format off
+#include "external/df_serialize/MakeBinaryReadHeader.h"
+#include "Schemas.h"
+#include "external/df_serialize/MakeBinaryReadFooter.h"
+
+#include "external/df_serialize/MakeBinaryWriteHeader.h"
+#include "Schemas.h"
+#include "external/df_serialize/MakeBinaryWriteFooter.h"
+
+#include "external/df_serialize/MakeBinaryLayoutHash.h"
+#include "Schemas.h"
+// clang-format on
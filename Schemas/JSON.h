@@ -15,35 +15,60 @@
 
 #include "external/df_serialize/MakeJSONReadHeader.h"
 #include "Schemas.h"
+#include "external/df_serialize/MakeJSONSAXReadHeader.h"
+#include "Schemas.h"
 #include "external/df_serialize/MakeJSONReadFooter.h"
 // clang-format on
 
 // JSON Read Override functions
 
-template <typename T>
-JSONReadOverrideResult JSONReadOverride(RenderGraph& value, T& document)
+inline bool JSONReadSchema(RenderGraph& value, const rapidjson::Value& schema)
 {
-    if (!document.HasMember("$schema") || !document["$schema"].IsString())
-        return JSONReadOverrideResult::Error;
+    if (!schema.IsString())
+        return false;
 
-    JSONRead(value.schema, document["$schema"]);
+    JSONRead(value.schema, schema);
 
     // Before 0.91b, this is how the version was read in. We can get rid of this code when the upgrade path is no longer needed.
     size_t versionStart = value.schema.find("gigischema_", 0);
     if (versionStart == std::string::npos)
-        return JSONReadOverrideResult::Continue;
+        return true;
     versionStart += 11;
 
     size_t versionEnd = value.schema.find(".json", versionStart);
     if (versionEnd == std::string::npos)
-        return JSONReadOverrideResult::Continue;
+        return true;
 
     value.version = value.schema.substr(versionStart, versionEnd - versionStart);
     value.schema = "gigischema.json";
 
+    return true;
+}
+
+template <typename T>
+JSONReadOverrideResult JSONReadOverride(RenderGraph& value, T& document)
+{
+    if (!document.HasMember("$schema") || !JSONReadSchema(value, document["$schema"]))
+        return JSONReadOverrideResult::Error;
+
     return JSONReadOverrideResult::Continue;
 }
 
+// The streaming reader reads "$schema" the same way, as long as it's the first key, which it is in files Gigi writes.
+// Otherwise the DOM reads the file, so that the version from "$schema" is always set before the "version" field is read, like above.
+template <typename READER>
+JSONSAXOverrideResult JSONSAXReadOverride(RenderGraph& value, const char* key, int keyIndex, READER& reader)
+{
+    if (keyIndex > 0)
+        return JSONSAXOverrideResult::Continue;
+
+    if (key == nullptr || strcmp(key, "$schema") != 0)
+        return JSONSAXOverrideResult::UseDOM;
+
+    reader.template PushDOMValue<RenderGraph, &JSONReadSchema>(value, nullptr);
+    return JSONSAXOverrideResult::Finished;
+}
+
 // clang-format off
 #include "external/df_serialize/MakeEqualityTests.h"
 #include "Schemas.h"
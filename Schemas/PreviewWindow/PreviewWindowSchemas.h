@@ -56,6 +56,12 @@ ENUM_BEGIN(GGUserFile_ImportedTexture_BinaryType, "The basic data type within th
 	ENUM_ITEM(Count, "")
 ENUM_END()
 
+ENUM_BEGIN(GGUserFile_ImportedBuffer_MeshLayout, "How a mesh file (.obj, .fbx) is loaded into a buffer")
+	ENUM_ITEM(Flattened, "Three vertices per triangle, with no vertices shared")
+	ENUM_ITEM(IndexedVertices, "Identical vertices welded together. Draw with an index buffer that loads the same file as Indices")
+	ENUM_ITEM(Indices, "The index buffer for IndexedVertices. The buffer type should be Uint, or Uint_16 if the mesh has no more than 65536 unique vertices")
+ENUM_END()
+
 ENUM_BEGIN(GGUserFile_TLASBuildFlags, "D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE etc")
 	ENUM_ITEM(None, "")
 	ENUM_ITEM(AllowUpdate, "")
@@ -81,6 +87,7 @@ STRUCT_END()
 STRUCT_BEGIN(GGUserFile_ImportedBuffer, "The details of an imported buffer")
 	STRUCT_FIELD(std::string, fileName, "", "The file loaded", 0)
 	STRUCT_FIELD(bool, CSVHeaderRow, true, "If reading a CSV, and this is true, it will skip everything up to the first newline, to ignore a header row.", 0)
+	STRUCT_FIELD(GGUserFile_ImportedBuffer_MeshLayout, meshLayout, GGUserFile_ImportedBuffer_MeshLayout::Flattened, "If reading a mesh, whether to load flattened vertices, welded vertices, or the indices of the welded vertices.", 0)
 	STRUCT_FIELD(int, structIndex, -1, "the index of the struct if a structured buffer", 0)
 	STRUCT_FIELD(DataFieldType, type, DataFieldType::Count, "The data field type, if not a structured buffer", 0)
 	STRUCT_FIELD(int, count, 1, "how many items are stored", 0)
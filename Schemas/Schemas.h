@@ -71,9 +71,27 @@ STRUCT_BEGIN(BackendSettings, "Backend settings")
     STRUCT_FIELD(BackendSettings_Common, common, {}, "", SCHEMA_FLAG_UI_COLLAPSABLE)
 STRUCT_END()
 
+ENUM_BEGIN(FlattenScheduler, "How the compiler chooses the order that nodes execute in")
+    ENUM_ITEM(Default, "Nodes execute in the order they appear in the render graph, as dependencies allow.")
+    ENUM_ITEM(Auto, "Uses Exhaustive for graphs with few action nodes, and Beam for larger graphs.")
+    ENUM_ITEM(Greedy, "At each step, the ready node that adds the fewest resource transitions is chosen.")
+    ENUM_ITEM(Beam, "Keeps the best scoring partial orderings at each step, and expands those.")
+    ENUM_ITEM(Exhaustive, "Branch and bound over every valid ordering. Keeps the best ordering found so far if the budget runs out.")
+ENUM_END()
+
 STRUCT_BEGIN(BuildSettings, "Backend settings")
     STRUCT_DYNAMIC_ARRAY(GigiCompileWarning, disableWarnings, "Warnings listed here will be suppressed", 0)
 
+    STRUCT_FIELD(FlattenScheduler, scheduler, FlattenScheduler::Default, "How the compiler chooses the order that nodes execute in", 0)
+    STRUCT_FIELD(int, schedulerExhaustiveMaxNodes, 12, "Auto uses Exhaustive when there are at most this many action nodes", 0)
+    STRUCT_FIELD(int, schedulerBeamWidth, 16, "The number of partial orderings Beam keeps at each step", 0)
+    STRUCT_FIELD(int, schedulerBudgetMS, 2000, "The time budget in milliseconds for Beam and Exhaustive. 0 means no time limit.", 0)
+    STRUCT_FIELD(int, schedulerBudgetIterations, 1000000, "The number of partial orderings Beam and Exhaustive may consider. 0 means no limit.", 0)
+    STRUCT_FIELD(int, schedulerMemoMaxEntries, 1000000, "The number of partial orderings Exhaustive may remember the best score of, to prune orderings that can't beat it. 0 means no limit.", 0)
+    STRUCT_FIELD(bool, splitBarriers, false, "If true, resource transitions begin right after the last step that used the resource, and end right before the next step that uses it, as split barriers.", 0)
+    STRUCT_FIELD(bool, hazardDependencies, false, "If true, node ordering comes from resource hazards (read after write, write after read, write after write) instead of pin wiring. Nodes that only read a resource may then be reordered. Barrier nodes are still honored.", 0)
+    STRUCT_FIELD(bool, showVisitorPassTimings, false, "If true, the compiler reports how long each traversal of its visitor passes took.", 0)
+
     // Only used by editor
     STRUCT_FIELD(std::string, outDX12, "out/dx12/", "The output location for DX12", 0)
 
@@ -84,14 +102,53 @@ STRUCT_BEGIN(ConfigFromBackend, "Frontend configuration set by the backend.")
     STRUCT_FIELD(bool, RTSceneTakesSRVSlot, true, "If true, RT scenes will take an SRV register slot.", 0)
 STRUCT_END()
 
+ENUM_BEGIN(ResourceTransitionSplit, "Whether a resource transition is a whole transition, or half of a split barrier")
+    ENUM_ITEM(None, "A whole transition")
+    ENUM_ITEM(Begin, "The start of a split barrier. The resource is not used again until the matching End.")
+    ENUM_ITEM(End, "The end of a split barrier which began at an earlier step")
+ENUM_END()
+
 STRUCT_BEGIN(ResourceTransition, "A single resource transition")
     STRUCT_FIELD(int, nodeIndex, -1, "The node for the resource being transitioned.", 0)
     STRUCT_FIELD(ShaderResourceAccessType, oldState, ShaderResourceAccessType::Count, "The previous state", 0)
     STRUCT_FIELD(ShaderResourceAccessType, newState, ShaderResourceAccessType::Count, "The next state", 0)
+    STRUCT_FIELD(ResourceTransitionSplit, split, ResourceTransitionSplit::None, "Whether this is a whole transition, or half of a split barrier", 0)
 STRUCT_END()
 
 STRUCT_BEGIN(ResourceTransitions, "A list of resource transitions")
-    STRUCT_DYNAMIC_ARRAY(ResourceTransition, transitions, "A list of resource transitions", 0)
+    STRUCT_DYNAMIC_ARRAY(ResourceTransition, transitions, "A list of resource transitions, to be issued together as one batch. Sorted by nodeIndex.", 0)
+STRUCT_END()
+
+ENUM_BEGIN(ResourceHeapClass, "Resources may only share memory with resources of the same heap class, since not all hardware can mix them in one heap")
+    ENUM_ITEM(Buffer, "Buffers")
+    ENUM_ITEM(Texture, "Textures which are not used as render targets or depth targets")
+    ENUM_ITEM(RenderTarget, "Textures which are used as render targets or depth targets")
+    ENUM_ITEM(Count, "")
+ENUM_END()
+
+STRUCT_BEGIN(ResourceLifetime, "The steps of the flattened render graph that a transient resource is used in")
+    STRUCT_FIELD(int, nodeIndex, -1, "The resource node.", 0)
+    STRUCT_FIELD(int, firstStep, -1, "The first step in flattenedNodeList that uses the resource.", 0)
+    STRUCT_FIELD(int, lastStep, -1, "The last step in flattenedNodeList that uses the resource.", 0)
+    STRUCT_FIELD(ResourceHeapClass, heapClass, ResourceHeapClass::Count, "The heap class of the resource.", 0)
+    STRUCT_FIELD(int, aliasGroup, -1, "The index of the alias group the resource is in.", 0)
+    STRUCT_FIELD(size_t, sizeInBytes, 0, "The size of the resource in a heap, rounded up to its alignment. 0 if it isn't known at compile time, because it depends on a variable or another resource.", SCHEMA_FLAG_NO_SERIALIZE)
+    STRUCT_FIELD(size_t, alignment, 0, "The placement alignment of the resource in a heap.", SCHEMA_FLAG_NO_SERIALIZE)
+STRUCT_END()
+
+STRUCT_BEGIN(ResourceAliasGroup, "Resources whose lifetimes don't overlap. They can all be placed at the same offset in a heap, in a region as large as the largest of them.")
+    STRUCT_FIELD(ResourceHeapClass, heapClass, ResourceHeapClass::Count, "The heap class of every resource in the group.", 0)
+    STRUCT_DYNAMIC_ARRAY(int, nodeIndices, "The resource nodes in the group, in the order they are used.", 0)
+    STRUCT_FIELD(size_t, sizeInBytes, 0, "The size of the largest resource in the group. 0 if the size of any of them isn't known.", SCHEMA_FLAG_NO_SERIALIZE)
+    STRUCT_FIELD(size_t, alignment, 0, "The largest alignment of the resources in the group.", SCHEMA_FLAG_NO_SERIALIZE)
+    STRUCT_FIELD(bool, placed, false, "True if the group has a heap offset, which needs the size of every resource in the group to be known.", SCHEMA_FLAG_NO_SERIALIZE)
+    STRUCT_FIELD(size_t, heapOffset, 0, "Where every resource in the group goes in the heap for its heap class, if placed is true.", SCHEMA_FLAG_NO_SERIALIZE)
+STRUCT_END()
+
+STRUCT_BEGIN(ResourceAliasingPlan, "Which transient resources can share memory")
+    STRUCT_DYNAMIC_ARRAY(ResourceLifetime, lifetimes, "The lifetime of each resource which may be aliased.", 0)
+    STRUCT_DYNAMIC_ARRAY(ResourceAliasGroup, groups, "The alias groups. Resources in a group don't overlap in lifetime.", 0)
+    STRUCT_STATIC_ARRAY(size_t, heapSizes, 3, { 0 COMMA 0 COMMA 0 }, "The size of the heap for each ResourceHeapClass, holding every placed group of that class.", SCHEMA_FLAG_NO_SERIALIZE)
 STRUCT_END()
 
 ENUM_BEGIN(FileCopyType, "")
@@ -159,6 +216,21 @@ STRUCT_BEGIN(VariableReplacement, "When subgraph variables are replaced by paren
     STRUCT_FIELD(std::string, destName, "", "", 0)
 STRUCT_END()
 
+STRUCT_BEGIN(SymbolIndex, "A hash index of names, so that finding something by name doesn't have to search a list.")
+    STRUCT_FIELD(std::unordered_map<std::string COMMA int>, indices, {}, "Lower case name to the index of the first item with that name.", SCHEMA_FLAG_NO_UI | SCHEMA_FLAG_NO_SERIALIZE)
+    STRUCT_FIELD(int, count, -1, "How many items there were when the index was built. -1 means it needs to be built.", SCHEMA_FLAG_NO_UI | SCHEMA_FLAG_NO_SERIALIZE)
+    STRUCT_FIELD(bool, hasDuplicates, false, "True if more than one item has the same name. Renames rebuild the index then, instead of updating it.", SCHEMA_FLAG_NO_UI | SCHEMA_FLAG_NO_SERIALIZE)
+STRUCT_END()
+
+STRUCT_BEGIN(SymbolTable, "Hash indices of the names in a render graph. Built on demand and kept up to date by the functions in RenderGraph/SymbolTable.h.")
+    STRUCT_FIELD(SymbolIndex, variables, {}, "Variables by name.", SCHEMA_FLAG_NO_UI | SCHEMA_FLAG_NO_SERIALIZE)
+    STRUCT_FIELD(SymbolIndex, scopedVariables, {}, "Variables by scope and original name.", SCHEMA_FLAG_NO_UI | SCHEMA_FLAG_NO_SERIALIZE)
+    STRUCT_FIELD(SymbolIndex, variableReplacements, {}, "Variable replacements by source scope and source name.", SCHEMA_FLAG_NO_UI | SCHEMA_FLAG_NO_SERIALIZE)
+    STRUCT_FIELD(SymbolIndex, nodes, {}, "Nodes by name.", SCHEMA_FLAG_NO_UI | SCHEMA_FLAG_NO_SERIALIZE)
+    STRUCT_FIELD(SymbolIndex, shaders, {}, "Shaders by name.", SCHEMA_FLAG_NO_UI | SCHEMA_FLAG_NO_SERIALIZE)
+    STRUCT_FIELD(SymbolIndex, structs, {}, "Structs by name.", SCHEMA_FLAG_NO_UI | SCHEMA_FLAG_NO_SERIALIZE)
+STRUCT_END()
+
 STRUCT_BEGIN(RenderGraph, "The root type of the render graph")
     STRUCT_FIELD(std::string, name, "Unnamed", "The name of the render graph.", 0)
     STRUCT_FIELD(std::string, comment, "", "Put author information, links, etc here.", SCHEMA_FLAG_UI_MULTILINETEXT)
@@ -180,7 +252,9 @@ STRUCT_BEGIN(RenderGraph, "The root type of the render graph")
     STRUCT_FIELD(std::string, baseDirectory, "", "The relative location of the render graph file.", SCHEMA_FLAG_NO_SERIALIZE)
     STRUCT_FIELD(std::string, outputDirectory, "", "Where the render graph output should go (this field used by the compiler).", SCHEMA_FLAG_NO_SERIALIZE)
     STRUCT_FIELD(std::vector<int>, flattenedNodeList, {}, "The flattened list of nodes, in the order they should be executed in. Calculated before being given to back end code.", SCHEMA_FLAG_NO_SERIALIZE)
+    STRUCT_FIELD(std::vector<int>, flattenedNodeLevels, {}, "The parallelism level of each node in flattenedNodeList. Nodes at the same level don't depend on each other. Calculated before being given to back end code.", SCHEMA_FLAG_NO_SERIALIZE)
     STRUCT_FIELD(std::vector<ResourceTransitions>, transitions, {}, "The resource transitions that want to happen before each node executes. Calculated before being given to back end code.", SCHEMA_FLAG_NO_SERIALIZE)
+    STRUCT_FIELD(ResourceAliasingPlan, aliasingPlan, {}, "Which transient resources can share memory, based on when they are used in flattenedNodeList. Calculated before being given to back end code.", SCHEMA_FLAG_NO_SERIALIZE)
     STRUCT_FIELD(Backend, backend, Backend::DX12, "The backend currently being ran", SCHEMA_FLAG_NO_SERIALIZE)
 
     STRUCT_FIELD(ConfigFromBackend, configFromBackend, {}, "Information communicated to the front end, by the back end.", SCHEMA_FLAG_NO_SERIALIZE)
@@ -202,4 +276,6 @@ STRUCT_BEGIN(RenderGraph, "The root type of the render graph")
 
     STRUCT_FIELD(std::vector<std::string>, assertsFormatStrings, {}, "The unique formatting strings of the asserts messages", SCHEMA_FLAG_NO_SERIALIZE)
     STRUCT_FIELD(std::unordered_set<std::string>, firedAssertsIdentifiers, {}, "The identifiers of the fired asserts to ignore them later on", SCHEMA_FLAG_NO_SERIALIZE)
+
+    STRUCT_FIELD(SymbolTable, symbols, {}, "Name lookups for variables, nodes, shaders and structs. Use the functions in RenderGraph/SymbolTable.h rather than this directly.", SCHEMA_FLAG_NO_UI | SCHEMA_FLAG_NO_SERIALIZE)
 STRUCT_END()
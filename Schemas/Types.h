@@ -25,22 +25,25 @@ inline const char* EnumToString(_NAME value) \
 #include "../external/df_serialize/_fillunsetdefines.h"
 #include "schemas.h"
 
-// StringToEnum functions
+// StringToEnum functions. Case insensitive, using a hash table of the labels made at compile time.
 #include "external/df_serialize/_common.h"
 #define ENUM_BEGIN(_NAME, _DESCRIPTION) \
 inline bool StringToEnum(const char* value, _NAME& out) \
 { \
-    typedef _NAME TheEnum;
+    typedef _NAME TheEnum; \
+    static constexpr const char* c_labels[] = {
 
 #define ENUM_ITEM(_NAME, _DESCRIPTION) \
-        if(!_stricmp(value, #_NAME)) \
-        { \
-            out = TheEnum::_NAME; \
-            return true; \
-        }
+        #_NAME,
 
 #define ENUM_END() \
-    return false; \
+    }; \
+    static constexpr auto c_table = DFS_MakeEnumStringTable(c_labels); \
+    int index = c_table.Find(value); \
+    if (index == -1) \
+        return false; \
+    out = (TheEnum)index; \
+    return true; \
 }
 #include "../external/df_serialize/_fillunsetdefines.h"
 #include "schemas.h"
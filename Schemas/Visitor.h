@@ -9,10 +9,159 @@
 // passing the render graph and data structure for each type visited.
 
 #include "external/df_serialize/_common.h"
+#include <string>
+#include <tuple>
+#include <utility>
+
+// The path to the data being visited, like renderGraph.nodes[2].name, for error messages.
+// Each level of the traversal makes one on the stack which points to its parent, so visiting doesn't allocate.
+// The string is only made when asked for, with ToString().
+class VisitPath
+{
+public:
+    VisitPath(const char* root)
+        : m_name(root)
+    {
+    }
+
+    VisitPath(const VisitPath& parent, const char* field, int index = -1)
+        : m_parent(&parent)
+        , m_name(field)
+        , m_index(index)
+    {
+    }
+
+    // Paths point at their parent on the stack, so they can't be copied and kept around. Keep ToString() instead.
+    VisitPath(const VisitPath&) = delete;
+    VisitPath& operator=(const VisitPath&) = delete;
+
+    std::string ToString() const
+    {
+        std::string ret;
+        if (m_parent)
+        {
+            ret = m_parent->ToString();
+            ret += ".";
+        }
+        ret += m_name;
+        if (m_index >= 0)
+        {
+            char indexBuffer[32];
+            sprintf_s(indexBuffer, "[%i]", m_index);
+            ret += indexBuffer;
+        }
+        return ret;
+    }
+
+private:
+    const VisitPath* m_parent = nullptr;
+    const char* m_name = "";
+    int m_index = -1;
+};
+
+// What a visitor reads and writes, as masks of the kinds of data the visitors define.
+// reads and writes are of the thing being visited, from its own Visit(). readsAnywhere and writesAnywhere are of anything else,
+// like a node's Visit() looking at the shader it references, or adding a new node.
+struct VisitorAccess
+{
+    unsigned int reads = 0;
+    unsigned int writes = 0;
+    unsigned int readsAnywhere = 0;
+    unsigned int writesAnywhere = 0;
+
+    constexpr VisitorAccess Reads(unsigned int data) const { VisitorAccess ret = *this; ret.reads |= data; return ret; }
+    constexpr VisitorAccess Writes(unsigned int data) const { VisitorAccess ret = *this; ret.writes |= data; return ret; }
+    constexpr VisitorAccess ReadsAnywhere(unsigned int data) const { VisitorAccess ret = *this; ret.readsAnywhere |= data; return ret; }
+    constexpr VisitorAccess WritesAnywhere(unsigned int data) const { VisitorAccess ret = *this; ret.writesAnywhere |= data; return ret; }
+};
+
+// Whether visitor B can share a traversal with visitor A, which comes before it, and see and leave the same data as if A had finished first.
+// They can't if either reads anywhere what the other writes, since it would see the other's writes to only part of the structure,
+// or if either writes anywhere what the other touches at all, since the write can land before or after the other visits the thing written.
+constexpr bool CanShareTraversal(const VisitorAccess& A, const VisitorAccess& B)
+{
+    unsigned int AWrites = A.writes | A.writesAnywhere;
+    unsigned int BWrites = B.writes | B.writesAnywhere;
+    return
+        (AWrites & B.readsAnywhere) == 0 &&
+        (BWrites & A.readsAnywhere) == 0 &&
+        (A.writesAnywhere & (B.reads | BWrites)) == 0 &&
+        (B.writesAnywhere & (A.reads | AWrites)) == 0;
+}
+
+// Visitors declare what they access with a static c_access. Visitors [begin, VisitorGroupEnd(begin)) can all share one traversal,
+// and the visitor at VisitorGroupEnd(begin) can't share it with at least one of them.
+template <typename... TVISITORS>
+constexpr size_t VisitorGroupEnd(size_t begin)
+{
+    const VisitorAccess accesses[] = { TVISITORS::c_access... };
+    size_t end = begin + 1;
+    for (; end < sizeof...(TVISITORS); ++end)
+    {
+        for (size_t index = begin; index < end; ++index)
+        {
+            if (!CanShareTraversal(accesses[index], accesses[end]))
+                return end;
+        }
+    }
+    return end;
+}
+
+// Calls several visitors on each thing visited, in the order given, so that they can share one traversal.
+// A visitor sees what the visitors before it did to the current thing, and to everything visited before it, but not to anything after it.
+// Visitors which need an earlier visitor to have finished with the whole structure can't share a traversal with it, see CanShareTraversal().
+// When a visitor fails, it and the visitors after it aren't called again, but the ones before it keep visiting, so that FailedIndex()
+// is the visitor that would have failed first if each visitor had made its own traversal. A visitor that fails later in the traversal
+// may still have reported an error of its own by then, and that is reported before the error of the visitor that failed first.
+template <typename... TVISITORS>
+class FusedVisitor
+{
+public:
+    FusedVisitor(TVISITORS&... visitors)
+        : m_visitors(visitors...)
+    {
+        static_assert(VisitorGroupEnd<TVISITORS...>(0) == sizeof...(TVISITORS), "These visitors can't share a traversal, see CanShareTraversal()");
+    }
+
+    // Returns false to stop the traversal once every visitor has failed
+    template <typename TDATA>
+    bool Visit(TDATA& data, const VisitPath& path)
+    {
+        VisitEach(data, path, std::index_sequence_for<TVISITORS...>());
+        return m_activeCount > 0;
+    }
+
+    // The first of the visitors to fail, or -1 if none did
+    int FailedIndex() const
+    {
+        return (m_activeCount < (int)sizeof...(TVISITORS)) ? m_activeCount : -1;
+    }
+
+private:
+    template <typename TDATA, size_t... INDEX>
+    void VisitEach(TDATA& data, const VisitPath& path, std::index_sequence<INDEX...>)
+    {
+        // A failure makes m_activeCount smaller, so the visitors after a failed one aren't called
+        ((((int)INDEX < m_activeCount && !std::get<INDEX>(m_visitors).Visit(data, path)) ? (void)(m_activeCount = (int)INDEX) : (void)0), ...);
+    }
+
+    std::tuple<TVISITORS&...> m_visitors;
+    int m_activeCount = (int)sizeof...(TVISITORS);
+};
+
+// Visits data with visitors [BEGIN, BEGIN + sizeof...(INDEX)) of those given, sharing one traversal.
+// Returns the index of the one that failed first, out of all of those given, or -1 if none did.
+template <size_t BEGIN, typename TDATA, typename... TVISITORS, size_t... INDEX>
+int VisitFusedGroup(TDATA& data, std::tuple<TVISITORS&...>& visitors, const char* rootName, std::index_sequence<INDEX...>)
+{
+    FusedVisitor<std::tuple_element_t<BEGIN + INDEX, std::tuple<TVISITORS...>>...> visitor(std::get<BEGIN + INDEX>(visitors)...);
+    Visit(data, visitor, rootName);
+    return (visitor.FailedIndex() == -1) ? -1 : (int)BEGIN + visitor.FailedIndex();
+}
 
 // catch all for pods
 template <typename TDATA, typename TVISITOR>
-bool Visit(TDATA& data, TVISITOR& visitor, const std::string& path)
+bool Visit(TDATA& data, TVISITOR& visitor, const VisitPath& path)
 {
     return visitor.Visit(data, path);
 }
@@ -21,14 +170,14 @@ bool Visit(TDATA& data, TVISITOR& visitor, const std::string& path)
 
 #define STRUCT_BEGIN(_NAME, _DESCRIPTION) \
     template <typename TVISITOR> \
-    bool Visit(_NAME& data, TVISITOR& visitor, const std::string& path) \
+    bool Visit(_NAME& data, TVISITOR& visitor, const VisitPath& path) \
     { \
         if(!visitor.Visit(data, path)) \
             return false;
 
 #define STRUCT_INHERIT_BEGIN(_NAME, _BASE, _DESCRIPTION) \
     template <typename TVISITOR> \
-    bool Visit(_NAME& data, TVISITOR& visitor, const std::string& path) \
+    bool Visit(_NAME& data, TVISITOR& visitor, const VisitPath& path) \
     { \
         if (!Visit(*(_BASE*)&data, visitor, path)) \
             return false; \
@@ -36,30 +185,26 @@ bool Visit(TDATA& data, TVISITOR& visitor, const std::string& path)
             return false;
 
 #define STRUCT_FIELD(_TYPE, _NAME, _DEFAULT, _DESCRIPTION, _FLAGS) \
-        if(!Visit(data._NAME, visitor, path + "." #_NAME)) \
+        if(!Visit(data._NAME, visitor, VisitPath(path, #_NAME))) \
             return false;
 
 #define STRUCT_CONST(_TYPE, _NAME, _DEFAULT, _DESCRIPTION, _FLAGS)
 
 #define STRUCT_DYNAMIC_ARRAY(_TYPE, _NAME, _DESCRIPTION, _FLAGS) \
-        if (!Visit(data._NAME, visitor, path + "." #_NAME)) \
+        if (!Visit(data._NAME, visitor, VisitPath(path, #_NAME))) \
             return false; \
         for(int i = 0; i < (int)TDYNAMICARRAY_SIZE(data._NAME); ++i) \
         { \
-            char pathBuffer[256]; \
-            sprintf_s(pathBuffer, "." #_NAME "[%i]", i); \
-            if (!Visit(data._NAME[i], visitor, path + pathBuffer)) \
+            if (!Visit(data._NAME[i], visitor, VisitPath(path, #_NAME, i))) \
                 return false; \
         }
 
 #define STRUCT_STATIC_ARRAY(_TYPE, _NAME, _SIZE, _DEFAULT, _DESCRIPTION, _FLAGS) \
-        if (!Visit(data._NAME, visitor, path + "." #_NAME)) \
+        if (!Visit(data._NAME, visitor, VisitPath(path, #_NAME))) \
             return false; \
         for(int i = 0; i < (int)_SIZE; ++i) \
         { \
-            char pathBuffer[256]; \
-            sprintf_s(pathBuffer, "." #_NAME "[%i]", i); \
-            if (!Visit(data._NAME[i], visitor, path + pathBuffer)) \
+            if (!Visit(data._NAME[i], visitor, VisitPath(path, #_NAME, i))) \
                 return false; \
         }
 
@@ -71,7 +216,7 @@ bool Visit(TDATA& data, TVISITOR& visitor, const std::string& path)
 
 #define VARIANT_BEGIN(_NAME, _DESCRIPTION) \
     template <typename TVISITOR> \
-    bool Visit(_NAME& data, TVISITOR& visitor, const std::string& path) \
+    bool Visit(_NAME& data, TVISITOR& visitor, const VisitPath& path) \
     { \
         typedef _NAME ThisType; \
         if (!visitor.Visit(data, path)) \
@@ -79,7 +224,7 @@ bool Visit(TDATA& data, TVISITOR& visitor, const std::string& path)
 
 #define VARIANT_TYPE(_TYPE, _NAME, _DEFAULT, _DESCRIPTION) \
     if (data._index == ThisType::c_index_##_NAME) \
-        return Visit(data._NAME, visitor, path + "." #_NAME);
+        return Visit(data._NAME, visitor, VisitPath(path, #_NAME));
 
 #define VARIANT_END() \
         return true; \
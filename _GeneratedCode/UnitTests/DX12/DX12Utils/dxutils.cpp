@@ -804,266 +804,23 @@ namespace DX12Utils
         return true;
     }
 
-    static inline double Lerp(double A, double B, double t)
-    {
-        return A * (1.0 - t) + B * t;
-    }
-
-    template <typename T>
-    std::vector<double> ConvertToDoubles(const std::vector<unsigned char>& src, double multiplier)
-    {
-        const size_t valueCount = src.size() / sizeof(T);
-
-        std::vector<double> ret(valueCount, 0);
-
-        const T* srcValues = (const T*)src.data();
-        for (size_t index = 0; index < valueCount; ++index)
-            ret[index] = multiplier * (double)srcValues[index];
-
-        return ret;
-    }
-
-    template <typename T>
-    std::vector<double> ConvertToDoubles(const unsigned char* src, size_t valueCount, double multiplier)
-    {
-        std::vector<double> ret(valueCount, 0);
-
-        const T* srcValues = (const T*)src;
-        for (size_t index = 0; index < valueCount; ++index)
-            ret[index] = multiplier * (double)srcValues[index];
-
-        return ret;
-    }
-
-    static bool ConvertToDoubles(const std::vector<unsigned char>& src, DXGI_FORMAT_Info::ChannelType type, std::vector<double>& doubles)
-    {
-        switch (type)
-        {
-            case DXGI_FORMAT_Info::ChannelType::_uint8_t: doubles = ConvertToDoubles<uint8_t>(src, 1.0 / 255.0); break;
-            case DXGI_FORMAT_Info::ChannelType::_uint16_t: doubles = ConvertToDoubles<uint16_t>(src, 1.0 / 65535.0); break;
-            case DXGI_FORMAT_Info::ChannelType::_int16_t: doubles = ConvertToDoubles<int16_t>(src, 1.0 / 32767.0); break;
-            case DXGI_FORMAT_Info::ChannelType::_uint32_t: doubles = ConvertToDoubles<uint32_t>(src, 1.0 / 4294967296.0); break;
-            //case DXGI_FORMAT_Info::ChannelType::_half: doubles = ConvertToDoubles<half>(src, 1.0); break;
-            case DXGI_FORMAT_Info::ChannelType::_float: doubles = ConvertToDoubles<float>(src, 1.0); break;
-            default: return false;
-        }
-        return true;
-    }
-
-    static bool ConvertToDoubles(const unsigned char* src, size_t valueCount, DXGI_FORMAT_Info::ChannelType type, std::vector<double>& doubles)
-    {
-        switch (type)
-        {
-            case DXGI_FORMAT_Info::ChannelType::_uint8_t: doubles = ConvertToDoubles<uint8_t>(src, valueCount, 1.0 / 255.0); break;
-            case DXGI_FORMAT_Info::ChannelType::_uint16_t: doubles = ConvertToDoubles<uint16_t>(src, valueCount, 1.0 / 65535.0); break;
-            case DXGI_FORMAT_Info::ChannelType::_int16_t: doubles = ConvertToDoubles<int16_t>(src, valueCount, 1.0 / 32767.0); break;
-            case DXGI_FORMAT_Info::ChannelType::_uint32_t: doubles = ConvertToDoubles<uint32_t>(src, valueCount, 1.0 / 4294967296.0); break;
-            //case DXGI_FORMAT_Info::ChannelType::_half: doubles = ConvertToDoubles<half>(src, valueCount, 1.0); break;
-            case DXGI_FORMAT_Info::ChannelType::_float: doubles = ConvertToDoubles<float>(src, valueCount, 1.0); break;
-            default: return false;
-        }
-        return true;
-    }
-
-    template <typename T>
-    std::vector<unsigned char> ConvertFromDoubles(const std::vector<double>& src, double multiplier, double theMin, double theMax)
-    {
-        const size_t valueCount = src.size();
-
-        std::vector<unsigned char> ret(valueCount * sizeof(T), 0);
-
-        T* destValues = (T*)ret.data();
-        for (size_t index = 0; index < valueCount; ++index)
-            destValues[index] = (T)(max(min(src[index] * multiplier, theMax), theMin));
-
-        return ret;
-    }
-
-    static bool ConvertFromDoubles(const std::vector<double>& doubles, DXGI_FORMAT_Info::ChannelType type, std::vector<unsigned char>& dest)
-    {
-        switch (type)
-        {
-            case DXGI_FORMAT_Info::ChannelType::_uint8_t: dest = ConvertFromDoubles<uint8_t>(doubles, 256.0, 0.0, 255.0); break;
-            case DXGI_FORMAT_Info::ChannelType::_int8_t: dest = ConvertFromDoubles<uint8_t>(doubles, 256.0, -128.0, 127.0); break;
-            case DXGI_FORMAT_Info::ChannelType::_int16_t: dest = ConvertFromDoubles<uint16_t>(doubles, 65536.0, -32768.0, 32767.0); break;
-            case DXGI_FORMAT_Info::ChannelType::_uint16_t: dest = ConvertFromDoubles<uint16_t>(doubles, 65536.0, 0.0, 65535.0); break;
-            case DXGI_FORMAT_Info::ChannelType::_uint32_t: dest = ConvertFromDoubles<uint32_t>(doubles, 4294967296.0, 0.0, 4294967295.0); break;
-            //case DXGI_FORMAT_Info::ChannelType::_half: dest = ConvertFromDoubles<half>(doubles, 1.0, -65504.0, 65504.0); break;
-            case DXGI_FORMAT_Info::ChannelType::_float: dest = ConvertFromDoubles<float>(doubles, 1.0, -FLT_MAX, FLT_MAX); break;
-            default: return false;
-        }
-        return true;
-    }
-
-    static bool ConvertFromDoubles(const std::vector<double>& doubles, DXGI_FORMAT_Info::ChannelType type, unsigned char* dest)
-    {
-        std::vector<unsigned char> _dest;
-        switch (type)
-        {
-            case DXGI_FORMAT_Info::ChannelType::_uint8_t: _dest = ConvertFromDoubles<uint8_t>(doubles, 256.0, 0.0, 255.0); break;
-            case DXGI_FORMAT_Info::ChannelType::_int8_t: _dest = ConvertFromDoubles<uint8_t>(doubles, 256.0, -128.0, 127.0); break;
-            case DXGI_FORMAT_Info::ChannelType::_int16_t: _dest = ConvertFromDoubles<uint16_t>(doubles, 65536.0, -32768.0, 32767.0); break;
-            case DXGI_FORMAT_Info::ChannelType::_uint16_t: _dest = ConvertFromDoubles<uint16_t>(doubles, 65536.0, 0.0, 65535.0); break;
-            case DXGI_FORMAT_Info::ChannelType::_uint32_t: _dest = ConvertFromDoubles<uint32_t>(doubles, 4294967296.0, 0.0, 4294967295.0); break;
-            //case DXGI_FORMAT_Info::ChannelType::_half: _dest = ConvertFromDoubles<half>(doubles, 1.0, -65504.0, 65504.0); break;
-            case DXGI_FORMAT_Info::ChannelType::_float: _dest = ConvertFromDoubles<float>(doubles, 1.0, -FLT_MAX, FLT_MAX); break;
-            default: return false;
-        }
-
-        memcpy(dest, _dest.data(), _dest.size());
-
-        return true;
-    }
-
-    static void BilinearSample(const unsigned char* src, const DXGI_FORMAT_Info& formatInfo, const int dims[3], float U, float V, unsigned char* dest)
-    {
-        float srcX = U * float(dims[0]) - 0.5f;
-        float srcY = V * float(dims[1]) - 0.5f;
-
-        int x1 = int(srcX);
-        int y1 = int(srcY);
-        int x2 = (x1 + 1) % dims[0];
-        int y2 = (y1 + 1) % dims[1];
-
-        float fracX = std::fmod(srcX, 1.0f);
-        float fracY = std::fmod(srcY, 1.0f);
-
-        // read the source pixels
-        std::vector<double> P00Values, P01Values, P10Values, P11Values;
-        ConvertToDoubles(&src[(y1 * dims[0] + x1) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P00Values);
-        ConvertToDoubles(&src[(y1 * dims[0] + x2) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P10Values);
-        ConvertToDoubles(&src[(y2 * dims[0] + x1) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P01Values);
-        ConvertToDoubles(&src[(y2 * dims[0] + x2) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P11Values);
-
-        // Calculate the result
-        std::vector<double> result(formatInfo.channelCount);
-        for (size_t channelIndex = 0; channelIndex < formatInfo.channelCount; ++channelIndex)
-        {
-            double resultx0 = Lerp(P00Values[channelIndex], P10Values[channelIndex], fracX);
-            double resultx1 = Lerp(P01Values[channelIndex], P11Values[channelIndex], fracX);
-            result[channelIndex] = Lerp(resultx0, resultx1, fracY);
-        }
-
-        // Write the dest pixel
-        ConvertFromDoubles(result, formatInfo.channelType, dest);
-    }
-
-    static void TrilinearSample(const unsigned char* src, const DXGI_FORMAT_Info& formatInfo, const int dims[3], float U, float V, float W, unsigned char* dest)
-    {
-        float srcX = U * float(dims[0]) - 0.5f;
-        float srcY = V * float(dims[1]) - 0.5f;
-        float srcZ = W * float(dims[2]) - 0.5f;
-
-        int x1 = int(srcX);
-        int y1 = int(srcY);
-        int z1 = int(srcZ);
-        int x2 = (x1 + 1) % dims[0];
-        int y2 = (y1 + 1) % dims[1];
-        int z2 = (z1 + 1) % dims[2];
-
-        float fracX = std::fmod(srcX, 1.0f);
-        float fracY = std::fmod(srcY, 1.0f);
-        float fracZ = std::fmod(srcZ, 1.0f);
-
-        // read the source pixels
-        std::vector<double> P000Values, P010Values, P100Values, P110Values;
-        std::vector<double> P001Values, P011Values, P101Values, P111Values;
-        ConvertToDoubles(&src[(z1 * dims[1] * dims[0] + y1 * dims[0] + x1) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P000Values);
-        ConvertToDoubles(&src[(z1 * dims[1] * dims[0] + y1 * dims[0] + x2) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P100Values);
-        ConvertToDoubles(&src[(z1 * dims[1] * dims[0] + y2 * dims[0] + x1) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P010Values);
-        ConvertToDoubles(&src[(z1 * dims[1] * dims[0] + y2 * dims[0] + x2) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P110Values);
-        ConvertToDoubles(&src[(z2 * dims[1] * dims[0] + y1 * dims[0] + x1) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P001Values);
-        ConvertToDoubles(&src[(z2 * dims[1] * dims[0] + y1 * dims[0] + x2) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P101Values);
-        ConvertToDoubles(&src[(z2 * dims[1] * dims[0] + y2 * dims[0] + x1) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P011Values);
-        ConvertToDoubles(&src[(z2 * dims[1] * dims[0] + y2 * dims[0] + x2) * formatInfo.bytesPerPixel], formatInfo.channelCount, formatInfo.channelType, P111Values);
-
-        // Calculate the result
-        std::vector<double> result(formatInfo.channelCount);
-        for (size_t channelIndex = 0; channelIndex < formatInfo.channelCount; ++channelIndex)
-        {
-            double resultx00 = Lerp(P000Values[channelIndex], P100Values[channelIndex], fracX);
-            double resultx10 = Lerp(P010Values[channelIndex], P110Values[channelIndex], fracX);
-
-            double resultx01 = Lerp(P001Values[channelIndex], P101Values[channelIndex], fracX);
-            double resultx11 = Lerp(P011Values[channelIndex], P111Values[channelIndex], fracX);
-
-            double resultxy0 = Lerp(resultx00, resultx10, fracY);
-            double resultxy1 = Lerp(resultx01, resultx11, fracY);
-
-            result[channelIndex] = Lerp(resultxy0, resultxy1, fracZ);
-        }
-
-        // Write the dest pixel
-        ConvertFromDoubles(result, formatInfo.channelType, dest);
-    }
-
     void MakeMip(const std::vector<unsigned char>& src, std::vector<unsigned char>& dest, const DXGI_FORMAT_Info& formatInfo, D3D12_RESOURCE_DIMENSION dimension, const int srcDims[3])
     {
-        // calculate the size of the destination dims
-        bool is3D = (dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D);
-        int destDims[3] = { max(srcDims[0] / 2, 1), max(srcDims[1] / 2, 1), is3D ? max(srcDims[2] / 2, 1) : srcDims[2] };
-
-        // Allocate space for the mip
-        dest.resize(destDims[0] * destDims[1] * destDims[2] * formatInfo.bytesPerPixel, 0);
-
-        int srcUnalignedPitch = srcDims[0] * formatInfo.bytesPerPixel;
-        int destUnalignedPitch = destDims[0] * formatInfo.bytesPerPixel;
-
-        if (is3D)
+        MipGenerator::Format format;
+        format.channelCount = formatInfo.channelCount;
+        format.sRGB = formatInfo.sRGB;
+        switch (formatInfo.channelType)
         {
-            // For each z slize
-            for (size_t destZ = 0; destZ < destDims[2]; ++destZ)
-            {
-                float W = (float(destZ) + 0.5f) / float(destDims[2]);
-
-                size_t destArrayOffset = destZ * destDims[1] * destUnalignedPitch;
-
-                // for each pixel
-                for (size_t destY = 0; destY < destDims[1]; ++destY)
-                {
-                    float V = (float(destY) + 0.5f) / float(destDims[1]);
-
-                    size_t destOffset = destArrayOffset + destY * destUnalignedPitch;
-
-                    for (size_t destX = 0; destX < destDims[0]; ++destX)
-                    {
-                        float U = (float(destX) + 0.5f) / float(destDims[0]);
-
-                        unsigned char* destPx = &dest[destOffset + destX * formatInfo.bytesPerPixel];
-
-                        // trilinear sample src[U, V, W] and write to dest
-                        TrilinearSample(src.data(), formatInfo, srcDims, U, V, W, destPx);
-                    }
-                }
-            }
+            case DXGI_FORMAT_Info::ChannelType::_uint8_t: format.channelType = MipGenerator::ChannelType::U8; break;
+            case DXGI_FORMAT_Info::ChannelType::_uint16_t: format.channelType = MipGenerator::ChannelType::U16; break;
+            case DXGI_FORMAT_Info::ChannelType::_uint32_t: format.channelType = MipGenerator::ChannelType::U32; break;
+            case DXGI_FORMAT_Info::ChannelType::_int8_t: format.channelType = MipGenerator::ChannelType::S8; break;
+            case DXGI_FORMAT_Info::ChannelType::_int16_t: format.channelType = MipGenerator::ChannelType::S16; break;
+            case DXGI_FORMAT_Info::ChannelType::_int32_t: format.channelType = MipGenerator::ChannelType::S32; break;
+            case DXGI_FORMAT_Info::ChannelType::_float: format.channelType = MipGenerator::ChannelType::F32; break;
         }
-        else
-        {
-            // For each array slize
-            for (size_t iZ = 0; iZ < srcDims[2]; ++iZ)
-            {
-                size_t srcArrayOffset = iZ * srcDims[1] * srcUnalignedPitch;
-                size_t destArrayOffset = iZ * destDims[1] * destUnalignedPitch;
-
-                // for each pixel
-                for (size_t destY = 0; destY < destDims[1]; ++destY)
-                {
-                    float V = (float(destY) + 0.5f) / float(destDims[1]);
-
-                    size_t destOffset = destArrayOffset + destY * destUnalignedPitch;
-
-                    for (size_t destX = 0; destX < destDims[0]; ++destX)
-                    {
-                        float U = (float(destX) + 0.5f) / float(destDims[0]);
 
-                        unsigned char* destPx = &dest[destOffset + destX * formatInfo.bytesPerPixel];
-
-                        // bilinear sample src[U, V] and write to dest
-                        BilinearSample(&src[srcArrayOffset], formatInfo, srcDims, U, V, destPx);
-                    }
-                }
-            }
-        }
+        MipGenerator::MakeMip(src, dest, format, dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D, srcDims);
     }
 
     void UploadTextureToGPUAndMakeMips(ID3D12Device* device, ID3D12GraphicsCommandList* commandList, DX12Utils::UploadBufferTracker& uploadBufferTracker, ID3D12Resource* destResource, const std::vector<unsigned char>& pixels, const unsigned int size[3], unsigned int numMips, D3D12_RESOURCE_STATES state, D3D12_RESOURCE_STATES stateAfter, TLogFn logFn)
@@ -6,6 +6,7 @@
 #include <unordered_map>
 #include "CompileShaders.h"
 #include "logfn.h"
+#include "MipGenerator.h"
 #include "SRGB.h"
 
 #define ALIGN(_alignment, _val) (((_val + _alignment - 1) / _alignment) * _alignment)
@@ -0,0 +1,84 @@
+// A case insensitive hash table of enum labels, built at compile time from the ENUM_ITEM labels.
+// Used to turn strings into enum values without comparing against every label in turn.
+// Only ASCII letters are case folded, like _stricmp in the C locale.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+constexpr char DFS_EnumToLower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+// FNV-1a of the lower case string
+constexpr uint32_t DFS_EnumHash(const char* s)
+{
+    uint32_t hash = 2166136261u;
+    for (; *s; ++s)
+    {
+        hash ^= (uint32_t)(unsigned char)DFS_EnumToLower(*s);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+constexpr bool DFS_EnumEquals(const char* a, const char* b)
+{
+    for (; *a && *b; ++a, ++b)
+    {
+        if (DFS_EnumToLower(*a) != DFS_EnumToLower(*b))
+            return false;
+    }
+    return *a == *b;
+}
+
+// At least twice the number of labels, and a power of two, so probe chains stay short
+constexpr size_t DFS_EnumSlotCount(size_t labelCount)
+{
+    size_t slotCount = 1;
+    while (slotCount < labelCount * 2)
+        slotCount *= 2;
+    return slotCount;
+}
+
+template <size_t N>
+struct DFS_EnumStringTable
+{
+    static constexpr size_t c_slotCount = DFS_EnumSlotCount(N);
+
+    const char* const* labels = nullptr;
+    int slots[c_slotCount] = {}; // label index + 1, 0 for an empty slot
+
+    // Returns the index of the label, which is the enum value, or -1 if it isn't a label.
+    // If labels differ only by case, the first one wins, like comparing against each in turn.
+    constexpr int Find(const char* s) const
+    {
+        size_t slot = DFS_EnumHash(s) & (c_slotCount - 1);
+        while (slots[slot] != 0)
+        {
+            int index = slots[slot] - 1;
+            if (DFS_EnumEquals(labels[index], s))
+                return index;
+            slot = (slot + 1) & (c_slotCount - 1);
+        }
+        return -1;
+    }
+};
+
+// Linear probing, inserting in label order, so an earlier label is always found before a later one that matches the same string.
+template <size_t N>
+constexpr DFS_EnumStringTable<N> DFS_MakeEnumStringTable(const char* const (&labels)[N])
+{
+    DFS_EnumStringTable<N> table;
+    table.labels = labels;
+    for (size_t index = 0; index < N; ++index)
+    {
+        size_t slot = DFS_EnumHash(labels[index]) & (table.c_slotCount - 1);
+        while (table.slots[slot] != 0)
+            slot = (slot + 1) & (table.c_slotCount - 1);
+        table.slots[slot] = (int)index + 1;
+    }
+    return table;
+}
@@ -0,0 +1,101 @@
+// Generates BinaryLayoutHash(), which hashes what the layout of the binary data depends on:
+// the types and names of the fields that are serialized, the enum labels and the variant type indices.
+// Binary data written by code with a different hash for the root type should not be read.
+
+#include "_common.h"
+
+inline void BinaryLayoutHashString(const char* s, uint64_t& hash)
+{
+    // FNV-1a, including the null terminator so that "ab","c" and "a","bc" are different
+    do
+    {
+        hash ^= (unsigned char)*s;
+        hash *= 1099511628211ull;
+    }
+    while (*s++);
+}
+
+inline void BinaryLayoutHashValue(uint64_t value, uint64_t& hash)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        hash ^= (value >> (i * 8)) & 0xFF;
+        hash *= 1099511628211ull;
+    }
+}
+
+// Built in types. Their names are hashed by the field that has them.
+template <typename T>
+void BinaryLayoutHash(const T* value, uint64_t& hash)
+{
+}
+
+// Enums
+
+#define ENUM_BEGIN(_NAME, _DESCRIPTION) \
+    inline void BinaryLayoutHash(const _NAME* value, uint64_t& hash) \
+    { \
+        BinaryLayoutHashString("enum " #_NAME, hash);
+
+#define ENUM_ITEM(_NAME, _DESCRIPTION) \
+        BinaryLayoutHashString(#_NAME, hash);
+
+#define ENUM_END() \
+    }
+
+// Structs
+
+#define STRUCT_BEGIN(_NAME, _DESCRIPTION) \
+    inline void BinaryLayoutHash(const _NAME* value, uint64_t& hash) \
+    { \
+        BinaryLayoutHashString("struct " #_NAME, hash);
+
+#define STRUCT_INHERIT_BEGIN(_NAME, _BASE, _DESCRIPTION) \
+    inline void BinaryLayoutHash(const _NAME* value, uint64_t& hash) \
+    { \
+        BinaryLayoutHashString("struct " #_NAME " : " #_BASE, hash); \
+        BinaryLayoutHash((const _BASE*)nullptr, hash);
+
+#define STRUCT_FIELD(_TYPE, _NAME, _DEFAULT, _DESCRIPTION, _FLAGS) \
+        if (((_FLAGS) & SCHEMA_FLAG_NO_SERIALIZE) == 0) \
+        { \
+            BinaryLayoutHashString("field " #_TYPE " " #_NAME, hash); \
+            BinaryLayoutHash((const _TYPE*)nullptr, hash); \
+        }
+
+#define STRUCT_CONST(_TYPE, _NAME, _DEFAULT, _DESCRIPTION, _FLAGS)
+
+#define STRUCT_DYNAMIC_ARRAY(_TYPE, _NAME, _DESCRIPTION, _FLAGS) \
+        if (((_FLAGS) & SCHEMA_FLAG_NO_SERIALIZE) == 0) \
+        { \
+            BinaryLayoutHashString("dynamic array " #_TYPE " " #_NAME, hash); \
+            BinaryLayoutHash((const _TYPE*)nullptr, hash); \
+        }
+
+#define STRUCT_STATIC_ARRAY(_TYPE, _NAME, _SIZE, _DEFAULT, _DESCRIPTION, _FLAGS) \
+        if (((_FLAGS) & SCHEMA_FLAG_NO_SERIALIZE) == 0) \
+        { \
+            BinaryLayoutHashString("static array " #_TYPE " " #_NAME, hash); \
+            BinaryLayoutHashValue(_SIZE, hash); \
+            BinaryLayoutHash((const _TYPE*)nullptr, hash); \
+        }
+
+#define STRUCT_END() \
+    }
+
+// Variants
+
+#define VARIANT_BEGIN(_NAME, _DESCRIPTION) \
+    inline void BinaryLayoutHash(const _NAME* value, uint64_t& hash) \
+    { \
+        typedef _NAME ThisType; \
+        BinaryLayoutHashString("variant " #_NAME, hash);
+
+// The indices come from __COUNTER__, so they depend on what was compiled before the schemas, not just on the schemas
+#define VARIANT_TYPE(_TYPE, _NAME, _DEFAULT, _DESCRIPTION) \
+        BinaryLayoutHashString(#_TYPE " " #_NAME, hash); \
+        BinaryLayoutHashValue(ThisType::c_index_##_NAME, hash); \
+        BinaryLayoutHash((const _TYPE*)nullptr, hash);
+
+#define VARIANT_END() \
+    }
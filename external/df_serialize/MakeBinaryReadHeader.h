@@ -2,118 +2,21 @@
 
 #include "_common.h"
 
-// Enums
-
-#define ENUM_BEGIN(_NAME, _DESCRIPTION) \
-    bool BinaryRead(_NAME& value, const TDYNAMICARRAY<char>& data, size_t& offset) \
-    { \
-        typedef _NAME EnumType; \
-        TSTRING stringValue; \
-        if(!BinaryRead(stringValue, data, offset)) \
-        { \
-            DFS_LOG("Trying to read a #_NAME " as a string, but we couldn't\n"); \
-            return false; \
-        }
-
-#define ENUM_ITEM(_NAME, _DESCRIPTION) \
-        if (!_stricmp(&stringValue[0], #_NAME)) \
-        { \
-            value = EnumType::_NAME; \
-            return true; \
-        }
-
-#define ENUM_END() \
-        DFS_LOG("Unknown Enum Value: \"%s\"", &stringValue[0]); \
-        return false; \
-    }
-
-// Structs
-
-#define STRUCT_BEGIN(_NAME, _DESCRIPTION) \
-    bool BinaryRead(_NAME& value, const TDYNAMICARRAY<char>& data, size_t& offset) \
-    {
-
-#define STRUCT_INHERIT_BEGIN(_NAME, _BASE, _DESCRIPTION) \
-    bool BinaryRead(_NAME& value, const TDYNAMICARRAY<char>& data, size_t& offset) \
-    { \
-        if (!BinaryRead(*(_BASE*)&value, data, offset)) \
-            return false;
-
-#define STRUCT_FIELD(_TYPE, _NAME, _DEFAULT, _DESCRIPTION, _FLAGS) \
-        if ((_FLAGS) & SCHEMA_FLAG_NO_SERIALIZE) == 0 && !BinaryRead(value.##_NAME, data, offset)) \
-        { \
-            DFS_LOG("Could not read member " #_NAME "\n"); \
-            return false; \
-        }
-
-#define STRUCT_CONST(_TYPE, _NAME, _DEFAULT, _DESCRIPTION, _FLAGS)
-
-#define STRUCT_DYNAMIC_ARRAY(_TYPE, _NAME, _DESCRIPTION, _FLAGS) \
-        if (((_FLAGS) & SCHEMA_FLAG_NO_SERIALIZE) == 0) \
-        { \
-            int arrayCount = 0; \
-            if (!BinaryRead(arrayCount, data, offset)) \
-            { \
-                DFS_LOG("Could not read array count of array " #_NAME "\n"); \
-                return false; \
-            } \
-            TDYNAMICARRAY_RESIZE(value._NAME,arrayCount); \
-            for (size_t index = 0; index < TDYNAMICARRAY_SIZE(value._NAME); ++index) \
-            { \
-                if(!BinaryRead(value._NAME[index], data, offset)) \
-                { \
-                    DFS_LOG("Could not read an array item for array " #_NAME "\n"); \
-                    return false; \
-                } \
-            } \
-        }
-
-#define STRUCT_STATIC_ARRAY(_TYPE, _NAME, _SIZE, _DEFAULT, _DESCRIPTION, _FLAGS) \
-        if (((_FLAGS) & SCHEMA_FLAG_NO_SERIALIZE) == 0) \
-        { \
-            for (size_t index = 0; index < _SIZE; ++index) \
-            { \
-                if(!BinaryRead(value._NAME[index], data, offset)) \
-                { \
-                    DFS_LOG("Could not read an array item for array " #_NAME "\n"); \
-                    return false; \
-                } \
-            } \
-        }
-
-#define STRUCT_END() \
-        return true; \
-    }
-
-// Variants
-
-#define VARIANT_BEGIN(_NAME, _DESCRIPTION) \
-    bool BinaryRead(_NAME& value, const TDYNAMICARRAY<char>& data, size_t& offset) \
-    { \
-        typedef _NAME ThisType; \
-        if(!BinaryRead(value._index, data, offset)) \
-            return false;
-
-#define VARIANT_TYPE(_TYPE, _NAME, _DEFAULT, _DESCRIPTION) \
-        if (value._index == ThisType::c_index_##_NAME && !BinaryRead(value._NAME, data, offset)) \
-            return false;
-
-#define VARIANT_END() \
-        return true; \
-    }
+#include <cstring>
 
 // A catch all template type to make compile errors about unsupported types easier to understand
 
 template <typename T>
 bool BinaryRead(T& value, const TDYNAMICARRAY<char>& data, size_t& offset)
 {
-    static_assert(false, __FUNCSIG__ ": Unsupported type encountered!");
+    // Like JSONRead, this can't be a static assert, because fields that aren't serialized still compile a call to it.
+    Assert(false, __FUNCSIG__ ": Unsupported type encountered!");
     return false;
 }
 
-// Built in types
+// Built in types. These are declared before the generated code, which calls them.
 
-bool BinaryRead(uint8_t& value, const TDYNAMICARRAY<char>& data, size_t& offset)
+inline bool BinaryRead(uint8_t& value, const TDYNAMICARRAY<char>& data, size_t& offset)
 {
     if (offset + sizeof(value) > TDYNAMICARRAY_SIZE(data))
         return false;
@@ -124,7 +27,7 @@ bool BinaryRead(uint8_t& value, const TDYNAMICARRAY<char>& data, size_t& offset)
     return true;
 }
 
-bool BinaryRead(uint16_t& value, const TDYNAMICARRAY<char>& data, size_t& offset)
+inline bool BinaryRead(uint16_t& value, const TDYNAMICARRAY<char>& data, size_t& offset)
 {
     if (offset + sizeof(value) > TDYNAMICARRAY_SIZE(data))
         return false;
@@ -135,7 +38,7 @@ bool BinaryRead(uint16_t& value, const TDYNAMICARRAY<char>& data, size_t& offset
     return true;
 }
 
-bool BinaryRead(uint32_t& value, const TDYNAMICARRAY<char>& data, size_t& offset)
+inline bool BinaryRead(uint32_t& value, const TDYNAMICARRAY<char>& data, size_t& offset)
 {
     if (offset + sizeof(value) > TDYNAMICARRAY_SIZE(data))
         return false;
@@ -146,7 +49,7 @@ bool BinaryRead(uint32_t& value, const TDYNAMICARRAY<char>& data, size_t& offset
     return true;
 }
 
-bool BinaryRead(uint64_t& value, const TDYNAMICARRAY<char>& data, size_t& offset)
+inline bool BinaryRead(uint64_t& value, const TDYNAMICARRAY<char>& data, size_t& offset)
 {
     if (offset + sizeof(value) > TDYNAMICARRAY_SIZE(data))
         return false;
@@ -157,7 +60,7 @@ bool BinaryRead(uint64_t& value, const TDYNAMICARRAY<char>& data, size_t& offset
     return true;
 }
 
-bool BinaryRead(int8_t& value, const TDYNAMICARRAY<char>& data, size_t& offset)
+inline bool BinaryRead(int8_t& value, const TDYNAMICARRAY<char>& data, size_t& offset)
 {
     if (offset + sizeof(value) > TDYNAMICARRAY_SIZE(data))
         return false;
@@ -168,7 +71,7 @@ bool BinaryRead(int8_t& value, const TDYNAMICARRAY<char>& data, size_t& offset)
     return true;
 }
 
-bool BinaryRead(int16_t& value, const TDYNAMICARRAY<char>& data, size_t& offset)
+inline bool BinaryRead(int16_t& value, const TDYNAMICARRAY<char>& data, size_t& offset)
 {
     if (offset + sizeof(value) > TDYNAMICARRAY_SIZE(data))
         return false;
@@ -179,7 +82,7 @@ bool BinaryRead(int16_t& value, const TDYNAMICARRAY<char>& data, size_t& offset)
     return true;
 }
 
-bool BinaryRead(int32_t& value, const TDYNAMICARRAY<char>& data, size_t& offset)
+inline bool BinaryRead(int32_t& value, const TDYNAMICARRAY<char>& data, size_t& offset)
 {
     if (offset + sizeof(value) > TDYNAMICARRAY_SIZE(data))
         return false;
@@ -190,7 +93,7 @@ bool BinaryRead(int32_t& value, const TDYNAMICARRAY<char>& data, size_t& offset)
     return true;
 }
 
-bool BinaryRead(int64_t& value, const TDYNAMICARRAY<char>& data, size_t& offset)
+inline bool BinaryRead(int64_t& value, const TDYNAMICARRAY<char>& data, size_t& offset)
 {
     if (offset + sizeof(value) > TDYNAMICARRAY_SIZE(data))
         return false;
@@ -201,7 +104,7 @@ bool BinaryRead(int64_t& value, const TDYNAMICARRAY<char>& data, size_t& offset)
     return true;
 }
 
-bool BinaryRead(float& value, const TDYNAMICARRAY<char>& data, size_t& offset)
+inline bool BinaryRead(float& value, const TDYNAMICARRAY<char>& data, size_t& offset)
 {
     if (offset + sizeof(value) > TDYNAMICARRAY_SIZE(data))
         return false;
@@ -212,7 +115,7 @@ bool BinaryRead(float& value, const TDYNAMICARRAY<char>& data, size_t& offset)
     return true;
 }
 
-bool BinaryRead(bool& value, const TDYNAMICARRAY<char>& data, size_t& offset)
+inline bool BinaryRead(bool& value, const TDYNAMICARRAY<char>& data, size_t& offset)
 {
     int intValue = 0;
     if (!BinaryRead(intValue, data, offset))
@@ -223,10 +126,123 @@ bool BinaryRead(bool& value, const TDYNAMICARRAY<char>& data, size_t& offset)
     return true;
 }
 
-bool BinaryRead(TSTRING& value, const TDYNAMICARRAY<char>& data, size_t& offset)
+inline bool BinaryRead(TSTRING& value, const TDYNAMICARRAY<char>& data, size_t& offset)
 {
     // Yes, the strings are null terminated in the binary file
-    value = (const char*)&data[offset];
-    offset += strlen(&value[0]) + 1;
+    if (offset >= TDYNAMICARRAY_SIZE(data))
+        return false;
+
+    const char* start = &data[offset];
+    const char* end = (const char*)memchr(start, 0, TDYNAMICARRAY_SIZE(data) - offset);
+    if (!end)
+        return false;
+
+    value = start;
+    offset += (end - start) + 1;
     return true;
 }
+
+// Enums
+
+#define ENUM_BEGIN(_NAME, _DESCRIPTION) \
+    inline bool BinaryRead(_NAME& value, const TDYNAMICARRAY<char>& data, size_t& offset) \
+    { \
+        typedef _NAME EnumType; \
+        TSTRING stringValue; \
+        if(!BinaryRead(stringValue, data, offset)) \
+        { \
+            DFS_LOG("Trying to read a " #_NAME " as a string, but we couldn't\n"); \
+            return false; \
+        } \
+        static constexpr const char* c_labels[] = {
+
+#define ENUM_ITEM(_NAME, _DESCRIPTION) \
+            #_NAME,
+
+#define ENUM_END() \
+        }; \
+        static constexpr auto c_table = DFS_MakeEnumStringTable(c_labels); \
+        int index = c_table.Find(&stringValue[0]); \
+        if (index != -1) \
+        { \
+            value = (EnumType)index; \
+            return true; \
+        } \
+        DFS_LOG("Unknown Enum Value: \"%s\"", &stringValue[0]); \
+        return false; \
+    }
+
+// Structs
+
+#define STRUCT_BEGIN(_NAME, _DESCRIPTION) \
+    inline bool BinaryRead(_NAME& value, const TDYNAMICARRAY<char>& data, size_t& offset) \
+    {
+
+#define STRUCT_INHERIT_BEGIN(_NAME, _BASE, _DESCRIPTION) \
+    inline bool BinaryRead(_NAME& value, const TDYNAMICARRAY<char>& data, size_t& offset) \
+    { \
+        if (!BinaryRead(*(_BASE*)&value, data, offset)) \
+            return false;
+
+#define STRUCT_FIELD(_TYPE, _NAME, _DEFAULT, _DESCRIPTION, _FLAGS) \
+        if (((_FLAGS) & SCHEMA_FLAG_NO_SERIALIZE) == 0 && !BinaryRead(value._NAME, data, offset)) \
+        { \
+            DFS_LOG("Could not read member " #_NAME "\n"); \
+            return false; \
+        }
+
+#define STRUCT_CONST(_TYPE, _NAME, _DEFAULT, _DESCRIPTION, _FLAGS)
+
+#define STRUCT_DYNAMIC_ARRAY(_TYPE, _NAME, _DESCRIPTION, _FLAGS) \
+        if (((_FLAGS) & SCHEMA_FLAG_NO_SERIALIZE) == 0) \
+        { \
+            int arrayCount = 0; \
+            if (!BinaryRead(arrayCount, data, offset) || arrayCount < 0) \
+            { \
+                DFS_LOG("Could not read array count of array " #_NAME "\n"); \
+                return false; \
+            } \
+            TDYNAMICARRAY_RESIZE(value._NAME,arrayCount); \
+            for (size_t index = 0; index < TDYNAMICARRAY_SIZE(value._NAME); ++index) \
+            { \
+                if(!BinaryRead(value._NAME[index], data, offset)) \
+                { \
+                    DFS_LOG("Could not read an array item for array " #_NAME "\n"); \
+                    return false; \
+                } \
+            } \
+        }
+
+#define STRUCT_STATIC_ARRAY(_TYPE, _NAME, _SIZE, _DEFAULT, _DESCRIPTION, _FLAGS) \
+        if (((_FLAGS) & SCHEMA_FLAG_NO_SERIALIZE) == 0) \
+        { \
+            for (size_t index = 0; index < _SIZE; ++index) \
+            { \
+                if(!BinaryRead(value._NAME[index], data, offset)) \
+                { \
+                    DFS_LOG("Could not read an array item for array " #_NAME "\n"); \
+                    return false; \
+                } \
+            } \
+        }
+
+#define STRUCT_END() \
+        return true; \
+    }
+
+// Variants
+
+#define VARIANT_BEGIN(_NAME, _DESCRIPTION) \
+    inline bool BinaryRead(_NAME& value, const TDYNAMICARRAY<char>& data, size_t& offset) \
+    { \
+        typedef _NAME ThisType; \
+        if(!BinaryRead(value._index, data, offset)) \
+            return false;
+
+#define VARIANT_TYPE(_TYPE, _NAME, _DEFAULT, _DESCRIPTION) \
+        if (value._index == ThisType::c_index_##_NAME && !BinaryRead(value._NAME, data, offset)) \
+            return false;
+
+#define VARIANT_END() \
+        return true; \
+    }
@@ -1,4 +1,4 @@
-bool WriteBinaryFile(const char* fileName, TDYNAMICARRAY<char>& data)
+inline bool WriteBinaryFile(const char* fileName, TDYNAMICARRAY<char>& data)
 {
     FILE* file = nullptr;
     fopen_s(&file, fileName, "w+b");
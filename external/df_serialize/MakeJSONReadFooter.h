@@ -28,9 +28,9 @@ inline bool LoadTextFile(const char* fileName, TDYNAMICARRAY<char>& data)
     return true;
 }
 
-// Read a structure from a JSON string
+// Read a structure from a JSON string, by building a DOM of the whole document first
 template<typename TROOT>
-bool ReadFromJSONBuffer(TROOT& root, const char* data)
+bool ReadFromJSONBuffer_DOM(TROOT& root, const char* data)
 {
     rapidjson::Document document;
     rapidjson::ParseResult ok = document.Parse<rapidjson::kParseCommentsFlag | rapidjson::kParseTrailingCommasFlag>(data);
@@ -78,6 +78,32 @@ bool ReadFromJSONBuffer(TROOT& root, const char* data)
     return JSONRead(root, document) && ReadFromJSON_PostLoad(root);
 }
 
+// Read a structure from a JSON string.
+// Uses the streaming reader from MakeJSONSAXReadHeader.h, which reads into a copy so that the DOM can start over from the original if it needs to.
+template<typename TROOT>
+bool ReadFromJSONBuffer(TROOT& root, const char* data)
+{
+    TROOT streamedRoot = root;
+    switch (JSONSAXReadBuffer(streamedRoot, data))
+    {
+        case JSONSAXReadResult::Finished:
+        {
+            root = std::move(streamedRoot);
+            return ReadFromJSON_PostLoad(root);
+        }
+        case JSONSAXReadResult::Error:
+        {
+            return false;
+        }
+        case JSONSAXReadResult::UseDOM:
+        {
+            break;
+        }
+    }
+
+    return ReadFromJSONBuffer_DOM(root, data);
+}
+
 template<typename TROOT>
 bool ReadFromJSONBuffer(TROOT& root, const TDYNAMICARRAY<char>& data)
 {
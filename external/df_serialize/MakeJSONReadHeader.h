@@ -29,16 +29,21 @@ enum class JSONReadOverrideResult
             DFS_LOG("Trying to read a " #_NAME " but it wasn't a string\n"); \
             return false; \
         } \
-        const char* stringValue = document.GetString();
+        const char* stringValue = document.GetString(); \
+        static constexpr const char* c_labels[] = {
 
 #define ENUM_ITEM(_NAME, _DESCRIPTION) \
-        if (!_stricmp(stringValue, #_NAME)) \
-        { \
-            value = EnumType::_NAME; \
-            return true; \
-        }
+            #_NAME,
 
 #define ENUM_END() \
+        }; \
+        static constexpr auto c_table = DFS_MakeEnumStringTable(c_labels); \
+        int index = c_table.Find(stringValue); \
+        if (index != -1) \
+        { \
+            value = (EnumType)index; \
+            return true; \
+        } \
         DFS_LOG("Unknown Enum Value: \"%s\"", stringValue); \
         return false; \
     }
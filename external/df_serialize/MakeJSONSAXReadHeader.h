@@ -0,0 +1,554 @@
+// Generates code to read data from json files and strings with the rapidjson SAX reader, instead of building a DOM first.
+// Structs are filled in as the parser reaches each key, which is found with a switch on a hash of the key.
+// Include after MakeJSONReadHeader.h and the schemas, and before MakeJSONReadFooter.h, whose ReadFromJSONBuffer() uses it.
+// Values that aren't structs, variants or arrays are read with the JSONRead() functions, so they give the same results and errors.
+// Anything that can't be read the same way as JSONRead() would, such as a parse error, gives UseDOM, to read it through the DOM instead.
+// RapidJSON Website: https://rapidjson.org/
+// RapidJSON Github:  https://github.com/Tencent/rapidjson/
+
+#include "_common.h"
+
+#include <cstring>
+
+enum class JSONSAXReadResult
+{
+    Finished,
+    Error,
+    UseDOM
+};
+
+enum class JSONSAXOverrideResult
+{
+    UseDOM,
+    Finished,
+    Continue
+};
+
+// FNV-1a of the key, case sensitive like rapidjson member lookups
+constexpr uint32_t DFS_JSONKeyHash(const char* s, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= (uint32_t)(unsigned char)s[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+#define DFS_JSON_KEY_HASH(_NAME) DFS_JSONKeyHash(#_NAME, sizeof(#_NAME) - 1)
+#define DFS_JSON_KEY_EQUALS(_NAME) (keyLength == sizeof(#_NAME) - 1 && memcmp(key, #_NAME, keyLength) == 0)
+
+// Specialize this function to override the automatic streaming reads, like JSONReadOverride() does for DOM reads.
+// It's given each key of an object before the key is looked up as a field, with its index in the object.
+// At the end of the object, it's given a null key, with the number of keys.
+// Return Finished if it pushed a reader for the key's value, and UseDOM if the document needs to be read through the DOM.
+template <typename T, typename READER>
+JSONSAXOverrideResult JSONSAXReadOverride(T& value, const char* key, int keyIndex, READER& reader)
+{
+    return JSONSAXOverrideResult::Continue;
+}
+
+// Reads a value of a type that the streaming reader doesn't know, with JSONRead()
+template <typename T>
+bool JSONSAXReadWithDOM(T& value, const rapidjson::Value& document)
+{
+    return JSONRead(value, document);
+}
+
+// Pushes the reader for a value. Overloaded for structs and variants by the generated code.
+// memberName is given for fields that JSONRead() reports "Could not read member" for, when reading them fails.
+template <typename T, typename READER>
+void JSONSAXPushValue(T& value, READER& reader, const char* memberName)
+{
+    reader.template PushDOMValue<T, &JSONSAXReadWithDOM<T>>(value, memberName);
+}
+
+// The rapidjson SAX handler. It keeps a stack of frames, one for each value being read, and the top frame gets each event.
+// A frame pops itself when its value is complete.
+class JSONSAXReader
+{
+public:
+    struct Event
+    {
+        enum class Type
+        {
+            Scalar,
+            Key,
+            StartObject,
+            EndObject,
+            StartArray,
+            EndArray
+        };
+
+        Type type = Type::Scalar;
+        const rapidjson::Value* scalar = nullptr;
+        const char* key = nullptr;
+        size_t keyLength = 0;
+    };
+
+    struct Frame
+    {
+        bool (*onEvent)(JSONSAXReader& reader, Frame& frame, const Event& event) = nullptr;
+        void* value = nullptr;
+        const char* memberName = nullptr;
+        const char* arrayName = nullptr;
+        size_t arraySize = 0;
+        size_t start = 0;
+        int index = 0;
+        int depth = 0;
+        bool started = false;
+    };
+
+    explicit JSONSAXReader(const char* json)
+        : m_json(json)
+    {
+        m_frames.reserve(32);
+    }
+
+    // Reads the whole document into the value pushed for the root
+    JSONSAXReadResult Parse()
+    {
+        rapidjson::StringStream stream(m_json);
+        m_stream = &stream;
+
+        Handler handler{ *this };
+        rapidjson::Reader reader;
+        rapidjson::ParseResult ok = reader.Parse<rapidjson::kParseCommentsFlag | rapidjson::kParseTrailingCommasFlag>(stream, handler);
+        m_stream = nullptr;
+
+        // Errors from the parser itself are reported by the DOM reader, which gives the line and text of the error
+        if (!ok)
+            return (ok.Code() == rapidjson::kParseErrorTermination) ? m_result : JSONSAXReadResult::UseDOM;
+
+        return m_result;
+    }
+
+    // Structs and variants, which read each key with JSONSAXReadMember()
+    template <typename T>
+    void PushObject(T& value, const char* memberName)
+    {
+        Frame frame;
+        frame.onEvent = &ObjectEvent<T>;
+        frame.value = &value;
+        frame.memberName = memberName;
+        m_frames.push_back(frame);
+    }
+
+    template <typename T>
+    void PushDynamicArray(TDYNAMICARRAY<T>& value, const char* arrayName)
+    {
+        Frame frame;
+        frame.onEvent = &DynamicArrayEvent<T>;
+        frame.value = &value;
+        frame.arrayName = arrayName;
+        m_frames.push_back(frame);
+    }
+
+    template <typename T>
+    void PushStaticArray(T* value, size_t arraySize, const char* arrayName)
+    {
+        Frame frame;
+        frame.onEvent = &StaticArrayEvent<T>;
+        frame.value = value;
+        frame.arrayName = arrayName;
+        frame.arraySize = arraySize;
+        m_frames.push_back(frame);
+    }
+
+    // Reads the value with READ, given the value as a rapidjson::Value.
+    // Scalars are made into a value directly, and objects and arrays are parsed again by the DOM, once the parser is past them.
+    template <typename T, bool (*READ)(T& value, const rapidjson::Value& document)>
+    void PushDOMValue(T& value, const char* memberName)
+    {
+        Frame frame;
+        frame.onEvent = &DOMValueEvent<T, READ>;
+        frame.value = &value;
+        frame.memberName = memberName;
+        m_frames.push_back(frame);
+    }
+
+    // Ignores the value, for keys that aren't fields
+    void PushSkip()
+    {
+        Frame frame;
+        frame.onEvent = &SkipEvent;
+        m_frames.push_back(frame);
+    }
+
+    // Stops the parse. Reports the fields being read, innermost first, like JSONRead() does as it returns.
+    bool Error()
+    {
+        for (size_t i = m_frames.size(); i > 0; --i)
+        {
+            if (m_frames[i - 1].memberName)
+                DFS_LOG("Could not read member %s\n", m_frames[i - 1].memberName);
+        }
+        m_result = JSONSAXReadResult::Error;
+        return false;
+    }
+
+    bool UseDOM()
+    {
+        m_result = JSONSAXReadResult::UseDOM;
+        return false;
+    }
+
+private:
+    struct Handler
+    {
+        JSONSAXReader& reader;
+
+        bool Null() { rapidjson::Value value; return Scalar(value); }
+        bool Bool(bool b) { rapidjson::Value value(b); return Scalar(value); }
+        bool Int(int i) { rapidjson::Value value(i); return Scalar(value); }
+        bool Uint(unsigned i) { rapidjson::Value value(i); return Scalar(value); }
+        bool Int64(int64_t i) { rapidjson::Value value(i); return Scalar(value); }
+        bool Uint64(uint64_t i) { rapidjson::Value value(i); return Scalar(value); }
+        bool Double(double d) { rapidjson::Value value(d); return Scalar(value); }
+        bool RawNumber(const char* str, rapidjson::SizeType length, bool copy) { return String(str, length, copy); }
+        bool String(const char* str, rapidjson::SizeType length, bool copy) { rapidjson::Value value(rapidjson::StringRef(str, length)); return Scalar(value); }
+        bool StartObject() { return Structural(Event::Type::StartObject); }
+        bool EndObject(rapidjson::SizeType memberCount) { return Structural(Event::Type::EndObject); }
+        bool StartArray() { return Structural(Event::Type::StartArray); }
+        bool EndArray(rapidjson::SizeType elementCount) { return Structural(Event::Type::EndArray); }
+
+        bool Key(const char* str, rapidjson::SizeType length, bool copy)
+        {
+            Event event;
+            event.type = Event::Type::Key;
+            event.key = str;
+            event.keyLength = length;
+            return reader.Dispatch(event);
+        }
+
+        bool Scalar(const rapidjson::Value& value)
+        {
+            Event event;
+            event.type = Event::Type::Scalar;
+            event.scalar = &value;
+            return reader.Dispatch(event);
+        }
+
+        bool Structural(Event::Type type)
+        {
+            Event event;
+            event.type = type;
+            return reader.Dispatch(event);
+        }
+    };
+
+    // Frames pop themselves and push children, so they must not use the frame reference after either
+    bool Dispatch(const Event& event)
+    {
+        if (m_frames.empty())
+            return UseDOM();
+        return m_frames.back().onEvent(*this, m_frames.back(), event);
+    }
+
+    void Pop()
+    {
+        m_frames.pop_back();
+    }
+
+    // Where the object or array that was just started begins in the buffer
+    size_t GetStartOffset() const
+    {
+        return m_stream->Tell() - 1;
+    }
+
+    template <typename T>
+    static bool ObjectEvent(JSONSAXReader& reader, Frame& frame, const Event& event)
+    {
+        T& value = *(T*)frame.value;
+
+        if (!frame.started)
+        {
+            // JSONRead() of a struct or variant fails without a message when it isn't an object
+            if (event.type != Event::Type::StartObject)
+                return reader.Error();
+            frame.started = true;
+            return true;
+        }
+
+        switch (event.type)
+        {
+            case Event::Type::Key:
+            {
+                int keyIndex = frame.index++;
+                switch (JSONSAXReadOverride(value, event.key, keyIndex, reader))
+                {
+                    case JSONSAXOverrideResult::UseDOM: return reader.UseDOM();
+                    case JSONSAXOverrideResult::Finished: return true;
+                    case JSONSAXOverrideResult::Continue: break;
+                }
+
+                uint32_t keyHash = DFS_JSONKeyHash(event.key, event.keyLength);
+                if (!JSONSAXReadMember(value, event.key, event.keyLength, keyHash, reader))
+                    reader.PushSkip();
+                return true;
+            }
+            case Event::Type::EndObject:
+            {
+                if (JSONSAXReadOverride(value, (const char*)nullptr, frame.index, reader) == JSONSAXOverrideResult::UseDOM)
+                    return reader.UseDOM();
+                reader.Pop();
+                return true;
+            }
+            default:
+            {
+                // The parser only gives keys and the end of the object at this level
+                return reader.UseDOM();
+            }
+        }
+    }
+
+    // Items are read into the existing items, and the array is resized at the end, like JSONRead() resizing it first.
+    template <typename T>
+    static bool DynamicArrayEvent(JSONSAXReader& reader, Frame& frame, const Event& event)
+    {
+        TDYNAMICARRAY<T>& value = *(TDYNAMICARRAY<T>*)frame.value;
+
+        if (!frame.started)
+        {
+            if (event.type != Event::Type::StartArray)
+            {
+                DFS_LOG("'%s' is not an array.\n", frame.arrayName);
+                return reader.Error();
+            }
+            frame.started = true;
+            return true;
+        }
+
+        if (event.type == Event::Type::EndArray)
+        {
+            TDYNAMICARRAY_RESIZE(value, frame.index);
+            reader.Pop();
+            return true;
+        }
+
+        size_t index = (size_t)frame.index++;
+        if (index >= TDYNAMICARRAY_SIZE(value))
+            TDYNAMICARRAY_RESIZE(value, index + 1);
+        JSONSAXPushValue(value[index], reader, (const char*)nullptr);
+        return reader.Dispatch(event);
+    }
+
+    template <typename T>
+    static bool StaticArrayEvent(JSONSAXReader& reader, Frame& frame, const Event& event)
+    {
+        T* value = (T*)frame.value;
+
+        if (!frame.started)
+        {
+            if (event.type != Event::Type::StartArray)
+            {
+                DFS_LOG("'%s' is not an array.\n", frame.arrayName);
+                return reader.Error();
+            }
+            frame.started = true;
+            return true;
+        }
+
+        if (event.type == Event::Type::EndArray)
+        {
+            if ((size_t)frame.index != frame.arraySize)
+            {
+                DFS_LOG("'%s' array was not the correct size.\n", frame.arrayName);
+                return reader.Error();
+            }
+            reader.Pop();
+            return true;
+        }
+
+        // Extra items are skipped, and reported as the wrong size at the end
+        size_t index = (size_t)frame.index++;
+        if (index < frame.arraySize)
+            JSONSAXPushValue(value[index], reader, (const char*)nullptr);
+        else
+            reader.PushSkip();
+        return reader.Dispatch(event);
+    }
+
+    template <typename T, bool (*READ)(T& value, const rapidjson::Value& document)>
+    static bool DOMValueEvent(JSONSAXReader& reader, Frame& frame, const Event& event)
+    {
+        T& value = *(T*)frame.value;
+
+        if (!frame.started && event.type == Event::Type::Scalar)
+        {
+            if (!READ(value, *event.scalar))
+                return reader.Error();
+            reader.Pop();
+            return true;
+        }
+
+        if (!frame.started)
+        {
+            frame.started = true;
+            frame.start = reader.GetStartOffset();
+        }
+
+        if (!TrackDepth(frame, event))
+            return true;
+
+        rapidjson::Document document;
+        document.Parse<rapidjson::kParseCommentsFlag | rapidjson::kParseTrailingCommasFlag | rapidjson::kParseStopWhenDoneFlag>(reader.m_json + frame.start);
+        if (document.HasParseError())
+            return reader.UseDOM();
+
+        if (!READ(value, document))
+            return reader.Error();
+        reader.Pop();
+        return true;
+    }
+
+    static bool SkipEvent(JSONSAXReader& reader, Frame& frame, const Event& event)
+    {
+        if (TrackDepth(frame, event))
+            reader.Pop();
+        return true;
+    }
+
+    // Returns true when the value is complete
+    static bool TrackDepth(Frame& frame, const Event& event)
+    {
+        switch (event.type)
+        {
+            case Event::Type::StartObject:
+            case Event::Type::StartArray:
+                frame.depth++;
+                return false;
+            case Event::Type::EndObject:
+            case Event::Type::EndArray:
+                frame.depth--;
+                return frame.depth == 0;
+            case Event::Type::Scalar:
+                return frame.depth == 0;
+            default:
+                return false;
+        }
+    }
+
+    const char* m_json = nullptr;
+    rapidjson::StringStream* m_stream = nullptr;
+    std::vector<Frame> m_frames;
+    JSONSAXReadResult m_result = JSONSAXReadResult::Finished;
+};
+
+// Read a structure from a JSON string with the streaming reader
+template<typename TROOT>
+JSONSAXReadResult JSONSAXReadBuffer(TROOT& root, const char* data)
+{
+    JSONSAXReader reader(data);
+    JSONSAXPushValue(root, reader, (const char*)nullptr);
+    return reader.Parse();
+}
+
+// Enums are read with JSONRead()
+
+#define ENUM_BEGIN(_NAME, _DESCRIPTION)
+
+#define ENUM_ITEM(_NAME, _DESCRIPTION)
+
+#define ENUM_END()
+
+// Structs
+
+#define STRUCT_BEGIN(_NAME, _DESCRIPTION) \
+    template <typename READER> \
+    void JSONSAXPushValue(_NAME& value, READER& reader, const char* memberName) \
+    { \
+        reader.PushObject(value, memberName); \
+    } \
+    template <typename READER> \
+    bool JSONSAXReadMember(_NAME& value, const char* key, size_t keyLength, uint32_t keyHash, READER& reader) \
+    { \
+        switch (keyHash) \
+        {
+
+#define STRUCT_INHERIT_BEGIN(_NAME, _BASE, _DESCRIPTION) \
+    template <typename READER> \
+    void JSONSAXPushValue(_NAME& value, READER& reader, const char* memberName) \
+    { \
+        reader.PushObject(value, memberName); \
+    } \
+    template <typename READER> \
+    bool JSONSAXReadMember(_NAME& value, const char* key, size_t keyLength, uint32_t keyHash, READER& reader) \
+    { \
+        if (JSONSAXReadMember(*(_BASE*)&value, key, keyLength, keyHash, reader)) \
+            return true; \
+        switch (keyHash) \
+        {
+
+#define STRUCT_FIELD(_TYPE, _NAME, _DEFAULT, _DESCRIPTION, _FLAGS) \
+            case DFS_JSON_KEY_HASH(_NAME): \
+            { \
+                if (((_FLAGS) & SCHEMA_FLAG_NO_SERIALIZE) == 0 && DFS_JSON_KEY_EQUALS(_NAME)) \
+                { \
+                    JSONSAXPushValue(value._NAME, reader, #_NAME); \
+                    return true; \
+                } \
+                break; \
+            }
+
+#define STRUCT_CONST(_TYPE, _NAME, _DEFAULT, _DESCRIPTION, _FLAGS)
+
+#define STRUCT_DYNAMIC_ARRAY(_TYPE, _NAME, _DESCRIPTION, _FLAGS) \
+            case DFS_JSON_KEY_HASH(_NAME): \
+            { \
+                if (((_FLAGS) & SCHEMA_FLAG_NO_SERIALIZE) == 0 && DFS_JSON_KEY_EQUALS(_NAME)) \
+                { \
+                    reader.PushDynamicArray(value._NAME, #_NAME); \
+                    return true; \
+                } \
+                break; \
+            }
+
+#define STRUCT_STATIC_ARRAY(_TYPE, _NAME, _SIZE, _DEFAULT, _DESCRIPTION, _FLAGS) \
+            case DFS_JSON_KEY_HASH(_NAME): \
+            { \
+                if (((_FLAGS) & SCHEMA_FLAG_NO_SERIALIZE) == 0 && DFS_JSON_KEY_EQUALS(_NAME)) \
+                { \
+                    reader.PushStaticArray(&value._NAME[0], _SIZE, #_NAME); \
+                    return true; \
+                } \
+                break; \
+            }
+
+#define STRUCT_END() \
+        } \
+        return false; \
+    }
+
+// Variants
+
+#define VARIANT_BEGIN(_NAME, _DESCRIPTION) \
+    template <typename READER> \
+    void JSONSAXPushValue(_NAME& value, READER& reader, const char* memberName) \
+    { \
+        reader.PushObject(value, memberName); \
+    } \
+    template <typename READER> \
+    bool JSONSAXReadMember(_NAME& value, const char* key, size_t keyLength, uint32_t keyHash, READER& reader) \
+    { \
+        typedef _NAME ThisType; \
+        switch (keyHash) \
+        {
+
+#define VARIANT_TYPE(_TYPE, _NAME, _DEFAULT, _DESCRIPTION) \
+            case DFS_JSON_KEY_HASH(_NAME): \
+            { \
+                if (DFS_JSON_KEY_EQUALS(_NAME)) \
+                { \
+                    value._index = ThisType::c_index_##_NAME; \
+                    JSONSAXPushValue(value._NAME, reader, (const char*)nullptr); \
+                    return true; \
+                } \
+                break; \
+            }
+
+#define VARIANT_END() \
+        } \
+        return false; \
+    }
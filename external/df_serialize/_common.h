@@ -1,4 +1,5 @@
 #include "Config.h"
+#include "EnumStringTable.h"
 
 // Undefine any macros that may be defined, so they can safely be defined. Lazy define cleanup.
 
@@ -6,8 +6,24 @@
 //clang-format off
 #include "GigiCompilerLib/gigicompiler.h"
 
+#include "GigiCompilerLib/SubGraphs.h"
+#include "GigiCompilerLib/CompilerUnitTests.h"
+#include "GigiCompilerLib/RenderGraphFileCache.h"
+
 #include "Schemas/HTML.h"
 #include "Schemas/JSONSchema.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
 //clang-format on
 
 #ifdef _DEBUG
@@ -55,61 +71,460 @@ void WriteViewerPythonTypes(const char* fileName)
     fclose(file);
 }
 
-int main(int argc, char** argv)
+void PrintUsage()
 {
-    // Write out the most up to date help file and json schema
-    WriteHTML("gigihelp.html");
-    WriteJSONSchema("gigischema.json");
-    WriteViewerPythonTypes("UserDocumentation/PythonTypes.txt");
+    printf("Version " GIGI_VERSION() " (" BUILD_FLAVOR() ")\n");
+    printf("Usage: GigiCompiler.exe <platform> <json file> <output directory>\n\nExample: GigiCompiler.exe DX12_Module Techniques/boxblur.gg ./out/ [-graphviz]\n\n");
+    printf("Backends Supported:\n");
+    #include "external/df_serialize/_common.h"
+    #define GIGI_BUILD_FLAVOR(BACKEND, FLAVOR, INTERNAL) if(!INTERNAL) { printf("  " #BACKEND "_" #FLAVOR "\n"); }
+    #include "GigiCompilerLib/GigiBuildFlavorList.h"
+    #undef GIGI_BUILD_FLAVOR
+    printf("\n");
+    printf("optional -graphviz enables generation of GraphViz graphs & images for gigi project visualization\n");
+    printf("\n");
+    printf("Batch Usage: GigiCompiler.exe -batch <manifest file> [-jobs <count>]\n");
+    printf("  Compiles every job in the manifest in one process. Each line of the manifest is a job, with the same\n");
+    printf("  arguments as a single compile: <platform> <json file> <output directory> [-graphviz]\n");
+    printf("  Arguments with spaces go in double quotes. Blank lines and lines starting with # are skipped.\n");
+    printf("  Jobs run in parallel, except that jobs whose output directories are the same or nested run in manifest order.\n");
+    printf("\n");
+    printf("Daemon Usage: GigiCompiler.exe -daemon [-jobs <count>]\n");
+    printf("  Reads jobs from stdin, one per line like the manifest, until end of input or a line saying quit.\n");
+    printf("  Prints \"done <job number> <result> <json file>\" to stdout as each job finishes. Job numbers start at 1.\n");
+    printf("\n");
+    printf("Unit Test Usage: GigiCompiler.exe -unittests\n");
+    printf("  Runs the compiler's unit tests. Returns 0 if they all pass.\n");
+    printf("\n");
+    printf("Cache Verify Usage: GigiCompiler.exe -verifycache <manifest file>\n");
+    printf("  Checks that the binary cache of each .gg file in a batch manifest gives the same render graph as its JSON,\n");
+    printf("  and that the streaming and DOM JSON readers read the same render graph.\n");
+    printf("  Returns 0 if they all match.\n");
+    printf("\n");
+}
+
+struct CompileJob
+{
+    GigiBuildFlavor buildFlavor = GigiBuildFlavor::Interpreter_Interpreter;
+    std::string jsonFile;
+    std::string outputDir;
+    bool graphviz = false;
+    int jobNumber = 0;
+
+    // outputDir made canonical and lower case, for finding jobs that write to the same place
+    std::filesystem::path outputPath;
+};
+
+void (*GetPostLoad(Backend backend))(RenderGraph&)
+{
+    void (*PostLoad)(RenderGraph&) = nullptr;
+    switch (backend)
+    {
+        #include "external/df_serialize/_common.h"
+        #define ENUM_ITEM(x, y) case Backend::x: PostLoad = PostLoad_##x; break;
+        // clang-format off
+        #include "external/df_serialize/_fillunsetdefines.h"
+        #include "Schemas/BackendList.h"
+        // clang-format on
+    }
+    return PostLoad;
+}
+
+// args are <platform> <json file> <output directory> [-graphviz], the same as the command line of a single compile
+GigiCompileResult MakeCompileJob(const std::vector<std::string>& args, CompileJob& job)
+{
+    bool graphviz = (args.size() == 4 && args[3] == "-graphviz");
+    if (args.size() != 3 && !graphviz)
+        return GigiCompileResult::WrongParams;
 
-    bool GENERATE_GRAPHVIZ_FLAG = false;
-    std::string graphviz_param = "-graphviz";
-    if (argc == 5 && graphviz_param.compare(argv[4]) == 0)
+    if (!StringToEnum(args[0].c_str(), job.buildFlavor))
     {
-        GENERATE_GRAPHVIZ_FLAG = true;
+        Assert(false, "Could not find build flavor '%s'", args[0].c_str());
+        return GigiCompileResult::NoBackend;
     }
-    if ((argc != 4 && argc != 5) || (argc == 5 && !GENERATE_GRAPHVIZ_FLAG))
+
+    Backend backend;
+    if (!GigiBuildFlavorBackend(job.buildFlavor, backend))
     {
-        printf("Version " GIGI_VERSION() " (" BUILD_FLAVOR() ")\n");
-        printf("Usage: GigiCompiler.exe <platform> <json file> <output directory>\n\nExample: GigiCompiler.exe DX12_Module Techniques/boxblur.gg ./out/ [-graphviz]\n\n");
-        printf("Backends Supported:\n");
-        #include "external/df_serialize/_common.h"
-        #define GIGI_BUILD_FLAVOR(BACKEND, FLAVOR, INTERNAL) if(!INTERNAL) { printf("  " #BACKEND "_" #FLAVOR "\n"); }
-        #include "GigiCompilerLib/GigiBuildFlavorList.h"
-        #undef GIGI_BUILD_FLAVOR
-        printf("\n");
-        printf("optional -graphviz enables generation of GraphViz graphs & images for gigi project visualization\n");
-        printf("\n");
-        return (int)GigiCompileResult::WrongParams;
+        Assert(false, "Could not get backend for build flavor '%s'", args[0].c_str());
+        return GigiCompileResult::NoBackend;
     }
 
+    job.jsonFile = args[1];
+    job.outputDir = args[2];
+    job.graphviz = graphviz;
 
-    // Get the build flavor
-    GigiBuildFlavor buildFlavor;
-    if (!StringToEnum(argv[1], buildFlavor))
+    std::error_code ec;
+    std::filesystem::path absolutePath = std::filesystem::absolute(job.outputDir, ec).lexically_normal();
+    std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(absolutePath, ec);
+    std::string outputPath = (ec ? absolutePath : canonicalPath).string();
+    std::transform(outputPath.begin(), outputPath.end(), outputPath.begin(), [](unsigned char c) { return std::tolower(c); });
+    job.outputPath = std::filesystem::path(outputPath) / "";
+    job.outputPath = job.outputPath.parent_path();
+    return GigiCompileResult::OK;
+}
+
+// True if one output directory is the same as, or inside of, the other.
+// An application job writes to the directory that its modules are in, so it and the module jobs could write the same files.
+bool OutputDirectoriesOverlap(const CompileJob& a, const CompileJob& b)
+{
+    auto itA = a.outputPath.begin();
+    auto itB = b.outputPath.begin();
+    for (; itA != a.outputPath.end() && itB != b.outputPath.end(); ++itA, ++itB)
     {
-        Assert(false, "Could not find build flavor '%s'", argv[1]);
-        return (int)GigiCompileResult::NoBackend;
+        if (*itA != *itB)
+            return false;
     }
+    return true;
+}
 
-    // Get the backend
+GigiCompileResult RunCompileJob(const CompileJob& job, SubGraphCache* subGraphCache)
+{
     Backend backend;
-    if (!GigiBuildFlavorBackend(buildFlavor, backend))
+    GigiBuildFlavorBackend(job.buildFlavor, backend);
+    return GigiCompile(job.buildFlavor, job.jsonFile, job.outputDir, GetPostLoad(backend), nullptr, job.graphviz, subGraphCache);
+}
+
+// Splits a line of a manifest into arguments. Arguments are separated by whitespace, and can be in double quotes.
+std::vector<std::string> SplitJobLine(const std::string& line)
+{
+    std::vector<std::string> args;
+    size_t index = 0;
+    while (true)
     {
-        Assert(false, "Could not get backend for build flavor '%s'", argv[1]);
-        return (int)GigiCompileResult::NoBackend;
+        while (index < line.size() && isspace((unsigned char)line[index]))
+            index++;
+        if (index >= line.size())
+            break;
+
+        std::string arg;
+        if (line[index] == '"')
+        {
+            size_t end = line.find('"', index + 1);
+            if (end == std::string::npos)
+                end = line.size();
+            arg = line.substr(index + 1, end - index - 1);
+            index = end + 1;
+        }
+        else
+        {
+            size_t end = index;
+            while (end < line.size() && !isspace((unsigned char)line[end]))
+                end++;
+            arg = line.substr(index, end - index);
+            index = end;
+        }
+        args.push_back(arg);
     }
+    return args;
+}
 
-    void (*PostLoad)(RenderGraph&) = nullptr;
-    switch (backend)
+bool IsJobLineEmpty(const std::vector<std::string>& args)
+{
+    return args.empty() || args[0][0] == '#';
+}
+
+// Runs compile jobs on a pool of worker threads. Jobs can be added while it runs.
+// Jobs whose output directories overlap run one after another, in the order they were added. Other jobs run in parallel.
+// Every job shares the sub graph cache, and the parsed template cache in Backends/Shared.h is shared by the whole process.
+// Messages from a job are prefixed with its job number and file name.
+class CompileJobQueue
+{
+public:
+    CompileJobQueue(int workerCount, bool printResults)
+        : m_printResults(printResults)
     {
-        #include "external/df_serialize/_common.h"
-        #define ENUM_ITEM(x, y) case Backend::x: PostLoad = PostLoad_##x; break;
-        // clang-format off
-        #include "external/df_serialize/_fillunsetdefines.h"
-        #include "Schemas/BackendList.h"
-        // clang-format on
+        for (int index = 0; index < workerCount; ++index)
+            m_workers.emplace_back([this]() { WorkerThread(); });
+    }
+
+    void Add(const CompileJob& job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.push_back(job);
+        }
+        m_jobsChanged.notify_one();
+    }
+
+    // Lets the workers finish the jobs that are left, then waits for them.
+    void Finish()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_finishing = true;
+        }
+        m_jobsChanged.notify_all();
+
+        for (std::thread& worker : m_workers)
+            worker.join();
+        m_workers.clear();
+    }
+
+    int GetFailedCount() const
+    {
+        return m_failedCount;
+    }
+
+    GigiCompileResult GetFirstFailure() const
+    {
+        return m_firstFailure;
+    }
+
+    SubGraphCache& GetSubGraphCache()
+    {
+        return m_subGraphCache;
     }
 
-    return (int)GigiCompile(buildFlavor, argv[2], argv[3], PostLoad, nullptr, GENERATE_GRAPHVIZ_FLAG);
+private:
+    // Takes the first job that doesn't overlap the output directory of a running job, or of a job ahead of it in the queue.
+    // Call with m_mutex locked.
+    bool TakeRunnableJob(CompileJob& job)
+    {
+        for (size_t jobIndex = 0; jobIndex < m_jobs.size(); ++jobIndex)
+        {
+            bool blocked = false;
+            for (const CompileJob& runningJob : m_runningJobs)
+                blocked = blocked || OutputDirectoriesOverlap(m_jobs[jobIndex], runningJob);
+            for (size_t earlierIndex = 0; earlierIndex < jobIndex; ++earlierIndex)
+                blocked = blocked || OutputDirectoriesOverlap(m_jobs[jobIndex], m_jobs[earlierIndex]);
+            if (blocked)
+                continue;
+
+            job = m_jobs[jobIndex];
+            m_jobs.erase(m_jobs.begin() + jobIndex);
+            m_runningJobs.push_back(job);
+            return true;
+        }
+        return false;
+    }
+
+    void WorkerThread()
+    {
+        while (true)
+        {
+            CompileJob job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                while (!TakeRunnableJob(job))
+                {
+                    if (m_finishing && m_jobs.empty())
+                        return;
+                    m_jobsChanged.wait(lock);
+                }
+            }
+
+            char messagePrefix[1024];
+            sprintf_s(messagePrefix, "[Job %i %s] ", job.jobNumber, std::filesystem::path(job.jsonFile).filename().string().c_str());
+            SetGigiThreadMessagePrefix(messagePrefix);
+            GigiCompileResult result = RunCompileJob(job, &m_subGraphCache);
+            SetGigiThreadMessagePrefix(nullptr);
+
+            ReportResult(job, result);
+            m_jobsChanged.notify_all();
+        }
+    }
+
+    void ReportResult(const CompileJob& job, GigiCompileResult result)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t runningIndex = 0; runningIndex < m_runningJobs.size(); ++runningIndex)
+        {
+            if (m_runningJobs[runningIndex].jobNumber == job.jobNumber)
+            {
+                m_runningJobs.erase(m_runningJobs.begin() + runningIndex);
+                break;
+            }
+        }
+
+        if (result != GigiCompileResult::OK)
+        {
+            if (m_failedCount == 0)
+                m_firstFailure = result;
+            m_failedCount++;
+            ShowErrorMessage("Job %i failed (%s): %s", job.jobNumber, EnumToString(result), job.jsonFile.c_str());
+        }
+
+        if (m_printResults)
+        {
+            printf("done %i %s %s\n", job.jobNumber, EnumToString(result), job.jsonFile.c_str());
+            fflush(stdout);
+        }
+    }
+
+    bool m_printResults = false;
+    SubGraphCache m_subGraphCache;
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_mutex;
+    std::condition_variable m_jobsChanged;
+    std::deque<CompileJob> m_jobs;
+    std::vector<CompileJob> m_runningJobs;
+    bool m_finishing = false;
+    int m_failedCount = 0;
+    GigiCompileResult m_firstFailure = GigiCompileResult::OK;
+};
+
+int RunBatch(const char* manifestFileName, int workerCount)
+{
+    std::ifstream stream(manifestFileName);
+    if (!stream)
+    {
+        Assert(false, "Could not load manifest %s", manifestFileName);
+        return (int)GigiCompileResult::WrongParams;
+    }
+
+    // Read every job before starting any, so a bad manifest doesn't leave half of the output written
+    std::vector<CompileJob> jobs;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(stream, line))
+    {
+        lineNumber++;
+        std::vector<std::string> args = SplitJobLine(line);
+        if (IsJobLineEmpty(args))
+            continue;
+
+        CompileJob job;
+        GigiCompileResult result = MakeCompileJob(args, job);
+        if (result != GigiCompileResult::OK)
+        {
+            Assert(false, "%s line %i is not a valid job: %s", manifestFileName, lineNumber, line.c_str());
+            return (int)result;
+        }
+        job.jobNumber = (int)jobs.size() + 1;
+        jobs.push_back(job);
+    }
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+    CompileJobQueue queue(workerCount, false);
+    for (const CompileJob& job : jobs)
+        queue.Add(job);
+    queue.Finish();
+
+    std::chrono::duration<float> duration = std::chrono::high_resolution_clock::now() - start;
+    ShowInfoMessage("Batch compiled %i jobs on %i threads in %0.2f seconds, %i failed. Sub graph cache: %i hits, %i misses",
+        (int)jobs.size(), workerCount, duration.count(), queue.GetFailedCount(), queue.GetSubGraphCache().GetHits(), queue.GetSubGraphCache().GetMisses());
+
+    return (int)queue.GetFirstFailure();
+}
+
+int RunVerifyCache(const char* manifestFileName)
+{
+    std::ifstream stream(manifestFileName);
+    if (!stream)
+    {
+        Assert(false, "Could not load manifest %s", manifestFileName);
+        return (int)GigiCompileResult::WrongParams;
+    }
+
+    int fileCount = 0;
+    int failedCount = 0;
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        std::vector<std::string> args = SplitJobLine(line);
+        if (IsJobLineEmpty(args))
+            continue;
+
+        CompileJob job;
+        if (MakeCompileJob(args, job) != GigiCompileResult::OK)
+        {
+            Assert(false, "%s has a line that is not a valid job: %s", manifestFileName, line.c_str());
+            return (int)GigiCompileResult::WrongParams;
+        }
+
+        fileCount++;
+        if (!VerifyRenderGraphFileCache(job.jsonFile))
+            failedCount++;
+    }
+
+    ShowInfoMessage("Verified the render graph cache of %i files, %i failed", fileCount, failedCount);
+    return failedCount == 0 ? 0 : 1;
+}
+
+int RunDaemon(int workerCount)
+{
+    CompileJobQueue queue(workerCount, true);
+
+    int jobCount = 0;
+    std::string line;
+    while (std::getline(std::cin, line))
+    {
+        std::vector<std::string> args = SplitJobLine(line);
+        if (IsJobLineEmpty(args))
+            continue;
+
+        if (args.size() == 1 && args[0] == "quit")
+            break;
+
+        CompileJob job;
+        job.jobNumber = ++jobCount;
+        GigiCompileResult result = MakeCompileJob(args, job);
+        if (result != GigiCompileResult::OK)
+        {
+            printf("done %i %s %s\n", job.jobNumber, EnumToString(result), args.size() > 1 ? args[1].c_str() : "");
+            fflush(stdout);
+            continue;
+        }
+
+        queue.Add(job);
+    }
+
+    queue.Finish();
+    return (int)queue.GetFirstFailure();
+}
+
+int main(int argc, char** argv)
+{
+    // Write out the most up to date help file and json schema.
+    // Batch and daemon modes do this once for all of their jobs.
+    WriteHTML("gigihelp.html");
+    WriteJSONSchema("gigischema.json");
+    WriteViewerPythonTypes("UserDocumentation/PythonTypes.txt");
+
+    if (argc == 2 && !strcmp(argv[1], "-unittests"))
+        return RunCompilerUnitTests() ? 0 : 1;
+
+    if (argc == 3 && !strcmp(argv[1], "-verifycache"))
+        return RunVerifyCache(argv[2]);
+
+    // Batch and daemon modes
+    if (argc >= 2 && (!strcmp(argv[1], "-batch") || !strcmp(argv[1], "-daemon")))
+    {
+        bool batch = !strcmp(argv[1], "-batch");
+        int argIndex = batch ? 3 : 2;
+        if (batch && argc < 3)
+        {
+            PrintUsage();
+            return (int)GigiCompileResult::WrongParams;
+        }
+
+        int workerCount = (int)std::thread::hardware_concurrency();
+        if (argc == argIndex + 2 && !strcmp(argv[argIndex], "-jobs"))
+            workerCount = atoi(argv[argIndex + 1]);
+        else if (argc != argIndex)
+        {
+            PrintUsage();
+            return (int)GigiCompileResult::WrongParams;
+        }
+        if (workerCount < 1)
+            workerCount = 1;
+
+        return batch ? RunBatch(argv[2], workerCount) : RunDaemon(workerCount);
+    }
+
+    std::vector<std::string> args;
+    for (int argIndex = 1; argIndex < argc; ++argIndex)
+        args.push_back(argv[argIndex]);
+
+    CompileJob job;
+    GigiCompileResult result = MakeCompileJob(args, job);
+    if (result == GigiCompileResult::WrongParams)
+        PrintUsage();
+    if (result != GigiCompileResult::OK)
+        return (int)result;
+
+    return (int)RunCompileJob(job, nullptr);
 }